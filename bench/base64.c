@@ -0,0 +1,87 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "bench.h"
+#include <gg/arena.h>
+#include <gg/base64.h>
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Large enough for a camera frame
+#define BASE64_BENCH_MAX (1024U * 1024U)
+
+static uint8_t raw[BASE64_BENCH_MAX];
+static uint8_t encoded[((BASE64_BENCH_MAX + 2) / 3) * 4];
+// Decoding needs space for whole groups, including padding
+static uint8_t decoded[((BASE64_BENCH_MAX + 2) / 3) * 3];
+
+static GgBuffer base64_bench_input(size_t len) {
+    uint32_t state = 1;
+    for (size_t i = 0; i < len; i++) {
+        state = (state * 1103515245U) + 12345U;
+        raw[i] = (uint8_t) (state >> 16);
+    }
+    return (GgBuffer) { .data = raw, .len = len };
+}
+
+static void bench_encode(GgBench *bench, size_t len) {
+    GgBuffer input = base64_bench_input(len);
+    bench->bytes = len;
+    gg_bench_reset_timer(bench);
+
+    for (uint64_t i = 0; i < bench->iterations; i++) {
+        GgArena arena = gg_arena_init(GG_BUF(encoded));
+        GgBuffer result;
+        if (gg_base64_encode(input, &arena, &result) != GG_ERR_OK) {
+            abort();
+        }
+        gg_bench_keep(result.data);
+    }
+}
+
+static void bench_decode(GgBench *bench, size_t len) {
+    GgBuffer input = base64_bench_input(len);
+    GgArena arena = gg_arena_init(GG_BUF(encoded));
+    GgBuffer b64;
+    if (gg_base64_encode(input, &arena, &b64) != GG_ERR_OK) {
+        abort();
+    }
+    bench->bytes = len;
+    gg_bench_reset_timer(bench);
+
+    for (uint64_t i = 0; i < bench->iterations; i++) {
+        GgBuffer out = GG_BUF(decoded);
+        if (!gg_base64_decode(b64, &out)) {
+            abort();
+        }
+        gg_bench_keep(out.data);
+    }
+}
+
+GG_BENCH_DEFINE(base64_encode_64) {
+    bench_encode(bench, 64);
+}
+
+GG_BENCH_DEFINE(base64_encode_4k) {
+    bench_encode(bench, 4096);
+}
+
+GG_BENCH_DEFINE(base64_encode_1m) {
+    bench_encode(bench, BASE64_BENCH_MAX);
+}
+
+GG_BENCH_DEFINE(base64_decode_64) {
+    bench_decode(bench, 64);
+}
+
+GG_BENCH_DEFINE(base64_decode_4k) {
+    bench_decode(bench, 4096);
+}
+
+GG_BENCH_DEFINE(base64_decode_1m) {
+    bench_decode(bench, BASE64_BENCH_MAX);
+}
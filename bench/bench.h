@@ -0,0 +1,54 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef GG_BENCH_H
+#define GG_BENCH_H
+
+//! Microbenchmark registration
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// State of a running benchmark.
+typedef struct {
+    /// Number of operations the benchmark must run.
+    uint64_t iterations;
+    /// Bytes processed per operation, for reporting throughput.
+    size_t bytes;
+    /// Start of the timed region.
+    uint64_t start_ns;
+} GgBench;
+
+typedef void (*GgBenchFunction)(GgBench *bench);
+
+typedef struct GgBenchListNode {
+    GgBenchFunction func;
+    const char *func_name;
+    struct GgBenchListNode *next;
+} GgBenchListNode;
+
+void gg_bench_register(GgBenchListNode *entry);
+
+/// Define a benchmark. The body runs `bench->iterations` operations.
+#define GG_BENCH_DEFINE(benchname) \
+    static void bench_gg_##benchname(GgBench *bench); \
+    __attribute__((constructor)) static void gg_bench_register_##benchname( \
+        void \
+    ) { \
+        static GgBenchListNode entry = { .func = bench_gg_##benchname, \
+                                         .func_name = #benchname, \
+                                         .next = NULL }; \
+        gg_bench_register(&entry); \
+    } \
+    static void bench_gg_##benchname(GgBench *bench)
+
+/// Restart the timed region, excluding setup done so far.
+void gg_bench_reset_timer(GgBench *bench);
+
+/// Keep the compiler from optimizing away a computed result.
+static inline void gg_bench_keep(const void *ptr) {
+    __asm__ volatile("" : : "r"(ptr) : "memory");
+}
+
+#endif
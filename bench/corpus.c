@@ -0,0 +1,139 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "corpus.h"
+#include <gg/arena.h>
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/json_decode.h>
+#include <gg/object.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static const char MESSAGE_JSON[]
+    = "{\"jsonMessage\":{\"message\":{\"deviceId\":\"sensor-0042\","
+      "\"timestamp\":1718035200123,\"temperature\":21.53,\"humidity\":40.2,"
+      "\"battery\":0.87,\"online\":true,\"alerts\":[]},"
+      "\"context\":{\"topic\":\"factory/line-3/sensors/sensor-0042/"
+      "telemetry\"}}}";
+
+static const char CONFIG_JSON[]
+    = "{\"componentName\":\"com.example.LineMonitor\","
+      "\"version\":\"2.4.1\","
+      "\"logging\":{\"level\":\"INFO\",\"format\":\"JSON\","
+      "\"outputDirectory\":\"/greengrass/v2/logs\",\"fileSizeKB\":1024,"
+      "\"totalLogsSizeKB\":10240},"
+      "\"mqtt\":{\"port\":8883,\"keepAliveTimeoutMs\":60000,"
+      "\"pingTimeoutMs\":30000,\"operationTimeoutMs\":30000,"
+      "\"maxInFlightPublishes\":5,\"maxMessageSizeInBytes\":131072,"
+      "\"spooler\":{\"storageType\":\"Memory\",\"maxSizeInBytes\":2621440,"
+      "\"keepQos0WhenOffline\":false}},"
+      "\"accessControl\":{\"aws.greengrass.ipc.pubsub\":{"
+      "\"com.example.LineMonitor:pubsub:1\":{"
+      "\"policyDescription\":\"Allows publishing line telemetry.\","
+      "\"operations\":[\"aws.greengrass#PublishToTopic\","
+      "\"aws.greengrass#SubscribeToTopic\"],"
+      "\"resources\":[\"factory/line-3/#\",\"factory/alerts\"]}},"
+      "\"aws.greengrass.ipc.mqttproxy\":{"
+      "\"com.example.LineMonitor:mqttproxy:1\":{"
+      "\"policyDescription\":\"Forwards alerts to the cloud.\","
+      "\"operations\":[\"aws.greengrass#PublishToIoTCore\"],"
+      "\"resources\":[\"dt/factory/+/alerts\"]}}},"
+      "\"sensors\":["
+      "{\"id\":\"sensor-0040\",\"type\":\"temperature\",\"unit\":\"\\u00b0C\","
+      "\"min\":-40,\"max\":125,\"sampleIntervalMs\":500,\"enabled\":true},"
+      "{\"id\":\"sensor-0041\",\"type\":\"humidity\",\"unit\":\"%\","
+      "\"min\":0,\"max\":100,\"sampleIntervalMs\":1000,\"enabled\":true},"
+      "{\"id\":\"sensor-0042\",\"type\":\"vibration\",\"unit\":\"mm/s\","
+      "\"min\":0,\"max\":50.5,\"sampleIntervalMs\":100,\"enabled\":true},"
+      "{\"id\":\"sensor-0043\",\"type\":\"pressure\",\"unit\":\"kPa\","
+      "\"min\":80,\"max\":120,\"sampleIntervalMs\":250,\"enabled\":false}],"
+      "\"thresholds\":{\"temperature\":{\"warn\":70.0,\"critical\":85.0},"
+      "\"humidity\":{\"warn\":80,\"critical\":95},"
+      "\"vibration\":{\"warn\":12.5,\"critical\":25.0}},"
+      "\"upload\":{\"enabled\":true,\"batchSize\":500,\"intervalSeconds\":60,"
+      "\"compression\":\"none\",\"retry\":{\"maxAttempts\":5,"
+      "\"baseDelayMs\":200,\"maxDelayMs\":30000,\"jitter\":true}},"
+      "\"labels\":{\"site\":\"Seattle \\\"South\\\"\","
+      "\"building\":\"B-12\",\"line\":\"3\",\"owner\":\"ops@example.com\","
+      "\"notes\":\"Recalibrated 2024-05-02.\\nReplace filter quarterly.\"}}";
+
+// Each record is just under 128 bytes
+#define TELEMETRY_RECORDS 512U
+
+static char telemetry_json[TELEMETRY_RECORDS * 128U + 64U];
+static size_t telemetry_json_len = 0;
+
+static GgBuffer telemetry(void) {
+    if (telemetry_json_len > 0) {
+        return (GgBuffer) { .data = (uint8_t *) telemetry_json,
+                            .len = telemetry_json_len };
+    }
+
+    size_t len = 0;
+    size_t cap = sizeof(telemetry_json);
+    len += (size_t) snprintf(&telemetry_json[len], cap - len, "{\"records\":[");
+    for (uint32_t i = 0; i < TELEMETRY_RECORDS; i++) {
+        len += (size_t) snprintf(
+            &telemetry_json[len],
+            cap - len,
+            "%s{\"ts\":%u,\"device\":\"sensor-%04u\",\"temperature\":%u.%02u,"
+            "\"humidity\":%u.%u,\"ok\":%s,\"tags\":[\"line-3\",\"zone-%u\"]}",
+            (i == 0) ? "" : ",",
+            1718035200U + i,
+            i % 64U,
+            18U + (i * 7U % 9U),
+            i * 37U % 100U,
+            30U + (i * 13U % 40U),
+            i % 10U,
+            (i % 17U == 0) ? "false" : "true",
+            i % 8U
+        );
+    }
+    len += (size_t) snprintf(&telemetry_json[len], cap - len, "]}");
+    if (len >= cap) {
+        abort();
+    }
+
+    telemetry_json_len = len;
+    return (GgBuffer) { .data = (uint8_t *) telemetry_json, .len = len };
+}
+
+GgBuffer gg_bench_json(GgBenchJson doc) {
+    switch (doc) {
+    case GG_BENCH_JSON_MESSAGE:
+        return (GgBuffer) { .data = (uint8_t *) MESSAGE_JSON,
+                            .len = sizeof(MESSAGE_JSON) - 1 };
+    case GG_BENCH_JSON_CONFIG:
+        return (GgBuffer) { .data = (uint8_t *) CONFIG_JSON,
+                            .len = sizeof(CONFIG_JSON) - 1 };
+    case GG_BENCH_JSON_TELEMETRY:
+        return telemetry();
+    }
+    abort();
+}
+
+GgObject gg_bench_json_obj(GgBenchJson doc, GgArena *arena) {
+    GgBuffer json = gg_bench_json(doc);
+    uint8_t *copy = GG_ARENA_ALLOCN(arena, uint8_t, json.len);
+    if (copy == NULL) {
+        abort();
+    }
+    memcpy(copy, json.data, json.len);
+
+    GgObject obj;
+    GgError ret = gg_json_decode_destructive_with_limits(
+        (GgBuffer) { .data = copy, .len = json.len },
+        arena,
+        &obj,
+        GG_BENCH_CORPUS_LIMITS
+    );
+    if (ret != GG_ERR_OK) {
+        abort();
+    }
+    return obj;
+}
@@ -0,0 +1,36 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef GG_BENCH_CORPUS_H
+#define GG_BENCH_CORPUS_H
+
+//! Payloads representative of component IPC traffic
+
+#include <gg/arena.h>
+#include <gg/buffer.h>
+#include <gg/object.h>
+
+/// JSON documents to benchmark with.
+typedef enum {
+    /// A pub/sub message with its context, about 250 bytes.
+    GG_BENCH_JSON_MESSAGE,
+    /// A component configuration document, about 2 KiB.
+    GG_BENCH_JSON_CONFIG,
+    /// A batch of telemetry records, about 64 KiB.
+    GG_BENCH_JSON_TELEMETRY,
+} GgBenchJson;
+
+/// Limits large enough for every corpus document.
+#define GG_BENCH_CORPUS_LIMITS \
+    ((GgObjectLimits) { .max_depth = GG_MAX_OBJECT_DEPTH, \
+                        .max_subobjects = 16384 })
+
+/// Get a corpus document. The returned memory must not be modified.
+GgBuffer gg_bench_json(GgBenchJson doc);
+
+/// Decode a corpus document into `arena`, aborting on failure.
+/// The decoded object references copied JSON in `arena`.
+GgObject gg_bench_json_obj(GgBenchJson doc, GgArena *arena);
+
+#endif
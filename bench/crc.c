@@ -0,0 +1,41 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../src/crc32.h"
+#include "bench.h"
+#include <gg/buffer.h>
+#include <stddef.h>
+#include <stdint.h>
+
+static uint8_t crc_input[64U * 1024U];
+
+static void bench_crc(GgBench *bench, size_t len) {
+    uint32_t state = 1;
+    for (size_t i = 0; i < len; i++) {
+        state = (state * 1103515245U) + 12345U;
+        crc_input[i] = (uint8_t) (state >> 16);
+    }
+    GgBuffer input = { .data = crc_input, .len = len };
+    bench->bytes = len;
+    gg_bench_reset_timer(bench);
+
+    uint32_t crc = 0;
+    for (uint64_t i = 0; i < bench->iterations; i++) {
+        crc = gg_update_crc(crc, input);
+        gg_bench_keep(&crc);
+    }
+}
+
+// Size of an EventStream prelude
+GG_BENCH_DEFINE(crc_12) {
+    bench_crc(bench, 12);
+}
+
+GG_BENCH_DEFINE(crc_1k) {
+    bench_crc(bench, 1024);
+}
+
+GG_BENCH_DEFINE(crc_64k) {
+    bench_crc(bench, sizeof(crc_input));
+}
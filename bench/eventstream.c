@@ -0,0 +1,127 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "bench.h"
+#include "corpus.h"
+#include <gg/arena.h>
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/eventstream/decode.h>
+#include <gg/eventstream/encode.h>
+#include <gg/eventstream/rpc.h>
+#include <gg/eventstream/types.h>
+#include <gg/io.h>
+#include <gg/ipc/limits.h>
+#include <gg/json_encode.h>
+#include <gg/map.h>
+#include <gg/object.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+static uint8_t packet_mem[GG_IPC_MAX_MSG_LEN];
+static uint8_t obj_mem[16384];
+
+// Headers of a PublishToTopic request
+static const EventStreamHeader PUBLISH_HEADERS[] = {
+    { GG_STR(":message-type"),
+      { EVENTSTREAM_INT32, .int32 = EVENTSTREAM_APPLICATION_MESSAGE } },
+    { GG_STR(":message-flags"), { EVENTSTREAM_INT32, .int32 = 0 } },
+    { GG_STR(":stream-id"), { EVENTSTREAM_INT32, .int32 = 42 } },
+    { GG_STR("operation"),
+      { EVENTSTREAM_STRING, .string = GG_STR("aws.greengrass#PublishToTopic") }
+    },
+    { GG_STR("service-model-type"),
+      { EVENTSTREAM_STRING,
+        .string = GG_STR("aws.greengrass#PublishToTopicRequest") } },
+};
+
+// Encodes a publish of a corpus document, as sent by the IPC client
+static GgBuffer encode(GgObject *request) {
+    GgBuffer packet = GG_BUF(packet_mem);
+    GgError ret = eventstream_encode(
+        &packet,
+        PUBLISH_HEADERS,
+        sizeof(PUBLISH_HEADERS) / sizeof(PUBLISH_HEADERS[0]),
+        gg_json_reader(request)
+    );
+    if (ret != GG_ERR_OK) {
+        abort();
+    }
+    return packet;
+}
+
+static GgObject publish_request(GgBenchJson doc, GgArena *arena) {
+    GgObject message = gg_bench_json_obj(doc, arena);
+    GgKV *request = GG_ARENA_ALLOCN(arena, GgKV, 2);
+    GgKV *publish = GG_ARENA_ALLOC(arena, GgKV);
+    GgKV *json_message = GG_ARENA_ALLOC(arena, GgKV);
+    if ((request == NULL) || (publish == NULL) || (json_message == NULL)) {
+        abort();
+    }
+    *json_message = gg_kv(GG_STR("message"), message);
+    *publish = gg_kv(
+        GG_STR("jsonMessage"),
+        gg_obj_map((GgMap) { .pairs = json_message, .len = 1 })
+    );
+    request[0] = gg_kv(GG_STR("topic"), gg_obj_buf(GG_STR("factory/line-3")));
+    request[1] = gg_kv(
+        GG_STR("publishMessage"),
+        gg_obj_map((GgMap) { .pairs = publish, .len = 1 })
+    );
+    return gg_obj_map((GgMap) { .pairs = request, .len = 2 });
+}
+
+static void bench_encode(GgBench *bench, GgBenchJson doc) {
+    GgArena arena = gg_arena_init(GG_BUF(obj_mem));
+    GgObject request = publish_request(doc, &arena);
+    bench->bytes = encode(&request).len;
+    gg_bench_reset_timer(bench);
+
+    for (uint64_t i = 0; i < bench->iterations; i++) {
+        GgBuffer packet = encode(&request);
+        gg_bench_keep(packet.data);
+    }
+}
+
+// Decodes a frame and its common headers, as received by the IPC client
+static void bench_decode(GgBench *bench, GgBenchJson doc) {
+    GgArena arena = gg_arena_init(GG_BUF(obj_mem));
+    GgObject request = publish_request(doc, &arena);
+    GgBuffer packet = encode(&request);
+    GgBuffer prelude_buf = gg_buffer_substr(packet, 0, 12);
+    GgBuffer data_section = gg_buffer_substr(packet, 12, SIZE_MAX);
+    bench->bytes = packet.len;
+    gg_bench_reset_timer(bench);
+
+    for (uint64_t i = 0; i < bench->iterations; i++) {
+        EventStreamPrelude prelude;
+        EventStreamMessage msg;
+        EventStreamCommonHeaders common_headers;
+        if ((eventstream_decode_prelude(prelude_buf, &prelude) != GG_ERR_OK)
+            || (eventstream_decode(&prelude, data_section, &msg) != GG_ERR_OK)
+            || (eventstream_get_common_headers(&msg, &common_headers)
+                != GG_ERR_OK)) {
+            abort();
+        }
+        gg_bench_keep(&common_headers);
+        gg_bench_keep(msg.payload.data);
+    }
+}
+
+GG_BENCH_DEFINE(eventstream_encode_message) {
+    bench_encode(bench, GG_BENCH_JSON_MESSAGE);
+}
+
+GG_BENCH_DEFINE(eventstream_encode_config) {
+    bench_encode(bench, GG_BENCH_JSON_CONFIG);
+}
+
+GG_BENCH_DEFINE(eventstream_decode_message) {
+    bench_decode(bench, GG_BENCH_JSON_MESSAGE);
+}
+
+GG_BENCH_DEFINE(eventstream_decode_config) {
+    bench_decode(bench, GG_BENCH_JSON_CONFIG);
+}
@@ -0,0 +1,617 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "harness.h"
+#include <errno.h>
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/ipc/client.h>
+#include <gg/ipc/mock.h>
+#include <gg/log_config.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MAX_SIZES 8
+#define MAX_THREADS 16
+// Largest binary payload that fits in an IPC packet once base64 encoded
+#define MAX_PAYLOAD_LEN 7000U
+// Seconds the nucleus waits for the next client packet
+#define SERVE_TIMEOUT 30
+// Seconds to wait for subscription messages still in flight
+#define DELIVERY_TIMEOUT 10
+// Maximum arguments of the proxy command
+#define MAX_PROXY_ARGS 32
+// Subscribe payloads start with the publish time and the run number
+#define STAMP_LEN (sizeof(uint64_t) + sizeof(uint32_t))
+
+typedef struct {
+    uint32_t ops;
+    size_t sizes[MAX_SIZES];
+    size_t size_count;
+    uint32_t threads;
+    uint32_t subs;
+    /// Command run as a proxy between the client and the mock nucleus.
+    const char *proxy;
+} BenchOptions;
+
+/// A run of one workload, over one size or all of them.
+typedef struct {
+    const char *workload;
+    const size_t *sizes;
+    size_t size_count;
+} BenchRun;
+
+typedef struct {
+    const BenchRun *run;
+    GgError (*op)(const BenchRun *run, uint32_t i);
+    uint32_t first;
+    uint32_t count;
+    uint32_t errors;
+} BenchWorker;
+
+static const GgIpcBenchClient *bench_client;
+static BenchOptions bench_opts = { .ops = 10000,
+                                   .sizes = { 64, 1024, 4096 },
+                                   .size_count = 3,
+                                   .threads = 1,
+                                   .subs = 8 };
+
+static uint8_t payload_mem[MAX_PAYLOAD_LEN];
+static uint64_t *latencies;
+/// Failed ops of the current run.
+static uint32_t run_errors;
+
+static pthread_mutex_t delivery_mtx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t delivery_cond = PTHREAD_COND_INITIALIZER;
+/// Subscribe run accepting deliveries, or 0 if none is.
+static uint32_t delivery_run;
+static uint32_t delivered;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t) ts.tv_sec * 1000000000U) + (uint64_t) ts.tv_nsec;
+}
+
+static uint64_t cpu_ns(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return ((uint64_t) usage.ru_utime.tv_sec * 1000000000U)
+        + ((uint64_t) usage.ru_utime.tv_usec * 1000U)
+        + ((uint64_t) usage.ru_stime.tv_sec * 1000000000U)
+        + ((uint64_t) usage.ru_stime.tv_usec * 1000U);
+}
+
+static size_t op_size(const BenchRun *run, uint32_t i) {
+    return run->sizes[i % run->size_count];
+}
+
+static GgError publish_op(const BenchRun *run, uint32_t i) {
+    GgBuffer payload = { .data = payload_mem, .len = op_size(run, i) };
+    return bench_client->publish(GG_STR("bench/publish"), payload);
+}
+
+static GgError call_op(const BenchRun *run, uint32_t i) {
+    char key_mem[16];
+    size_t size = op_size(run, i);
+    int key_len = snprintf(key_mem, sizeof(key_mem), "%zu", size);
+    GgBuffer key = { .data = (uint8_t *) key_mem, .len = (size_t) key_len };
+    size_t value_len = 0;
+    GgError ret = bench_client->get_config(key, &value_len);
+    if ((ret == GG_ERR_OK) && (value_len != size)) {
+        fprintf(
+            stderr, "Config value has %zu bytes, not %zu.\n", value_len, size
+        );
+        return GG_ERR_FAILURE;
+    }
+    return ret;
+}
+
+static void *worker_thread(void *arg) {
+    BenchWorker *worker = arg;
+    for (uint32_t i = worker->first; i < worker->first + worker->count; i++) {
+        uint64_t start = now_ns();
+        GgError ret = worker->op(worker->run, i);
+        latencies[i] = now_ns() - start;
+        // Failures are counted, so faults injected by a proxy show in results
+        if (ret != GG_ERR_OK) {
+            worker->errors += 1;
+        }
+    }
+    return NULL;
+}
+
+// Splits the ops over the worker threads, which run them back to back
+static void run_workers(
+    const BenchRun *run, GgError (*op)(const BenchRun *run, uint32_t i)
+) {
+    BenchWorker workers[MAX_THREADS];
+    pthread_t threads[MAX_THREADS];
+    uint32_t per_thread = bench_opts.ops / bench_opts.threads;
+    for (uint32_t t = 0; t < bench_opts.threads; t++) {
+        workers[t] = (BenchWorker) {
+            .run = run,
+            .op = op,
+            .first = t * per_thread,
+            .count = (t + 1 == bench_opts.threads)
+                ? bench_opts.ops - (t * per_thread)
+                : per_thread,
+            .errors = 0,
+        };
+    }
+    if (bench_opts.threads == 1) {
+        (void) worker_thread(&workers[0]);
+        run_errors = workers[0].errors;
+        return;
+    }
+
+    for (uint32_t t = 0; t < bench_opts.threads; t++) {
+        int sys_ret
+            = pthread_create(&threads[t], NULL, worker_thread, &workers[t]);
+        if (sys_ret != 0) {
+            fprintf(stderr, "Failed to create thread: %d.\n", sys_ret);
+            _Exit(1);
+        }
+    }
+    for (uint32_t t = 0; t < bench_opts.threads; t++) {
+        pthread_join(threads[t], NULL);
+        run_errors += workers[t].errors;
+    }
+}
+
+void gg_ipc_bench_deliver(GgBuffer payload) {
+    uint64_t published;
+    uint32_t run;
+    if (payload.len < STAMP_LEN) {
+        return;
+    }
+    memcpy(&published, payload.data, sizeof(published));
+    memcpy(&run, &payload.data[sizeof(published)], sizeof(run));
+    uint64_t latency = now_ns() - published;
+
+    // Messages held up past an earlier run's timeout are not counted
+    pthread_mutex_lock(&delivery_mtx);
+    if ((run == delivery_run) && (delivered < bench_opts.ops)) {
+        latencies[delivered] = latency;
+        delivered += 1;
+        if (delivered == bench_opts.ops) {
+            pthread_cond_signal(&delivery_cond);
+        }
+    }
+    pthread_mutex_unlock(&delivery_mtx);
+}
+
+// Publishes to the subscribed topics in turn, timing each message from publish
+// to delivery. The publish time is carried in the payload.
+static GgError run_subscribe(const BenchRun *run) {
+    static bool subscribed = false;
+    static uint32_t run_count = 0;
+    char topic_mem[32];
+
+    if (!subscribed) {
+        for (uint32_t s = 0; s < bench_opts.subs; s++) {
+            int len
+                = snprintf(topic_mem, sizeof(topic_mem), "bench/sub/%u", s);
+            GgBuffer topic
+                = { .data = (uint8_t *) topic_mem, .len = (size_t) len };
+            GgError ret = bench_client->subscribe(topic);
+            if (ret != GG_ERR_OK) {
+                return ret;
+            }
+        }
+        subscribed = true;
+    }
+
+    run_count += 1;
+    pthread_mutex_lock(&delivery_mtx);
+    delivery_run = run_count;
+    delivered = 0;
+    pthread_mutex_unlock(&delivery_mtx);
+
+    for (uint32_t i = 0; i < bench_opts.ops; i++) {
+        int len = snprintf(
+            topic_mem, sizeof(topic_mem), "bench/sub/%u", i % bench_opts.subs
+        );
+        GgBuffer topic = { .data = (uint8_t *) topic_mem, .len = (size_t) len };
+        uint8_t message_mem[MAX_PAYLOAD_LEN];
+        GgBuffer payload = { .data = message_mem, .len = op_size(run, i) };
+        memcpy(message_mem, payload_mem, payload.len);
+        uint64_t published = now_ns();
+        memcpy(message_mem, &published, sizeof(published));
+        memcpy(&message_mem[sizeof(published)], &run_count, sizeof(run_count));
+
+        // A failed publish shows as a message not delivered
+        (void) bench_client->publish(topic, payload);
+    }
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += DELIVERY_TIMEOUT;
+    pthread_mutex_lock(&delivery_mtx);
+    while (delivered < bench_opts.ops) {
+        if (pthread_cond_timedwait(&delivery_cond, &delivery_mtx, &deadline)
+            == ETIMEDOUT) {
+            break;
+        }
+    }
+    // Later deliveries are ignored, so missing ones can be filled in and the
+    // latencies read without the lock
+    delivery_run = 0;
+    uint32_t count = delivered;
+    pthread_mutex_unlock(&delivery_mtx);
+
+    if (count < bench_opts.ops) {
+        run_errors = bench_opts.ops - count;
+        for (uint32_t i = count; i < bench_opts.ops; i++) {
+            latencies[i] = DELIVERY_TIMEOUT * 1000000000ULL;
+        }
+    }
+    return GG_ERR_OK;
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *) a;
+    uint64_t y = *(const uint64_t *) b;
+    return (x > y) - (x < y);
+}
+
+static double percentile_us(const uint64_t *sorted, uint32_t len, double p) {
+    uint32_t index = (uint32_t) (p * (double) len);
+    if (index >= len) {
+        index = len - 1;
+    }
+    return (double) sorted[index] / 1000.0;
+}
+
+static void print_result(
+    const BenchRun *run, uint64_t elapsed_ns, uint64_t cpu_used_ns
+) {
+    uint32_t ops = bench_opts.ops;
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < ops; i++) {
+        bytes += op_size(run, i);
+    }
+    qsort(latencies, ops, sizeof(latencies[0]), compare_u64);
+
+    char size_mem[16] = "mixed";
+    if (run->size_count == 1) {
+        snprintf(size_mem, sizeof(size_mem), "%zu", run->sizes[0]);
+    }
+    double seconds = (double) elapsed_ns / 1e9;
+    printf(
+        "%s,%s,%s,%" PRIu32 ",%" PRIu32 ",%.0f,%.2f,%.1f,%.1f,%.1f,%.1f,%.2f,"
+        "%" PRIu32 "\n",
+        bench_client->name,
+        run->workload,
+        size_mem,
+        (strcmp(run->workload, "subscribe") == 0) ? 1 : bench_opts.threads,
+        ops,
+        (double) ops / seconds,
+        (double) bytes / seconds / 1e6,
+        percentile_us(latencies, ops, 0.50),
+        percentile_us(latencies, ops, 0.90),
+        percentile_us(latencies, ops, 0.99),
+        (double) latencies[ops - 1] / 1000.0,
+        (double) cpu_used_ns / 1000.0 / (double) ops,
+        run_errors
+    );
+    fflush(stdout);
+}
+
+static GgError run_workload(const BenchRun *run) {
+    uint64_t cpu_start = cpu_ns();
+    uint64_t start = now_ns();
+    GgError ret = GG_ERR_OK;
+    run_errors = 0;
+    if (strcmp(run->workload, "publish") == 0) {
+        run_workers(run, publish_op);
+    } else if (strcmp(run->workload, "call") == 0) {
+        run_workers(run, call_op);
+    } else {
+        ret = run_subscribe(run);
+    }
+    uint64_t elapsed = now_ns() - start;
+    uint64_t cpu_used = cpu_ns() - cpu_start;
+    if (ret != GG_ERR_OK) {
+        fprintf(
+            stderr, "Workload %s failed: %s.\n", run->workload, gg_strerror(ret)
+        );
+        return ret;
+    }
+    print_result(run, elapsed, cpu_used);
+    return GG_ERR_OK;
+}
+
+static int run_client(const char *const *workloads, size_t workload_count) {
+    latencies = calloc(bench_opts.ops, sizeof(latencies[0]));
+    if (latencies == NULL) {
+        fprintf(stderr, "Failed to allocate latencies.\n");
+        return 1;
+    }
+    for (size_t i = 0; i < sizeof(payload_mem); i++) {
+        payload_mem[i] = (uint8_t) (i * 131U);
+    }
+
+    GgError ret = bench_client->connect();
+    if (ret != GG_ERR_OK) {
+        fprintf(stderr, "Failed to connect: %s.\n", gg_strerror(ret));
+        return 1;
+    }
+
+    printf("client,workload,size,threads,ops,ops_per_s,mb_per_s,p50_us,p90_us,"
+           "p99_us,max_us,cpu_us_per_op,errors\n");
+    fflush(stdout);
+    for (size_t w = 0; w < workload_count; w++) {
+        for (size_t s = 0; s < bench_opts.size_count; s++) {
+            BenchRun run = { .workload = workloads[w],
+                             .sizes = &bench_opts.sizes[s],
+                             .size_count = 1 };
+            if (run_workload(&run) != GG_ERR_OK) {
+                return 1;
+            }
+        }
+        if (bench_opts.size_count > 1) {
+            BenchRun run = { .workload = workloads[w],
+                             .sizes = bench_opts.sizes,
+                             .size_count = bench_opts.size_count };
+            if (run_workload(&run) != GG_ERR_OK) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static bool parse_u32(
+    const char *arg, uint32_t min, uint32_t max, uint32_t *out
+) {
+    char *end;
+    errno = 0;
+    unsigned long value = strtoul(arg, &end, 10);
+    if ((errno != 0) || (end == arg) || (*end != '\0') || (value < min)
+        || (value > max)) {
+        return false;
+    }
+    *out = (uint32_t) value;
+    return true;
+}
+
+static bool parse_sizes(const char *arg) {
+    char list[128];
+    size_t len = strlen(arg);
+    if (len >= sizeof(list)) {
+        return false;
+    }
+    memcpy(list, arg, len + 1);
+    bench_opts.size_count = 0;
+    char *save;
+    for (char *tok = strtok_r(list, ",", &save); tok != NULL;
+         tok = strtok_r(NULL, ",", &save)) {
+        uint32_t size;
+        if ((bench_opts.size_count == MAX_SIZES)
+            || !parse_u32(tok, STAMP_LEN, MAX_PAYLOAD_LEN, &size)) {
+            return false;
+        }
+        bench_opts.sizes[bench_opts.size_count] = size;
+        bench_opts.size_count += 1;
+    }
+    return bench_opts.size_count > 0;
+}
+
+static void usage(const char *name) {
+    fprintf(
+        stderr,
+        "Usage: %s [--ops N] [--sizes N,...] [--threads N] [--subs N] "
+        "[--proxy CMD] [publish|call|subscribe...]\n",
+        name
+    );
+}
+
+// Runs the proxy command with the mock nucleus as its upstream, and points the
+// client at the proxy once it is listening
+static pid_t start_proxy(void) {
+    static const char *const SOCKET_ENV
+        = "AWS_GG_NUCLEUS_DOMAIN_SOCKET_FILEPATH_FOR_COMPONENT";
+    static char upstream_path[108];
+    static char proxy_path[116];
+    static char command[512];
+    static char listen_flag[] = "--listen";
+    static char upstream_flag[] = "--upstream";
+    // NOLINTBEGIN(concurrency-mt-unsafe)
+    const char *upstream = getenv(SOCKET_ENV);
+    size_t command_len = strlen(bench_opts.proxy);
+    if ((upstream == NULL) || (strlen(upstream) >= sizeof(upstream_path))
+        || (command_len >= sizeof(command))) {
+        fprintf(stderr, "Proxy command or socket path too long.\n");
+        return -1;
+    }
+    memcpy(upstream_path, upstream, strlen(upstream) + 1);
+    (void) snprintf(proxy_path, sizeof(proxy_path), "%s.proxy", upstream_path);
+    memcpy(command, bench_opts.proxy, command_len + 1);
+
+    char *args[MAX_PROXY_ARGS + 5];
+    size_t arg_count = 0;
+    for (char *arg = strtok(command, " "); arg != NULL;
+         arg = strtok(NULL, " ")) {
+        if (arg_count == MAX_PROXY_ARGS) {
+            fprintf(stderr, "Too many proxy arguments.\n");
+            return -1;
+        }
+        args[arg_count] = arg;
+        arg_count += 1;
+    }
+    args[arg_count] = listen_flag;
+    args[arg_count + 1] = proxy_path;
+    args[arg_count + 2] = upstream_flag;
+    args[arg_count + 3] = upstream_path;
+    args[arg_count + 4] = NULL;
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        fprintf(stderr, "Failed to fork: %d.\n", errno);
+        return -1;
+    }
+    if (pid == 0) {
+        execvp(args[0], args);
+        fprintf(stderr, "Failed to run %s: %d.\n", args[0], errno);
+        _exit(127);
+    }
+
+    // Connecting to check would take the mock's only connection
+    struct stat st;
+    for (int i = 0; (i < 500) && (stat(proxy_path, &st) != 0); i++) {
+        int status;
+        if (waitpid(pid, &status, WNOHANG) == pid) {
+            fprintf(stderr, "Proxy exited before listening.\n");
+            return -1;
+        }
+        (void) usleep(10000);
+    }
+    // Allow for the proxy binding before it listens
+    (void) usleep(10000);
+    if ((stat(proxy_path, &st) != 0)
+        || (setenv(SOCKET_ENV, proxy_path, true) != 0)) {
+        fprintf(stderr, "Proxy did not start listening.\n");
+        (void) kill(pid, SIGKILL);
+        (void) waitpid(pid, NULL, 0);
+        return -1;
+    }
+    // NOLINTEND(concurrency-mt-unsafe)
+    return pid;
+}
+
+static void stop_proxy(pid_t pid) {
+    (void) kill(pid, SIGTERM);
+    while ((waitpid(pid, NULL, 0) == -1) && (errno == EINTR)) { }
+}
+
+int gg_ipc_bench_main(int argc, char **argv, const GgIpcBenchClient *client) {
+    static const char *const ALL_WORKLOADS[]
+        = { "publish", "call", "subscribe" };
+    const char *workloads[3];
+    size_t workload_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : "";
+        bool ok = true;
+        if (strcmp(arg, "--ops") == 0) {
+            ok = parse_u32(value, 1, 10000000, &bench_opts.ops);
+            i++;
+        } else if (strcmp(arg, "--sizes") == 0) {
+            ok = parse_sizes(value);
+            i++;
+        } else if (strcmp(arg, "--threads") == 0) {
+            ok = parse_u32(value, 1, MAX_THREADS, &bench_opts.threads);
+            i++;
+        } else if (strcmp(arg, "--proxy") == 0) {
+            bench_opts.proxy = value;
+            ok = value[0] != '\0';
+            i++;
+        } else if (strcmp(arg, "--subs") == 0) {
+            // One stream is needed for the publishes
+            ok = parse_u32(value, 1, GG_IPC_MAX_STREAMS - 1, &bench_opts.subs);
+            i++;
+        } else {
+            ok = false;
+            for (size_t w = 0; w < 3; w++) {
+                if ((strcmp(arg, ALL_WORKLOADS[w]) == 0)
+                    && (workload_count < 3)) {
+                    workloads[workload_count] = ALL_WORKLOADS[w];
+                    workload_count += 1;
+                    ok = true;
+                }
+            }
+        }
+        if (!ok) {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (workload_count == 0) {
+        memcpy(workloads, ALL_WORKLOADS, sizeof(workloads));
+        workload_count = 3;
+    }
+    // Calls in flight and subscriptions each hold a stream
+    if (bench_opts.threads + bench_opts.subs > GG_IPC_MAX_STREAMS) {
+        fprintf(
+            stderr,
+            "Threads and subscriptions must not exceed %d in total.\n",
+            GG_IPC_MAX_STREAMS
+        );
+        return 2;
+    }
+    if (bench_opts.threads > bench_opts.ops) {
+        bench_opts.threads = bench_opts.ops;
+    }
+    bench_client = client;
+
+    // Debug lines for each packet would dominate the timings
+    // NOLINTNEXTLINE(concurrency-mt-unsafe)
+    if (getenv("GG_LOG_LEVELS") == NULL) {
+        (void) gg_log_set_levels(GG_STR("warn"));
+    }
+
+    GgError ret = gg_test_setup_ipc("/tmp/gg-ipc-bench", 0700, "bench-token");
+    if (ret != GG_ERR_OK) {
+        return 1;
+    }
+    pid_t proxy_pid = 0;
+    if (bench_opts.proxy != NULL) {
+        proxy_pid = start_proxy();
+        if (proxy_pid < 0) {
+            gg_test_close();
+            return 1;
+        }
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        fprintf(stderr, "Failed to fork: %d.\n", errno);
+        if (proxy_pid > 0) {
+            stop_proxy(proxy_pid);
+        }
+        gg_test_close();
+        return 1;
+    }
+    if (pid == 0) {
+        exit(run_client(workloads, workload_count));
+    }
+
+    ret = gg_test_serve(SERVE_TIMEOUT);
+    if (ret != GG_ERR_OK) {
+        fprintf(stderr, "Mock nucleus failed: %s.\n", gg_strerror(ret));
+        (void) kill(pid, SIGKILL);
+    }
+
+    int status = 0;
+    while ((waitpid(pid, &status, 0) == -1) && (errno == EINTR)) { }
+    if (proxy_pid > 0) {
+        stop_proxy(proxy_pid);
+    }
+    gg_test_close();
+
+    if ((ret != GG_ERR_OK) || !WIFEXITED(status)) {
+        return 1;
+    }
+    // The client exits if its connection is lost, as a proxy may force
+    if (WEXITSTATUS(status) != 0) {
+        fprintf(stderr, "Client exited with status %d.\n", WEXITSTATUS(status));
+    }
+    return WEXITSTATUS(status);
+}
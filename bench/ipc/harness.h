@@ -0,0 +1,46 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef GG_IPC_BENCH_HARNESS_H
+#define GG_IPC_BENCH_HARNESS_H
+
+//! End-to-end IPC benchmark against the mock nucleus, shared by the clients
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+#include <gg/error.hpp>
+#include <gg/types.hpp>
+extern "C" {
+#else
+#include <gg/buffer.h>
+#include <gg/error.h>
+#endif
+
+/// Client operations driven by the harness. Each returns once the nucleus has
+/// responded, and may be called from several threads at once.
+typedef struct {
+    /// Name of the client in results.
+    const char *name;
+    GgError (*connect)(void);
+    GgError (*publish)(GgBuffer topic, GgBuffer payload);
+    /// Gets a string config value, with `key` as the final key of the path.
+    GgError (*get_config)(GgBuffer key, size_t *value_len);
+    /// Subscribes to a topic, passing messages to gg_ipc_bench_deliver().
+    GgError (*subscribe)(GgBuffer topic);
+} GgIpcBenchClient;
+
+/// Records delivery of a message published by the subscribe workload.
+void gg_ipc_bench_deliver(GgBuffer payload);
+
+/// Runs the workloads selected by the arguments and prints results as CSV.
+/// The client runs in a forked process, with the mock nucleus serving it from
+/// this one. Returns the process exit status.
+int gg_ipc_bench_main(int argc, char **argv, const GgIpcBenchClient *client);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,58 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "harness.h"
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/ipc/client.h>
+#include <gg/ipc/limits.h>
+#include <gg/object.h>
+#include <gg/sdk.h>
+#include <stddef.h>
+#include <stdint.h>
+
+static GgError client_connect(void) {
+    gg_sdk_init();
+    return ggipc_connect();
+}
+
+static GgError publish(GgBuffer topic, GgBuffer payload) {
+    return ggipc_publish_to_topic_binary(topic, payload);
+}
+
+static GgError get_config(GgBuffer key, size_t *value_len) {
+    static _Thread_local uint8_t value_mem[GG_IPC_MAX_MSG_LEN];
+    GgBuffer value = GG_BUF(value_mem);
+    GgError ret = ggipc_get_config_str(
+        GG_BUF_LIST(GG_STR("bench"), key), NULL, &value
+    );
+    *value_len = value.len;
+    return ret;
+}
+
+static void on_message(
+    void *ctx, GgBuffer topic, GgObject payload, GgIpcSubscriptionHandle handle
+) {
+    (void) ctx;
+    (void) topic;
+    (void) handle;
+    if (gg_obj_type(payload) == GG_TYPE_BUF) {
+        gg_ipc_bench_deliver(gg_obj_into_buf(payload));
+    }
+}
+
+static GgError subscribe(GgBuffer topic) {
+    return ggipc_subscribe_to_topic(topic, on_message, NULL, NULL);
+}
+
+int main(int argc, char **argv) {
+    static const GgIpcBenchClient CLIENT = {
+        .name = "c",
+        .connect = client_connect,
+        .publish = publish,
+        .get_config = get_config,
+        .subscribe = subscribe,
+    };
+    return gg_ipc_bench_main(argc, argv, &CLIENT);
+}
@@ -0,0 +1,98 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "bench.h"
+#include "corpus.h"
+#include <gg/arena.h>
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/io.h>
+#include <gg/json_decode.h>
+#include <gg/json_encode.h>
+#include <gg/object.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+static uint8_t json_mem[128U * 1024U];
+static uint8_t obj_mem[1024U * 1024U];
+
+static void bench_decode(GgBench *bench, GgBenchJson doc) {
+    GgBuffer json = gg_bench_json(doc);
+    bench->bytes = json.len;
+    gg_bench_reset_timer(bench);
+
+    // Decoding is destructive, so the copy of the input is part of each op
+    for (uint64_t i = 0; i < bench->iterations; i++) {
+        memcpy(json_mem, json.data, json.len);
+        GgArena arena = gg_arena_init(GG_BUF(obj_mem));
+        GgObject obj;
+        GgError ret = gg_json_decode_destructive_with_limits(
+            (GgBuffer) { .data = json_mem, .len = json.len },
+            &arena,
+            &obj,
+            GG_BENCH_CORPUS_LIMITS
+        );
+        if (ret != GG_ERR_OK) {
+            abort();
+        }
+        gg_bench_keep(&obj);
+    }
+}
+
+// Encodes as for IPC requests, through the JSON reader
+static size_t encode(GgBenchJson doc, GgObject obj) {
+    GgBuffer out = GG_BUF(json_mem);
+    if (doc == GG_BENCH_JSON_TELEMETRY) {
+        // Too large for the default limits used by the reader
+        GgBuffer rest = out;
+        GgError ret = gg_json_encode_with_limits(
+            obj, gg_buf_writer(&rest), GG_BENCH_CORPUS_LIMITS
+        );
+        if (ret != GG_ERR_OK) {
+            abort();
+        }
+        return out.len - rest.len;
+    }
+    if (gg_reader_call(gg_json_reader(&obj), &out) != GG_ERR_OK) {
+        abort();
+    }
+    return out.len;
+}
+
+static void bench_encode(GgBench *bench, GgBenchJson doc) {
+    GgArena arena = gg_arena_init(GG_BUF(obj_mem));
+    GgObject obj = gg_bench_json_obj(doc, &arena);
+    bench->bytes = encode(doc, obj);
+    gg_bench_reset_timer(bench);
+
+    for (uint64_t i = 0; i < bench->iterations; i++) {
+        gg_bench_keep((void *) (uintptr_t) encode(doc, obj));
+    }
+}
+
+GG_BENCH_DEFINE(json_decode_message) {
+    bench_decode(bench, GG_BENCH_JSON_MESSAGE);
+}
+
+GG_BENCH_DEFINE(json_decode_config) {
+    bench_decode(bench, GG_BENCH_JSON_CONFIG);
+}
+
+GG_BENCH_DEFINE(json_decode_telemetry) {
+    bench_decode(bench, GG_BENCH_JSON_TELEMETRY);
+}
+
+GG_BENCH_DEFINE(json_encode_message) {
+    bench_encode(bench, GG_BENCH_JSON_MESSAGE);
+}
+
+GG_BENCH_DEFINE(json_encode_config) {
+    bench_encode(bench, GG_BENCH_JSON_CONFIG);
+}
+
+GG_BENCH_DEFINE(json_encode_telemetry) {
+    bench_encode(bench, GG_BENCH_JSON_TELEMETRY);
+}
@@ -0,0 +1,124 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+// Object layout benchmarks. Build with and without GG_OBJECT_ALIGNED to
+// compare the packed and aligned layouts, each against GgMapSoa.
+
+#include "bench.h"
+#include <gg/arena.h>
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/map.h>
+#include <gg/map_soa.h>
+#include <gg/object.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define LAYOUT_MAX_KEYS 1000
+#define LAYOUT_LOOKUPS 64
+
+static uint8_t soa_mem[LAYOUT_MAX_KEYS * 32];
+
+// Map of `len` keys with lengths from 4 to 19 bytes, as in configurations
+static GgMap layout_map(size_t len) {
+    static uint8_t key_mem[LAYOUT_MAX_KEYS][20];
+    static GgKV pairs[LAYOUT_MAX_KEYS];
+    for (size_t i = 0; i < len; i++) {
+        size_t key_len = 4 + ((i * 7) % 16);
+        memset(key_mem[i], 'k', key_len);
+        key_mem[i][0] = (uint8_t) ('0' + (i / 100) % 10);
+        key_mem[i][1] = (uint8_t) ('0' + (i / 10) % 10);
+        key_mem[i][2] = (uint8_t) ('0' + i % 10);
+        pairs[i] = gg_kv(
+            (GgBuffer) { .data = key_mem[i], .len = key_len },
+            gg_obj_i64((int64_t) i)
+        );
+    }
+    return (GgMap) { .pairs = pairs, .len = len };
+}
+
+static GgMapSoa layout_map_soa(GgMap map) {
+    GgArena arena = gg_arena_init(GG_BUF(soa_mem));
+    GgMapSoa soa;
+    if (gg_map_soa_from_map(map, &arena, &soa) != GG_ERR_OK) {
+        abort();
+    }
+    return soa;
+}
+
+// Looks up LAYOUT_LOOKUPS keys in a fixed pseudorandom order
+static void bench_layout_get(GgBench *bench, size_t len, bool soa) {
+    GgMap map = layout_map(len);
+    GgMapSoa soa_map = layout_map_soa(map);
+    GgBuffer keys[LAYOUT_LOOKUPS];
+    uint32_t state = 1;
+    for (size_t i = 0; i < LAYOUT_LOOKUPS; i++) {
+        state = (state * 1103515245U) + 12345U;
+        keys[i] = gg_kv_key(map.pairs[(state >> 16) % len]);
+    }
+    gg_bench_reset_timer(bench);
+
+    for (uint64_t i = 0; i < bench->iterations; i++) {
+        for (size_t j = 0; j < LAYOUT_LOOKUPS; j++) {
+            GgObject *val;
+            bool found = soa ? gg_map_soa_get(soa_map, keys[j], &val)
+                             : gg_map_get(map, keys[j], &val);
+            if (!found) {
+                abort();
+            }
+            gg_bench_keep(val);
+        }
+    }
+}
+
+// Sums every value, touching values but not keys
+static void bench_layout_sum(GgBench *bench, size_t len, bool soa) {
+    GgMap map = layout_map(len);
+    GgMapSoa soa_map = layout_map_soa(map);
+    gg_bench_reset_timer(bench);
+
+    for (uint64_t i = 0; i < bench->iterations; i++) {
+        int64_t sum = 0;
+        for (size_t j = 0; j < len; j++) {
+            GgObject *val = soa ? &soa_map.values[j] : gg_kv_val(&map.pairs[j]);
+            sum += gg_obj_into_i64(*val);
+        }
+        gg_bench_keep(&sum);
+    }
+}
+
+GG_BENCH_DEFINE(layout_map_get_10) {
+    bench_layout_get(bench, 10, false);
+}
+
+GG_BENCH_DEFINE(layout_map_get_100) {
+    bench_layout_get(bench, 100, false);
+}
+
+GG_BENCH_DEFINE(layout_map_get_1000) {
+    bench_layout_get(bench, 1000, false);
+}
+
+GG_BENCH_DEFINE(layout_map_soa_get_10) {
+    bench_layout_get(bench, 10, true);
+}
+
+GG_BENCH_DEFINE(layout_map_soa_get_100) {
+    bench_layout_get(bench, 100, true);
+}
+
+GG_BENCH_DEFINE(layout_map_soa_get_1000) {
+    bench_layout_get(bench, 1000, true);
+}
+
+GG_BENCH_DEFINE(layout_map_sum_1000) {
+    bench_layout_sum(bench, 1000, false);
+}
+
+GG_BENCH_DEFINE(layout_map_soa_sum_1000) {
+    bench_layout_sum(bench, 1000, true);
+}
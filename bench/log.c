@@ -0,0 +1,32 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "bench.h"
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/log.h>
+#include <gg/log_config.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Same loop as log_disabled, with the line compiled out
+GG_BENCH_DEFINE(log_compiled_out) {
+    for (uint64_t i = 0; i < bench->iterations; i++) {
+        gg_log_disabled("Iteration %" PRIu64 ".", i);
+        gg_bench_keep(bench);
+    }
+}
+
+GG_BENCH_DEFINE(log_disabled) {
+    if (gg_log_set_levels(GG_STR("gg-bench=info")) != GG_ERR_OK) {
+        abort();
+    }
+    gg_bench_reset_timer(bench);
+
+    for (uint64_t i = 0; i < bench->iterations; i++) {
+        GG_LOGD("Iteration %" PRIu64 ".", i);
+        gg_bench_keep(bench);
+    }
+}
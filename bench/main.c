@@ -0,0 +1,106 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "bench.h"
+#include <inttypes.h>
+#include <string.h>
+#include <time.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Each sample runs for about this long
+#define BENCH_SAMPLE_NS (100000000U)
+#define BENCH_SAMPLES 5
+
+static GgBenchListNode *bench_list_head = NULL;
+static GgBenchListNode **bench_list_tail = &bench_list_head;
+
+void gg_bench_register(GgBenchListNode *entry) {
+    *bench_list_tail = entry;
+    bench_list_tail = &entry->next;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t) ts.tv_sec * 1000000000U) + (uint64_t) ts.tv_nsec;
+}
+
+void gg_bench_reset_timer(GgBench *bench) {
+    bench->start_ns = now_ns();
+}
+
+static uint64_t run_once(
+    GgBenchFunction func, uint64_t iterations, size_t bytes[static 1]
+) {
+    GgBench bench = { .iterations = iterations };
+    gg_bench_reset_timer(&bench);
+    func(&bench);
+    uint64_t elapsed = now_ns() - bench.start_ns;
+    *bytes = bench.bytes;
+    return (elapsed > 0) ? elapsed : 1;
+}
+
+static void run_bench(const GgBenchListNode *node) {
+    size_t bytes = 0;
+
+    // Scale up iterations until a sample takes long enough to time
+    uint64_t iterations = 1;
+    uint64_t elapsed = run_once(node->func, iterations, &bytes);
+    while (elapsed < (BENCH_SAMPLE_NS / 10)) {
+        iterations *= (elapsed < (BENCH_SAMPLE_NS / 1000)) ? 100 : 10;
+        elapsed = run_once(node->func, iterations, &bytes);
+    }
+    iterations = (uint64_t) ((double) iterations * BENCH_SAMPLE_NS
+                             / (double) elapsed);
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    // Report the fastest sample, which is least disturbed by noise
+    double best_ns = 0;
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+        double ns = (double) run_once(node->func, iterations, &bytes)
+            / (double) iterations;
+        if ((i == 0) || (ns < best_ns)) {
+            best_ns = ns;
+        }
+    }
+
+    double mb_per_s = (double) bytes * 1000.0 / best_ns;
+    printf(
+        "%s,%" PRIu64 ",%.1f,%.1f\n",
+        node->func_name,
+        iterations,
+        best_ns,
+        mb_per_s
+    );
+    fflush(stdout);
+}
+
+static bool selected(const char *name, int argc, char **argv) {
+    if (argc <= 1) {
+        return true;
+    }
+    for (int i = 1; i < argc; i++) {
+        if (strstr(name, argv[i]) != NULL) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Runs benchmarks whose names contain any of the arguments, or all if none
+/// are given, and prints results as CSV.
+int main(int argc, char **argv) {
+    printf("benchmark,iterations,ns_per_op,mb_per_s\n");
+    for (GgBenchListNode *node = bench_list_head; node != NULL;
+         node = node->next) {
+        if (selected(node->func_name, argc, argv)) {
+            run_bench(node);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,275 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "bench.h"
+#include "corpus.h"
+#include <gg/arena.h>
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/flags.h>
+#include <gg/map.h>
+#include <gg/object.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static uint8_t corpus_mem[1024U * 1024U];
+static uint8_t claim_mem[1024U * 1024U];
+
+static GgMap config_map(GgArena *arena) {
+    return gg_obj_into_map(gg_bench_json_obj(GG_BENCH_JSON_CONFIG, arena));
+}
+
+// Looks up every key of the config's top-level map, and one missing key
+GG_BENCH_DEFINE(map_get_config) {
+    GgArena arena = gg_arena_init(GG_BUF(corpus_mem));
+    GgMap map = config_map(&arena);
+    gg_bench_reset_timer(bench);
+
+    for (uint64_t i = 0; i < bench->iterations; i++) {
+        for (size_t j = 0; j < map.len; j++) {
+            GgObject *val;
+            if (!gg_map_get(map, gg_kv_key(map.pairs[j]), &val)) {
+                abort();
+            }
+            gg_bench_keep(val);
+        }
+        if (gg_map_get(map, GG_STR("missingKey"), NULL)) {
+            abort();
+        }
+    }
+}
+
+#define CONFIG_SCHEMA(values) \
+    GG_MAP_SCHEMA( \
+        { GG_STR("componentName"), GG_REQUIRED, GG_TYPE_BUF, &(values)[0] }, \
+        { GG_STR("version"), GG_REQUIRED, GG_TYPE_BUF, &(values)[1] }, \
+        { GG_STR("logging"), GG_OPTIONAL, GG_TYPE_MAP, &(values)[2] }, \
+        { GG_STR("mqtt"), GG_OPTIONAL, GG_TYPE_MAP, &(values)[3] }, \
+        { GG_STR("sensors"), GG_REQUIRED, GG_TYPE_LIST, &(values)[4] }, \
+        { GG_STR("thresholds"), GG_OPTIONAL, GG_TYPE_MAP, &(values)[5] }, \
+        { GG_STR("upload"), GG_OPTIONAL, GG_TYPE_MAP, &(values)[6] }, \
+        { GG_STR("debug"), GG_OPTIONAL, GG_TYPE_BOOLEAN, &(values)[7] }, \
+    )
+
+GG_BENCH_DEFINE(map_validate_config) {
+    GgArena arena = gg_arena_init(GG_BUF(corpus_mem));
+    GgMap map = config_map(&arena);
+    gg_bench_reset_timer(bench);
+
+    for (uint64_t i = 0; i < bench->iterations; i++) {
+        GgObject *values[8];
+        if (gg_map_validate(map, CONFIG_SCHEMA(values)) != GG_ERR_OK) {
+            abort();
+        }
+        gg_bench_keep(values);
+    }
+}
+
+GG_BENCH_DEFINE(sorted_map_validate_config) {
+    GgArena arena = gg_arena_init(GG_BUF(corpus_mem));
+    GgMap map = config_map(&arena);
+    gg_map_canonicalize_shallow(&map);
+    GgSortedMap sorted;
+    if (gg_sorted_map(map, &sorted) != GG_ERR_OK) {
+        abort();
+    }
+    gg_bench_reset_timer(bench);
+
+    for (uint64_t i = 0; i < bench->iterations; i++) {
+        GgObject *values[8];
+        if (gg_sorted_map_validate(sorted, CONFIG_SCHEMA(values))
+            != GG_ERR_OK) {
+            abort();
+        }
+        gg_bench_keep(values);
+    }
+}
+
+// Canonical map of `len` keys, for comparing lookups as the map grows
+static GgMap sized_map(size_t len) {
+    static char key_mem[1000][8];
+    static GgKV pairs[1000];
+    for (size_t i = 0; i < len; i++) {
+        int key_len = snprintf(key_mem[i], sizeof(key_mem[i]), "key%04zu", i);
+        GgBuffer key = { .data = (uint8_t *) key_mem[i],
+                         .len = (size_t) key_len };
+        pairs[i] = gg_kv(key, gg_obj_i64((int64_t) i));
+    }
+    return (GgMap) { .pairs = pairs, .len = len };
+}
+
+#define SIZED_LOOKUPS 10
+
+// Looks up SIZED_LOOKUPS keys spread evenly over the map
+static void bench_sized_get(GgBench *bench, size_t len, bool sorted) {
+    GgMap map = sized_map(len);
+    GgSortedMap sorted_map;
+    if (gg_sorted_map(map, &sorted_map) != GG_ERR_OK) {
+        abort();
+    }
+    GgBuffer keys[SIZED_LOOKUPS];
+    for (size_t i = 0; i < SIZED_LOOKUPS; i++) {
+        keys[i] = gg_kv_key(map.pairs[(i * len) / SIZED_LOOKUPS]);
+    }
+    gg_bench_reset_timer(bench);
+
+    for (uint64_t i = 0; i < bench->iterations; i++) {
+        for (size_t j = 0; j < SIZED_LOOKUPS; j++) {
+            GgObject *val;
+            bool found = sorted ? gg_sorted_map_get(sorted_map, keys[j], &val)
+                                : gg_map_get(map, keys[j], &val);
+            if (!found) {
+                abort();
+            }
+            gg_bench_keep(val);
+        }
+    }
+}
+
+// Validates a schema of SIZED_LOOKUPS keys spread evenly over the map
+static void bench_sized_validate(GgBench *bench, size_t len, bool sorted) {
+    GgMap map = sized_map(len);
+    GgSortedMap sorted_map;
+    if (gg_sorted_map(map, &sorted_map) != GG_ERR_OK) {
+        abort();
+    }
+    GgObject *values[SIZED_LOOKUPS];
+    GgMapSchemaEntry entries[SIZED_LOOKUPS];
+    for (size_t i = 0; i < SIZED_LOOKUPS; i++) {
+        entries[i] = (GgMapSchemaEntry) {
+            .key = gg_kv_key(map.pairs[(i * len) / SIZED_LOOKUPS]),
+            .required = GG_REQUIRED,
+            .type = GG_TYPE_I64,
+            .value = &values[i],
+        };
+    }
+    GgMapSchema schema = { .entries = entries, .entry_count = SIZED_LOOKUPS };
+    gg_bench_reset_timer(bench);
+
+    for (uint64_t i = 0; i < bench->iterations; i++) {
+        GgError ret = sorted ? gg_sorted_map_validate(sorted_map, schema)
+                             : gg_map_validate(map, schema);
+        if (ret != GG_ERR_OK) {
+            abort();
+        }
+        gg_bench_keep(values);
+    }
+}
+
+GG_BENCH_DEFINE(map_get_10) {
+    bench_sized_get(bench, 10, false);
+}
+
+GG_BENCH_DEFINE(map_get_100) {
+    bench_sized_get(bench, 100, false);
+}
+
+GG_BENCH_DEFINE(map_get_1000) {
+    bench_sized_get(bench, 1000, false);
+}
+
+GG_BENCH_DEFINE(sorted_map_get_10) {
+    bench_sized_get(bench, 10, true);
+}
+
+GG_BENCH_DEFINE(sorted_map_get_100) {
+    bench_sized_get(bench, 100, true);
+}
+
+GG_BENCH_DEFINE(sorted_map_get_1000) {
+    bench_sized_get(bench, 1000, true);
+}
+
+GG_BENCH_DEFINE(map_validate_10) {
+    bench_sized_validate(bench, 10, false);
+}
+
+GG_BENCH_DEFINE(map_validate_100) {
+    bench_sized_validate(bench, 100, false);
+}
+
+GG_BENCH_DEFINE(map_validate_1000) {
+    bench_sized_validate(bench, 1000, false);
+}
+
+GG_BENCH_DEFINE(sorted_map_validate_10) {
+    bench_sized_validate(bench, 10, true);
+}
+
+GG_BENCH_DEFINE(sorted_map_validate_100) {
+    bench_sized_validate(bench, 100, true);
+}
+
+GG_BENCH_DEFINE(sorted_map_validate_1000) {
+    bench_sized_validate(bench, 1000, true);
+}
+
+// Canonicalizes a map with shuffled keys, copied in each op
+static void bench_canonicalize(GgBench *bench, size_t len) {
+    static char key_mem[1024][16];
+    static GgKV unsorted[1024];
+    static GgKV pairs[1024];
+    // Multiplying by a number coprime to len shuffles the keys
+    for (size_t i = 0; i < len; i++) {
+        int key_len = snprintf(
+            key_mem[i], sizeof(key_mem[i]), "setting%04zu", (i * 37) % len
+        );
+        GgBuffer key = { .data = (uint8_t *) key_mem[i],
+                         .len = (size_t) key_len };
+        unsorted[i] = gg_kv(key, gg_obj_i64((int64_t) i));
+    }
+    gg_bench_reset_timer(bench);
+
+    for (uint64_t i = 0; i < bench->iterations; i++) {
+        memcpy(pairs, unsorted, len * sizeof(GgKV));
+        GgMap map = { .pairs = pairs, .len = len };
+        gg_map_canonicalize_shallow(&map);
+        gg_bench_keep(pairs);
+    }
+}
+
+GG_BENCH_DEFINE(map_canonicalize_8) {
+    bench_canonicalize(bench, 8);
+}
+
+GG_BENCH_DEFINE(map_canonicalize_64) {
+    bench_canonicalize(bench, 64);
+}
+
+// Long enough that runs are merged by rotation
+GG_BENCH_DEFINE(map_canonicalize_1024) {
+    bench_canonicalize(bench, 1024);
+}
+
+// Claims a decoded document into an empty arena, copying all of it
+static void bench_claim(GgBench *bench, GgBenchJson doc) {
+    GgArena arena = gg_arena_init(GG_BUF(corpus_mem));
+    GgObject src = gg_bench_json_obj(doc, &arena);
+    gg_bench_reset_timer(bench);
+
+    for (uint64_t i = 0; i < bench->iterations; i++) {
+        GgArena claim_arena = gg_arena_init(GG_BUF(claim_mem));
+        GgObject obj = src;
+        GgError ret = gg_arena_claim_obj_with_limits(
+            &obj, &claim_arena, GG_BENCH_CORPUS_LIMITS
+        );
+        if (ret != GG_ERR_OK) {
+            abort();
+        }
+        bench->bytes = claim_arena.index;
+        gg_bench_keep(&obj);
+    }
+}
+
+GG_BENCH_DEFINE(arena_claim_obj_config) {
+    bench_claim(bench, GG_BENCH_JSON_CONFIG);
+}
+
+GG_BENCH_DEFINE(arena_claim_obj_telemetry) {
+    bench_claim(bench, GG_BENCH_JSON_TELEMETRY);
+}
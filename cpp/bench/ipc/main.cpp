@@ -0,0 +1,74 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "harness.h"
+#include <gg/buffer.hpp>
+#include <gg/ipc/client.hpp>
+#include <gg/object.hpp>
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace {
+GgError to_error(std::error_code error) noexcept {
+    return static_cast<GgError>(error.value());
+}
+
+class BenchCallback : public gg::ipc::LocalTopicCallback {
+    void operator()(
+        std::string_view topic,
+        gg::Object payload,
+        gg::ipc::Subscription &handle
+    ) override {
+        (void) topic;
+        (void) handle;
+        if (auto bytes = gg::get_if<gg::Buffer>(&payload)) {
+            gg_ipc_bench_deliver(*bytes);
+        }
+    }
+};
+
+BenchCallback callback;
+
+GgError client_connect() {
+    return to_error(gg::ipc::Client::get().connect());
+}
+
+GgError publish(GgBuffer topic, GgBuffer payload) {
+    return to_error(gg::ipc::Client::get().publish_to_topic(
+        std::string_view { reinterpret_cast<char *>(topic.data), topic.len },
+        gg::Buffer { payload }
+    ));
+}
+
+GgError get_config(GgBuffer key, size_t *value_len) {
+    std::array key_path = { gg::Buffer { "bench" }, gg::Buffer { key } };
+    std::string value;
+    auto error
+        = gg::ipc::Client::get().get_config(key_path, std::nullopt, value);
+    *value_len = value.size();
+    return to_error(error);
+}
+
+GgError subscribe(GgBuffer topic) {
+    return to_error(gg::ipc::Client::get().subscribe_to_topic(
+        std::string_view { reinterpret_cast<char *>(topic.data), topic.len },
+        callback
+    ));
+}
+}
+
+int main(int argc, char **argv) {
+    static const GgIpcBenchClient CLIENT = {
+        .name = "cpp",
+        .connect = client_connect,
+        .publish = publish,
+        .get_config = get_config,
+        .subscribe = subscribe,
+    };
+    return gg_ipc_bench_main(argc, argv, &CLIENT);
+}
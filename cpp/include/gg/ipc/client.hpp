@@ -66,6 +66,15 @@ public:
     static std::optional<AuthToken> from_environment() noexcept;
 };
 
+/// Snapshot of IPC client metrics. See `<gg/ipc/stats.h>` for field details.
+class Stats : public GgIpcStats {
+public:
+    /// Per-operation metrics, in order of first call.
+    std::span<const GgIpcOpStats> operations() const noexcept {
+        return { ops, op_count };
+    }
+};
+
 class LocalTopicCallback {
 public:
     virtual ~LocalTopicCallback() noexcept = default;
@@ -108,6 +117,16 @@ public:
         std::string_view socket_path, AuthToken auth_token
     ) noexcept;
 
+    /// Get a snapshot of the IPC client metrics.
+    Stats get_stats() noexcept;
+
+    /// Get the peak usage of the IPC client's fixed buffers.
+    /// See `<gg/ipc/stats.h>` for field details.
+    GgIpcMemoryUsage get_memory_usage() noexcept;
+
+    /// Reset the peak usage of the IPC client's fixed buffers.
+    void reset_memory_peaks() noexcept;
+
     std::error_code publish_to_topic(
         std::string_view topic, Buffer bytes
     ) noexcept;
@@ -6,12 +6,18 @@
 #define GG_TYPES_HPP
 
 #include <gg/error.hpp>
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 extern "C" {
 typedef struct {
+#ifdef GG_OBJECT_ALIGNED
+    alignas(16) uint8_t _private[16];
+#else
     uint8_t _private[(sizeof(void *) == 4) ? 9 : 11];
+#endif
 } GgObject;
 
 typedef struct {
@@ -30,7 +36,11 @@ typedef struct {
 } GgList;
 
 typedef struct {
+#ifdef GG_OBJECT_ALIGNED
+    alignas(16) uint8_t _private[2 * sizeof(GgObject)];
+#else
     uint8_t _private[sizeof(void *) + 2 + sizeof(GgObject)];
+#endif
 } GgKV;
 
 typedef struct {
@@ -60,6 +70,48 @@ typedef struct {
     uint32_t val;
 } GgIpcSubscriptionHandle;
 
+#define GG_IPC_LATENCY_BUCKETS 24
+#define GG_IPC_STATS_MAX_OPS 16
+#define GG_IPC_STATS_OP_NAME_MAX 64
+
+typedef struct {
+    char operation[GG_IPC_STATS_OP_NAME_MAX];
+    uint64_t calls;
+    uint64_t errors;
+    uint64_t timeouts;
+    uint64_t latency_ns_total;
+    uint64_t latency_hist[GG_IPC_LATENCY_BUCKETS];
+} GgIpcOpStats;
+
+typedef struct {
+    uint64_t calls;
+    uint64_t errors;
+    uint64_t timeouts;
+    uint64_t frames_sent;
+    uint64_t bytes_sent;
+    uint64_t frames_received;
+    uint64_t bytes_received;
+    uint64_t payloads_decoded;
+    uint64_t decode_ns_total;
+    uint64_t decode_failures;
+    uint64_t sub_messages;
+    uint64_t sub_dropped_too_large;
+    uint64_t unhandled_dropped;
+    size_t op_count;
+    GgIpcOpStats ops[GG_IPC_STATS_MAX_OPS];
+} GgIpcStats;
+
+typedef struct {
+    size_t peak;
+    size_t capacity;
+} GgIpcBufferUsage;
+
+typedef struct {
+    GgIpcBufferUsage send_buf;
+    GgIpcBufferUsage recv_buf;
+    GgIpcBufferUsage decode_mem;
+} GgIpcMemoryUsage;
+
 // NOLINTNEXTLINE(performance-enum-size)
 enum class GgComponentState {
     RUNNING,
@@ -70,20 +122,70 @@ namespace gg {
     using ComponentState = GgComponentState;
 }
 
+// Accessors are defined inline to match the C headers; the library also
+// exports them.
+
 [[gnu::const]]
-GgObjectType gg_obj_type(GgObject) noexcept;
+inline GgObjectType gg_obj_type(GgObject obj) noexcept {
+    // Last byte is tag
+    uint8_t result = obj._private[sizeof(obj._private) - 1];
+    assert(result <= 6);
+    return static_cast<GgObjectType>(result);
+}
+
 [[gnu::const]]
-bool gg_obj_into_bool(GgObject) noexcept;
+inline bool gg_obj_into_bool(GgObject boolean) noexcept {
+    assert(gg_obj_type(boolean) == GG_TYPE_BOOLEAN);
+    bool result;
+    std::memcpy(&result, boolean._private, sizeof(result));
+    return result;
+}
+
 [[gnu::const]]
-int64_t gg_obj_into_i64(GgObject) noexcept;
+inline int64_t gg_obj_into_i64(GgObject i64) noexcept {
+    assert(gg_obj_type(i64) == GG_TYPE_I64);
+    int64_t result;
+    std::memcpy(&result, i64._private, sizeof(result));
+    return result;
+}
+
 [[gnu::const]]
-double gg_obj_into_f64(GgObject) noexcept;
+inline double gg_obj_into_f64(GgObject f64) noexcept {
+    assert(gg_obj_type(f64) == GG_TYPE_F64);
+    double result;
+    std::memcpy(&result, f64._private, sizeof(result));
+    return result;
+}
+
 [[gnu::const]]
-GgBuffer gg_obj_into_buf(GgObject) noexcept;
+inline GgBuffer gg_obj_into_buf(GgObject buf) noexcept {
+    assert(gg_obj_type(buf) == GG_TYPE_BUF);
+    uint8_t *ptr;
+    uint16_t len;
+    std::memcpy(&ptr, buf._private, sizeof(void *));
+    std::memcpy(&len, &buf._private[sizeof(void *)], 2);
+    return GgBuffer { ptr, len };
+}
+
 [[gnu::const]]
-GgList gg_obj_into_list(GgObject) noexcept;
+inline GgList gg_obj_into_list(GgObject list) noexcept {
+    assert(gg_obj_type(list) == GG_TYPE_LIST);
+    GgObject *ptr;
+    uint16_t len;
+    std::memcpy(&ptr, list._private, sizeof(void *));
+    std::memcpy(&len, &list._private[sizeof(void *)], 2);
+    return GgList { ptr, len };
+}
+
 [[gnu::const]]
-GgMap gg_obj_into_map(GgObject) noexcept;
+inline GgMap gg_obj_into_map(GgObject map) noexcept {
+    assert(gg_obj_type(map) == GG_TYPE_MAP);
+    GgKV *ptr;
+    uint16_t len;
+    std::memcpy(&ptr, map._private, sizeof(void *));
+    std::memcpy(&len, &map._private[sizeof(void *)], 2);
+    return GgMap { ptr, len };
+}
 
 [[gnu::const]]
 GgObject gg_obj_bool(bool) noexcept;
@@ -101,9 +203,23 @@ GgObject gg_obj_map(GgMap) noexcept;
 [[gnu::const]]
 GgKV gg_kv(GgBuffer, GgObject) noexcept;
 [[gnu::const]]
-GgObject *gg_kv_val(GgKV *) noexcept;
+inline GgObject *gg_kv_val(GgKV *kv) noexcept {
+    // Value is stored at the end of the KV, after the key pointer and length
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return reinterpret_cast<GgObject *>(
+        &kv->_private[sizeof(GgKV) - sizeof(GgObject)]
+    );
+}
+
 [[gnu::const]]
-GgBuffer gg_kv_key(GgKV) noexcept;
+inline GgBuffer gg_kv_key(GgKV kv) noexcept {
+    uint8_t *ptr;
+    uint16_t len;
+    std::memcpy(&ptr, kv._private, sizeof(void *));
+    std::memcpy(&len, &kv._private[sizeof(void *)], 2);
+    return GgBuffer { ptr, len };
+}
+
 void gg_kv_set_key(GgKV *kv, GgBuffer key) noexcept;
 
 [[gnu::pure]]
@@ -9,6 +9,12 @@ extern "C" {
 
 GgError ggipc_connect(void) noexcept;
 
+void ggipc_get_stats(GgIpcStats *stats) noexcept;
+
+void ggipc_get_memory_usage(GgIpcMemoryUsage *usage) noexcept;
+
+void ggipc_reset_memory_peaks(void) noexcept;
+
 GgError ggipc_connect_with_token(
     GgBuffer socket_path, GgBuffer auth_token
 ) noexcept;
@@ -55,6 +55,22 @@ std::error_code Client::connect(
     );
 }
 
+Stats Client::get_stats() noexcept {
+    Stats stats {};
+    ggipc_get_stats(&stats);
+    return stats;
+}
+
+GgIpcMemoryUsage Client::get_memory_usage() noexcept {
+    GgIpcMemoryUsage usage {};
+    ggipc_get_memory_usage(&usage);
+    return usage;
+}
+
+void Client::reset_memory_peaks() noexcept {
+    ggipc_reset_memory_peaks();
+}
+
 std::error_code Client::update_component_state(
     GgComponentState state
 ) noexcept {
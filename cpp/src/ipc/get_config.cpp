@@ -2,7 +2,6 @@
 // Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
 // SPDX-License-Identifier: Apache-2.0
 
-#include <gg/arena.hpp>
 #include <gg/buffer.hpp>
 #include <gg/error.hpp>
 #include <gg/ipc/client.hpp>
@@ -65,7 +64,15 @@ struct GetConfigStrContext {
     const gg::Buffer *expected_key;
 };
 
-GgError gg_arena_claim_obj(GgObject *obj, GgArena *arena) noexcept;
+GgError gg_obj_clone_exact(
+    GgObject *obj, void *(*alloc_fn)(void *ctx, size_t size), void *ctx
+) noexcept;
+
+void *get_config_alloc_callback(void *ctx, size_t size) noexcept {
+    auto &alloc = *static_cast<std::unique_ptr<std::byte[]> *>(ctx);
+    alloc.reset(new (std::nothrow) std::byte[size]);
+    return alloc.get();
+}
 
 GgError get_config_str_callback(void *ctx, GgMap result) noexcept {
     GetConfigStrContext &context = *static_cast<GetConfigStrContext *>(ctx);
@@ -104,27 +111,14 @@ GgError get_config_obj_callback(void *ctx, GgMap result) noexcept {
         return GG_ERR_PARSE;
     }
 
-    size_t len = 0;
-    error = gg_obj_mem_usage(value, &len);
-    if (error != GG_ERR_OK) {
-        return GG_ERR_INVALID;
-    }
-
-    if (len == 0) {
-        *context.obj = AllocatedObject { value, nullptr };
-        return GG_ERR_OK;
-    }
-
-    std::unique_ptr<std::byte[]> alloc { new (std::nothrow) std::byte[len] };
-    if (alloc == nullptr) {
+    // Copied in a single pass, into an allocation of exactly the size used
+    std::unique_ptr<std::byte[]> alloc;
+    error = gg_obj_clone_exact(&value, get_config_alloc_callback, &alloc);
+    if (error == GG_ERR_NOMEM) {
         return GG_ERR_NOMEM;
     }
-
-    Arena arena { alloc.get(), len };
-    error = gg_arena_claim_obj(&value, &arena);
-    [[unlikely]] // Object traversal errors won't occur
     if (error != GG_ERR_OK) {
-        return GG_ERR_NOMEM;
+        return GG_ERR_INVALID;
     }
     *context.obj = AllocatedObject { value, std::move(alloc) };
     return GG_ERR_OK;
@@ -0,0 +1,256 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "emulator.h"
+#include <gg/arena.h>
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/eventstream/rpc.h>
+#include <gg/json_decode.h>
+#include <gg/list.h>
+#include <gg/log.h>
+#include <gg/map.h>
+#include <gg/object.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define CONFIG_MEM_LEN (4U * 1024U * 1024U)
+
+// The store alternates between two arenas. An update is merged in scratch
+// memory and claimed into the unused arena, so the old tree is never patched
+// in place and is dropped as a whole.
+static uint8_t *store_mem[2] = { NULL, NULL };
+static size_t store_current = 0;
+/// Map of component names to their configuration.
+static GgObject store_root;
+
+static uint8_t merge_mem[1024U * 1024U];
+
+GgError emu_config_init(GgBuffer json) {
+    store_mem[0] = malloc(CONFIG_MEM_LEN);
+    store_mem[1] = malloc(CONFIG_MEM_LEN);
+    if ((store_mem[0] == NULL) || (store_mem[1] == NULL)) {
+        return GG_ERR_NOMEM;
+    }
+
+    store_root = gg_obj_map((GgMap) { 0 });
+    if (json.len == 0) {
+        return GG_ERR_OK;
+    }
+
+    GgArena arena
+        = gg_arena_init((GgBuffer) { .data = store_mem[0],
+                                     .len = CONFIG_MEM_LEN });
+    GgError ret = gg_json_decode_destructive_with_limits(
+        json, &arena, &store_root, EMU_OBJECT_LIMITS
+    );
+    if (ret != GG_ERR_OK) {
+        GG_LOGE("Failed to parse initial configuration.");
+        return ret;
+    }
+    if (gg_obj_type(store_root) != GG_TYPE_MAP) {
+        GG_LOGE("Initial configuration must map component names to maps.");
+        return GG_ERR_INVALID;
+    }
+    GgMap components = gg_obj_into_map(store_root);
+    GG_MAP_FOREACH (pair, components) {
+        if (gg_obj_type(*gg_kv_val(pair)) != GG_TYPE_MAP) {
+            GG_LOGE("Initial configuration must map component names to maps.");
+            return GG_ERR_INVALID;
+        }
+    }
+    return GG_ERR_OK;
+}
+
+// Merges maps recursively, with `update` taking precedence for other types
+static GgError merge(
+    GgObject current, GgObject update, GgArena *arena, GgObject *result
+) {
+    if ((gg_obj_type(current) != GG_TYPE_MAP)
+        || (gg_obj_type(update) != GG_TYPE_MAP)) {
+        *result = update;
+        return GG_ERR_OK;
+    }
+
+    GgMap cur_map = gg_obj_into_map(current);
+    GgMap upd_map = gg_obj_into_map(update);
+    GgKV *pairs = GG_ARENA_ALLOCN(arena, GgKV, cur_map.len + upd_map.len);
+    if (pairs == NULL) {
+        return GG_ERR_NOMEM;
+    }
+    if (cur_map.len > 0) {
+        memcpy(pairs, cur_map.pairs, cur_map.len * sizeof(GgKV));
+    }
+    GgMap merged = { .pairs = pairs, .len = cur_map.len };
+
+    GG_MAP_FOREACH (pair, upd_map) {
+        GgObject *existing;
+        if (gg_map_get(merged, gg_kv_key(*pair), &existing)) {
+            GgError ret = merge(*existing, *gg_kv_val(pair), arena, existing);
+            if (ret != GG_ERR_OK) {
+                return ret;
+            }
+        } else {
+            merged.pairs[merged.len] = *pair;
+            merged.len += 1;
+        }
+    }
+
+    *result = gg_obj_map(merged);
+    return GG_ERR_OK;
+}
+
+static bool component_config(GgBuffer component, GgObject **config) {
+    return gg_map_get(gg_obj_into_map(store_root), component, config);
+}
+
+void emu_handle_get_config(EmuConn *conn, int32_t stream_id, GgMap request) {
+    GgObject *component_obj;
+    GgObject *key_path_obj;
+    GgError ret = gg_map_validate(
+        request,
+        GG_MAP_SCHEMA(
+            { GG_STR("componentName"),
+              GG_OPTIONAL,
+              GG_TYPE_BUF,
+              &component_obj },
+            { GG_STR("keyPath"), GG_OPTIONAL, GG_TYPE_LIST, &key_path_obj },
+        )
+    );
+    GgList key_path = (key_path_obj != NULL) ? gg_obj_into_list(*key_path_obj)
+                                             : (GgList) { 0 };
+    if (ret == GG_ERR_OK) {
+        ret = gg_list_type_check(key_path, GG_TYPE_BUF);
+    }
+    if (ret != GG_ERR_OK) {
+        emu_send_error(
+            conn,
+            stream_id,
+            GG_STR("InvalidArgumentsError"),
+            GG_STR("Invalid GetConfiguration request")
+        );
+        return;
+    }
+    GgBuffer component = (component_obj != NULL)
+        ? gg_obj_into_buf(*component_obj)
+        : conn->component;
+
+    GgObject *value = NULL;
+    bool found = component_config(component, &value);
+    for (size_t i = 0; found && (i < key_path.len); i++) {
+        found = (gg_obj_type(*value) == GG_TYPE_MAP)
+            && gg_map_get(
+                    gg_obj_into_map(*value),
+                    gg_obj_into_buf(key_path.items[i]),
+                    &value
+            );
+    }
+    if (!found) {
+        emu_send_error(
+            conn,
+            stream_id,
+            GG_STR("ResourceNotFoundError"),
+            GG_STR("Key not found")
+        );
+        return;
+    }
+
+    // Leaf values are returned under their key, as by the nucleus
+    GgKV leaf;
+    GgObject result = *value;
+    if (gg_obj_type(result) != GG_TYPE_MAP) {
+        leaf = gg_kv(gg_obj_into_buf(key_path.items[key_path.len - 1]), result);
+        result = gg_obj_map((GgMap) { .pairs = &leaf, .len = 1 });
+    }
+
+    GgObject response = gg_obj_map(GG_MAP(
+        gg_kv(GG_STR("componentName"), gg_obj_buf(component)),
+        gg_kv(GG_STR("value"), result)
+    ));
+    emu_send(
+        conn,
+        stream_id,
+        EVENTSTREAM_TERMINATE_STREAM,
+        GG_STR("aws.greengrass#GetConfigurationResponse"),
+        &response
+    );
+}
+
+void emu_handle_update_config(
+    EmuConn *conn, int32_t stream_id, GgMap request
+) {
+    GgObject *key_path_obj;
+    GgObject *value_to_merge;
+    GgError ret = gg_map_validate(
+        request,
+        GG_MAP_SCHEMA(
+            { GG_STR("keyPath"), GG_OPTIONAL, GG_TYPE_LIST, &key_path_obj },
+            { GG_STR("valueToMerge"),
+              GG_REQUIRED,
+              GG_TYPE_MAP,
+              &value_to_merge },
+        )
+    );
+    GgList key_path = (key_path_obj != NULL) ? gg_obj_into_list(*key_path_obj)
+                                             : (GgList) { 0 };
+    if (ret == GG_ERR_OK) {
+        ret = gg_list_type_check(key_path, GG_TYPE_BUF);
+    }
+    if ((ret != GG_ERR_OK) || (key_path.len >= GG_MAX_OBJECT_DEPTH - 1)) {
+        emu_send_error(
+            conn,
+            stream_id,
+            GG_STR("InvalidArgumentsError"),
+            GG_STR("Invalid UpdateConfiguration request")
+        );
+        return;
+    }
+
+    // Nest the value under its key path and component, then merge from root
+    GgKV levels[GG_MAX_OBJECT_DEPTH];
+    GgObject update = *value_to_merge;
+    for (size_t i = key_path.len; i > 0; i--) {
+        levels[i] = gg_kv(gg_obj_into_buf(key_path.items[i - 1]), update);
+        update = gg_obj_map((GgMap) { .pairs = &levels[i], .len = 1 });
+    }
+    levels[0] = gg_kv(conn->component, update);
+    update = gg_obj_map((GgMap) { .pairs = &levels[0], .len = 1 });
+
+    GgArena merge_arena = gg_arena_init(GG_BUF(merge_mem));
+    GgObject merged;
+    ret = merge(store_root, update, &merge_arena, &merged);
+    size_t next = 1 - store_current;
+    GgArena store_arena
+        = gg_arena_init((GgBuffer) { .data = store_mem[next],
+                                     .len = CONFIG_MEM_LEN });
+    if (ret == GG_ERR_OK) {
+        ret = gg_arena_claim_obj_with_limits(
+            &merged, &store_arena, EMU_OBJECT_LIMITS
+        );
+    }
+    if (ret != GG_ERR_OK) {
+        emu_send_error(
+            conn,
+            stream_id,
+            GG_STR("ServiceError"),
+            GG_STR("Configuration store is full")
+        );
+        return;
+    }
+    store_root = merged;
+    store_current = next;
+
+    GgObject empty = gg_obj_map((GgMap) { 0 });
+    emu_send(
+        conn,
+        stream_id,
+        EVENTSTREAM_TERMINATE_STREAM,
+        GG_STR("aws.greengrass#UpdateConfigurationResponse"),
+        &empty
+    );
+    emu_pubsub_config_updated(conn->component, key_path);
+}
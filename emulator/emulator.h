@@ -0,0 +1,130 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef GG_EMULATOR_H
+#define GG_EMULATOR_H
+
+//! Local nucleus emulator for load testing IPC clients
+
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/eventstream/types.h>
+#include <gg/ipc/limits.h>
+#include <gg/object.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Bytes of responses and deliveries buffered per client. A client that falls
+/// this far behind is disconnected.
+#define EMU_OUT_BUF_LEN (256U * 1024U)
+
+/// Maximum length of a component name, taken from the client's auth token.
+#define EMU_MAX_COMPONENT_LEN 128U
+
+/// Object limits for requests and the config store.
+#define EMU_OBJECT_LIMITS \
+    ((GgObjectLimits) { .max_depth = GG_MAX_OBJECT_DEPTH, \
+                        .max_subobjects = 65536 })
+
+/// A connected client.
+typedef struct {
+    int fd;
+    /// Set once the client has sent a valid connect message.
+    bool connected;
+    /// Set when the client must be disconnected after the current event.
+    bool closing;
+    /// Set when waiting for the socket to accept buffered output.
+    bool want_write;
+    uint8_t component_mem[EMU_MAX_COMPONENT_LEN];
+    GgBuffer component;
+    /// Partially received frame.
+    uint8_t in_mem[GG_IPC_MAX_MSG_LEN];
+    size_t in_len;
+    /// Output not yet accepted by the socket, from `out_start` to `out_end`.
+    uint8_t *out_mem;
+    size_t out_start;
+    size_t out_end;
+} EmuConn;
+
+/// Counters printed on exit.
+typedef struct {
+    uint64_t connections;
+    uint64_t requests;
+    uint64_t errors;
+    uint64_t deliveries;
+    uint64_t slow_disconnects;
+} EmuStats;
+
+extern EmuStats emu_stats;
+
+/// Queue an application message on a client stream.
+/// `payload` may be NULL for no payload. On failure the client is closed.
+void emu_send(
+    EmuConn *conn,
+    int32_t stream_id,
+    int32_t flags,
+    GgBuffer service_model_type,
+    const GgObject *payload
+);
+
+/// Queue an error response, terminating a client stream.
+void emu_send_error(
+    EmuConn *conn, int32_t stream_id, GgBuffer error_code, GgBuffer message
+);
+
+/// Queue an application message with an already encoded JSON payload.
+void emu_send_json(
+    EmuConn *conn,
+    int32_t stream_id,
+    int32_t flags,
+    GgBuffer service_model_type,
+    GgBuffer json
+);
+
+/// Serve clients on a socket until interrupted.
+GgError emu_serve(GgBuffer socket_path, size_t max_clients);
+
+/// Drop subscriptions of a closed client stream.
+void emu_pubsub_close_stream(const EmuConn *conn, int32_t stream_id);
+
+/// Drop all subscriptions of a disconnecting client.
+void emu_pubsub_close_conn(const EmuConn *conn);
+
+/// Check whether an MQTT-style topic filter, which may contain `+` and `#`
+/// wildcards, matches a topic.
+bool emu_topic_matches(GgBuffer filter, GgBuffer topic);
+
+/// Reserve space for subscriptions.
+GgError emu_pubsub_init(size_t max_subscriptions);
+
+void emu_handle_subscribe_to_topic(
+    EmuConn *conn, int32_t stream_id, GgMap request
+);
+void emu_handle_publish_to_topic(
+    EmuConn *conn, int32_t stream_id, GgMap request
+);
+void emu_handle_subscribe_to_iot_core(
+    EmuConn *conn, int32_t stream_id, GgMap request
+);
+void emu_handle_publish_to_iot_core(
+    EmuConn *conn, int32_t stream_id, GgMap request
+);
+void emu_handle_subscribe_to_config_update(
+    EmuConn *conn, int32_t stream_id, GgMap request
+);
+
+/// Notify config update subscribers of a change under `key_path`.
+void emu_pubsub_config_updated(GgBuffer component, GgList key_path);
+
+/// Load initial configuration, a JSON map of component names to their
+/// configuration.
+GgError emu_config_init(GgBuffer json);
+
+void emu_handle_get_config(EmuConn *conn, int32_t stream_id, GgMap request);
+void emu_handle_update_config(
+    EmuConn *conn, int32_t stream_id, GgMap request
+);
+
+#endif
@@ -0,0 +1,126 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+//! Serves the IPC operations used by components to many clients at once, for
+//! load testing without a Greengrass nucleus.
+
+#include "emulator.h"
+#include <errno.h>
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/file.h>
+#include <gg/log_config.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+static uint8_t config_file_mem[1024U * 1024U];
+
+static bool parse_count(const char *arg, size_t *out) {
+    char *end;
+    errno = 0;
+    unsigned long value = strtoul(arg, &end, 10);
+    if ((errno != 0) || (end == arg) || (*end != '\0') || (value == 0)
+        || (value > 1000000)) {
+        return false;
+    }
+    *out = (size_t) value;
+    return true;
+}
+
+static void usage(const char *name) {
+    fprintf(
+        stderr,
+        "Usage: %s --socket PATH [--config FILE] [--max-clients N] "
+        "[--max-subscriptions N]\n",
+        name
+    );
+}
+
+int main(int argc, char **argv) {
+    const char *socket_path = NULL;
+    const char *config_path = NULL;
+    size_t max_clients = 256;
+    size_t max_subscriptions = 4096;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        bool ok = value != NULL;
+        if (!ok) {
+            // All options take a value
+        } else if (strcmp(arg, "--socket") == 0) {
+            socket_path = value;
+        } else if (strcmp(arg, "--config") == 0) {
+            config_path = value;
+        } else if (strcmp(arg, "--max-clients") == 0) {
+            ok = parse_count(value, &max_clients);
+        } else if (strcmp(arg, "--max-subscriptions") == 0) {
+            ok = parse_count(value, &max_subscriptions);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            usage(argv[0]);
+            return 2;
+        }
+        i++;
+    }
+    if (socket_path == NULL) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // Per-message logs would dominate a load test
+    // NOLINTNEXTLINE(concurrency-mt-unsafe)
+    if (getenv("GG_LOG_LEVELS") == NULL) {
+        (void) gg_log_set_levels(GG_STR("info"));
+    }
+
+    GgBuffer config = { 0 };
+    if (config_path != NULL) {
+        config = GG_BUF(config_file_mem);
+        GgError ret = gg_file_read_path(
+            gg_buffer_from_null_term((char *) config_path), &config
+        );
+        if (ret != GG_ERR_OK) {
+            fprintf(
+                stderr,
+                "Failed to read %s: %s.\n",
+                config_path,
+                gg_strerror(ret)
+            );
+            return 1;
+        }
+    }
+
+    GgError ret = emu_config_init(config);
+    if (ret == GG_ERR_OK) {
+        ret = emu_pubsub_init(max_subscriptions);
+    }
+    if (ret == GG_ERR_OK) {
+        ret = emu_serve(
+            gg_buffer_from_null_term((char *) socket_path), max_clients
+        );
+    }
+    if (ret != GG_ERR_OK) {
+        fprintf(stderr, "Emulator failed: %s.\n", gg_strerror(ret));
+        return 1;
+    }
+
+    printf(
+        "connections=%" PRIu64 " requests=%" PRIu64 " errors=%" PRIu64
+        " deliveries=%" PRIu64 " slow_disconnects=%" PRIu64 "\n",
+        emu_stats.connections,
+        emu_stats.requests,
+        emu_stats.errors,
+        emu_stats.deliveries,
+        emu_stats.slow_disconnects
+    );
+    return 0;
+}
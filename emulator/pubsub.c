@@ -0,0 +1,490 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "emulator.h"
+#include <gg/arena.h>
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/eventstream/rpc.h>
+#include <gg/io.h>
+#include <gg/json_encode.h>
+#include <gg/list.h>
+#include <gg/log.h>
+#include <gg/map.h>
+#include <gg/object.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef enum {
+    SUB_LOCAL,
+    SUB_IOT_CORE,
+    SUB_CONFIG,
+} EmuSubKind;
+
+typedef struct {
+    /// NULL if the slot is free.
+    const EmuConn *conn;
+    int32_t stream_id;
+    EmuSubKind kind;
+    /// Set for local subscriptions that skip the subscriber's own messages.
+    bool skip_own;
+    /// Topic filter, or component name for config subscriptions.
+    GgBuffer filter;
+    /// Key path of config subscriptions.
+    GgList key_path;
+    uint8_t mem[1024];
+} EmuSub;
+
+static EmuSub *subs = NULL;
+static size_t sub_capacity = 0;
+/// Slots past this are all free.
+static size_t sub_end = 0;
+
+// Deliveries are encoded once for all subscribers
+static uint8_t delivery_mem[GG_IPC_MAX_MSG_LEN];
+
+GgError emu_pubsub_init(size_t max_subscriptions) {
+    subs = calloc(max_subscriptions, sizeof(EmuSub));
+    if (subs == NULL) {
+        return GG_ERR_NOMEM;
+    }
+    sub_capacity = max_subscriptions;
+    return GG_ERR_OK;
+}
+
+bool emu_topic_matches(GgBuffer filter, GgBuffer topic) {
+    size_t f = 0;
+    size_t t = 0;
+    while (true) {
+        size_t f_end = f;
+        while ((f_end < filter.len) && (filter.data[f_end] != '/')) {
+            f_end++;
+        }
+        size_t t_end = t;
+        while ((t_end < topic.len) && (topic.data[t_end] != '/')) {
+            t_end++;
+        }
+        GgBuffer f_level = gg_buffer_substr(filter, f, f_end);
+        if (gg_buffer_eq(f_level, GG_STR("#"))) {
+            return true;
+        }
+        if (!gg_buffer_eq(f_level, GG_STR("+"))
+            && !gg_buffer_eq(f_level, gg_buffer_substr(topic, t, t_end))) {
+            return false;
+        }
+
+        if (f_end == filter.len) {
+            return t_end == topic.len;
+        }
+        if (t_end == topic.len) {
+            // `a/#` also matches `a`
+            return gg_buffer_eq(
+                gg_buffer_substr(filter, f_end + 1, SIZE_MAX), GG_STR("#")
+            );
+        }
+        f = f_end + 1;
+        t = t_end + 1;
+    }
+}
+
+static bool has_wildcard(GgBuffer topic) {
+    return (memchr(topic.data, '+', topic.len) != NULL)
+        || (memchr(topic.data, '#', topic.len) != NULL);
+}
+
+static EmuSub *add_sub(
+    EmuConn *conn,
+    int32_t stream_id,
+    EmuSubKind kind,
+    GgBuffer filter,
+    GgList key_path
+) {
+    EmuSub *sub = NULL;
+    for (size_t i = 0; i < sub_capacity; i++) {
+        if (subs[i].conn == NULL) {
+            sub = &subs[i];
+            break;
+        }
+    }
+    if (sub == NULL) {
+        emu_send_error(
+            conn,
+            stream_id,
+            GG_STR("ServiceError"),
+            GG_STR("Too many subscriptions")
+        );
+        return NULL;
+    }
+
+    GgArena arena = gg_arena_init(GG_BUF(sub->mem));
+    GgObject path = gg_obj_list(key_path);
+    GgError ret = gg_arena_claim_buf(&filter, &arena);
+    if (ret == GG_ERR_OK) {
+        ret = gg_arena_claim_obj(&path, &arena);
+    }
+    if (ret != GG_ERR_OK) {
+        emu_send_error(
+            conn,
+            stream_id,
+            GG_STR("InvalidArgumentsError"),
+            GG_STR("Subscription too large")
+        );
+        return NULL;
+    }
+
+    sub->conn = conn;
+    sub->stream_id = stream_id;
+    sub->kind = kind;
+    sub->skip_own = false;
+    sub->filter = filter;
+    sub->key_path = gg_obj_into_list(path);
+    if ((size_t) (sub - subs) >= sub_end) {
+        sub_end = (size_t) (sub - subs) + 1;
+    }
+    return sub;
+}
+
+static void remove_subs(const EmuConn *conn, int32_t stream_id, bool all) {
+    for (size_t i = 0; i < sub_end; i++) {
+        if ((subs[i].conn == conn)
+            && (all || (subs[i].stream_id == stream_id))) {
+            subs[i].conn = NULL;
+        }
+    }
+    while ((sub_end > 0) && (subs[sub_end - 1].conn == NULL)) {
+        sub_end--;
+    }
+}
+
+void emu_pubsub_close_stream(const EmuConn *conn, int32_t stream_id) {
+    remove_subs(conn, stream_id, false);
+}
+
+void emu_pubsub_close_conn(const EmuConn *conn) {
+    remove_subs(conn, 0, true);
+}
+
+static void send_subscribed(
+    EmuConn *conn, int32_t stream_id, GgBuffer service_model_type
+) {
+    GgObject empty = gg_obj_map((GgMap) { 0 });
+    emu_send(conn, stream_id, 0, service_model_type, &empty);
+}
+
+static void send_accepted(
+    EmuConn *conn, int32_t stream_id, GgBuffer service_model_type
+) {
+    GgObject empty = gg_obj_map((GgMap) { 0 });
+    emu_send(
+        conn,
+        stream_id,
+        EVENTSTREAM_TERMINATE_STREAM,
+        service_model_type,
+        &empty
+    );
+}
+
+// Sends an encoded message to matching subscriptions of a kind
+static void deliver(
+    const EmuConn *sender,
+    EmuSubKind kind,
+    GgBuffer topic,
+    GgBuffer service_model_type,
+    GgObject payload
+) {
+    GgBuffer json = GG_BUF(delivery_mem);
+    GgBuffer rest = json;
+    GgError ret = gg_json_encode_with_limits(
+        payload, gg_buf_writer(&rest), EMU_OBJECT_LIMITS
+    );
+    if (ret != GG_ERR_OK) {
+        GG_LOGW("Dropping message too large for IPC.");
+        return;
+    }
+    json.len -= rest.len;
+
+    for (size_t i = 0; i < sub_end; i++) {
+        EmuSub *sub = &subs[i];
+        if ((sub->conn == NULL) || (sub->kind != kind)
+            || (sub->skip_own && (sub->conn == sender))
+            || !emu_topic_matches(sub->filter, topic)) {
+            continue;
+        }
+        emu_send_json(
+            (EmuConn *) sub->conn, sub->stream_id, 0, service_model_type, json
+        );
+        emu_stats.deliveries += 1;
+    }
+}
+
+void emu_handle_subscribe_to_topic(
+    EmuConn *conn, int32_t stream_id, GgMap request
+) {
+    GgObject *topic;
+    GgObject *receive_mode;
+    GgError ret = gg_map_validate(
+        request,
+        GG_MAP_SCHEMA(
+            { GG_STR("topic"), GG_REQUIRED, GG_TYPE_BUF, &topic },
+            { GG_STR("receiveMode"),
+              GG_OPTIONAL,
+              GG_TYPE_BUF,
+              &receive_mode },
+        )
+    );
+    if (ret != GG_ERR_OK) {
+        emu_send_error(
+            conn,
+            stream_id,
+            GG_STR("InvalidArgumentsError"),
+            GG_STR("Invalid SubscribeToTopic request")
+        );
+        return;
+    }
+
+    EmuSub *sub = add_sub(
+        conn, stream_id, SUB_LOCAL, gg_obj_into_buf(*topic), (GgList) { 0 }
+    );
+    if (sub == NULL) {
+        return;
+    }
+    sub->skip_own = (receive_mode != NULL)
+        && gg_buffer_eq(
+                    gg_obj_into_buf(*receive_mode),
+                    GG_STR("RECEIVE_MESSAGES_FROM_OTHERS")
+        );
+    send_subscribed(
+        conn, stream_id, GG_STR("aws.greengrass#SubscribeToTopicResponse")
+    );
+}
+
+void emu_handle_publish_to_topic(
+    EmuConn *conn, int32_t stream_id, GgMap request
+) {
+    GgObject *topic;
+    GgObject *publish_message;
+    GgError ret = gg_map_validate(
+        request,
+        GG_MAP_SCHEMA(
+            { GG_STR("topic"), GG_REQUIRED, GG_TYPE_BUF, &topic },
+            { GG_STR("publishMessage"),
+              GG_REQUIRED,
+              GG_TYPE_MAP,
+              &publish_message },
+        )
+    );
+    GgMap message_map = { 0 };
+    GgObject *message = NULL;
+    if (ret == GG_ERR_OK) {
+        message_map = gg_obj_into_map(*publish_message);
+        ret = ((message_map.len == 1)
+               && (gg_obj_type(*gg_kv_val(&message_map.pairs[0]))
+                   == GG_TYPE_MAP))
+            ? GG_ERR_OK
+            : GG_ERR_INVALID;
+    }
+    if (ret == GG_ERR_OK) {
+        ret = gg_map_validate(
+            gg_obj_into_map(*gg_kv_val(&message_map.pairs[0])),
+            GG_MAP_SCHEMA(
+                { GG_STR("message"), GG_REQUIRED, GG_TYPE_NULL, &message },
+            )
+        );
+    }
+    if ((ret != GG_ERR_OK) || has_wildcard(gg_obj_into_buf(*topic))) {
+        emu_send_error(
+            conn,
+            stream_id,
+            GG_STR("InvalidArgumentsError"),
+            GG_STR("Invalid PublishToTopic request")
+        );
+        return;
+    }
+
+    send_accepted(
+        conn, stream_id, GG_STR("aws.greengrass#PublishToTopicResponse")
+    );
+
+    // Delivered as published, with the context added by the nucleus
+    deliver(
+        conn,
+        SUB_LOCAL,
+        gg_obj_into_buf(*topic),
+        GG_STR("aws.greengrass#SubscriptionResponseMessage"),
+        gg_obj_map(GG_MAP(gg_kv(
+            gg_kv_key(message_map.pairs[0]),
+            gg_obj_map(GG_MAP(
+                gg_kv(GG_STR("message"), *message),
+                gg_kv(
+                    GG_STR("context"),
+                    gg_obj_map(GG_MAP(gg_kv(GG_STR("topic"), *topic)))
+                )
+            ))
+        )))
+    );
+}
+
+void emu_handle_subscribe_to_iot_core(
+    EmuConn *conn, int32_t stream_id, GgMap request
+) {
+    GgObject *topic_filter;
+    GgError ret = gg_map_validate(
+        request,
+        GG_MAP_SCHEMA(
+            { GG_STR("topicName"), GG_REQUIRED, GG_TYPE_BUF, &topic_filter },
+        )
+    );
+    if (ret != GG_ERR_OK) {
+        emu_send_error(
+            conn,
+            stream_id,
+            GG_STR("InvalidArgumentsError"),
+            GG_STR("Invalid SubscribeToIoTCore request")
+        );
+        return;
+    }
+
+    EmuSub *sub = add_sub(
+        conn,
+        stream_id,
+        SUB_IOT_CORE,
+        gg_obj_into_buf(*topic_filter),
+        (GgList) { 0 }
+    );
+    if (sub == NULL) {
+        return;
+    }
+    send_subscribed(
+        conn, stream_id, GG_STR("aws.greengrass#SubscribeToIoTCoreResponse")
+    );
+}
+
+void emu_handle_publish_to_iot_core(
+    EmuConn *conn, int32_t stream_id, GgMap request
+) {
+    GgObject *topic;
+    GgObject *payload;
+    GgError ret = gg_map_validate(
+        request,
+        GG_MAP_SCHEMA(
+            { GG_STR("topicName"), GG_REQUIRED, GG_TYPE_BUF, &topic },
+            { GG_STR("payload"), GG_OPTIONAL, GG_TYPE_BUF, &payload },
+        )
+    );
+    if ((ret != GG_ERR_OK) || has_wildcard(gg_obj_into_buf(*topic))) {
+        emu_send_error(
+            conn,
+            stream_id,
+            GG_STR("InvalidArgumentsError"),
+            GG_STR("Invalid PublishToIoTCore request")
+        );
+        return;
+    }
+
+    send_accepted(
+        conn, stream_id, GG_STR("aws.greengrass#PublishToIoTCoreResponse")
+    );
+
+    // Looped back as if the cloud echoed the publish, payload still base64
+    GgObject payload_obj
+        = (payload != NULL) ? *payload : gg_obj_buf(GG_STR(""));
+    deliver(
+        conn,
+        SUB_IOT_CORE,
+        gg_obj_into_buf(*topic),
+        GG_STR("aws.greengrass#IoTCoreMessage"),
+        gg_obj_map(GG_MAP(gg_kv(
+            GG_STR("message"),
+            gg_obj_map(GG_MAP(
+                gg_kv(GG_STR("topicName"), *topic),
+                gg_kv(GG_STR("payload"), payload_obj)
+            ))
+        )))
+    );
+}
+
+void emu_handle_subscribe_to_config_update(
+    EmuConn *conn, int32_t stream_id, GgMap request
+) {
+    GgObject *component;
+    GgObject *key_path;
+    GgError ret = gg_map_validate(
+        request,
+        GG_MAP_SCHEMA(
+            { GG_STR("componentName"), GG_OPTIONAL, GG_TYPE_BUF, &component },
+            { GG_STR("keyPath"), GG_OPTIONAL, GG_TYPE_LIST, &key_path },
+        )
+    );
+    if ((ret == GG_ERR_OK) && (key_path != NULL)) {
+        ret = gg_list_type_check(gg_obj_into_list(*key_path), GG_TYPE_BUF);
+    }
+    if (ret != GG_ERR_OK) {
+        emu_send_error(
+            conn,
+            stream_id,
+            GG_STR("InvalidArgumentsError"),
+            GG_STR("Invalid SubscribeToConfigurationUpdate request")
+        );
+        return;
+    }
+
+    EmuSub *sub = add_sub(
+        conn,
+        stream_id,
+        SUB_CONFIG,
+        (component != NULL) ? gg_obj_into_buf(*component) : conn->component,
+        (key_path != NULL) ? gg_obj_into_list(*key_path) : (GgList) { 0 }
+    );
+    if (sub == NULL) {
+        return;
+    }
+    send_subscribed(
+        conn,
+        stream_id,
+        GG_STR("aws.greengrass#SubscribeToConfigurationUpdateResponse")
+    );
+}
+
+// Whether one key path is a prefix of the other
+static bool key_paths_overlap(GgList a, GgList b) {
+    size_t len = (a.len < b.len) ? a.len : b.len;
+    for (size_t i = 0; i < len; i++) {
+        if (!gg_buffer_eq(
+                gg_obj_into_buf(a.items[i]), gg_obj_into_buf(b.items[i])
+            )) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void emu_pubsub_config_updated(GgBuffer component, GgList key_path) {
+    GgObject event = gg_obj_map(GG_MAP(gg_kv(
+        GG_STR("configurationUpdateEvent"),
+        gg_obj_map(GG_MAP(
+            gg_kv(GG_STR("componentName"), gg_obj_buf(component)),
+            gg_kv(GG_STR("keyPath"), gg_obj_list(key_path))
+        ))
+    )));
+
+    for (size_t i = 0; i < sub_end; i++) {
+        EmuSub *sub = &subs[i];
+        if ((sub->conn == NULL) || (sub->kind != SUB_CONFIG)
+            || !gg_buffer_eq(sub->filter, component)
+            || !key_paths_overlap(sub->key_path, key_path)) {
+            continue;
+        }
+        emu_send(
+            (EmuConn *) sub->conn,
+            sub->stream_id,
+            0,
+            GG_STR("aws.greengrass#ConfigurationUpdateEvents"),
+            &event
+        );
+        emu_stats.deliveries += 1;
+    }
+}
@@ -0,0 +1,675 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "emulator.h"
+#include <errno.h>
+#include <gg/arena.h>
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/eventstream/decode.h>
+#include <gg/eventstream/encode.h>
+#include <gg/eventstream/rpc.h>
+#include <gg/eventstream/types.h>
+#include <gg/io.h>
+#include <gg/ipc/limits.h>
+#include <gg/json_decode.h>
+#include <gg/json_encode.h>
+#include <gg/log.h>
+#include <gg/map.h>
+#include <gg/object.h>
+#include <gg/vector.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define LISTEN_DATA UINT64_MAX
+
+EmuStats emu_stats = { 0 };
+
+static EmuConn *conns = NULL;
+static size_t conn_count = 0;
+/// Connections to release once the current batch of events is handled.
+static EmuConn **closing = NULL;
+static size_t closing_count = 0;
+static char socket_path_mem[sizeof(((struct sockaddr_un *) NULL)->sun_path)];
+static int listen_fd = -1;
+static int epoll_fd = -1;
+static volatile sig_atomic_t stop_requested = 0;
+
+static uint8_t frame_mem[GG_IPC_MAX_MSG_LEN];
+static uint8_t request_mem[1024U * 1024U];
+
+static void on_stop_signal(int sig) {
+    (void) sig;
+    stop_requested = 1;
+}
+
+static void conn_close(EmuConn *conn) {
+    if (!conn->closing) {
+        GG_LOGD("Closing connection %d.", conn->fd);
+        conn->closing = true;
+        closing[closing_count] = conn;
+        closing_count += 1;
+    }
+}
+
+static void conn_release(EmuConn *conn) {
+    emu_pubsub_close_conn(conn);
+    (void) epoll_ctl(epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+    (void) close(conn->fd);
+    free(conn->out_mem);
+    *conn = (EmuConn) { .fd = -1 };
+}
+
+static void conn_watch(EmuConn *conn, bool want_write) {
+    if (conn->want_write == want_write) {
+        return;
+    }
+    struct epoll_event event
+        = { .events = EPOLLIN | (want_write ? EPOLLOUT : 0U),
+            .data = { .u64 = (uint64_t) (conn - conns) } };
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, conn->fd, &event) == -1) {
+        GG_LOGE("Failed to update watch for %d: %d.", conn->fd, errno);
+        conn_close(conn);
+        return;
+    }
+    conn->want_write = want_write;
+}
+
+static void conn_flush(EmuConn *conn) {
+    if (conn->closing) {
+        return;
+    }
+    while (conn->out_start < conn->out_end) {
+        ssize_t written = send(
+            conn->fd,
+            &conn->out_mem[conn->out_start],
+            conn->out_end - conn->out_start,
+            MSG_NOSIGNAL
+        );
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+                break;
+            }
+            GG_LOGD("Write to %d failed: %d.", conn->fd, errno);
+            conn_close(conn);
+            return;
+        }
+        conn->out_start += (size_t) written;
+    }
+    if (conn->out_start == conn->out_end) {
+        conn->out_start = 0;
+        conn->out_end = 0;
+    }
+    conn_watch(conn, conn->out_end > conn->out_start);
+}
+
+static void conn_queue(EmuConn *conn, GgBuffer frame) {
+    if (conn->closing) {
+        return;
+    }
+    if (EMU_OUT_BUF_LEN - conn->out_end < frame.len) {
+        memmove(
+            conn->out_mem,
+            &conn->out_mem[conn->out_start],
+            conn->out_end - conn->out_start
+        );
+        conn->out_end -= conn->out_start;
+        conn->out_start = 0;
+    }
+    if (EMU_OUT_BUF_LEN - conn->out_end < frame.len) {
+        GG_LOGW(
+            "Disconnecting component %.*s: not reading its messages.",
+            (int) conn->component.len,
+            conn->component.data
+        );
+        emu_stats.slow_disconnects += 1;
+        conn_close(conn);
+        return;
+    }
+    memcpy(&conn->out_mem[conn->out_end], frame.data, frame.len);
+    conn->out_end += frame.len;
+
+    // Once the socket is full, wait for it to drain instead of retrying
+    if (!conn->want_write) {
+        conn_flush(conn);
+    }
+}
+
+// Encodes payloads with the emulator's limits, which exceed the defaults
+static GgError payload_reader_fn(void *ctx, GgBuffer *buf) {
+    const GgObject *payload = ctx;
+    GgBuffer rest = *buf;
+    GgError ret = gg_json_encode_with_limits(
+        *payload, gg_buf_writer(&rest), EMU_OBJECT_LIMITS
+    );
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    buf->len -= rest.len;
+    return GG_ERR_OK;
+}
+
+// Copies pre-encoded JSON
+static GgError json_reader_fn(void *ctx, GgBuffer *buf) {
+    const GgBuffer *json = ctx;
+    if (buf->len < json->len) {
+        return GG_ERR_NOMEM;
+    }
+    memcpy(buf->data, json->data, json->len);
+    buf->len = json->len;
+    return GG_ERR_OK;
+}
+
+static void send_frame(
+    EmuConn *conn,
+    const EventStreamHeader *headers,
+    size_t header_count,
+    GgReader payload
+) {
+    GgBuffer frame = GG_BUF(frame_mem);
+    GgError ret = eventstream_encode(&frame, headers, header_count, payload);
+    if (ret != GG_ERR_OK) {
+        // Larger than the client could receive
+        GG_LOGW("Dropping message too large for IPC (%d).", (int) ret);
+        return;
+    }
+    conn_queue(conn, frame);
+}
+
+static GgReader payload_reader(const GgObject *payload) {
+    if (payload == NULL) {
+        return GG_NULL_READER;
+    }
+    return (GgReader) { .read = payload_reader_fn, .ctx = (void *) payload };
+}
+
+static void send_message(
+    EmuConn *conn,
+    int32_t stream_id,
+    int32_t flags,
+    GgBuffer service_model_type,
+    GgReader payload
+) {
+    const EventStreamHeader HEADERS[] = {
+        { GG_STR(":message-type"),
+          { EVENTSTREAM_INT32, .int32 = EVENTSTREAM_APPLICATION_MESSAGE } },
+        { GG_STR(":message-flags"), { EVENTSTREAM_INT32, .int32 = flags } },
+        { GG_STR(":stream-id"), { EVENTSTREAM_INT32, .int32 = stream_id } },
+        { GG_STR(":content-type"),
+          { EVENTSTREAM_STRING, .string = GG_STR("application/json") } },
+        { GG_STR("service-model-type"),
+          { EVENTSTREAM_STRING, .string = service_model_type } },
+    };
+    send_frame(conn, HEADERS, sizeof(HEADERS) / sizeof(HEADERS[0]), payload);
+}
+
+void emu_send(
+    EmuConn *conn,
+    int32_t stream_id,
+    int32_t flags,
+    GgBuffer service_model_type,
+    const GgObject *payload
+) {
+    send_message(
+        conn, stream_id, flags, service_model_type, payload_reader(payload)
+    );
+}
+
+void emu_send_json(
+    EmuConn *conn,
+    int32_t stream_id,
+    int32_t flags,
+    GgBuffer service_model_type,
+    GgBuffer json
+) {
+    send_message(
+        conn,
+        stream_id,
+        flags,
+        service_model_type,
+        (GgReader) { .read = json_reader_fn, .ctx = &json }
+    );
+}
+
+void emu_send_error(
+    EmuConn *conn, int32_t stream_id, GgBuffer error_code, GgBuffer message
+) {
+    uint8_t model_mem[128];
+    GgByteVec model = gg_byte_vec_init(GG_BUF(model_mem));
+    GgError ret = GG_ERR_OK;
+    gg_byte_vec_chain_append(&ret, &model, GG_STR("aws.greengrass#"));
+    gg_byte_vec_chain_append(&ret, &model, error_code);
+    if (ret != GG_ERR_OK) {
+        model.buf = GG_STR("aws.greengrass#ServiceError");
+    }
+
+    const EventStreamHeader HEADERS[] = {
+        { GG_STR(":message-type"),
+          { EVENTSTREAM_INT32, .int32 = EVENTSTREAM_APPLICATION_ERROR } },
+        { GG_STR(":message-flags"),
+          { EVENTSTREAM_INT32, .int32 = EVENTSTREAM_TERMINATE_STREAM } },
+        { GG_STR(":stream-id"), { EVENTSTREAM_INT32, .int32 = stream_id } },
+        { GG_STR(":content-type"),
+          { EVENTSTREAM_STRING, .string = GG_STR("application/json") } },
+        { GG_STR("service-model-type"),
+          { EVENTSTREAM_STRING, .string = model.buf } },
+    };
+    GgObject payload = gg_obj_map(GG_MAP(
+        gg_kv(GG_STR("_errorCode"), gg_obj_buf(error_code)),
+        gg_kv(GG_STR("_message"), gg_obj_buf(message))
+    ));
+    emu_stats.errors += 1;
+    send_frame(
+        conn,
+        HEADERS,
+        sizeof(HEADERS) / sizeof(HEADERS[0]),
+        payload_reader(&payload)
+    );
+}
+
+static void send_connect_ack(EmuConn *conn, bool accepted) {
+    const EventStreamHeader HEADERS[] = {
+        { GG_STR(":message-type"),
+          { EVENTSTREAM_INT32, .int32 = EVENTSTREAM_CONNECT_ACK } },
+        { GG_STR(":message-flags"),
+          { EVENTSTREAM_INT32,
+            .int32 = accepted ? EVENTSTREAM_CONNECTION_ACCEPTED : 0 } },
+        { GG_STR(":stream-id"), { EVENTSTREAM_INT32, .int32 = 0 } },
+    };
+    send_frame(
+        conn, HEADERS, sizeof(HEADERS) / sizeof(HEADERS[0]), GG_NULL_READER
+    );
+}
+
+static void handle_update_state(
+    EmuConn *conn, int32_t stream_id, GgMap request
+) {
+    (void) request;
+    GgObject empty = gg_obj_map((GgMap) { 0 });
+    emu_send(
+        conn,
+        stream_id,
+        EVENTSTREAM_TERMINATE_STREAM,
+        GG_STR("aws.greengrass#UpdateStateResponse"),
+        &empty
+    );
+}
+
+static void handle_restart_component(
+    EmuConn *conn, int32_t stream_id, GgMap request
+) {
+    (void) request;
+    GgObject response = gg_obj_map(
+        GG_MAP(gg_kv(GG_STR("restartStatus"), gg_obj_buf(GG_STR("SUCCEEDED"))))
+    );
+    emu_send(
+        conn,
+        stream_id,
+        EVENTSTREAM_TERMINATE_STREAM,
+        GG_STR("aws.greengrass#RestartComponentResponse"),
+        &response
+    );
+}
+
+typedef void EmuHandler(EmuConn *conn, int32_t stream_id, GgMap request);
+
+static const struct {
+    GgBuffer operation;
+    EmuHandler *handler;
+} HANDLERS[] = {
+    { GG_STR("aws.greengrass#PublishToTopic"), emu_handle_publish_to_topic },
+    { GG_STR("aws.greengrass#SubscribeToTopic"),
+      emu_handle_subscribe_to_topic },
+    { GG_STR("aws.greengrass#PublishToIoTCore"),
+      emu_handle_publish_to_iot_core },
+    { GG_STR("aws.greengrass#SubscribeToIoTCore"),
+      emu_handle_subscribe_to_iot_core },
+    { GG_STR("aws.greengrass#GetConfiguration"), emu_handle_get_config },
+    { GG_STR("aws.greengrass#UpdateConfiguration"), emu_handle_update_config },
+    { GG_STR("aws.greengrass#SubscribeToConfigurationUpdate"),
+      emu_handle_subscribe_to_config_update },
+    { GG_STR("aws.greengrass#UpdateState"), handle_update_state },
+    { GG_STR("aws.greengrass#RestartComponent"), handle_restart_component },
+};
+
+static void handle_connect(EmuConn *conn, GgMap payload) {
+    GgObject *token;
+    GgError ret = gg_map_validate(
+        payload,
+        GG_MAP_SCHEMA(
+            { GG_STR("authToken"), GG_REQUIRED, GG_TYPE_BUF, &token },
+        )
+    );
+    GgBuffer token_buf = (ret == GG_ERR_OK) ? gg_obj_into_buf(*token)
+                                            : GG_STR("");
+    if ((token_buf.len == 0) || (token_buf.len > EMU_MAX_COMPONENT_LEN)) {
+        GG_LOGW("Rejecting connection %d with invalid auth token.", conn->fd);
+        send_connect_ack(conn, false);
+        conn_close(conn);
+        return;
+    }
+
+    // Components are identified by their auth token
+    memcpy(conn->component_mem, token_buf.data, token_buf.len);
+    conn->component = (GgBuffer) { .data = conn->component_mem,
+                                   .len = token_buf.len };
+    conn->connected = true;
+    GG_LOGI(
+        "Component %.*s connected.",
+        (int) conn->component.len,
+        conn->component.data
+    );
+    send_connect_ack(conn, true);
+}
+
+static void handle_frame(EmuConn *conn, EventStreamMessage msg) {
+    EventStreamCommonHeaders common;
+    GgError ret = eventstream_get_common_headers(&msg, &common);
+    if (ret != GG_ERR_OK) {
+        conn_close(conn);
+        return;
+    }
+
+    GgBuffer operation = { 0 };
+    EventStreamHeaderIter iter = msg.headers;
+    EventStreamHeader header;
+    while (eventstream_header_next(&iter, &header) == GG_ERR_OK) {
+        if (gg_buffer_eq(header.name, GG_STR("operation"))
+            && (header.value.type == EVENTSTREAM_STRING)) {
+            operation = header.value.string;
+        }
+    }
+
+    GgMap payload = { 0 };
+    if (msg.payload.len > 0) {
+        GgArena arena = gg_arena_init(GG_BUF(request_mem));
+        GgObject obj;
+        ret = gg_json_decode_destructive_with_limits(
+            msg.payload, &arena, &obj, EMU_OBJECT_LIMITS
+        );
+        if ((ret != GG_ERR_OK) || (gg_obj_type(obj) != GG_TYPE_MAP)) {
+            GG_LOGW("Received invalid payload from %d.", conn->fd);
+            if (!conn->connected) {
+                conn_close(conn);
+            } else if (common.message_type == EVENTSTREAM_APPLICATION_MESSAGE) {
+                emu_send_error(
+                    conn,
+                    common.stream_id,
+                    GG_STR("InvalidArgumentsError"),
+                    GG_STR("Payload must be a JSON object")
+                );
+            }
+            return;
+        }
+        payload = gg_obj_into_map(obj);
+    }
+
+    if (!conn->connected) {
+        if (common.message_type != EVENTSTREAM_CONNECT) {
+            GG_LOGW("Connection %d sent a message before connect.", conn->fd);
+            conn_close(conn);
+            return;
+        }
+        handle_connect(conn, payload);
+        return;
+    }
+
+    if (common.message_type != EVENTSTREAM_APPLICATION_MESSAGE) {
+        return;
+    }
+    if ((common.message_flags & EVENTSTREAM_TERMINATE_STREAM) != 0) {
+        emu_pubsub_close_stream(conn, common.stream_id);
+        return;
+    }
+
+    emu_stats.requests += 1;
+    for (size_t i = 0; i < sizeof(HANDLERS) / sizeof(HANDLERS[0]); i++) {
+        if (gg_buffer_eq(operation, HANDLERS[i].operation)) {
+            HANDLERS[i].handler(conn, common.stream_id, payload);
+            return;
+        }
+    }
+    GG_LOGW(
+        "Unsupported operation %.*s.", (int) operation.len, operation.data
+    );
+    emu_send_error(
+        conn,
+        common.stream_id,
+        GG_STR("ServiceError"),
+        GG_STR("Operation not supported by the emulator")
+    );
+}
+
+// Handles each complete frame received, keeping any partial frame
+static void process_input(EmuConn *conn) {
+    size_t pos = 0;
+    while ((conn->in_len - pos >= 12) && !conn->closing) {
+        EventStreamPrelude prelude;
+        GgBuffer frame = { .data = &conn->in_mem[pos],
+                           .len = conn->in_len - pos };
+        GgError ret = eventstream_decode_prelude(
+            gg_buffer_substr(frame, 0, 12), &prelude
+        );
+        if ((ret != GG_ERR_OK)
+            || (prelude.data_len > sizeof(conn->in_mem) - 12)) {
+            GG_LOGW("Received invalid frame from %d.", conn->fd);
+            conn_close(conn);
+            return;
+        }
+        if (frame.len < 12U + prelude.data_len) {
+            break;
+        }
+
+        EventStreamMessage msg;
+        ret = eventstream_decode(
+            &prelude, gg_buffer_substr(frame, 12, 12U + prelude.data_len), &msg
+        );
+        if (ret != GG_ERR_OK) {
+            GG_LOGW("Received invalid frame from %d.", conn->fd);
+            conn_close(conn);
+            return;
+        }
+        handle_frame(conn, msg);
+        pos += 12U + prelude.data_len;
+    }
+
+    memmove(conn->in_mem, &conn->in_mem[pos], conn->in_len - pos);
+    conn->in_len -= pos;
+}
+
+static void conn_read(EmuConn *conn) {
+    while (!conn->closing) {
+        ssize_t len = read(
+            conn->fd,
+            &conn->in_mem[conn->in_len],
+            sizeof(conn->in_mem) - conn->in_len
+        );
+        if (len < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+                conn_close(conn);
+            }
+            return;
+        }
+        if (len == 0) {
+            conn_close(conn);
+            return;
+        }
+        conn->in_len += (size_t) len;
+        process_input(conn);
+    }
+}
+
+static void accept_clients(void) {
+    while (true) {
+        int fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+                GG_LOGE("Failed to accept client: %d.", errno);
+            }
+            return;
+        }
+
+        EmuConn *conn = NULL;
+        for (size_t i = 0; i < conn_count; i++) {
+            if (conns[i].fd < 0) {
+                conn = &conns[i];
+                break;
+            }
+        }
+        uint8_t *out_mem = (conn == NULL) ? NULL : malloc(EMU_OUT_BUF_LEN);
+        if (out_mem == NULL) {
+            GG_LOGW("Rejecting client: too many connections.");
+            (void) close(fd);
+            continue;
+        }
+
+        *conn = (EmuConn) { .fd = fd, .out_mem = out_mem };
+        struct epoll_event event = {
+            .events = EPOLLIN,
+            .data = { .u64 = (uint64_t) (conn - conns) },
+        };
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) == -1) {
+            GG_LOGE("Failed to add watch for %d: %d.", fd, errno);
+            free(out_mem);
+            (void) close(fd);
+            *conn = (EmuConn) { .fd = -1 };
+            continue;
+        }
+        emu_stats.connections += 1;
+    }
+}
+
+static GgError open_listener(GgBuffer path) {
+    struct sockaddr_un addr = { .sun_family = AF_UNIX, .sun_path = { 0 } };
+    if (path.len >= sizeof(addr.sun_path)) {
+        GG_LOGE("Socket path too long.");
+        return GG_ERR_RANGE;
+    }
+    memcpy(addr.sun_path, path.data, path.len);
+    memcpy(socket_path_mem, addr.sun_path, sizeof(socket_path_mem));
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd == -1) {
+        GG_LOGE("Failed to create socket: %d.", errno);
+        return GG_ERR_FAILURE;
+    }
+    if ((unlink(addr.sun_path) == -1) && (errno != ENOENT)) {
+        GG_LOGE("Failed to unlink socket path: %d.", errno);
+        return GG_ERR_FAILURE;
+    }
+    if (bind(listen_fd, (struct sockaddr *) &addr, sizeof(addr)) == -1) {
+        GG_LOGE("Failed to bind socket: %d.", errno);
+        return GG_ERR_FAILURE;
+    }
+    if (chmod(addr.sun_path, 0666) == -1) {
+        GG_LOGE("Failed to chmod socket: %d.", errno);
+        return GG_ERR_FAILURE;
+    }
+    if (listen(listen_fd, SOMAXCONN) == -1) {
+        GG_LOGE("Failed to listen on socket: %d.", errno);
+        return GG_ERR_FAILURE;
+    }
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd == -1) {
+        GG_LOGE("Failed to create epoll fd: %d.", errno);
+        return GG_ERR_FAILURE;
+    }
+    struct epoll_event event
+        = { .events = EPOLLIN, .data = { .u64 = LISTEN_DATA } };
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event) == -1) {
+        GG_LOGE("Failed to add watch for socket: %d.", errno);
+        return GG_ERR_FAILURE;
+    }
+    return GG_ERR_OK;
+}
+
+GgError emu_serve(GgBuffer socket_path, size_t max_clients) {
+    conns = calloc(max_clients, sizeof(EmuConn));
+    closing = calloc(max_clients, sizeof(EmuConn *));
+    if ((conns == NULL) || (closing == NULL)) {
+        return GG_ERR_NOMEM;
+    }
+    conn_count = max_clients;
+    for (size_t i = 0; i < conn_count; i++) {
+        conns[i].fd = -1;
+    }
+
+    GgError ret = open_listener(socket_path);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+
+    struct sigaction action = { .sa_handler = on_stop_signal };
+    (void) sigaction(SIGINT, &action, NULL);
+    (void) sigaction(SIGTERM, &action, NULL);
+
+    GG_LOGI(
+        "Serving IPC on %.*s.", (int) socket_path.len, socket_path.data
+    );
+
+    struct epoll_event events[64];
+    while (!stop_requested) {
+        int ready = epoll_wait(
+            epoll_fd, events, sizeof(events) / sizeof(events[0]), -1
+        );
+        if (ready == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            GG_LOGE("Failed to wait on epoll: %d.", errno);
+            return GG_ERR_FAILURE;
+        }
+
+        for (int i = 0; i < ready; i++) {
+            if (events[i].data.u64 == LISTEN_DATA) {
+                accept_clients();
+                continue;
+            }
+            EmuConn *conn = &conns[events[i].data.u64];
+            if ((events[i].events & EPOLLOUT) != 0) {
+                conn_flush(conn);
+            }
+            if ((events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0) {
+                conn_read(conn);
+            }
+        }
+
+        // Released after the batch, so no event refers to a reused slot
+        for (size_t i = 0; i < closing_count; i++) {
+            conn_release(closing[i]);
+        }
+        closing_count = 0;
+    }
+
+    for (size_t i = 0; i < conn_count; i++) {
+        if (conns[i].fd >= 0) {
+            conn_release(&conns[i]);
+        }
+    }
+    (void) close(epoll_fd);
+    (void) close(listen_fd);
+    (void) unlink(socket_path_mem);
+    return GG_ERR_OK;
+}
@@ -7,6 +7,7 @@
 
 //! Arena allocation
 
+#include <assert.h>
 #include <gg/attr.h>
 #include <gg/buffer.h>
 #include <gg/error.h>
@@ -35,6 +36,57 @@ inline GgArena gg_arena_init(GgBuffer buf) {
                                                          : UINT32_MAX };
 }
 
+/// Save the allocation state of an arena.
+inline GgArenaState gg_arena_save(const GgArena arena[static 1]) {
+    return (GgArenaState) { .index = arena->index };
+}
+
+/// Restore an arena to a saved state, releasing later allocations.
+/// `state` must be from this arena and no older than the last restore.
+inline void gg_arena_restore(GgArena arena[static 1], GgArenaState state) {
+    assert(state.index <= arena->index);
+    arena->index = state.index;
+}
+
+/// Arena allocator that also tracks its peak usage.
+/// Allocate from `arena`, and release memory with `gg_peak_arena_restore` so
+/// that the peak is kept. Memory released through `arena` directly, such as
+/// by shrinking with `gg_arena_resize_last`, is not tracked.
+typedef struct {
+    GgArena arena;
+    /// Highest index before memory was last released.
+    uint32_t peak;
+} GgPeakArena;
+
+/// Obtain an initialized `GgPeakArena` backed by `buf`.
+inline GgPeakArena gg_peak_arena_init(GgBuffer buf) {
+    return (GgPeakArena) { .arena = gg_arena_init(buf) };
+}
+
+/// Restore a tracked arena to a saved state, releasing later allocations.
+/// `state` must be from this arena and no older than the last restore.
+inline void gg_peak_arena_restore(
+    GgPeakArena tracked[static 1], GgArenaState state
+) {
+    if (tracked->arena.index > tracked->peak) {
+        tracked->peak = tracked->arena.index;
+    }
+    gg_arena_restore(&tracked->arena, state);
+}
+
+/// Get the most memory a tracked arena has had allocated at once, including
+/// padding. The peak is only updated when memory is released, so this adds no
+/// cost to allocation.
+inline size_t gg_peak_arena_peak(const GgPeakArena tracked[static 1]) {
+    return (tracked->arena.index > tracked->peak) ? tracked->arena.index
+                                                  : tracked->peak;
+}
+
+/// Reset a tracked arena's peak usage to its current usage.
+inline void gg_peak_arena_reset_peak(GgPeakArena tracked[static 1]) {
+    tracked->peak = tracked->arena.index;
+}
+
 /// Allocate a `type` from an arena.
 #define GG_ARENA_ALLOC(arena, type) \
     (typeof(type) *) gg_arena_alloc(arena, sizeof(type), alignof(type))
@@ -75,6 +127,37 @@ GgBuffer gg_arena_alloc_rest(GgArena *arena);
 ACCESS(read_write, 1) ACCESS(read_write, 2)
 GgError gg_arena_claim_obj(GgObject obj[static 1], GgArena *arena);
 
+/// Modify an object's references to point into an arena, with given limits.
+/// Behaves as `gg_arena_claim_obj` for objects within `limits`.
+ACCESS(read_write, 1) ACCESS(read_write, 2)
+GgError gg_arena_claim_obj_with_limits(
+    GgObject obj[static 1], GgArena *arena, GgObjectLimits limits
+);
+
+/// Modify an object's references to point into an arena in a single pass.
+/// Behaves as `gg_arena_claim_obj_with_limits`, and on success sets `used` to
+/// the exact number of arena bytes used, if not NULL.
+/// Buffer data adjacent in the source object is copied together, so claiming
+/// an object from one arena into another copies all of its buffers at once.
+ACCESS(read_write, 1) ACCESS(read_write, 2) ACCESS(write_only, 4)
+GgError gg_arena_claim_obj_measured(
+    GgObject obj[static 1], GgArena *arena, GgObjectLimits limits, size_t *used
+);
+
+/// Deep copy an object into one allocation of exactly the size needed.
+/// The object is claimed in a single pass into per-thread scratch memory, and
+/// then moved with its references relocated into memory from `alloc_fn`.
+/// `alloc_fn` is called at most once, and not if no memory is needed. It must
+/// return memory aligned as `max_align_t`, or NULL on failure.
+/// Updates `obj` in place to reference the new memory.
+/// Objects are limited as by `gg_obj_visit`.
+ACCESS(read_write, 1)
+GgError gg_obj_clone_exact(
+    GgObject obj[static 1],
+    void *(*alloc_fn)(void *ctx, size_t size),
+    void *ctx
+);
+
 /// Modify a buffer to point into an arena.
 /// Copies buffer data if not already in `arena`.
 /// Updates `buf` in place to reference the copied data.
@@ -10,6 +10,7 @@
 #include <gg/attr.h>
 #include <gg/cbmc.h>
 #include <gg/error.h>
+#include <string.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -74,7 +75,20 @@ GgBuffer gg_buffer_from_null_term(char str[static 1]);
 
 /// Returns whether two buffers have identical content.
 PURE
-bool gg_buffer_eq(GgBuffer buf1, GgBuffer buf2);
+inline bool gg_buffer_eq(GgBuffer buf1, GgBuffer buf2) {
+    if (buf1.len == buf2.len) {
+        if (buf1.len == 0) {
+            return true;
+        }
+        return memcmp(buf1.data, buf2.data, buf1.len) == 0;
+    }
+    return false;
+}
+
+/// Compares buffers bytewise; a buffer orders before any longer extension.
+/// Returns <0, 0, or >0 if buf1 is less than, equal to, or greater than buf2.
+PURE
+int gg_buffer_cmp(GgBuffer buf1, GgBuffer buf2);
 
 /// Returns whether the buffer has the given prefix.
 PURE
@@ -0,0 +1,109 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef GG_FROZEN_H
+#define GG_FROZEN_H
+
+//! Relocatable frozen object images
+//!
+//! A frozen image holds an object tree in one contiguous buffer, using
+//! offsets instead of pointers. Images can be copied, mapped, or placed in
+//! shared memory, and read in place by any thread or process on the same
+//! platform. Images contain no padding requirements and may be placed at any
+//! address.
+
+#include <gg/arena.h>
+#include <gg/attr.h>
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/object.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Reference to an object within a frozen image.
+/// Only valid for images validated by `gg_frozen_open`.
+typedef struct {
+    const uint8_t *image;
+    uint32_t record;
+} GgFrozenObject;
+
+/// Calculate the size of the frozen image of an object.
+ACCESS(write_only, 2)
+GgError gg_obj_frozen_size(GgObject obj, size_t *size);
+
+/// Serialize an object into a frozen image allocated from arena.
+/// Objects are limited as by `gg_obj_visit`.
+/// Map keys are recorded as sorted if the map is canonical, which enables
+/// binary search lookup.
+ACCESS(write_only, 3)
+GgError gg_obj_freeze(GgObject obj, GgArena *arena, GgBuffer *image);
+
+/// Validate a frozen image and get its root object.
+/// Validation checks all offsets and limits without copying, so that the
+/// other accessors can read the image directly.
+/// The image must not be modified while it is being read.
+ACCESS(write_only, 2)
+GgError gg_frozen_open(GgBuffer image, GgFrozenObject *root);
+
+/// Get type of a frozen object.
+PURE
+GgObjectType gg_frozen_type(GgFrozenObject obj);
+
+/// Get the bool represented by a frozen object.
+/// The object must be of type GG_TYPE_BOOLEAN.
+PURE
+bool gg_frozen_into_bool(GgFrozenObject obj);
+
+/// Get the i64 represented by a frozen object.
+/// The object must be of type GG_TYPE_I64.
+PURE
+int64_t gg_frozen_into_i64(GgFrozenObject obj);
+
+/// Get the f64 represented by a frozen object.
+/// The object must be of type GG_TYPE_F64.
+PURE
+double gg_frozen_into_f64(GgFrozenObject obj);
+
+/// Get the buffer represented by a frozen object.
+/// The object must be of type GG_TYPE_BUF.
+/// The result references the image, and must not be modified.
+PURE
+GgBuffer gg_frozen_into_buf(GgFrozenObject obj);
+
+/// Get the length of a frozen list or map.
+PURE
+size_t gg_frozen_len(GgFrozenObject obj);
+
+/// Get an item of a frozen list.
+/// `index` must be less than the list length.
+PURE
+GgFrozenObject gg_frozen_list_get(GgFrozenObject list, size_t index);
+
+/// Get a key of a frozen map by index.
+/// `index` must be less than the map length.
+/// The result references the image, and must not be modified.
+PURE
+GgBuffer gg_frozen_map_key(GgFrozenObject map, size_t index);
+
+/// Get a value of a frozen map by index.
+/// `index` must be less than the map length.
+PURE
+GgFrozenObject gg_frozen_map_val(GgFrozenObject map, size_t index);
+
+/// Get the value corresponding with a key in a frozen map.
+/// Returns whether the key was found in the map.
+/// If `result` is not NULL it is set to the found value.
+ACCESS(write_only, 3)
+bool gg_frozen_map_get(
+    GgFrozenObject map, GgBuffer key, GgFrozenObject *result
+);
+
+/// Convert a frozen object into a GgObject.
+/// Lists and maps are allocated from arena; buffers and keys reference the
+/// image and must not be modified.
+ACCESS(write_only, 3)
+GgError gg_frozen_thaw(GgFrozenObject obj, GgArena *arena, GgObject *result);
+
+#endif
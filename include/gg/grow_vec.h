@@ -0,0 +1,149 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef GG_GROW_VEC_H
+#define GG_GROW_VEC_H
+
+//! Growable vectors backed by an allocator
+//!
+//! Growable vectors reallocate geometrically through a `GgAlloc` as items are
+//! added. The built list, map, or buffer can be taken with the `steal`
+//! functions without copying; the caller then owns its memory, and frees it
+//! with the vector's allocator.
+//! Vectors can be moved to transfer ownership, leaving the source empty.
+//! Appended lists, maps, and buffers may point into the vector itself.
+
+#include <gg/alloc.h>
+#include <gg/attr.h>
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/object.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Growable vector of objects.
+typedef struct {
+    GgList list;
+    size_t capacity;
+    GgAlloc alloc;
+} GgObjGrowVec;
+
+/// Growable vector of map pairs.
+typedef struct {
+    GgMap map;
+    size_t capacity;
+    GgAlloc alloc;
+} GgKVGrowVec;
+
+/// Growable vector of bytes.
+typedef struct {
+    GgBuffer buf;
+    size_t capacity;
+    GgAlloc alloc;
+} GgByteGrowVec;
+
+/// Growable vector of buffers.
+typedef struct {
+    GgBufList buf_list;
+    size_t capacity;
+    GgAlloc alloc;
+} GgBufGrowVec;
+
+/// Obtain an empty growable object vector using `alloc`.
+GgObjGrowVec gg_obj_grow_vec_init(GgAlloc alloc);
+/// Ensure space for `additional` more items without reallocation.
+NONNULL(1)
+GgError gg_obj_grow_vec_reserve(GgObjGrowVec *vector, size_t additional);
+NONNULL(1)
+GgError gg_obj_grow_vec_push(GgObjGrowVec *vector, GgObject object);
+NONNULL(1, 2)
+void gg_obj_grow_vec_chain_push(
+    GgError *err, GgObjGrowVec *vector, GgObject object
+);
+NONNULL(1)
+GgError gg_obj_grow_vec_append(GgObjGrowVec *vector, GgList list);
+/// Move a vector's contents into a new vector, leaving it empty.
+NONNULL(1)
+GgObjGrowVec gg_obj_grow_vec_move(GgObjGrowVec *vector);
+/// Take ownership of a vector's list, leaving it empty.
+/// The list must be freed with the vector's allocator.
+NONNULL(1)
+GgList gg_obj_grow_vec_steal(GgObjGrowVec *vector);
+/// Free a vector's memory, leaving it empty.
+NONNULL(1)
+void gg_obj_grow_vec_free(GgObjGrowVec *vector);
+
+/// Obtain an empty growable pair vector using `alloc`.
+GgKVGrowVec gg_kv_grow_vec_init(GgAlloc alloc);
+/// Ensure space for `additional` more pairs without reallocation.
+NONNULL(1)
+GgError gg_kv_grow_vec_reserve(GgKVGrowVec *vector, size_t additional);
+NONNULL(1)
+GgError gg_kv_grow_vec_push(GgKVGrowVec *vector, GgKV kv);
+NONNULL(1, 2)
+void gg_kv_grow_vec_chain_push(GgError *err, GgKVGrowVec *vector, GgKV kv);
+NONNULL(1)
+GgError gg_kv_grow_vec_append(GgKVGrowVec *vector, GgMap map);
+/// Move a vector's contents into a new vector, leaving it empty.
+NONNULL(1)
+GgKVGrowVec gg_kv_grow_vec_move(GgKVGrowVec *vector);
+/// Take ownership of a vector's map, leaving it empty.
+/// The map's pairs must be freed with the vector's allocator.
+NONNULL(1)
+GgMap gg_kv_grow_vec_steal(GgKVGrowVec *vector);
+/// Free a vector's memory, leaving it empty.
+NONNULL(1)
+void gg_kv_grow_vec_free(GgKVGrowVec *vector);
+
+/// Obtain an empty growable byte vector using `alloc`.
+GgByteGrowVec gg_byte_grow_vec_init(GgAlloc alloc);
+/// Ensure space for `additional` more bytes without reallocation.
+NONNULL(1)
+GgError gg_byte_grow_vec_reserve(GgByteGrowVec *vector, size_t additional);
+NONNULL(1)
+GgError gg_byte_grow_vec_push(GgByteGrowVec *vector, uint8_t byte);
+NONNULL(1, 2)
+void gg_byte_grow_vec_chain_push(
+    GgError *err, GgByteGrowVec *vector, uint8_t byte
+);
+NONNULL(1)
+GgError gg_byte_grow_vec_append(GgByteGrowVec *vector, GgBuffer buf);
+NONNULL(1, 2)
+void gg_byte_grow_vec_chain_append(
+    GgError *err, GgByteGrowVec *vector, GgBuffer buf
+);
+/// Move a vector's contents into a new vector, leaving it empty.
+NONNULL(1)
+GgByteGrowVec gg_byte_grow_vec_move(GgByteGrowVec *vector);
+/// Take ownership of a vector's buffer, leaving it empty.
+/// The buffer must be freed with the vector's allocator.
+NONNULL(1)
+GgBuffer gg_byte_grow_vec_steal(GgByteGrowVec *vector);
+/// Free a vector's memory, leaving it empty.
+NONNULL(1)
+void gg_byte_grow_vec_free(GgByteGrowVec *vector);
+
+/// Obtain an empty growable buffer vector using `alloc`.
+GgBufGrowVec gg_buf_grow_vec_init(GgAlloc alloc);
+/// Ensure space for `additional` more buffers without reallocation.
+NONNULL(1)
+GgError gg_buf_grow_vec_reserve(GgBufGrowVec *vector, size_t additional);
+NONNULL(1)
+GgError gg_buf_grow_vec_push(GgBufGrowVec *vector, GgBuffer buf);
+NONNULL(1, 2)
+void gg_buf_grow_vec_chain_push(
+    GgError *err, GgBufGrowVec *vector, GgBuffer buf
+);
+/// Move a vector's contents into a new vector, leaving it empty.
+NONNULL(1)
+GgBufGrowVec gg_buf_grow_vec_move(GgBufGrowVec *vector);
+/// Take ownership of a vector's buffer list, leaving it empty.
+/// The list's buffers array must be freed with the vector's allocator.
+NONNULL(1)
+GgBufList gg_buf_grow_vec_steal(GgBufGrowVec *vector);
+/// Free a vector's memory, leaving it empty.
+NONNULL(1)
+void gg_buf_grow_vec_free(GgBufGrowVec *vector);
+
+#endif
@@ -71,6 +71,15 @@ GgError ggipc_publish_to_topic_binary(GgBuffer topic, GgBuffer payload);
 /// <https://docs.aws.amazon.com/greengrass/v2/developerguide/ipc-publish-subscribe.html#ipc-operation-publishtotopic>
 GgError ggipc_publish_to_topic_binary_b64(GgBuffer topic, GgBuffer b64_payload);
 
+/// Publish a CBOR (RFC 8949) encoded map to a local pub/sub topic.
+/// The payload is sent as a binary message; receive it with
+/// `ggipc_subscribe_to_topic_cbor`. Encoded size is limited by
+/// GG_IPC_MAX_MSG_LEN after base64 encoding.
+/// Requires aws.greengrass#PublishToTopic authorization.
+/// See:
+/// <https://docs.aws.amazon.com/greengrass/v2/developerguide/ipc-publish-subscribe.html#ipc-operation-publishtotopic>
+GgError ggipc_publish_to_topic_cbor(GgBuffer topic, GgMap payload);
+
 typedef void GgIpcSubscribeToTopicCallback(
     void *ctx, GgBuffer topic, GgObject payload, GgIpcSubscriptionHandle handle
 );
@@ -89,6 +98,24 @@ GgError ggipc_subscribe_to_topic(
     GgIpcSubscriptionHandle *handle
 );
 
+typedef void GgIpcSubscribeToTopicCborCallback(
+    void *ctx, GgBuffer topic, GgMap payload, GgIpcSubscriptionHandle handle
+);
+
+/// Subscribe to CBOR encoded maps on a local pub/sub topic.
+/// Binary messages are decoded from CBOR, and JSON messages are passed as-is.
+/// Messages that are not maps are dropped.
+/// Requires aws.greengrass#SubscribeToTopic authorization.
+/// See:
+/// <https://docs.aws.amazon.com/greengrass/v2/developerguide/ipc-publish-subscribe.html#ipc-operation-subscribetotopic>
+NONNULL(2)
+GgError ggipc_subscribe_to_topic_cbor(
+    GgBuffer topic,
+    GgIpcSubscribeToTopicCborCallback *callback,
+    void *ctx,
+    GgIpcSubscriptionHandle *handle
+);
+
 /// Publish an MQTT message to AWS IoT Core.
 /// Sends messages to AWS IoT Core MQTT broker with specified QoS.
 /// Requires aws.greengrass#PublishToIoTCore authorization.
@@ -0,0 +1,110 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef GG_IPC_STATS_H
+#define GG_IPC_STATS_H
+
+//! GG-IPC client metrics
+//!
+//! The IPC client counts calls, frames, and drops as it runs. Counters are
+//! cumulative from process start and are updated with relaxed atomics, so a
+//! snapshot taken while calls are in flight may be slightly inconsistent
+//! across counters.
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// Number of round-trip latency histogram buckets.
+#define GG_IPC_LATENCY_BUCKETS 24
+
+/// Maximum number of operations with separate metrics.
+/// Calls to further operations are only counted in the totals.
+#define GG_IPC_STATS_MAX_OPS 16
+
+/// Size of an operation name, including its null terminator.
+/// Calls to operations with longer names are only counted in the totals.
+#define GG_IPC_STATS_OP_NAME_MAX 64
+
+/// Metrics for one IPC operation.
+typedef struct {
+    /// Operation name, such as `aws.greengrass#PublishToTopic`.
+    char operation[GG_IPC_STATS_OP_NAME_MAX];
+    /// Requests sent.
+    uint64_t calls;
+    /// Calls that failed, including with an error response or timeout.
+    uint64_t errors;
+    /// Calls that timed out waiting for a response.
+    uint64_t timeouts;
+    /// Sum of round-trip times of calls that got a response.
+    uint64_t latency_ns_total;
+    /// Round-trip times of calls that got a response. Bucket 0 counts those
+    /// under 1 us, and bucket `i` those from 2^(i-1) to 2^i us. The last
+    /// bucket also counts all longer ones.
+    uint64_t latency_hist[GG_IPC_LATENCY_BUCKETS];
+} GgIpcOpStats;
+
+/// Snapshot of IPC client metrics.
+typedef struct {
+    /// Requests sent, for all operations.
+    uint64_t calls;
+    /// Calls that failed, for all operations.
+    uint64_t errors;
+    /// Calls that timed out, for all operations.
+    uint64_t timeouts;
+    /// EventStream frames written to the IPC socket.
+    uint64_t frames_sent;
+    /// Bytes written to the IPC socket.
+    uint64_t bytes_sent;
+    /// EventStream frames read from the IPC socket.
+    uint64_t frames_received;
+    /// Bytes read from the IPC socket.
+    uint64_t bytes_received;
+    /// Response and subscription payloads decoded.
+    uint64_t payloads_decoded;
+    /// Time spent decoding payloads.
+    uint64_t decode_ns_total;
+    /// Frames or payloads that failed to decode.
+    uint64_t decode_failures;
+    /// Subscription messages passed to callbacks.
+    uint64_t sub_messages;
+    /// Subscription messages dropped for not fitting in decode memory.
+    uint64_t sub_dropped_too_large;
+    /// Frames dropped for not matching an active stream.
+    uint64_t unhandled_dropped;
+    /// Number of valid entries in `ops`.
+    size_t op_count;
+    /// Per-operation metrics, in order of first call.
+    GgIpcOpStats ops[GG_IPC_STATS_MAX_OPS];
+} GgIpcStats;
+
+/// Get a snapshot of the IPC client metrics.
+void ggipc_get_stats(GgIpcStats *stats);
+
+/// Peak usage of one of the IPC client's fixed buffers.
+typedef struct {
+    /// Most bytes in use at once since process start or the last reset.
+    size_t peak;
+    /// Size of the buffer in bytes.
+    size_t capacity;
+} GgIpcBufferUsage;
+
+/// Peak usage of the IPC client's fixed buffers, for choosing the smallest
+/// `GG_IPC_MAX_MSG_LEN` and object limits that fit a component's traffic.
+typedef struct {
+    /// Frames being encoded to send; sized by `GG_IPC_MAX_MSG_LEN`.
+    GgIpcBufferUsage send_buf;
+    /// Frames being received; sized by `GG_IPC_MAX_MSG_LEN`.
+    GgIpcBufferUsage recv_buf;
+    /// Decoded response and subscription payloads; sized by
+    /// `GG_MAX_OBJECT_SUBOBJECTS`.
+    GgIpcBufferUsage decode_mem;
+} GgIpcMemoryUsage;
+
+/// Get the peak usage of the IPC client's fixed buffers.
+void ggipc_get_memory_usage(GgIpcMemoryUsage *usage);
+
+/// Reset the peak usage of the IPC client's fixed buffers to zero.
+void ggipc_reset_memory_peaks(void);
+
+#endif
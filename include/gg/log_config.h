@@ -0,0 +1,47 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef GG_LOG_CONFIG_H
+#define GG_LOG_CONFIG_H
+
+//! SDK log output configuration
+//!
+//! By default, SDK log lines are written to stderr by the logging thread.
+//! In async mode, logging threads instead record each line's format arguments
+//! in a per-thread ring buffer without locking, and a background thread
+//! formats and writes them in batches. Lines that do not fit in their
+//! thread's buffer are dropped and counted.
+//! Async mode can also be enabled by setting `GG_LOG_ASYNC=1` in the
+//! environment.
+//!
+//! Log levels can be lowered at runtime per SDK module, or per source file.
+//! Levels are configured with a comma-separated list of `[name=]level`
+//! entries, where `name` is a module name or a file name with or without its
+//! extension, and `level` is one of `none`, `error`, `warn`, `info`, `debug`,
+//! or `trace`. Entries without a name set the level for all modules, and later
+//! entries override earlier ones; for example `info,socket_epoll=trace`. The
+//! initial levels are read from `GG_LOG_LEVELS` in the environment. Levels
+//! above the one the SDK was built with have no effect.
+
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <stdint.h>
+
+/// Switch SDK logging to async mode, starting the log writer thread.
+/// Pending lines are written on `gg_log_flush` and at process exit.
+/// Error lines are written before the logging call returns.
+/// Children forked afterwards have no writer thread and log synchronously.
+GgError gg_log_start_async(void);
+
+/// Write out all log lines recorded so far.
+void gg_log_flush(void);
+
+/// Number of log lines dropped because their thread's buffer was full.
+uint64_t gg_log_dropped_count(void);
+
+/// Replace the runtime log level configuration with `spec`.
+/// Unmatched modules print every level built in.
+GgError gg_log_set_levels(GgBuffer spec);
+
+#endif
@@ -12,8 +12,10 @@
 #include <gg/error.h>
 #include <gg/flags.h>
 #include <gg/object.h>
+#include <string.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 // NOLINTBEGIN(bugprone-macro-parentheses)
 /// Loop over the KV pairs in a map.
@@ -40,13 +42,36 @@ void gg_map_canonicalize_shallow(GgMap *map);
 
 bool gg_map_is_canonical(GgMap map);
 
+/// A map whose top-level keys are known to be canonical (sorted, unique).
+/// Keys of the underlying map must not be modified while this is in use.
+typedef struct {
+    GgMap map;
+} GgSortedMap;
+
+/// Get a sorted view of a map, checking that it is canonical.
+/// Returns GG_ERR_INVALID if the map is not canonical.
+ACCESS(write_only, 2)
+GgError gg_sorted_map(GgMap map, GgSortedMap *result);
+
+/// Get the value corresponding with a key, using binary search.
+/// Returns whether the key was found in the map.
+/// If `result` is not NULL it is set to the found value or NULL.
+ACCESS(write_only, 3)
+bool gg_sorted_map_get(GgSortedMap map, GgBuffer key, GgObject **result);
+
 /// Construct a GgKV.
 CONST
 GgKV gg_kv(GgBuffer key, GgObject val);
 
 /// Get a GgKV's key.
 CONST
-GgBuffer gg_kv_key(GgKV kv);
+inline GgBuffer gg_kv_key(GgKV kv) {
+    void *ptr;
+    uint16_t len;
+    memcpy(&ptr, kv._private, sizeof(void *));
+    memcpy(&len, &kv._private[sizeof(void *)], 2);
+    return (GgBuffer) { .data = ptr, .len = len };
+}
 
 /// Set a GgKV's key.
 ACCESS(write_only, 1)
@@ -54,7 +79,10 @@ void gg_kv_set_key(GgKV *kv, GgBuffer key);
 
 /// Get a GgKV's value.
 CONST ACCESS(none, 1)
-GgObject *gg_kv_val(GgKV *kv);
+inline GgObject *gg_kv_val(GgKV *kv) {
+    // Value is stored at the end of the KV, after the key pointer and length
+    return (GgObject *) &kv->_private[sizeof(GgKV) - sizeof(GgObject)];
+}
 
 /// Entry in a map validation schema.
 typedef struct {
@@ -84,4 +112,10 @@ typedef struct {
 /// or GG_ERR_PARSE if type mismatch or MISSING key is present.
 GgError gg_map_validate(GgMap map, GgMapSchema schema);
 
+/// Validate a sorted map against a schema, as with `gg_map_validate`.
+/// Runs of schema entries in canonical key order are matched against the map
+/// in a single merge pass, so sorting the schema keys makes this
+/// O(keys + schema); entries may still be in any order.
+GgError gg_sorted_map_validate(GgSortedMap map, GgMapSchema schema);
+
 #endif
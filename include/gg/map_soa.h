@@ -0,0 +1,45 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef GG_MAP_SOA_H
+#define GG_MAP_SOA_H
+
+//! Struct-of-arrays map representation
+
+#include <gg/arena.h>
+#include <gg/attr.h>
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/object.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// A map stored as separate arrays of key lengths, key pointers, and values.
+/// Key lookups scan the dense key length array, and only touch key data for
+/// keys of matching length and values for the found key.
+typedef struct {
+    uint16_t *key_lens;
+    uint8_t **keys;
+    GgObject *values;
+    size_t len;
+} GgMapSoa;
+
+/// Convert a map to struct-of-arrays form, with arrays allocated from arena.
+/// Key data and nested objects are not copied.
+NONNULL(2) ACCESS(write_only, 3)
+GgError gg_map_soa_from_map(GgMap map, GgArena *arena, GgMapSoa *result);
+
+/// Convert a struct-of-arrays map to a GgMap, with pairs allocated from arena.
+/// Key data and nested objects are not copied.
+ACCESS(write_only, 3)
+GgError gg_map_soa_to_map(GgMapSoa map, GgArena *arena, GgMap *result);
+
+/// Get the value corresponding with a key.
+/// Returns whether the key was found in the map.
+/// If `result` is not NULL it is set to the found value or NULL.
+ACCESS(write_only, 3)
+bool gg_map_soa_get(GgMapSoa map, GgBuffer key, GgObject **result);
+
+#endif
@@ -7,9 +7,12 @@
 
 //! Generic dynamic object representation.
 
+#include <assert.h>
 #include <gg/attr.h>
 #include <gg/buffer.h>
 #include <gg/error.h>
+#include <string.h>
+#include <stdalign.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -25,10 +28,32 @@
 ///   subobject_count(map) = 2 * len + sum({pair: subobject_count(pair.value))})
 #define GG_MAX_OBJECT_SUBOBJECTS (255U)
 
+/// Size limits applied by operations that traverse an object.
+/// Limits above the defaults are supported, with traversal state allocated on
+/// the heap instead of the stack.
+typedef struct {
+    /// Maximum depth, as for `GG_MAX_OBJECT_DEPTH`. Must be at least 1.
+    size_t max_depth;
+    /// Maximum subobject count, as for `GG_MAX_OBJECT_SUBOBJECTS`.
+    size_t max_subobjects;
+} GgObjectLimits;
+
+/// Default object limits, used by operations not taking limits.
+#define GG_OBJECT_LIMITS_DEFAULT \
+    ((GgObjectLimits) { .max_depth = GG_MAX_OBJECT_DEPTH, \
+                        .max_subobjects = GG_MAX_OBJECT_SUBOBJECTS })
+
 /// A generic object.
+/// Packed to 11 bytes (9 on 32-bit platforms) by default. If the library is
+/// built with `GG_OBJECT_ALIGNED`, objects are instead 16 bytes and 16-byte
+/// aligned, trading memory for aligned field access.
 typedef struct {
     // Used only with memcpy so no aliasing with contents
+#ifdef GG_OBJECT_ALIGNED
+    alignas(16) uint8_t _private[16];
+#else
     uint8_t _private[(sizeof(void *) == 4) ? 9 : 11];
+#endif
 } GgObject;
 
 /// Type tag for `GgObject`.
@@ -52,7 +77,11 @@ typedef struct {
 /// `key` must be an UTF-8 encoded string.
 typedef struct {
     // KVs alias with pointers to their value objects
+#ifdef GG_OBJECT_ALIGNED
+    alignas(16) uint8_t _private[2 * sizeof(GgObject)];
+#else
     uint8_t _private[sizeof(void *) + 2 + sizeof(GgObject)];
+#endif
 } GgKV;
 
 /// A map of UTF-8 strings to `GgObject`s.
@@ -75,65 +104,159 @@ typedef struct {
         .len = (sizeof((GgKV[]) { __VA_ARGS__ })) / (sizeof(GgKV)) \
     }
 
+// Reports a length too long for a GgObject and clamps it.
+// Not part of the API; used by the inline object constructors.
+COLD
+void gg_obj_length_err(const char *type, size_t *len);
+
 /// Get type of an GgObject.
 CONST
-GgObjectType gg_obj_type(GgObject obj);
+inline GgObjectType gg_obj_type(GgObject obj) {
+    // Last byte is tag
+    uint8_t result = obj._private[sizeof(obj._private) - 1];
+    assert(result <= 6);
+    return (GgObjectType) result;
+}
 
 #define GG_OBJ_NULL (GgObject) { 0 }
 
 /// Create bool object.
 CONST
-GgObject gg_obj_bool(bool value);
+inline GgObject gg_obj_bool(bool value) {
+    GgObject result = { 0 };
+    memcpy(result._private, &value, sizeof(value));
+    result._private[sizeof(result._private) - 1] = GG_TYPE_BOOLEAN;
+    return result;
+}
 
 /// Get the bool represented by an object.
 /// The GgObject must be of type GG_TYPE_BOOLEAN.
 CONST
-bool gg_obj_into_bool(GgObject boolean);
+inline bool gg_obj_into_bool(GgObject boolean) {
+    assert(gg_obj_type(boolean) == GG_TYPE_BOOLEAN);
+    bool result;
+    memcpy(&result, boolean._private, sizeof(result));
+    return result;
+}
 
 /// Create signed integer object.
 CONST
-GgObject gg_obj_i64(int64_t value);
+inline GgObject gg_obj_i64(int64_t value) {
+    GgObject result = { 0 };
+    memcpy(result._private, &value, sizeof(value));
+    result._private[sizeof(result._private) - 1] = GG_TYPE_I64;
+    return result;
+}
 
 /// Get the i64 represented by an object.
 /// The GgObject must be of type GG_TYPE_I64.
 CONST
-int64_t gg_obj_into_i64(GgObject i64);
+inline int64_t gg_obj_into_i64(GgObject i64) {
+    assert(gg_obj_type(i64) == GG_TYPE_I64);
+    int64_t result;
+    memcpy(&result, i64._private, sizeof(result));
+    return result;
+}
 
 /// Create floating point object.
 CONST
-GgObject gg_obj_f64(double value);
+inline GgObject gg_obj_f64(double value) {
+    GgObject result = { 0 };
+    memcpy(result._private, &value, sizeof(value));
+    result._private[sizeof(result._private) - 1] = GG_TYPE_F64;
+    return result;
+}
 
 /// Get the f64 represented by an object.
 /// The GgObject must be of type GG_TYPE_F64.
 CONST
-double gg_obj_into_f64(GgObject f64);
+inline double gg_obj_into_f64(GgObject f64) {
+    assert(gg_obj_type(f64) == GG_TYPE_F64);
+    double result;
+    memcpy(&result, f64._private, sizeof(result));
+    return result;
+}
 
 /// Create buffer object.
 CONST
-GgObject gg_obj_buf(GgBuffer value);
+inline GgObject gg_obj_buf(GgBuffer value) {
+    if (value.len > UINT16_MAX) {
+        gg_obj_length_err("GgBuffer", &value.len);
+    }
+    uint16_t len = (uint16_t) value.len;
+
+    GgObject result = { 0 };
+    memcpy(result._private, &value.data, sizeof(void *));
+    memcpy(&result._private[sizeof(void *)], &len, 2);
+    result._private[sizeof(result._private) - 1] = GG_TYPE_BUF;
+    return result;
+}
 
 /// Get the buffer represented by an object.
 /// The GgObject must be of type GG_TYPE_BUF.
 CONST
-GgBuffer gg_obj_into_buf(GgObject buf);
+inline GgBuffer gg_obj_into_buf(GgObject buf) {
+    assert(gg_obj_type(buf) == GG_TYPE_BUF);
+    void *ptr;
+    uint16_t len;
+    memcpy(&ptr, buf._private, sizeof(void *));
+    memcpy(&len, &buf._private[sizeof(void *)], 2);
+    return (GgBuffer) { .data = ptr, .len = len };
+}
 
 /// Create map object.
 CONST
-GgObject gg_obj_map(GgMap value);
+inline GgObject gg_obj_map(GgMap value) {
+    if (value.len > UINT16_MAX) {
+        gg_obj_length_err("GgMap", &value.len);
+    }
+    uint16_t len = (uint16_t) value.len;
+
+    GgObject result = { 0 };
+    memcpy(result._private, &value.pairs, sizeof(void *));
+    memcpy(&result._private[sizeof(void *)], &len, 2);
+    result._private[sizeof(result._private) - 1] = GG_TYPE_MAP;
+    return result;
+}
 
 /// Get the map represented by an object.
 /// The GgObject must be of type GG_TYPE_MAP.
 CONST
-GgMap gg_obj_into_map(GgObject map);
+inline GgMap gg_obj_into_map(GgObject map) {
+    assert(gg_obj_type(map) == GG_TYPE_MAP);
+    void *ptr;
+    uint16_t len;
+    memcpy(&ptr, map._private, sizeof(void *));
+    memcpy(&len, &map._private[sizeof(void *)], 2);
+    return (GgMap) { .pairs = ptr, .len = len };
+}
 
 /// Create list object.
 CONST
-GgObject gg_obj_list(GgList value);
+inline GgObject gg_obj_list(GgList value) {
+    if (value.len > UINT16_MAX) {
+        gg_obj_length_err("GgList", &value.len);
+    }
+    uint16_t len = (uint16_t) value.len;
+
+    GgObject result = { 0 };
+    memcpy(result._private, &value.items, sizeof(void *));
+    memcpy(&result._private[sizeof(void *)], &len, 2);
+    result._private[sizeof(result._private) - 1] = GG_TYPE_LIST;
+    return result;
+}
 
 /// Get the list represented by an object.
 /// The GgObject must be of type GG_TYPE_LIST.
 CONST
-GgList gg_obj_into_list(GgObject list);
+inline GgList gg_obj_into_list(GgObject list) {
+    assert(gg_obj_type(list) == GG_TYPE_LIST);
+    void *ptr;
+    uint16_t len;
+    memcpy(&ptr, list._private, sizeof(void *));
+    memcpy(&len, &list._private[sizeof(void *)], 2);
+    return (GgList) { .items = ptr, .len = len };
+}
 
 /// Calculate max memory needed to claim an object.
 /// This is the max memory used by gg_arena_claim_obj on this object.
@@ -142,6 +265,12 @@ GgList gg_obj_into_list(GgObject list);
 ACCESS(write_only, 2) REPRODUCIBLE
 GgError gg_obj_mem_usage(GgObject obj, size_t *size);
 
+/// Calculate max memory needed to claim an object with given limits.
+ACCESS(write_only, 2) REPRODUCIBLE
+GgError gg_obj_mem_usage_with_limits(
+    GgObject obj, size_t *size, GgObjectLimits limits
+);
+
 /// performs a stable sort on keys of all contained GgMaps alphabetically.
 /// Orphans all duplicate same-level map keys (e.g. {"a":1,"a":2} -> {"a":1}).
 /// On success, all contained GgMaps are canonicalized.
@@ -0,0 +1,65 @@
+#!/usr/bin/env python
+"""Generates src/pow10_table.h for the JSON number parser.
+
+Each entry is the 128-bit mantissa of a power of ten, rounded down and
+normalized so that the most significant bit is set.
+"""
+
+import sys
+
+MIN_EXP10 = -342
+MAX_EXP10 = 308
+
+HEADER = """\
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef GG_POW10_TABLE_H
+#define GG_POW10_TABLE_H
+
+#include <stdint.h>
+
+// Generated by misc/gen_pow10_table.py; do not edit by hand.
+
+#define POW10_TABLE_MIN_EXP10 ({min_exp10})
+#define POW10_TABLE_MAX_EXP10 {max_exp10}
+
+/// 128-bit mantissas of powers of ten, rounded down, normalized so the most
+/// significant bit is set. Entries are {{high, low}} for 1e{min_exp10} through
+/// 1e{max_exp10}.
+static const uint64_t POW10_TABLE[][2] = {{
+"""
+
+FOOTER = """\
+};
+
+#endif
+"""
+
+
+def mantissa128(exp10):
+    num, den = (10**exp10, 1) if exp10 >= 0 else (1, 10**-exp10)
+    shift = 127 - (num.bit_length() - den.bit_length())
+    for adj in (-1, 0, 1):
+        s = shift + adj
+        m = (num << s) // den if s >= 0 else num // (den << -s)
+        if (1 << 127) <= m < (1 << 128):
+            return m
+    raise ValueError(exp10)
+
+
+def main():
+    out = sys.stdout
+    out.write(HEADER.format(min_exp10=MIN_EXP10, max_exp10=MAX_EXP10))
+    for q in range(MIN_EXP10, MAX_EXP10 + 1):
+        m = mantissa128(q)
+        out.write(
+            f"    {{ 0x{m >> 64:016X}U, 0x{m & ((1 << 64) - 1):016X}U }},"
+            f" // 1e{q}\n"
+        )
+    out.write(FOOTER)
+
+
+if __name__ == "__main__":
+    main()
@@ -88,6 +88,14 @@ GgError gg_test_expect_packet_sequence(
     GgipcPacketSequence sequence, int client_timeout
 );
 
+/// Serves the client as a minimal nucleus until it disconnects, without
+/// validating packets against a sequence. Connects are accepted, publishes are
+/// delivered to subscriptions on the same topic, and GetConfiguration returns
+/// a string as long as the decimal value of the final key. Other operations
+/// get an empty response. Intended for benchmarking the client. The client
+/// timeout is the time in seconds to wait for the next client packet.
+GgError gg_test_serve(int client_timeout);
+
 /// Hangs up on the client
 GgError gg_test_disconnect(void);
 
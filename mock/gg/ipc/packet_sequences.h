@@ -35,4 +35,16 @@ GgipcPacketSequence gg_test_mqtt_subscribe_accepted_sequence(
     size_t messages
 );
 
+/// PublishToTopic binary message request followed by accepted response
+GgipcPacketSequence gg_test_pubsub_publish_binary_accepted_sequence(
+    int32_t stream_id, GgBuffer topic, GgBuffer payload_base64
+);
+
+/// SubscribeToTopic request and response, followed by a message for each of
+/// `messages`: a JSON message for maps, or a binary message for base64
+/// buffers.
+GgipcPacketSequence gg_test_pubsub_subscribe_accepted_sequence(
+    int32_t stream_id, GgBuffer topic, GgList messages
+);
+
 #endif
@@ -11,10 +11,12 @@
 #include <gg/eventstream/rpc.h>
 #include <gg/file.h>
 #include <gg/io.h>
+#include <gg/ipc/client.h>
 #include <gg/ipc/limits.h>
 #include <gg/json_decode.h>
 #include <gg/json_encode.h>
 #include <gg/log.h>
+#include <gg/map.h>
 #include <gg/socket.h>
 #include <gg/socket_epoll.h>
 #include <gg/vector.h>
@@ -515,6 +517,350 @@ GgError gg_test_expect_packet_sequence(
     return GG_ERR_OK;
 }
 
+typedef struct {
+    int32_t stream_id;
+    uint8_t topic_mem[256];
+    size_t topic_len;
+} ServeSubscription;
+
+static uint8_t serve_send_mem[GG_IPC_MAX_MSG_LEN];
+static uint8_t serve_value_mem[GG_IPC_MAX_MSG_LEN];
+static ServeSubscription serve_subs[GG_IPC_MAX_STREAMS];
+static size_t serve_sub_count = 0;
+
+static GgError serve_send(
+    int32_t stream_id,
+    int32_t flags,
+    GgBuffer service_model_type,
+    const GgObject *payload
+) {
+    const EventStreamHeader HEADERS[] = {
+        { GG_STR(":message-type"),
+          { EVENTSTREAM_INT32, .int32 = EVENTSTREAM_APPLICATION_MESSAGE } },
+        { GG_STR(":message-flags"), { EVENTSTREAM_INT32, .int32 = flags } },
+        { GG_STR(":stream-id"), { EVENTSTREAM_INT32, .int32 = stream_id } },
+        { GG_STR(":content-type"),
+          { EVENTSTREAM_STRING, .string = GG_STR("application/json") } },
+        { GG_STR("service-model-type"),
+          { EVENTSTREAM_STRING, .string = service_model_type } },
+    };
+    GgBuffer packet = GG_BUF(serve_send_mem);
+    GgError ret = eventstream_encode(
+        &packet,
+        HEADERS,
+        sizeof(HEADERS) / sizeof(HEADERS[0]),
+        gg_json_reader(payload)
+    );
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    return gg_socket_write(client_fd, packet);
+}
+
+static GgError serve_respond(
+    int32_t stream_id, int32_t flags, GgBuffer operation, GgObject payload
+) {
+    uint8_t model_mem[128];
+    GgByteVec model = gg_byte_vec_init(GG_BUF(model_mem));
+    GgError ret = GG_ERR_OK;
+    gg_byte_vec_chain_append(&ret, &model, operation);
+    gg_byte_vec_chain_append(&ret, &model, GG_STR("Response"));
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    return serve_send(stream_id, flags, model.buf, &payload);
+}
+
+static GgError serve_connect(void) {
+    const EventStreamHeader HEADERS[] = {
+        { GG_STR(":message-type"),
+          { EVENTSTREAM_INT32, .int32 = EVENTSTREAM_CONNECT_ACK } },
+        { GG_STR(":message-flags"),
+          { EVENTSTREAM_INT32, .int32 = EVENTSTREAM_CONNECTION_ACCEPTED } },
+        { GG_STR(":stream-id"), { EVENTSTREAM_INT32, .int32 = 0 } },
+    };
+    GgBuffer packet = GG_BUF(serve_send_mem);
+    GgError ret = eventstream_encode(
+        &packet, HEADERS, sizeof(HEADERS) / sizeof(HEADERS[0]), GG_NULL_READER
+    );
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    return gg_socket_write(client_fd, packet);
+}
+
+static GgError serve_subscribe(
+    int32_t stream_id, GgBuffer operation, GgMap request
+) {
+    GgObject *topic;
+    GgError ret = gg_map_validate(
+        request,
+        GG_MAP_SCHEMA({ GG_STR("topic"), GG_REQUIRED, GG_TYPE_BUF, &topic })
+    );
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    GgBuffer topic_buf = gg_obj_into_buf(*topic);
+
+    if (serve_sub_count == GG_IPC_MAX_STREAMS) {
+        GG_LOGE("Too many subscriptions.");
+        return GG_ERR_NOMEM;
+    }
+    ServeSubscription *sub = &serve_subs[serve_sub_count];
+    if (topic_buf.len > sizeof(sub->topic_mem)) {
+        GG_LOGE("Subscription topic too long.");
+        return GG_ERR_NOMEM;
+    }
+    memcpy(sub->topic_mem, topic_buf.data, topic_buf.len);
+    sub->topic_len = topic_buf.len;
+    sub->stream_id = stream_id;
+    serve_sub_count += 1;
+
+    return serve_respond(stream_id, 0, operation, gg_obj_map((GgMap) { 0 }));
+}
+
+static void serve_unsubscribe(int32_t stream_id) {
+    for (size_t i = 0; i < serve_sub_count; i++) {
+        if (serve_subs[i].stream_id == stream_id) {
+            serve_sub_count -= 1;
+            serve_subs[i] = serve_subs[serve_sub_count];
+            return;
+        }
+    }
+}
+
+static GgError serve_publish(
+    int32_t stream_id, GgBuffer operation, GgMap request
+) {
+    GgObject *topic;
+    GgObject *publish_message;
+    GgError ret = gg_map_validate(
+        request,
+        GG_MAP_SCHEMA(
+            { GG_STR("topic"), GG_REQUIRED, GG_TYPE_BUF, &topic },
+            { GG_STR("publishMessage"),
+              GG_REQUIRED,
+              GG_TYPE_MAP,
+              &publish_message },
+        )
+    );
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    // Either a binaryMessage or a jsonMessage
+    GgMap message_map = gg_obj_into_map(*publish_message);
+    if ((message_map.len != 1)
+        || (gg_obj_type(*gg_kv_val(&message_map.pairs[0])) != GG_TYPE_MAP)) {
+        GG_LOGE("Invalid publishMessage.");
+        return GG_ERR_INVALID;
+    }
+    GgObject *message;
+    ret = gg_map_validate(
+        gg_obj_into_map(*gg_kv_val(&message_map.pairs[0])),
+        GG_MAP_SCHEMA(
+            { GG_STR("message"), GG_REQUIRED, GG_TYPE_NULL, &message },
+        )
+    );
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+
+    ret = serve_respond(
+        stream_id,
+        EVENTSTREAM_TERMINATE_STREAM,
+        operation,
+        gg_obj_map((GgMap) { 0 })
+    );
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+
+    // Delivered as published, with the context added by the nucleus
+    GgObject delivery = gg_obj_map(GG_MAP(gg_kv(
+        gg_kv_key(message_map.pairs[0]),
+        gg_obj_map(GG_MAP(
+            gg_kv(GG_STR("message"), *message),
+            gg_kv(
+                GG_STR("context"),
+                gg_obj_map(GG_MAP(gg_kv(GG_STR("topic"), *topic)))
+            )
+        ))
+    )));
+    GgBuffer topic_buf = gg_obj_into_buf(*topic);
+    for (size_t i = 0; i < serve_sub_count; i++) {
+        GgBuffer sub_topic = { .data = serve_subs[i].topic_mem,
+                               .len = serve_subs[i].topic_len };
+        if (!gg_buffer_eq(sub_topic, topic_buf)) {
+            continue;
+        }
+        ret = serve_send(
+            serve_subs[i].stream_id,
+            0,
+            GG_STR("aws.greengrass#SubscriptionResponseMessage"),
+            &delivery
+        );
+        if (ret != GG_ERR_OK) {
+            return ret;
+        }
+    }
+    return GG_ERR_OK;
+}
+
+static GgError serve_get_config(
+    int32_t stream_id, GgBuffer operation, GgMap request
+) {
+    GgObject *key_path;
+    GgError ret = gg_map_validate(
+        request,
+        GG_MAP_SCHEMA(
+            { GG_STR("keyPath"), GG_REQUIRED, GG_TYPE_LIST, &key_path },
+        )
+    );
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    GgList keys = gg_obj_into_list(*key_path);
+    if ((keys.len == 0)
+        || (gg_obj_type(keys.items[keys.len - 1]) != GG_TYPE_BUF)) {
+        GG_LOGE("GetConfiguration key path must end in a length.");
+        return GG_ERR_INVALID;
+    }
+    GgBuffer final_key = gg_obj_into_buf(keys.items[keys.len - 1]);
+    int64_t len;
+    ret = gg_str_to_int64(final_key, &len);
+    if ((ret != GG_ERR_OK) || (len < 0)
+        || ((uint64_t) len > sizeof(serve_value_mem))) {
+        GG_LOGE("GetConfiguration key path must end in a length.");
+        return GG_ERR_INVALID;
+    }
+    GgBuffer value = { .data = serve_value_mem, .len = (size_t) len };
+
+    return serve_respond(
+        stream_id,
+        EVENTSTREAM_TERMINATE_STREAM,
+        operation,
+        gg_obj_map(GG_MAP(gg_kv(
+            GG_STR("value"),
+            gg_obj_map(GG_MAP(gg_kv(final_key, gg_obj_buf(value))))
+        )))
+    );
+}
+
+static GgError serve_request(EventStreamMessage msg) {
+    EventStreamCommonHeaders common;
+    GgError ret = eventstream_get_common_headers(&msg, &common);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+
+    if (common.message_type == EVENTSTREAM_CONNECT) {
+        return serve_connect();
+    }
+    if (common.message_type != EVENTSTREAM_APPLICATION_MESSAGE) {
+        return GG_ERR_OK;
+    }
+    if ((common.message_flags & EVENTSTREAM_TERMINATE_STREAM) != 0) {
+        serve_unsubscribe(common.stream_id);
+        return GG_ERR_OK;
+    }
+
+    GgBuffer operation = { 0 };
+    EventStreamHeaderIter iter = msg.headers;
+    EventStreamHeader header;
+    while (eventstream_header_next(&iter, &header) == GG_ERR_OK) {
+        if (gg_buffer_eq(header.name, GG_STR("operation"))
+            && (header.value.type == EVENTSTREAM_STRING)) {
+            operation = header.value.string;
+        }
+    }
+
+    GgMap request = { 0 };
+    if (msg.payload.len > 0) {
+        GgArena json_arena = gg_arena_init(GG_BUF(ipc_recv_decode_mem));
+        GgObject payload_obj;
+        ret = gg_json_decode_destructive(
+            msg.payload, &json_arena, &payload_obj
+        );
+        if ((ret != GG_ERR_OK) || (gg_obj_type(payload_obj) != GG_TYPE_MAP)) {
+            GG_LOGE("Expected payload to be map");
+            return GG_ERR_INVALID;
+        }
+        request = gg_obj_into_map(payload_obj);
+    }
+
+    if (gg_buffer_eq(operation, GG_STR("aws.greengrass#SubscribeToTopic"))) {
+        return serve_subscribe(common.stream_id, operation, request);
+    }
+    if (gg_buffer_eq(operation, GG_STR("aws.greengrass#PublishToTopic"))) {
+        return serve_publish(common.stream_id, operation, request);
+    }
+    if (gg_buffer_eq(operation, GG_STR("aws.greengrass#GetConfiguration"))) {
+        return serve_get_config(common.stream_id, operation, request);
+    }
+    return serve_respond(
+        common.stream_id,
+        EVENTSTREAM_TERMINATE_STREAM,
+        operation,
+        gg_obj_map((GgMap) { 0 })
+    );
+}
+
+GgError gg_test_serve(int client_timeout) {
+    if (client_fd < 0) {
+        GgError ret = gg_test_accept_client(client_timeout);
+        if (ret != GG_ERR_OK) {
+            return ret;
+        }
+    }
+
+    GgError ret = configure_client_timeout(client_fd, client_timeout);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+
+    memset(serve_value_mem, 'x', sizeof(serve_value_mem));
+    serve_sub_count = 0;
+
+    while (true) {
+        // Read the prelude directly, as EOF here is the client disconnecting
+        GgBuffer prelude_buf = gg_buffer_substr(GG_BUF(ipc_recv_mem), 0, 12);
+        ret = gg_socket_read(client_fd, prelude_buf);
+        if (ret == GG_ERR_NODATA) {
+            return gg_test_disconnect();
+        }
+        if (ret != GG_ERR_OK) {
+            return ret;
+        }
+
+        EventStreamPrelude prelude;
+        ret = eventstream_decode_prelude(prelude_buf, &prelude);
+        if (ret != GG_ERR_OK) {
+            return ret;
+        }
+        if (prelude.data_len > sizeof(ipc_recv_mem)) {
+            GG_LOGE("EventStream packet does not fit in IPC packet buffer.");
+            return GG_ERR_NOMEM;
+        }
+        GgBuffer data_section
+            = gg_buffer_substr(GG_BUF(ipc_recv_mem), 0, prelude.data_len);
+        ret = gg_socket_read(client_fd, data_section);
+        if (ret != GG_ERR_OK) {
+            return ret;
+        }
+
+        EventStreamMessage msg;
+        ret = eventstream_decode(&prelude, data_section, &msg);
+        if (ret != GG_ERR_OK) {
+            return ret;
+        }
+        ret = serve_request(msg);
+        if (ret != GG_ERR_OK) {
+            print_client_packet(msg);
+            return ret;
+        }
+    }
+}
+
 GgError gg_test_disconnect(void) {
     if (client_fd < 0) {
         return GG_ERR_NOENTRY;
@@ -128,4 +128,23 @@ GgipcPacket gg_test_mqtt_message_packet(
     int32_t stream_id, GgBuffer topic, GgBuffer payload_base64
 );
 
+/// client->server PublishToTopic binary message request
+GgipcPacket gg_test_pubsub_publish_binary_request_packet(
+    int32_t stream_id, GgBuffer topic, GgBuffer payload_base64
+);
+
+/// server->client successful PublishToTopic response
+GgipcPacket gg_test_pubsub_publish_accepted_packet(int32_t stream_id);
+
+GgipcPacket gg_test_pubsub_subscribe_request_packet(
+    int32_t stream_id, GgBuffer topic
+);
+
+GgipcPacket gg_test_pubsub_subscribe_accepted_packet(int32_t stream_id);
+
+/// JSON message if `message` is a map, otherwise base64 binary message
+GgipcPacket gg_test_pubsub_message_packet(
+    int32_t stream_id, GgBuffer topic, GgObject message
+);
+
 #endif
@@ -0,0 +1,156 @@
+#include "gg/ipc/packet_sequences.h"
+#include "packets.h"
+#include <assert.h>
+#include <gg/arena.h>
+#include <gg/ipc/mock.h>
+#include <gg/log.h>
+#include <gg/map.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+GgipcPacket gg_test_pubsub_publish_binary_request_packet(
+    int32_t stream_id, GgBuffer topic, GgBuffer payload_base64
+) {
+    static GgKV binary_message_pairs[1];
+    binary_message_pairs[0]
+        = gg_kv(GG_STR("message"), gg_obj_buf(payload_base64));
+
+    static GgKV publish_message_pairs[1];
+    publish_message_pairs[0] = gg_kv(
+        GG_STR("binaryMessage"),
+        gg_obj_map((GgMap) { .pairs = binary_message_pairs, .len = 1 })
+    );
+
+    static GgKV pairs[2];
+    pairs[0] = gg_kv(GG_STR("topic"), gg_obj_buf(topic));
+    pairs[1] = gg_kv(
+        GG_STR("publishMessage"),
+        gg_obj_map((GgMap) { .pairs = publish_message_pairs, .len = 1 })
+    );
+    size_t pairs_len = sizeof(pairs) / sizeof(pairs[0]);
+
+    return (GgipcPacket) {
+        .direction = CLIENT_TO_SERVER,
+        .has_payload = true,
+        .payload = gg_obj_map((GgMap) { .pairs = pairs, .len = pairs_len }),
+        .headers
+        = GG_IPC_REQUEST_HEADERS(stream_id, "aws.greengrass#PublishToTopic"),
+        .header_count = GG_IPC_REQUEST_HEADERS_COUNT
+    };
+}
+
+GgipcPacket gg_test_pubsub_publish_accepted_packet(int32_t stream_id) {
+    return (GgipcPacket) { .direction = SERVER_TO_CLIENT,
+                           .has_payload = false,
+                           .headers = GG_IPC_ACCEPTED_HEADERS(
+                               stream_id, "aws.greengrass#PublishToTopic"
+                           ),
+                           .header_count = GG_IPC_ACCEPTED_HEADERS_COUNT };
+}
+
+GgipcPacketSequence gg_test_pubsub_publish_binary_accepted_sequence(
+    int32_t stream_id, GgBuffer topic, GgBuffer payload_base64
+) {
+    return (GgipcPacketSequence) {
+        .packets = { gg_test_pubsub_publish_binary_request_packet(
+                         stream_id, topic, payload_base64
+                     ),
+                     gg_test_pubsub_publish_accepted_packet(stream_id) },
+        .len = 2
+    };
+}
+
+GgipcPacket gg_test_pubsub_message_packet(
+    int32_t stream_id, GgBuffer topic, GgObject message
+) {
+    bool is_json = gg_obj_type(message) == GG_TYPE_MAP;
+
+    static GgKV context_pairs[1];
+    context_pairs[0] = gg_kv(GG_STR("topic"), gg_obj_buf(topic));
+
+    static GgKV message_pairs[2];
+    message_pairs[0] = gg_kv(GG_STR("message"), message);
+    message_pairs[1] = gg_kv(
+        GG_STR("context"),
+        gg_obj_map((GgMap) { .pairs = context_pairs, .len = 1 })
+    );
+    size_t message_pairs_len = sizeof(message_pairs) / sizeof(message_pairs[0]);
+
+    static GgKV payload_pairs[1];
+    payload_pairs[0] = gg_kv(
+        is_json ? GG_STR("jsonMessage") : GG_STR("binaryMessage"),
+        gg_obj_map((GgMap) { .pairs = message_pairs,
+                             .len = message_pairs_len })
+    );
+
+    return (GgipcPacket) {
+        .direction = SERVER_TO_CLIENT,
+        .has_payload = true,
+        .payload = gg_obj_map((GgMap) { .pairs = payload_pairs, .len = 1 }),
+        .headers = GG_IPC_SUBSCRIBE_MESSAGE_HEADERS(
+            stream_id, "aws.greengrass#SubscriptionResponseMessage"
+        ),
+        .header_count = GG_IPC_SUBSCRIBE_MESSAGE_HEADERS_COUNT,
+    };
+}
+
+GgipcPacket gg_test_pubsub_subscribe_request_packet(
+    int32_t stream_id, GgBuffer topic
+) {
+    static GgKV pairs[1];
+    pairs[0] = gg_kv(GG_STR("topic"), gg_obj_buf(topic));
+    size_t pairs_len = sizeof(pairs) / sizeof(pairs[0]);
+
+    return (GgipcPacket) { .direction = CLIENT_TO_SERVER,
+                           .has_payload = true,
+                           .payload = gg_obj_map((GgMap) { .pairs = pairs,
+                                                           .len = pairs_len }),
+                           .headers = GG_IPC_REQUEST_HEADERS(
+                               stream_id, "aws.greengrass#SubscribeToTopic"
+                           ),
+                           .header_count = GG_IPC_REQUEST_HEADERS_COUNT };
+}
+
+GgipcPacket gg_test_pubsub_subscribe_accepted_packet(int32_t stream_id) {
+    return (GgipcPacket) {
+        .direction = SERVER_TO_CLIENT,
+        .has_payload = false,
+        .headers = GG_IPC_SUBSCRIBE_MESSAGE_HEADERS(
+            stream_id, "aws.greengrass#SubscribeToTopicResponse"
+        ),
+        .header_count = GG_IPC_SUBSCRIBE_MESSAGE_HEADERS_COUNT
+    };
+}
+
+GgipcPacketSequence gg_test_pubsub_subscribe_accepted_sequence(
+    int32_t stream_id, GgBuffer topic, GgList messages
+) {
+    GgipcPacketSequence seq
+        = { .packets
+            = { gg_test_pubsub_subscribe_request_packet(stream_id, topic),
+                gg_test_pubsub_subscribe_accepted_packet(stream_id) },
+            .len = 2 };
+
+    size_t max_len = (sizeof(seq.packets) / sizeof(seq.packets[0]));
+    assert(messages.len <= (max_len - seq.len));
+
+    // Each message packet reuses the same static storage, so is copied out
+    static uint8_t mem[4096];
+    GgArena arena = gg_arena_init(GG_BUF(mem));
+
+    for (size_t i = 0; (i != messages.len) && (seq.len != max_len);
+         ++i, ++seq.len) {
+        GgipcPacket packet = gg_test_pubsub_message_packet(
+            stream_id, topic, messages.items[i]
+        );
+        if (gg_arena_claim_obj(&packet.payload, &arena) != GG_ERR_OK) {
+            GG_LOGE("Arena too small to alloc packet!");
+            _Exit(1);
+        }
+        seq.packets[seq.len] = packet;
+    }
+
+    return seq;
+}
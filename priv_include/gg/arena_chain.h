@@ -0,0 +1,80 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef GG_ARENA_CHAIN_H
+#define GG_ARENA_CHAIN_H
+
+//! Growable arena allocation over a chain of blocks
+
+#include <gg/alloc.h>
+#include <gg/arena.h>
+#include <gg/attr.h>
+#include <gg/error.h>
+#include <stdalign.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct GgArenaBlock GgArenaBlock;
+
+/// Arena allocator that grows by allocating blocks from a `GgAlloc`.
+/// Blocks released by `gg_chain_arena_restore` are kept for reuse until
+/// `gg_chain_arena_free`.
+typedef struct {
+    GgAlloc alloc;
+    uint32_t block_size;
+    /// Blocks in use, most recent first.
+    GgArenaBlock *blocks;
+    /// Released blocks available for reuse.
+    GgArenaBlock *spare;
+    /// Arena over the remaining space of the most recent block.
+    GgArena cur;
+} GgChainArena;
+
+/// Saved state of a chained arena allocator.
+typedef struct {
+    GgArenaBlock *block;
+    GgArenaState state;
+} GgChainArenaState;
+
+/// Obtain an empty chained arena.
+/// Blocks are allocated from `alloc`, with at least `block_size` capacity.
+VISIBILITY(hidden)
+GgChainArena gg_chain_arena_init(GgAlloc alloc, uint32_t block_size);
+
+/// Allocate a `type` from a chained arena.
+#define GG_CHAIN_ARENA_ALLOC(chain, type) \
+    (typeof(type) *) gg_chain_arena_alloc(chain, sizeof(type), alignof(type))
+/// Allocate `n` units of `type` from a chained arena.
+#define GG_CHAIN_ARENA_ALLOCN(chain, type, n) \
+    (typeof(type) *) gg_chain_arena_alloc( \
+        chain, (n) * sizeof(type), alignof(type) \
+    )
+
+/// Allocate `size` bytes with given alignment from a chained arena.
+/// Returns NULL only if a new block is needed and cannot be allocated.
+/// Alignment must be a power of 2.
+VISIBILITY(hidden) NONNULL(1)
+void *gg_chain_arena_alloc(GgChainArena *chain, size_t size, size_t alignment);
+
+/// Allocate a contiguous region from a chained arena as a fixed arena.
+/// Allows using APIs that take a `GgArena` with a chained arena.
+VISIBILITY(hidden) NONNULL(1, 3) ACCESS(write_only, 3)
+GgError gg_chain_arena_sub(GgChainArena *chain, size_t size, GgArena *arena);
+
+/// Save the allocation state of a chained arena.
+VISIBILITY(hidden) PURE NONNULL(1)
+GgChainArenaState gg_chain_arena_save(const GgChainArena *chain);
+
+/// Restore a chained arena to a saved state, releasing later allocations.
+/// Blocks no longer in use are kept for reuse.
+/// `state` must be from this arena and no older than the last restore.
+VISIBILITY(hidden) NONNULL(1)
+void gg_chain_arena_restore(GgChainArena *chain, GgChainArenaState state);
+
+/// Free all blocks of a chained arena, including spare blocks.
+/// The arena is left empty and may be reused.
+VISIBILITY(hidden) NONNULL(1)
+void gg_chain_arena_free(GgChainArena *chain);
+
+#endif
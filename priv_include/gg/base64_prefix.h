@@ -0,0 +1,25 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef GG_BASE64_PREFIX_H
+#define GG_BASE64_PREFIX_H
+
+//! Incremental base64 decoding
+
+#include <gg/attr.h>
+#include <gg/buffer.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Decode the longest prefix of `base64` made of complete, unpadded groups.
+/// Stops before the first group containing padding or any character outside
+/// the base64 alphabet, so it can run up to a delimiter without first
+/// finding it. `dst` must have space for (base64.len / 4) * 3 bytes, and may
+/// alias `base64.data`.
+/// Returns the number of characters consumed, a multiple of 4; three bytes
+/// are written per four characters.
+VISIBILITY(hidden) NONNULL(2)
+size_t gg_base64_decode_prefix(GgBuffer base64, uint8_t *dst);
+
+#endif
@@ -0,0 +1,27 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef GG_BASE64_VEC_H
+#define GG_BASE64_VEC_H
+
+//! Base64 encoding into byte vectors
+
+#include <gg/attr.h>
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/vector.h>
+
+/// Append the padded base64 encoding of `buf` to `vector`.
+/// Encodes directly into the vector's spare capacity, without an intermediate
+/// buffer. Returns GG_ERR_NOMEM and leaves `vector` unchanged if the encoding
+/// does not fit.
+VISIBILITY(hidden) NONNULL(1)
+GgError gg_byte_vec_append_base64(GgByteVec *vector, GgBuffer buf);
+
+VISIBILITY(hidden) NONNULL(1, 2)
+void gg_byte_vec_chain_append_base64(
+    GgError *err, GgByteVec *vector, GgBuffer buf
+);
+
+#endif
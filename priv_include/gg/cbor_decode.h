@@ -0,0 +1,36 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef GG_CBOR_DECODE_H
+#define GG_CBOR_DECODE_H
+
+//! CBOR (RFC 8949) decoding
+
+#include <gg/arena.h>
+#include <gg/attr.h>
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/object.h>
+#include <stdalign.h>
+
+/// Arena capacity sufficient to decode any CBOR item within default limits.
+#define GG_CBOR_DECODE_MAX_ALLOC \
+    (GG_MAX_OBJECT_SUBOBJECTS * sizeof(GgKV) + alignof(GgKV) - 1)
+
+/// Reads a CBOR data item from a buffer as a GgObject.
+/// Result obj may contain references into buf, and allocations from arena.
+/// Input buffer is not modified. Indefinite-length items, simple values other
+/// than booleans/null/undefined, and integers outside of int64_t are rejected.
+/// Tags are skipped. Decoded objects are limited as by `gg_obj_visit`.
+VISIBILITY(hidden)
+GgError gg_cbor_decode(GgBuffer buf, GgArena *arena, GgObject *obj);
+
+/// Reads a CBOR data item from a buffer as a GgObject, with given limits.
+/// Recursion depth is bounded by `limits.max_depth`.
+VISIBILITY(hidden)
+GgError gg_cbor_decode_with_limits(
+    GgBuffer buf, GgArena *arena, GgObject *obj, GgObjectLimits limits
+);
+
+#endif
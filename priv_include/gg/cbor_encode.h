@@ -0,0 +1,28 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef GG_CBOR_ENCODE_H
+#define GG_CBOR_ENCODE_H
+
+//! CBOR (RFC 8949) encoding
+
+#include <gg/attr.h>
+#include <gg/error.h>
+#include <gg/io.h>
+#include <gg/object.h>
+
+/// Serializes a GgObject into a buffer in CBOR encoding.
+/// Only definite-length items are produced. Buffers are encoded as text
+/// strings if they are valid UTF-8, and as byte strings otherwise. Floats are
+/// encoded as single precision if that is lossless.
+VISIBILITY(hidden)
+GgError gg_cbor_encode(GgObject obj, GgWriter writer);
+
+/// Serializes a GgObject into a buffer in CBOR encoding, with given limits.
+VISIBILITY(hidden)
+GgError gg_cbor_encode_with_limits(
+    GgObject obj, GgWriter writer, GgObjectLimits limits
+);
+
+#endif
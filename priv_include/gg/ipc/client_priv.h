@@ -9,6 +9,8 @@
 #include <gg/buffer.h>
 #include <gg/error.h>
 #include <gg/eventstream/decode.h>
+#include <gg/io.h>
+#include <gg/ipc/client_raw.h>
 #include <gg/object.h>
 
 VISIBILITY(hidden)
@@ -17,4 +19,36 @@ GgError ggipc_connect_with_payload(GgBuffer socket_path, GgObject payload);
 VISIBILITY(hidden)
 GgError ggipc_connect_extra_header_handler(EventStreamHeaderIter headers);
 
+/// Make an IPC call with request parameters serialized by `params`.
+/// `params` must produce the JSON encoding of the parameters map; it is read
+/// directly into the outgoing packet.
+VISIBILITY(hidden)
+GgError ggipc_call_with_reader(
+    GgBuffer operation,
+    GgBuffer service_model_type,
+    GgReader params,
+    GgIpcResultCallback *result_callback,
+    GgIpcErrorCallback *error_callback,
+    void *response_ctx
+);
+
+/// Subscribe as with `ggipc_subscribe`, base64 decoding the string at key
+/// path `b64_path` of each subscription message while decoding its JSON.
+/// `sub_callback` receives the decoded bytes as the value at that path.
+/// `b64_path` must remain valid for the lifetime of the subscription.
+VISIBILITY(hidden)
+GgError ggipc_subscribe_b64(
+    GgBuffer operation,
+    GgBuffer service_model_type,
+    GgMap params,
+    GgIpcResultCallback *result_callback,
+    GgIpcErrorCallback *error_callback,
+    void *response_ctx,
+    GgIpcSubscribeCallback *sub_callback,
+    void *sub_callback_ctx,
+    void *sub_callback_aux_ctx,
+    const GgBufList *b64_path,
+    GgIpcSubscriptionHandle *sub_handle
+);
+
 #endif
@@ -0,0 +1,64 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef GG_IPC_STATS_PRIV_H
+#define GG_IPC_STATS_PRIV_H
+
+//! Recording of GG-IPC client metrics
+
+#include <gg/attr.h>
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Monotonic timestamp in nanoseconds for timing calls and decodes.
+VISIBILITY(hidden)
+uint64_t ggipc_stats_now(void);
+
+/// Record a finished call to `operation` started at `start_ns`.
+/// Latency is only recorded if a response was received.
+VISIBILITY(hidden)
+void ggipc_stats_record_call(
+    GgBuffer operation, GgError ret, bool responded, uint64_t start_ns
+);
+
+VISIBILITY(hidden)
+void ggipc_stats_record_sent(size_t bytes);
+
+VISIBILITY(hidden)
+void ggipc_stats_record_received(size_t bytes);
+
+/// Record a payload decode started at `start_ns`.
+VISIBILITY(hidden)
+void ggipc_stats_record_decode(GgError ret, uint64_t start_ns);
+
+/// Record a frame that could not be decoded.
+VISIBILITY(hidden)
+void ggipc_stats_record_frame_error(void);
+
+VISIBILITY(hidden)
+void ggipc_stats_record_sub_message(void);
+
+VISIBILITY(hidden)
+void ggipc_stats_record_sub_too_large(void);
+
+VISIBILITY(hidden)
+void ggipc_stats_record_unhandled(void);
+
+/// Record bytes of the send buffer used by a frame.
+VISIBILITY(hidden)
+void ggipc_stats_record_send_buf(size_t used);
+
+/// Record bytes of the receive buffer used by a frame.
+VISIBILITY(hidden)
+void ggipc_stats_record_recv_buf(size_t used);
+
+/// Record bytes of decode memory used by a payload.
+/// Decoding only allocates, so this is the decode arena's final index.
+VISIBILITY(hidden)
+void ggipc_stats_record_decode_mem(size_t used);
+
+#endif
@@ -16,7 +16,25 @@
 /// Reads a JSON doc from a buffer as a GgObject.
 /// Result obj may contain references into buf, and allocations from alloc.
 /// Input buffer will be modified.
+/// Decoded objects are limited to the default object limits.
 VISIBILITY(hidden)
 GgError gg_json_decode_destructive(GgBuffer buf, GgArena *arena, GgObject *obj);
 
+/// Reads a JSON doc from a buffer as a GgObject, with given object limits.
+VISIBILITY(hidden)
+GgError gg_json_decode_destructive_with_limits(
+    GgBuffer buf, GgArena *arena, GgObject *obj, GgObjectLimits limits
+);
+
+/// Reads a JSON doc from a buffer as a GgObject, base64 decoding the string
+/// found by following the object keys in `b64_path`.
+/// The string is decoded in place in the same scan that validates it, and its
+/// value in the result is a buffer of the decoded bytes. A doc without a
+/// string at that path is decoded as by `gg_json_decode_destructive`.
+/// Objects along the path may have at most 16 members.
+VISIBILITY(hidden) NONNULL(4)
+GgError gg_json_decode_destructive_b64(
+    GgBuffer buf, GgBufList b64_path, GgArena *arena, GgObject *obj
+);
+
 #endif
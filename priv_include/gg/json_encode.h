@@ -16,6 +16,12 @@
 VISIBILITY(hidden)
 GgError gg_json_encode(GgObject obj, GgWriter writer);
 
+/// Serializes a GgObject into a buffer in JSON encoding, with given limits.
+VISIBILITY(hidden)
+GgError gg_json_encode_with_limits(
+    GgObject obj, GgWriter writer, GgObjectLimits limits
+);
+
 /// Reader from which a JSON-serialized object can be read.
 /// Errors if buffer is not large enough for entire object.
 VISIBILITY(hidden)
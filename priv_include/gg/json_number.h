@@ -0,0 +1,29 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef GG_JSON_NUMBER_H
+#define GG_JSON_NUMBER_H
+
+//! JSON number parsing
+
+#include <gg/attr.h>
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/object.h>
+#include <stddef.h>
+
+/// Returns the length of the longest prefix of buf that is a JSON number, or 0
+/// if buf does not start with a number.
+VISIBILITY(hidden) PURE
+size_t gg_json_number_scan(GgBuffer buf);
+
+/// Parses a JSON number literal into an i64 or f64 object.
+/// The entire buffer must be the number; it does not need to be NUL
+/// terminated. Literals without a fraction or exponent produce an i64, others
+/// produce an f64 rounded to nearest. Parsing does not depend on the locale.
+/// Returns GG_ERR_RANGE if the value does not fit in the result type.
+VISIBILITY(hidden)
+GgError gg_json_number_decode(GgBuffer str, GgObject obj[static 1]);
+
+#endif
@@ -0,0 +1,21 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef GG_JSON_STR_H
+#define GG_JSON_STR_H
+
+//! JSON string scanning
+
+#include <gg/attr.h>
+#include <gg/buffer.h>
+#include <stddef.h>
+
+/// Returns the index of the first byte in buf that cannot appear literally in
+/// a JSON string: a quote, a backslash, or a control character.
+/// Returns buf.len if there is none.
+/// Uses vector instructions when supported by the CPU.
+VISIBILITY(hidden) PURE
+size_t gg_json_str_find_special(GgBuffer buf);
+
+#endif
@@ -9,6 +9,7 @@
 
 #include <gg/attr.h>
 #include <gg/cbmc.h>
+#include <stdatomic.h>
 #include <stdint.h>
 
 /// Logging interface implementation.
@@ -37,8 +38,9 @@ static inline void gg_log_disabled(const char *format, ...) {
 #define GG_LOG_DEBUG 4
 #define GG_LOG_TRACE 5
 
-/// Minimum log level to print.
+/// Most verbose log level compiled in; lines above it are compiled out.
 /// Can be overridden from make using command line or environment.
+/// Levels up to it can be lowered at runtime with `GG_LOG_LEVELS`.
 #ifndef GG_LOG_LEVEL
 #define GG_LOG_LEVEL GG_LOG_INFO
 #endif
@@ -47,8 +49,45 @@ static inline void gg_log_disabled(const char *format, ...) {
 #define __FILE_NAME__ __FILE__
 #endif
 
+#ifndef __BASE_FILE__
+#define __BASE_FILE__ __FILE__
+#endif
+
+/// Runtime log level of a source file.
+/// Each file including this header has one, registered at startup.
+typedef struct GgLogModule {
+    const char *tag;
+    const char *file;
+    /// Most verbose level currently printed.
+    atomic_uint_least32_t max_level;
+    struct GgLogModule *next;
+} GgLogModule;
+
+/// Register a file's level state and apply the configured levels to it.
+VISIBILITY(hidden)
+void gg_log_register_module(GgLogModule *module);
+
+#ifdef GG_MODULE
+static GgLogModule gg_log_module = { .tag = GG_MODULE,
+                                     .file = __BASE_FILE__,
+                                     .max_level = GG_LOG_LEVEL };
+
+__attribute__((constructor)) static void gg_log_module_register(void) {
+    gg_log_register_module(&gg_log_module);
+}
+#else
+/// Shared by files that define GG_MODULE after including this header.
+VISIBILITY(hidden)
+extern GgLogModule gg_log_module_default;
+#define gg_log_module gg_log_module_default
+#endif
+
+/// Check the runtime level before evaluating any of the log arguments.
 #define GG_LOG(level, ...) \
-    gg_log(level, __FILE_NAME__, __LINE__, GG_MODULE, __VA_ARGS__)
+    (((uint32_t) (level) \
+      <= atomic_load_explicit(&gg_log_module.max_level, memory_order_relaxed)) \
+         ? gg_log(level, __FILE_NAME__, __LINE__, GG_MODULE, __VA_ARGS__) \
+         : (void) 0)
 
 #if GG_LOG_LEVEL >= GG_LOG_ERROR
 #define GG_LOGE(...) GG_LOG(GG_LOG_ERROR, __VA_ARGS__)
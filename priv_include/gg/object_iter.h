@@ -1,9 +1,19 @@
 #ifndef GG_OBJECT_ITER_H
 #define GG_OBJECT_ITER_H
 
+#include <assert.h>
 #include <gg/object.h>
 #include <stdint.h>
 
+static_assert(
+    GG_MAX_OBJECT_DEPTH <= UINT8_MAX,
+    "GG_MAX_OBJECT_DEPTH must fit in a uint8_t."
+);
+static_assert(
+    GG_MAX_OBJECT_SUBOBJECTS <= UINT8_MAX,
+    "GG_MAX_OBJECT_SUBOBJECTS must fit in a uint8_t."
+);
+
 typedef enum {
     LEVEL_DEFAULT,
     LEVEL_LIST,
@@ -29,6 +29,8 @@ typedef struct {
     GgError (*end_map)(void *ctx);
 } GgObjectVisitHandlers;
 
+/// Visits an object depth-first, calling handlers for each subobject.
+/// Returns GG_ERR_RANGE if the object exceeds the default object limits.
 VISIBILITY(hidden)
 GgError gg_obj_visit(
     const GgObjectVisitHandlers handlers[static 1],
@@ -36,4 +38,14 @@ GgError gg_obj_visit(
     GgObject obj[static 1]
 );
 
+/// Visits an object as `gg_obj_visit`, with the given object limits.
+/// Traversal state is heap allocated if the depth limit exceeds the default.
+VISIBILITY(hidden)
+GgError gg_obj_visit_with_limits(
+    const GgObjectVisitHandlers handlers[static 1],
+    void *ctx,
+    GgObject obj[static 1],
+    GgObjectLimits limits
+);
+
 #endif
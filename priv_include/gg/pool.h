@@ -0,0 +1,52 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef GG_POOL_H
+#define GG_POOL_H
+
+//! Size-class pool allocator
+
+#include <gg/alloc.h>
+#include <gg/attr.h>
+#include <gg/error.h>
+#include <pthread.h>
+#include <stdbool.h>
+
+/// Size of pool slabs. Allocations larger than the largest size class are
+/// made individually.
+#define GG_POOL_SLAB_SIZE (16384U)
+
+/// Number of pool size classes, in powers of 2 from 16 to 2048 bytes.
+#define GG_POOL_CLASS_COUNT (8U)
+
+typedef struct GgPoolSlab GgPoolSlab;
+typedef struct GgPoolBlock GgPoolBlock;
+
+/// Pool allocator for long-lived objects of varying size.
+/// Small allocations are served from size-class slabs with free lists, so
+/// freed memory is reused for later allocations of similar size.
+typedef struct {
+    bool shared;
+    pthread_mutex_t mtx;
+    GgPoolBlock *free_blocks[GG_POOL_CLASS_COUNT];
+    /// All slabs and individual allocations, for release on destroy.
+    GgPoolSlab *slabs;
+} GgPool;
+
+/// Initialize a pool.
+/// If `shared` is set, the pool may be used from multiple threads. Pools
+/// owned by a single thread may skip locking.
+VISIBILITY(hidden) NONNULL(1)
+GgError gg_pool_init(GgPool *pool, bool shared);
+
+/// Release all memory of a pool, including outstanding allocations.
+VISIBILITY(hidden) NONNULL(1)
+void gg_pool_destroy(GgPool *pool);
+
+/// Obtain an allocator backed by a pool.
+/// Alignment is supported up to that of `max_align_t`.
+VISIBILITY(hidden) PURE NONNULL(1)
+GgAlloc gg_pool_alloc(GgPool *pool);
+
+#endif
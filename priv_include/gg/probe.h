@@ -0,0 +1,33 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef GG_PROBE_H
+#define GG_PROBE_H
+
+//! Static tracepoints
+//!
+//! When built with `GG_USDT`, probes are USDT markers under the `gg_sdk`
+//! provider, which bpftrace, perf, and SystemTap can attach to by name. A
+//! probe that is not attached is a single nop and keeps its arguments in
+//! registers. Otherwise probes compile to nothing and their arguments are not
+//! evaluated, so arguments must be free of side effects.
+
+#ifdef GG_USDT
+#include <sys/sdt.h>
+
+#define GG_PROBE0(name) DTRACE_PROBE(gg_sdk, name)
+#define GG_PROBE1(name, a1) DTRACE_PROBE1(gg_sdk, name, a1)
+#define GG_PROBE2(name, a1, a2) DTRACE_PROBE2(gg_sdk, name, a1, a2)
+#define GG_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(gg_sdk, name, a1, a2, a3)
+#define GG_PROBE4(name, a1, a2, a3, a4) \
+    DTRACE_PROBE4(gg_sdk, name, a1, a2, a3, a4)
+#else
+#define GG_PROBE0(name) ((void) 0)
+#define GG_PROBE1(name, a1) ((void) 0)
+#define GG_PROBE2(name, a1, a2) ((void) 0)
+#define GG_PROBE3(name, a1, a2, a3) ((void) 0)
+#define GG_PROBE4(name, a1, a2, a3, a4) ((void) 0)
+#endif
+
+#endif
@@ -0,0 +1,40 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef GG_SCRATCH_H
+#define GG_SCRATCH_H
+
+//! Per-thread scratch arenas
+
+#include <gg/arena.h>
+#include <gg/arena_chain.h>
+#include <gg/attr.h>
+#include <gg/error.h>
+#include <stddef.h>
+
+/// Minimum block size of per-thread scratch arenas.
+#define GG_SCRATCH_BLOCK_SIZE (16384U)
+
+/// A borrowed region of the calling thread's scratch arena.
+typedef struct {
+    GgChainArena *chain;
+    GgChainArenaState state;
+} GgScratch;
+
+/// Borrow `size` bytes of the calling thread's scratch arena as an arena.
+/// Borrows may nest, and must be returned in reverse order on the same
+/// thread. Scratch memory is reused across borrows and freed on thread exit.
+VISIBILITY(hidden) NONNULL(2, 3) ACCESS(write_only, 2) ACCESS(write_only, 3)
+GgError gg_scratch_borrow(size_t size, GgScratch *scratch, GgArena *arena);
+
+/// Return a borrowed scratch region, releasing its allocations.
+VISIBILITY(hidden) NONNULL(1)
+void gg_scratch_return(GgScratch *scratch);
+
+/// For use with `GG_CLEANUP` to return a scratch region on scope exit.
+static inline void cleanup_gg_scratch_return(GgScratch *scratch) {
+    gg_scratch_return(scratch);
+}
+
+#endif
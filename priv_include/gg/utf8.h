@@ -0,0 +1,20 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef GG_UTF8_H
+#define GG_UTF8_H
+
+//! UTF-8 validation
+
+#include <gg/attr.h>
+#include <gg/buffer.h>
+#include <stdbool.h>
+
+/// Returns whether buf is entirely valid UTF-8 (RFC 3629).
+/// Rejects overlong encodings, surrogates, and code points above U+10FFFF.
+/// Uses vector instructions when supported by the CPU.
+VISIBILITY(hidden) PURE
+bool gg_utf8_validate(GgBuffer buf);
+
+#endif
@@ -10,6 +10,7 @@
 #include <gg/attr.h>
 #include <gg/buffer.h>
 #include <gg/error.h>
+#include <gg/grow_vec.h>
 #include <gg/io.h>
 #include <gg/object.h>
 #include <stddef.h>
@@ -102,6 +103,10 @@ GgBuffer gg_byte_vec_remaining_capacity(GgByteVec vector);
 VISIBILITY(hidden)
 GgWriter gg_byte_vec_writer(GgByteVec *byte_vec);
 
+/// Returns a writer that appends to a GgByteGrowVec
+VISIBILITY(hidden)
+GgWriter gg_byte_grow_vec_writer(GgByteGrowVec *byte_vec);
+
 typedef struct {
     GgBufList buf_list;
     size_t capacity;
@@ -0,0 +1,114 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "proxy.h"
+#include <errno.h>
+#include <gg/error.h>
+#include <math.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Fixed seed so runs are reproducible unless seeded otherwise
+static uint64_t rand_state = 0x9E3779B97F4A7C15U;
+
+void proxy_seed(uint64_t seed) {
+    rand_state = seed;
+}
+
+// splitmix64
+static uint64_t rand_next(void) {
+    rand_state += 0x9E3779B97F4A7C15U;
+    uint64_t z = rand_state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9U;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBU;
+    return z ^ (z >> 31);
+}
+
+double proxy_rand(void) {
+    return (double) (rand_next() >> 11) * 0x1.0p-53;
+}
+
+static const struct {
+    const char *name;
+    ProxyDelayKind kind;
+    size_t params;
+} DELAY_KINDS[] = {
+    { "fixed", PROXY_DELAY_FIXED, 1 },
+    { "uniform", PROXY_DELAY_UNIFORM, 2 },
+    { "exp", PROXY_DELAY_EXP, 1 },
+    { "pareto", PROXY_DELAY_PARETO, 2 },
+};
+
+GgError proxy_parse_delay(const char *arg, ProxyDelay *delay) {
+    const char *sep = strchr(arg, ':');
+    if (sep == NULL) {
+        return GG_ERR_INVALID;
+    }
+    size_t name_len = (size_t) (sep - arg);
+
+    for (size_t i = 0; i < sizeof(DELAY_KINDS) / sizeof(DELAY_KINDS[0]); i++) {
+        if ((strlen(DELAY_KINDS[i].name) != name_len)
+            || (strncmp(arg, DELAY_KINDS[i].name, name_len) != 0)) {
+            continue;
+        }
+
+        double params[2] = { 0 };
+        const char *pos = sep + 1;
+        for (size_t p = 0; p < DELAY_KINDS[i].params; p++) {
+            char *end;
+            errno = 0;
+            params[p] = strtod(pos, &end);
+            if ((errno != 0) || (end == pos) || !(params[p] >= 0.0)) {
+                return GG_ERR_INVALID;
+            }
+            bool last = p + 1 == DELAY_KINDS[i].params;
+            if (*end != (last ? '\0' : ':')) {
+                return GG_ERR_INVALID;
+            }
+            pos = end + 1;
+        }
+
+        if (((DELAY_KINDS[i].kind == PROXY_DELAY_UNIFORM)
+             && (params[1] < params[0]))
+            || ((DELAY_KINDS[i].kind == PROXY_DELAY_PARETO)
+                && (params[1] <= 0.0))) {
+            return GG_ERR_INVALID;
+        }
+        *delay = (ProxyDelay) {
+            .kind = DELAY_KINDS[i].kind,
+            .a = params[0],
+            .b = params[1],
+        };
+        return GG_ERR_OK;
+    }
+    return GG_ERR_INVALID;
+}
+
+uint64_t proxy_sample_delay_ns(ProxyDelay delay) {
+    double ms = 0.0;
+    switch (delay.kind) {
+    case PROXY_DELAY_NONE:
+        return 0;
+    case PROXY_DELAY_FIXED:
+        ms = delay.a;
+        break;
+    case PROXY_DELAY_UNIFORM:
+        ms = delay.a + ((delay.b - delay.a) * proxy_rand());
+        break;
+    case PROXY_DELAY_EXP:
+        ms = -delay.a * log1p(-proxy_rand());
+        break;
+    case PROXY_DELAY_PARETO:
+        ms = delay.a / pow(1.0 - proxy_rand(), 1.0 / delay.b);
+        break;
+    }
+    // Bound heavy tails so a sample cannot stall a connection indefinitely
+    if (ms > 60000.0) {
+        ms = 60000.0;
+    }
+    return (uint64_t) (ms * 1e6);
+}
@@ -0,0 +1,182 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+//! Forwards IPC between clients and a server such as the nucleus emulator,
+//! injecting latency and faults, to test client tail latency and timeouts.
+
+#include "proxy.h"
+#include <errno.h>
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/log_config.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+static bool parse_u64(const char *arg, uint64_t max, uint64_t *out) {
+    char *end;
+    errno = 0;
+    unsigned long long value = strtoull(arg, &end, 10);
+    if ((errno != 0) || (end == arg) || (*end != '\0') || (arg[0] == '-')
+        || (value > max)) {
+        return false;
+    }
+    *out = (uint64_t) value;
+    return true;
+}
+
+static bool parse_rate(const char *arg, double *out) {
+    char *end;
+    errno = 0;
+    double value = strtod(arg, &end);
+    if ((errno != 0) || (end == arg) || (*end != '\0') || !(value >= 0.0)
+        || (value > 1.0)) {
+        return false;
+    }
+    *out = value;
+    return true;
+}
+
+static void usage(const char *name) {
+    fprintf(
+        stderr,
+        "Usage: %s --listen PATH --upstream PATH [--max-clients N] "
+        "[--seed N]\n"
+        "    [--request-delay DIST] [--response-delay DIST] "
+        "[--fragment BYTES]\n"
+        "    [--fragment-gap US] [--bandwidth BYTES_PER_S] "
+        "[--reorder FRAMES]\n"
+        "    [--reorder-window MS] [--disconnect-after FRAMES] "
+        "[--disconnect-rate P]\n"
+        "DIST is fixed:MS, uniform:MIN:MAX, exp:MEAN, or pareto:SCALE:SHAPE.\n",
+        name
+    );
+}
+
+static bool parse_option(
+    const char *arg,
+    const char *value,
+    const char **listen_path,
+    const char **upstream_path,
+    uint64_t *max_clients,
+    ProxyFaults *faults
+) {
+    uint64_t num = 0;
+    if (strcmp(arg, "--listen") == 0) {
+        *listen_path = value;
+        return true;
+    }
+    if (strcmp(arg, "--upstream") == 0) {
+        *upstream_path = value;
+        return true;
+    }
+    if (strcmp(arg, "--max-clients") == 0) {
+        return parse_u64(value, 100000, max_clients) && (*max_clients > 0);
+    }
+    if (strcmp(arg, "--seed") == 0) {
+        if (!parse_u64(value, UINT64_MAX, &num)) {
+            return false;
+        }
+        proxy_seed(num);
+        return true;
+    }
+    if (strcmp(arg, "--request-delay") == 0) {
+        return proxy_parse_delay(value, &faults->request_delay) == GG_ERR_OK;
+    }
+    if (strcmp(arg, "--response-delay") == 0) {
+        return proxy_parse_delay(value, &faults->response_delay) == GG_ERR_OK;
+    }
+    if (strcmp(arg, "--fragment") == 0) {
+        bool ok = parse_u64(value, SIZE_MAX, &num) && (num > 0);
+        faults->fragment = (size_t) num;
+        return ok;
+    }
+    if (strcmp(arg, "--fragment-gap") == 0) {
+        bool ok = parse_u64(value, 1000000, &num);
+        faults->fragment_gap_us = (uint32_t) num;
+        return ok;
+    }
+    if (strcmp(arg, "--bandwidth") == 0) {
+        return parse_u64(value, UINT64_MAX, &faults->bandwidth)
+            && (faults->bandwidth > 0);
+    }
+    if (strcmp(arg, "--reorder") == 0) {
+        bool ok = parse_u64(value, PROXY_MAX_REORDER, &num) && (num > 1);
+        faults->reorder = (uint32_t) num;
+        return ok;
+    }
+    if (strcmp(arg, "--reorder-window") == 0) {
+        bool ok = parse_u64(value, 60000, &num);
+        faults->reorder_window_ms = (uint32_t) num;
+        return ok;
+    }
+    if (strcmp(arg, "--disconnect-after") == 0) {
+        return parse_u64(value, UINT64_MAX, &faults->disconnect_after)
+            && (faults->disconnect_after > 0);
+    }
+    if (strcmp(arg, "--disconnect-rate") == 0) {
+        return parse_rate(value, &faults->disconnect_rate);
+    }
+    return false;
+}
+
+int main(int argc, char **argv) {
+    const char *listen_path = NULL;
+    const char *upstream_path = NULL;
+    uint64_t max_clients = 64;
+    ProxyFaults faults = { .reorder_window_ms = 5 };
+
+    for (int i = 1; i < argc; i += 2) {
+        if ((i + 1 >= argc)
+            || !parse_option(
+                argv[i],
+                argv[i + 1],
+                &listen_path,
+                &upstream_path,
+                &max_clients,
+                &faults
+            )) {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if ((listen_path == NULL) || (upstream_path == NULL)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // NOLINTNEXTLINE(concurrency-mt-unsafe)
+    if (getenv("GG_LOG_LEVELS") == NULL) {
+        (void) gg_log_set_levels(GG_STR("warn"));
+    }
+
+    GgError ret = proxy_serve(
+        gg_buffer_from_null_term((char *) listen_path),
+        gg_buffer_from_null_term((char *) upstream_path),
+        (size_t) max_clients,
+        &faults
+    );
+    if (ret != GG_ERR_OK) {
+        fprintf(stderr, "Proxy failed: %s.\n", gg_strerror(ret));
+        return 1;
+    }
+
+    // Printed to stderr so output of a wrapped benchmark stays parseable
+    fprintf(
+        stderr,
+        "connections=%" PRIu64 " requests=%" PRIu64 " responses=%" PRIu64
+        " bytes=%" PRIu64 " reordered=%" PRIu64 " disconnects=%" PRIu64 "\n",
+        proxy_stats.connections,
+        proxy_stats.requests,
+        proxy_stats.responses,
+        proxy_stats.bytes,
+        proxy_stats.reordered,
+        proxy_stats.disconnects
+    );
+    return 0;
+}
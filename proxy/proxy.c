@@ -0,0 +1,678 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "proxy.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/eventstream/decode.h>
+#include <gg/eventstream/rpc.h>
+#include <gg/eventstream/types.h>
+#include <gg/ipc/limits.h>
+#include <gg/log.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/timerfd.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define LISTEN_DATA UINT64_MAX
+#define TIMER_DATA (UINT64_MAX - 1U)
+#define NEVER UINT64_MAX
+
+/// Frames queued per direction before reading from the source pauses.
+#define MAX_QUEUED 256U
+
+ProxyStats proxy_stats = { 0 };
+
+typedef struct {
+    uint8_t *data;
+    size_t len;
+    int32_t stream_id;
+    /// Earliest time the frame may be written.
+    uint64_t due_ns;
+} ProxyFrame;
+
+/// One direction of a proxied connection.
+typedef struct {
+    int *src_fd;
+    int *dst_fd;
+    bool is_response;
+    /// Received bytes not yet queued as frames.
+    uint8_t in_mem[GG_IPC_MAX_MSG_LEN];
+    size_t in_len;
+    /// Frames held for reordering, in arrival order.
+    ProxyFrame held[PROXY_MAX_REORDER];
+    size_t held_count;
+    uint64_t held_since_ns;
+    /// Ring of frames to write, in order.
+    ProxyFrame queue[MAX_QUEUED];
+    size_t queue_start;
+    size_t queue_len;
+    /// Bytes of the first queued frame already written.
+    size_t written;
+    /// Set once the first queued frame has been counted for disconnects.
+    bool counted;
+    uint64_t last_due_ns;
+    uint64_t next_write_ns;
+    double tokens;
+    uint64_t tokens_ns;
+    /// Set when the destination socket is full.
+    bool blocked;
+} ProxyPipe;
+
+typedef struct {
+    int client_fd;
+    int server_fd;
+    ProxyPipe up;
+    ProxyPipe down;
+    uint64_t frames;
+    bool closing;
+    uint32_t client_events;
+    uint32_t server_events;
+} ProxySession;
+
+static const ProxyFaults *faults;
+static ProxySession **sessions = NULL;
+static size_t session_count = 0;
+static char socket_path_mem[sizeof(((struct sockaddr_un *) NULL)->sun_path)];
+static char upstream_path_mem[sizeof(socket_path_mem)];
+static int listen_fd = -1;
+static int timer_fd = -1;
+static int epoll_fd = -1;
+static volatile sig_atomic_t stop_requested = 0;
+
+static void on_stop_signal(int sig) {
+    (void) sig;
+    stop_requested = 1;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t) ts.tv_sec * 1000000000U) + (uint64_t) ts.tv_nsec;
+}
+
+static void pipe_clear(ProxyPipe *pipe) {
+    for (size_t i = 0; i < pipe->held_count; i++) {
+        free(pipe->held[i].data);
+    }
+    for (size_t i = 0; i < pipe->queue_len; i++) {
+        free(pipe->queue[(pipe->queue_start + i) % MAX_QUEUED].data);
+    }
+}
+
+static void session_release(size_t index) {
+    ProxySession *session = sessions[index];
+    pipe_clear(&session->up);
+    pipe_clear(&session->down);
+    (void) close(session->client_fd);
+    if (session->server_fd >= 0) {
+        (void) close(session->server_fd);
+    }
+    free(session);
+    sessions[index] = NULL;
+}
+
+static void disconnect(ProxySession *session) {
+    if (!session->closing) {
+        GG_LOGI("Disconnecting client %d.", session->client_fd);
+        session->closing = true;
+        proxy_stats.disconnects += 1;
+    }
+}
+
+static void pipe_enqueue(ProxyPipe *pipe, ProxyFrame frame, uint64_t now) {
+    ProxyDelay delay = pipe->is_response ? faults->response_delay
+                                         : faults->request_delay;
+    // Frames stay in order, so a delayed frame also holds back later ones
+    frame.due_ns = now + proxy_sample_delay_ns(delay);
+    if (frame.due_ns < pipe->last_due_ns) {
+        frame.due_ns = pipe->last_due_ns;
+    }
+    pipe->last_due_ns = frame.due_ns;
+    pipe->queue[(pipe->queue_start + pipe->queue_len) % MAX_QUEUED] = frame;
+    pipe->queue_len += 1;
+}
+
+// Releases held frames in random order, keeping each stream's frames in order
+static void pipe_release_held(ProxyPipe *pipe, uint64_t now) {
+    while (pipe->held_count > 0) {
+        size_t candidates[PROXY_MAX_REORDER];
+        size_t candidate_count = 0;
+        for (size_t i = 0; i < pipe->held_count; i++) {
+            bool first = true;
+            for (size_t j = 0; j < i; j++) {
+                if (pipe->held[j].stream_id == pipe->held[i].stream_id) {
+                    first = false;
+                    break;
+                }
+            }
+            if (first) {
+                candidates[candidate_count] = i;
+                candidate_count += 1;
+            }
+        }
+
+        size_t pick
+            = candidates[(size_t) (proxy_rand() * (double) candidate_count)];
+        if (pick != 0) {
+            proxy_stats.reordered += 1;
+        }
+        pipe_enqueue(pipe, pipe->held[pick], now);
+        memmove(
+            &pipe->held[pick],
+            &pipe->held[pick + 1],
+            (pipe->held_count - pick - 1) * sizeof(ProxyFrame)
+        );
+        pipe->held_count -= 1;
+    }
+}
+
+static bool pipe_has_room(const ProxyPipe *pipe) {
+    return pipe->queue_len + pipe->held_count < MAX_QUEUED;
+}
+
+// Queues each complete frame received while there is room
+static void pipe_parse(ProxySession *session, ProxyPipe *pipe, uint64_t now) {
+    size_t pos = 0;
+    while ((pipe->in_len - pos >= 12) && pipe_has_room(pipe)) {
+        GgBuffer frame = { .data = &pipe->in_mem[pos],
+                           .len = pipe->in_len - pos };
+        EventStreamPrelude prelude;
+        GgError ret = eventstream_decode_prelude(
+            gg_buffer_substr(frame, 0, 12), &prelude
+        );
+        if ((ret != GG_ERR_OK)
+            || (prelude.data_len > sizeof(pipe->in_mem) - 12)) {
+            GG_LOGW("Received invalid frame on %d.", *pipe->src_fd);
+            disconnect(session);
+            return;
+        }
+        frame.len = 12U + prelude.data_len;
+        if (pipe->in_len - pos < frame.len) {
+            break;
+        }
+
+        EventStreamMessage msg;
+        EventStreamCommonHeaders common;
+        ret = eventstream_decode(
+            &prelude, gg_buffer_substr(frame, 12, SIZE_MAX), &msg
+        );
+        if (ret == GG_ERR_OK) {
+            ret = eventstream_get_common_headers(&msg, &common);
+        }
+        uint8_t *data = (ret == GG_ERR_OK) ? malloc(frame.len) : NULL;
+        if (data == NULL) {
+            GG_LOGW("Failed to queue frame from %d.", *pipe->src_fd);
+            disconnect(session);
+            return;
+        }
+        memcpy(data, frame.data, frame.len);
+        ProxyFrame queued = { .data = data,
+                              .len = frame.len,
+                              .stream_id = common.stream_id };
+        pos += frame.len;
+
+        if (!pipe->is_response || (faults->reorder == 0)) {
+            pipe_enqueue(pipe, queued, now);
+            continue;
+        }
+        if (pipe->held_count == 0) {
+            pipe->held_since_ns = now;
+        }
+        pipe->held[pipe->held_count] = queued;
+        pipe->held_count += 1;
+        if (pipe->held_count >= faults->reorder) {
+            pipe_release_held(pipe, now);
+        }
+    }
+
+    memmove(pipe->in_mem, &pipe->in_mem[pos], pipe->in_len - pos);
+    pipe->in_len -= pos;
+}
+
+static void pipe_read(ProxySession *session, ProxyPipe *pipe) {
+    while (!session->closing && (pipe->in_len < sizeof(pipe->in_mem))) {
+        ssize_t len = read(
+            *pipe->src_fd,
+            &pipe->in_mem[pipe->in_len],
+            sizeof(pipe->in_mem) - pipe->in_len
+        );
+        if (len < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+                disconnect(session);
+            }
+            return;
+        }
+        if (len == 0) {
+            // Either end closing ends the session, as it would for IPC
+            session->closing = true;
+            return;
+        }
+        pipe->in_len += (size_t) len;
+        pipe_parse(session, pipe, now_ns());
+    }
+}
+
+// Returns the number of bytes the bandwidth limit allows now, refilling up
+// to 10ms worth of tokens
+static size_t pipe_allowance(ProxyPipe *pipe, size_t want, uint64_t now) {
+    if (faults->bandwidth == 0) {
+        return want;
+    }
+    double rate = (double) faults->bandwidth;
+    double burst = (rate / 100.0 > 1.0) ? rate / 100.0 : 1.0;
+    pipe->tokens += (double) (now - pipe->tokens_ns) * rate / 1e9;
+    if (pipe->tokens > burst) {
+        pipe->tokens = burst;
+    }
+    pipe->tokens_ns = now;
+    size_t allowed = (size_t) pipe->tokens;
+    return (allowed < want) ? allowed : want;
+}
+
+// Writes queued frames that are due, returning when it should next be called
+static uint64_t pipe_flush(ProxySession *session, ProxyPipe *pipe) {
+    while (!session->closing && !pipe->blocked && (pipe->queue_len > 0)) {
+        uint64_t now = now_ns();
+        ProxyFrame *frame = &pipe->queue[pipe->queue_start];
+        if (frame->due_ns > now) {
+            return frame->due_ns;
+        }
+        if (pipe->next_write_ns > now) {
+            return pipe->next_write_ns;
+        }
+
+        // Retries after throttling or a full socket must not count again
+        if (!pipe->counted) {
+            pipe->counted = true;
+            session->frames += 1;
+            if (((faults->disconnect_after != 0)
+                 && (session->frames > faults->disconnect_after))
+                || ((faults->disconnect_rate > 0.0)
+                    && (proxy_rand() < faults->disconnect_rate))) {
+                disconnect(session);
+                return NEVER;
+            }
+        }
+
+        size_t want = frame->len - pipe->written;
+        if ((faults->fragment != 0) && (want > faults->fragment)) {
+            want = faults->fragment;
+        }
+        want = pipe_allowance(pipe, want, now);
+        if (want == 0) {
+            double rate = (double) faults->bandwidth;
+            return now + (uint64_t) ((1.0 - pipe->tokens) * 1e9 / rate) + 1U;
+        }
+
+        ssize_t sent = send(
+            *pipe->dst_fd, &frame->data[pipe->written], want, MSG_NOSIGNAL
+        );
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+                pipe->blocked = true;
+                return NEVER;
+            }
+            disconnect(session);
+            return NEVER;
+        }
+
+        pipe->written += (size_t) sent;
+        proxy_stats.bytes += (uint64_t) sent;
+        if (faults->bandwidth != 0) {
+            pipe->tokens -= (double) sent;
+        }
+        if (faults->fragment_gap_us != 0) {
+            pipe->next_write_ns = now + (faults->fragment_gap_us * 1000ULL);
+        }
+        if (pipe->written == frame->len) {
+            free(frame->data);
+            pipe->queue_start = (pipe->queue_start + 1) % MAX_QUEUED;
+            pipe->queue_len -= 1;
+            pipe->written = 0;
+            pipe->counted = false;
+            if (pipe->is_response) {
+                proxy_stats.responses += 1;
+            } else {
+                proxy_stats.requests += 1;
+            }
+        }
+    }
+    return NEVER;
+}
+
+static void session_watch(ProxySession *session, size_t index, bool server) {
+    int fd = server ? session->server_fd : session->client_fd;
+    ProxyPipe *src = server ? &session->down : &session->up;
+    ProxyPipe *dst = server ? &session->up : &session->down;
+    uint32_t *current
+        = server ? &session->server_events : &session->client_events;
+
+    uint32_t events = 0;
+    if ((src->in_len < sizeof(src->in_mem)) && pipe_has_room(src)) {
+        events |= EPOLLIN;
+    }
+    if (dst->blocked) {
+        events |= EPOLLOUT;
+    }
+    if (events == *current) {
+        return;
+    }
+    struct epoll_event event = {
+        .events = events,
+        .data = { .u64 = ((uint64_t) index << 1) | (server ? 1U : 0U) },
+    };
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &event) == -1) {
+        GG_LOGE("Failed to update watch for %d: %d.", fd, errno);
+        disconnect(session);
+        return;
+    }
+    *current = events;
+}
+
+// Advances a session, returning when it should next be serviced
+static uint64_t session_service(ProxySession *session, size_t index) {
+    uint64_t now = now_ns();
+    uint64_t next = NEVER;
+    ProxyPipe *pipes[] = { &session->up, &session->down };
+    for (size_t i = 0; i < 2; i++) {
+        ProxyPipe *pipe = pipes[i];
+        if (pipe->held_count > 0) {
+            uint64_t release_ns = pipe->held_since_ns
+                + (faults->reorder_window_ms * 1000000ULL);
+            if (release_ns <= now) {
+                pipe_release_held(pipe, now);
+            } else if (release_ns < next) {
+                next = release_ns;
+            }
+        }
+        // Parses frames left over once the queue had filled
+        pipe_parse(session, pipe, now);
+        uint64_t flush_ns = pipe_flush(session, pipe);
+        if (flush_ns < next) {
+            next = flush_ns;
+        }
+    }
+    if (!session->closing) {
+        session_watch(session, index, false);
+        session_watch(session, index, true);
+    }
+    return next;
+}
+
+static GgError connect_upstream(int *fd) {
+    struct sockaddr_un addr = { .sun_family = AF_UNIX, .sun_path = { 0 } };
+    memcpy(addr.sun_path, upstream_path_mem, sizeof(addr.sun_path));
+    *fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (*fd == -1) {
+        GG_LOGE("Failed to create socket: %d.", errno);
+        return GG_ERR_FAILURE;
+    }
+    if (connect(*fd, (struct sockaddr *) &addr, sizeof(addr)) == -1) {
+        GG_LOGE("Failed to connect to upstream: %d.", errno);
+        return GG_ERR_NOCONN;
+    }
+    int flags = fcntl(*fd, F_GETFL);
+    if ((flags == -1) || (fcntl(*fd, F_SETFL, flags | O_NONBLOCK) == -1)) {
+        GG_LOGE("Failed to make upstream socket non-blocking: %d.", errno);
+        return GG_ERR_FAILURE;
+    }
+    return GG_ERR_OK;
+}
+
+static GgError session_open(size_t index, int client_fd) {
+    ProxySession *session = calloc(1, sizeof(ProxySession));
+    if (session == NULL) {
+        return GG_ERR_NOMEM;
+    }
+    *session = (ProxySession) { .client_fd = client_fd, .server_fd = -1 };
+    sessions[index] = session;
+    session->up = (ProxyPipe) { .src_fd = &session->client_fd,
+                                .dst_fd = &session->server_fd,
+                                .tokens_ns = now_ns() };
+    session->down = (ProxyPipe) { .src_fd = &session->server_fd,
+                                  .dst_fd = &session->client_fd,
+                                  .is_response = true,
+                                  .tokens_ns = now_ns() };
+
+    GgError ret = connect_upstream(&session->server_fd);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    for (size_t side = 0; side < 2; side++) {
+        int fd = (side == 0) ? session->client_fd : session->server_fd;
+        struct epoll_event event = {
+            .events = EPOLLIN,
+            .data = { .u64 = ((uint64_t) index << 1) | side },
+        };
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) == -1) {
+            GG_LOGE("Failed to add watch for %d: %d.", fd, errno);
+            return GG_ERR_FAILURE;
+        }
+    }
+    session->client_events = EPOLLIN;
+    session->server_events = EPOLLIN;
+    proxy_stats.connections += 1;
+    return GG_ERR_OK;
+}
+
+static void accept_clients(void) {
+    while (true) {
+        int fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+                GG_LOGE("Failed to accept client: %d.", errno);
+            }
+            return;
+        }
+
+        size_t index = session_count;
+        for (size_t i = 0; i < session_count; i++) {
+            if (sessions[i] == NULL) {
+                index = i;
+                break;
+            }
+        }
+        if (index == session_count) {
+            GG_LOGW("Rejecting client: too many connections.");
+            (void) close(fd);
+            continue;
+        }
+
+        if (session_open(index, fd) != GG_ERR_OK) {
+            if (sessions[index] == NULL) {
+                (void) close(fd);
+            } else {
+                session_release(index);
+            }
+        }
+    }
+}
+
+static GgError open_listener(GgBuffer path) {
+    struct sockaddr_un addr = { .sun_family = AF_UNIX, .sun_path = { 0 } };
+    memcpy(addr.sun_path, path.data, path.len);
+    memcpy(socket_path_mem, addr.sun_path, sizeof(socket_path_mem));
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd == -1) {
+        GG_LOGE("Failed to create socket: %d.", errno);
+        return GG_ERR_FAILURE;
+    }
+    if ((unlink(addr.sun_path) == -1) && (errno != ENOENT)) {
+        GG_LOGE("Failed to unlink socket path: %d.", errno);
+        return GG_ERR_FAILURE;
+    }
+    if (bind(listen_fd, (struct sockaddr *) &addr, sizeof(addr)) == -1) {
+        GG_LOGE("Failed to bind socket: %d.", errno);
+        return GG_ERR_FAILURE;
+    }
+    if (listen(listen_fd, SOMAXCONN) == -1) {
+        GG_LOGE("Failed to listen on socket: %d.", errno);
+        return GG_ERR_FAILURE;
+    }
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if ((epoll_fd == -1) || (timer_fd == -1)) {
+        GG_LOGE("Failed to create epoll or timer fd: %d.", errno);
+        return GG_ERR_FAILURE;
+    }
+    struct epoll_event event
+        = { .events = EPOLLIN, .data = { .u64 = LISTEN_DATA } };
+    struct epoll_event timer_event
+        = { .events = EPOLLIN, .data = { .u64 = TIMER_DATA } };
+    if ((epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event) == -1)
+        || (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &timer_event) == -1)) {
+        GG_LOGE("Failed to add watch: %d.", errno);
+        return GG_ERR_FAILURE;
+    }
+    return GG_ERR_OK;
+}
+
+static void arm_timer(uint64_t deadline_ns) {
+    // A zero value disarms the timer
+    struct itimerspec spec = { 0 };
+    if (deadline_ns != NEVER) {
+        spec.it_value = (struct timespec) {
+            .tv_sec = (time_t) (deadline_ns / 1000000000U),
+            .tv_nsec = (long) (deadline_ns % 1000000000U),
+        };
+        if ((spec.it_value.tv_sec == 0) && (spec.it_value.tv_nsec == 0)) {
+            spec.it_value.tv_nsec = 1;
+        }
+    }
+    if (timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &spec, NULL) == -1) {
+        GG_LOGE("Failed to arm timer: %d.", errno);
+    }
+}
+
+static void handle_event(struct epoll_event event) {
+    if (event.data.u64 == LISTEN_DATA) {
+        accept_clients();
+        return;
+    }
+    if (event.data.u64 == TIMER_DATA) {
+        uint64_t expirations;
+        (void) read(timer_fd, &expirations, sizeof(expirations));
+        return;
+    }
+
+    ProxySession *session = sessions[event.data.u64 >> 1];
+    if ((session == NULL) || session->closing) {
+        return;
+    }
+    bool server = (event.data.u64 & 1U) != 0;
+    if ((event.events & EPOLLOUT) != 0) {
+        (server ? &session->up : &session->down)->blocked = false;
+    }
+    if ((event.events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0) {
+        pipe_read(session, server ? &session->down : &session->up);
+    }
+}
+
+GgError proxy_serve(
+    GgBuffer listen_path,
+    GgBuffer upstream_path,
+    size_t max_clients,
+    const ProxyFaults *proxy_faults
+) {
+    if ((listen_path.len >= sizeof(socket_path_mem))
+        || (upstream_path.len >= sizeof(upstream_path_mem))) {
+        GG_LOGE("Socket path too long.");
+        return GG_ERR_RANGE;
+    }
+    memcpy(upstream_path_mem, upstream_path.data, upstream_path.len);
+    faults = proxy_faults;
+
+    sessions = calloc(max_clients, sizeof(ProxySession *));
+    if (sessions == NULL) {
+        return GG_ERR_NOMEM;
+    }
+    session_count = max_clients;
+
+    GgError ret = open_listener(listen_path);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+
+    struct sigaction action = { .sa_handler = on_stop_signal };
+    (void) sigaction(SIGINT, &action, NULL);
+    (void) sigaction(SIGTERM, &action, NULL);
+
+    GG_LOGI(
+        "Proxying %.*s to %.*s.",
+        (int) listen_path.len,
+        listen_path.data,
+        (int) upstream_path.len,
+        upstream_path.data
+    );
+
+    struct epoll_event events[64];
+    while (!stop_requested) {
+        int ready = epoll_wait(
+            epoll_fd, events, sizeof(events) / sizeof(events[0]), -1
+        );
+        if (ready == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            GG_LOGE("Failed to wait on epoll: %d.", errno);
+            return GG_ERR_FAILURE;
+        }
+        for (int i = 0; i < ready; i++) {
+            handle_event(events[i]);
+        }
+
+        // Faults are timed, so every session is serviced on each wakeup
+        uint64_t next = NEVER;
+        for (size_t i = 0; i < session_count; i++) {
+            if ((sessions[i] == NULL) || sessions[i]->closing) {
+                continue;
+            }
+            uint64_t session_next = session_service(sessions[i], i);
+            if (session_next < next) {
+                next = session_next;
+            }
+        }
+        for (size_t i = 0; i < session_count; i++) {
+            if ((sessions[i] != NULL) && sessions[i]->closing) {
+                session_release(i);
+            }
+        }
+        arm_timer(next);
+    }
+
+    for (size_t i = 0; i < session_count; i++) {
+        if (sessions[i] != NULL) {
+            session_release(i);
+        }
+    }
+    (void) close(timer_fd);
+    (void) close(epoll_fd);
+    (void) close(listen_fd);
+    (void) unlink(socket_path_mem);
+    return GG_ERR_OK;
+}
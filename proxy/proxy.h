@@ -0,0 +1,94 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef GG_PROXY_H
+#define GG_PROXY_H
+
+//! IPC proxy injecting latency and faults between clients and a server
+
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Maximum frames held for reordering.
+#define PROXY_MAX_REORDER 64U
+
+typedef enum {
+    PROXY_DELAY_NONE,
+    /// `a` milliseconds.
+    PROXY_DELAY_FIXED,
+    /// Uniform between `a` and `b` milliseconds.
+    PROXY_DELAY_UNIFORM,
+    /// Exponential with mean `a` milliseconds.
+    PROXY_DELAY_EXP,
+    /// Pareto with scale `a` milliseconds and shape `b`, for heavy tails.
+    PROXY_DELAY_PARETO,
+} ProxyDelayKind;
+
+typedef struct {
+    ProxyDelayKind kind;
+    double a;
+    double b;
+} ProxyDelay;
+
+/// Faults applied to each proxied connection.
+typedef struct {
+    /// Delay of frames from client to server.
+    ProxyDelay request_delay;
+    /// Delay of frames from server to client.
+    ProxyDelay response_delay;
+    /// Bytes per write, or 0 to write frames whole.
+    size_t fragment;
+    /// Microseconds between fragments.
+    uint32_t fragment_gap_us;
+    /// Bytes per second in each direction, or 0 for unlimited.
+    uint64_t bandwidth;
+    /// Frames from server to client held and released shuffled across
+    /// streams, or 0 to not reorder.
+    uint32_t reorder;
+    /// Milliseconds a frame may be held waiting for others to reorder with.
+    uint32_t reorder_window_ms;
+    /// Frames forwarded before disconnecting, or 0 to not disconnect.
+    uint64_t disconnect_after;
+    /// Chance of disconnecting before forwarding each frame.
+    double disconnect_rate;
+} ProxyFaults;
+
+/// Counters printed on exit.
+typedef struct {
+    uint64_t connections;
+    uint64_t requests;
+    uint64_t responses;
+    uint64_t bytes;
+    uint64_t reordered;
+    uint64_t disconnects;
+} ProxyStats;
+
+extern ProxyStats proxy_stats;
+
+/// Parse a delay distribution such as `fixed:2`, `uniform:1:5`, `exp:2`, or
+/// `pareto:1:1.5`, in milliseconds.
+GgError proxy_parse_delay(const char *arg, ProxyDelay *delay);
+
+/// Seed the random source used for faults, for reproducible runs.
+void proxy_seed(uint64_t seed);
+
+/// Uniform random value in [0, 1).
+double proxy_rand(void);
+
+/// Sample a delay in nanoseconds.
+uint64_t proxy_sample_delay_ns(ProxyDelay delay);
+
+/// Accept clients on `listen_path`, connecting each to `upstream_path`, until
+/// interrupted.
+GgError proxy_serve(
+    GgBuffer listen_path,
+    GgBuffer upstream_path,
+    size_t max_clients,
+    const ProxyFaults *faults
+);
+
+#endif
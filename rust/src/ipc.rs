@@ -647,6 +647,42 @@ impl Sdk {
         })
     }
 
+    /// Get a snapshot of the IPC client metrics.
+    ///
+    /// # Examples
+    ///
+    /// ```no_run
+    /// use gg_sdk::Sdk;
+    ///
+    /// let sdk = Sdk::init();
+    /// let stats = sdk.ipc_stats();
+    /// for op in stats.operations() {
+    ///     let _ = (op.operation(), op.calls(), op.errors());
+    /// }
+    /// ```
+    #[must_use]
+    pub fn ipc_stats(&self) -> IpcStats {
+        let mut stats = c::GgIpcStats::default();
+        unsafe { c::ggipc_get_stats(&raw mut stats) };
+        IpcStats(stats)
+    }
+
+    /// Get the peak usage of the IPC client's fixed buffers.
+    ///
+    /// Use with a representative workload to choose the smallest
+    /// `GG_IPC_MAX_MSG_LEN` and object limits that fit.
+    #[must_use]
+    pub fn ipc_memory_usage(&self) -> IpcMemoryUsage {
+        let mut usage = c::GgIpcMemoryUsage::default();
+        unsafe { c::ggipc_get_memory_usage(&raw mut usage) };
+        IpcMemoryUsage(usage)
+    }
+
+    /// Reset the peak usage of the IPC client's fixed buffers to zero.
+    pub fn reset_ipc_memory_peaks(&self) {
+        unsafe { c::ggipc_reset_memory_peaks() };
+    }
+
     /// Make a generic IPC call.
     ///
     /// Low-level interface for invoking IPC operations not covered by specific methods.
@@ -856,6 +892,179 @@ impl Sdk {
     }
 }
 
+/// Metrics for one IPC operation.
+#[derive(Debug, Clone, Copy)]
+#[repr(transparent)]
+pub struct IpcOperationStats(c::GgIpcOpStats);
+
+impl IpcOperationStats {
+    /// Operation name, such as `aws.greengrass#PublishToTopic`.
+    #[must_use]
+    pub fn operation(&self) -> &str {
+        let name = unsafe { ffi::CStr::from_ptr(self.0.operation.as_ptr()) };
+        name.to_str().unwrap_or_default()
+    }
+
+    /// Requests sent.
+    #[must_use]
+    pub fn calls(&self) -> u64 {
+        self.0.calls
+    }
+
+    /// Calls that failed, including with an error response or timeout.
+    #[must_use]
+    pub fn errors(&self) -> u64 {
+        self.0.errors
+    }
+
+    /// Calls that timed out waiting for a response.
+    #[must_use]
+    pub fn timeouts(&self) -> u64 {
+        self.0.timeouts
+    }
+
+    /// Sum of round-trip times of calls that got a response, in nanoseconds.
+    #[must_use]
+    pub fn latency_ns_total(&self) -> u64 {
+        self.0.latency_ns_total
+    }
+
+    /// Round-trip times of calls that got a response.
+    ///
+    /// Bucket 0 counts those under 1 us, and bucket `i` those from 2^(i-1) to
+    /// 2^i us. The last bucket also counts all longer ones.
+    #[must_use]
+    pub fn latency_histogram(&self) -> &[u64] {
+        &self.0.latency_hist
+    }
+}
+
+/// Snapshot of IPC client metrics.
+///
+/// Counters are cumulative from process start.
+#[derive(Debug, Clone, Copy)]
+pub struct IpcStats(c::GgIpcStats);
+
+impl IpcStats {
+    /// Requests sent, for all operations.
+    #[must_use]
+    pub fn calls(&self) -> u64 {
+        self.0.calls
+    }
+
+    /// Calls that failed, for all operations.
+    #[must_use]
+    pub fn errors(&self) -> u64 {
+        self.0.errors
+    }
+
+    /// Calls that timed out, for all operations.
+    #[must_use]
+    pub fn timeouts(&self) -> u64 {
+        self.0.timeouts
+    }
+
+    /// `EventStream` frames written to the IPC socket.
+    #[must_use]
+    pub fn frames_sent(&self) -> u64 {
+        self.0.frames_sent
+    }
+
+    /// Bytes written to the IPC socket.
+    #[must_use]
+    pub fn bytes_sent(&self) -> u64 {
+        self.0.bytes_sent
+    }
+
+    /// `EventStream` frames read from the IPC socket.
+    #[must_use]
+    pub fn frames_received(&self) -> u64 {
+        self.0.frames_received
+    }
+
+    /// Bytes read from the IPC socket.
+    #[must_use]
+    pub fn bytes_received(&self) -> u64 {
+        self.0.bytes_received
+    }
+
+    /// Response and subscription payloads decoded.
+    #[must_use]
+    pub fn payloads_decoded(&self) -> u64 {
+        self.0.payloads_decoded
+    }
+
+    /// Time spent decoding payloads, in nanoseconds.
+    #[must_use]
+    pub fn decode_ns_total(&self) -> u64 {
+        self.0.decode_ns_total
+    }
+
+    /// Frames or payloads that failed to decode.
+    #[must_use]
+    pub fn decode_failures(&self) -> u64 {
+        self.0.decode_failures
+    }
+
+    /// Subscription messages passed to callbacks.
+    #[must_use]
+    pub fn sub_messages(&self) -> u64 {
+        self.0.sub_messages
+    }
+
+    /// Subscription messages dropped for not fitting in decode memory.
+    #[must_use]
+    pub fn sub_dropped_too_large(&self) -> u64 {
+        self.0.sub_dropped_too_large
+    }
+
+    /// Frames dropped for not matching an active stream.
+    #[must_use]
+    pub fn unhandled_dropped(&self) -> u64 {
+        self.0.unhandled_dropped
+    }
+
+    /// Per-operation metrics, in order of first call.
+    #[must_use]
+    pub fn operations(&self) -> &[IpcOperationStats] {
+        let ops = &self.0.ops[..self.0.op_count];
+        unsafe {
+            slice::from_raw_parts(
+                ops.as_ptr().cast::<IpcOperationStats>(),
+                ops.len(),
+            )
+        }
+    }
+}
+
+/// Peak usage of the IPC client's fixed buffers.
+///
+/// Each entry is `(peak, capacity)` in bytes, with the peak since process
+/// start or the last reset.
+#[derive(Debug, Clone, Copy)]
+pub struct IpcMemoryUsage(c::GgIpcMemoryUsage);
+
+impl IpcMemoryUsage {
+    /// Frames being encoded to send; sized by `GG_IPC_MAX_MSG_LEN`.
+    #[must_use]
+    pub fn send_buf(&self) -> (usize, usize) {
+        (self.0.send_buf.peak, self.0.send_buf.capacity)
+    }
+
+    /// Frames being received; sized by `GG_IPC_MAX_MSG_LEN`.
+    #[must_use]
+    pub fn recv_buf(&self) -> (usize, usize) {
+        (self.0.recv_buf.peak, self.0.recv_buf.capacity)
+    }
+
+    /// Decoded response and subscription payloads; sized by
+    /// `GG_MAX_OBJECT_SUBOBJECTS`.
+    #[must_use]
+    pub fn decode_mem(&self) -> (usize, usize) {
+        (self.0.decode_mem.peak, self.0.decode_mem.capacity)
+    }
+}
+
 /// Handle for an active IPC subscription.
 #[derive(Debug)]
 pub struct Subscription<'a, T> {
@@ -900,3 +1109,38 @@ fn key_path_to_buf_list(
         len: key_path.len(),
     })
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn ipc_stats_start_empty() {
+        let stats = Sdk {}.ipc_stats();
+        assert_eq!(stats.calls(), 0);
+        assert_eq!(stats.errors(), 0);
+        assert_eq!(stats.timeouts(), 0);
+        assert_eq!(stats.frames_sent(), 0);
+        assert_eq!(stats.bytes_received(), 0);
+        assert_eq!(stats.sub_messages(), 0);
+        assert!(stats.operations().is_empty());
+    }
+
+    #[test]
+    fn ipc_memory_usage_reports_capacity() {
+        let sdk = Sdk {};
+        sdk.reset_ipc_memory_peaks();
+        let usage = sdk.ipc_memory_usage();
+        let (send_peak, send_capacity) = usage.send_buf();
+        assert_eq!(send_peak, 0);
+        assert!(send_capacity > 0);
+        assert_eq!(usage.recv_buf(), (0, send_capacity));
+        assert_eq!(
+            usage.decode_mem(),
+            (
+                0,
+                c::GG_MAX_OBJECT_SUBOBJECTS as usize * size_of::<c::GgObject>()
+            )
+        );
+    }
+}
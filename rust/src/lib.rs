@@ -15,6 +15,7 @@ mod object;
 
 pub use error::{Error, Result};
 pub use ipc::{
-    ComponentState, Qos, Sdk, SubscribeToTopicPayload, Subscription,
+    ComponentState, IpcMemoryUsage, IpcOperationStats, IpcStats, Qos, Sdk,
+    SubscribeToTopicPayload, Subscription,
 };
 pub use object::{Kv, List, Map, Object, UnpackedObject};
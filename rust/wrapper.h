@@ -4,6 +4,7 @@
 
 #include <gg/ipc/client.h>
 #include <gg/ipc/client_raw.h>
+#include <gg/ipc/stats.h>
 #include <gg/map.h>
 #include <gg/sdk.h>
 #include <time.h>
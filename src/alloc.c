@@ -2,9 +2,17 @@
 // Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
 // SPDX-License-Identifier: Apache-2.0
 
+#include <assert.h>
 #include <gg/alloc.h>
+#include <gg/error.h>
 #include <gg/log.h>
+#include <gg/pool.h>
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
 
 void *gg_alloc(GgAlloc alloc, size_t size, size_t alignment) {
     void *ret = NULL;
@@ -41,3 +49,295 @@ void gg_free(GgAlloc alloc, void *ptr) {
         alloc.VTABLE->FREE(alloc.ctx, ptr);
     }
 }
+
+static void *libc_alloc(void *ctx, size_t size, size_t alignment) {
+    (void) ctx;
+    if (alignment <= alignof(max_align_t)) {
+        return malloc(size);
+    }
+    // aligned_alloc requires size to be a multiple of alignment
+    size_t rounded = (size + alignment - 1) & ~(alignment - 1);
+    if (rounded < size) {
+        return NULL;
+    }
+    return aligned_alloc(alignment, rounded);
+}
+
+static void libc_free(void *ctx, void *ptr) {
+    (void) ctx;
+    free(ptr);
+}
+
+GgAlloc gg_libc_alloc(void) {
+    static const GgAllocVtable LIBC_ALLOC_VTABLE = {
+        .ALLOC = libc_alloc,
+        .FREE = libc_free,
+    };
+    return (GgAlloc) { .VTABLE = &LIBC_ALLOC_VTABLE, .ctx = NULL };
+}
+
+struct GgPoolBlock {
+    GgPoolBlock *next;
+};
+
+// Size class of headers of individual allocations
+#define POOL_CLASS_LARGE UINT32_MAX
+#define POOL_MIN_CLASS_SIZE (16U)
+
+// Header of a slab, or of an individual allocation larger than the size
+// classes. Both are aligned to the slab size, so masking a pointer from either
+// finds its header.
+struct GgPoolSlab {
+    GgPoolSlab *next;
+    GgPoolSlab *prev;
+    uint32_t size_class;
+    alignas(max_align_t) uint8_t mem[];
+};
+
+static_assert(
+    POOL_MIN_CLASS_SIZE >= sizeof(GgPoolBlock),
+    "Pool blocks must be able to hold a free list link."
+);
+static_assert(
+    (GG_POOL_SLAB_SIZE & (GG_POOL_SLAB_SIZE - 1)) == 0,
+    "Pool slab size must be a power of 2."
+);
+
+static size_t pool_class_size(uint32_t size_class) {
+    return (size_t) POOL_MIN_CLASS_SIZE << size_class;
+}
+
+static void pool_lock(GgPool *pool) {
+    if (pool->shared) {
+        pthread_mutex_lock(&pool->mtx);
+    }
+}
+
+static void pool_unlock(GgPool *pool) {
+    if (pool->shared) {
+        pthread_mutex_unlock(&pool->mtx);
+    }
+}
+
+// Slabs are aligned to their size, so a block's slab is found by masking.
+static GgPoolSlab *pool_slab_of(const void *ptr) {
+    return (GgPoolSlab *) ((uintptr_t) ptr
+                           & ~(uintptr_t) (GG_POOL_SLAB_SIZE - 1));
+}
+
+static void pool_link_slab(GgPool *pool, GgPoolSlab *slab) {
+    slab->prev = NULL;
+    slab->next = pool->slabs;
+    if (pool->slabs != NULL) {
+        pool->slabs->prev = slab;
+    }
+    pool->slabs = slab;
+}
+
+static GgPoolSlab *pool_new_slab(GgPool *pool, uint32_t size_class) {
+    GgPoolSlab *slab
+        = gg_alloc(gg_libc_alloc(), GG_POOL_SLAB_SIZE, GG_POOL_SLAB_SIZE);
+    if (slab == NULL) {
+        return NULL;
+    }
+    slab->size_class = size_class;
+    pool_link_slab(pool, slab);
+    return slab;
+}
+
+static void *pool_alloc_large(GgPool *pool, size_t size) {
+    if (size > SIZE_MAX - offsetof(GgPoolSlab, mem)) {
+        return NULL;
+    }
+    // Unlike aligned_alloc, posix_memalign does not round the size up to a
+    // multiple of the alignment, so the allocation does not pin whole slabs.
+    size_t alloc_size = offsetof(GgPoolSlab, mem) + size;
+    void *mem = NULL;
+    if (posix_memalign(&mem, GG_POOL_SLAB_SIZE, alloc_size) != 0) {
+        GG_LOGW("Failed to alloc %zu bytes for pool.", alloc_size);
+        return NULL;
+    }
+    GgPoolSlab *large = mem;
+    large->size_class = POOL_CLASS_LARGE;
+    pool_link_slab(pool, large);
+    return large->mem;
+}
+
+static void *pool_alloc_locked(GgPool *pool, size_t size) {
+    uint32_t size_class = 0;
+    while ((size_class < GG_POOL_CLASS_COUNT)
+           && (pool_class_size(size_class) < size)) {
+        size_class += 1;
+    }
+
+    if (size_class == GG_POOL_CLASS_COUNT) {
+        return pool_alloc_large(pool, size);
+    }
+
+    GgPoolBlock *block = pool->free_blocks[size_class];
+    if (block == NULL) {
+        GgPoolSlab *slab = pool_new_slab(pool, size_class);
+        if (slab == NULL) {
+            return NULL;
+        }
+        size_t block_size = pool_class_size(size_class);
+        size_t count
+            = (GG_POOL_SLAB_SIZE - offsetof(GgPoolSlab, mem)) / block_size;
+        // Link in address order, so consecutive allocations are adjacent
+        for (size_t i = count; i > 0; i--) {
+            GgPoolBlock *new_block
+                = (GgPoolBlock *) &slab->mem[(i - 1) * block_size];
+            new_block->next = block;
+            block = new_block;
+        }
+    }
+
+    pool->free_blocks[size_class] = block->next;
+    return block;
+}
+
+static void *pool_alloc(void *ctx, size_t size, size_t alignment) {
+    GgPool *pool = ctx;
+    if (alignment > alignof(max_align_t)) {
+        GG_LOGE("Pool allocation alignment %zu not supported.", alignment);
+        return NULL;
+    }
+
+    pool_lock(pool);
+    void *ret = pool_alloc_locked(pool, size);
+    pool_unlock(pool);
+    return ret;
+}
+
+static void pool_free(void *ctx, void *ptr) {
+    GgPool *pool = ctx;
+    GgPoolSlab *slab = pool_slab_of(ptr);
+
+    pool_lock(pool);
+    if (slab->size_class == POOL_CLASS_LARGE) {
+        assert(ptr == slab->mem);
+        if (slab->prev != NULL) {
+            slab->prev->next = slab->next;
+        } else {
+            pool->slabs = slab->next;
+        }
+        if (slab->next != NULL) {
+            slab->next->prev = slab->prev;
+        }
+        pool_unlock(pool);
+        gg_free(gg_libc_alloc(), slab);
+        return;
+    }
+
+    assert(slab->size_class < GG_POOL_CLASS_COUNT);
+    GgPoolBlock *block = ptr;
+    block->next = pool->free_blocks[slab->size_class];
+    pool->free_blocks[slab->size_class] = block;
+    pool_unlock(pool);
+}
+
+GgError gg_pool_init(GgPool *pool, bool shared) {
+    *pool = (GgPool) { .shared = shared };
+    if (shared && (pthread_mutex_init(&pool->mtx, NULL) != 0)) {
+        GG_LOGE("Failed to initialize pool mutex.");
+        return GG_ERR_FAILURE;
+    }
+    return GG_ERR_OK;
+}
+
+void gg_pool_destroy(GgPool *pool) {
+    GgPoolSlab *slab = pool->slabs;
+    while (slab != NULL) {
+        GgPoolSlab *next = slab->next;
+        gg_free(gg_libc_alloc(), slab);
+        slab = next;
+    }
+    if (pool->shared) {
+        pthread_mutex_destroy(&pool->mtx);
+    }
+    *pool = (GgPool) { 0 };
+}
+
+GgAlloc gg_pool_alloc(GgPool *pool) {
+    static const GgAllocVtable POOL_ALLOC_VTABLE = {
+        .ALLOC = pool_alloc,
+        .FREE = pool_free,
+    };
+    return (GgAlloc) { .VTABLE = &POOL_ALLOC_VTABLE, .ctx = pool };
+}
+
+#ifdef GG_SDK_TESTING
+
+#include <gg/map.h>
+#include <gg/object.h>
+#include <gg/test.h>
+#include <string.h>
+#include <unity.h>
+
+GG_TEST_DEFINE(pool_alloc_reuse) {
+    GgPool pool;
+    GG_TEST_ASSERT_OK(gg_pool_init(&pool, true));
+    GgAlloc alloc = gg_pool_alloc(&pool);
+
+    GgObject *items = GG_ALLOCN(alloc, GgObject, 3);
+    GgKV *pairs = GG_ALLOCN(alloc, GgKV, 5);
+    uint8_t *str = GG_ALLOCN(alloc, uint8_t, 7);
+    TEST_ASSERT_NOT_NULL(items);
+    TEST_ASSERT_NOT_NULL(pairs);
+    TEST_ASSERT_NOT_NULL(str);
+    TEST_ASSERT_EQUAL(0, (uintptr_t) items % alignof(GgObject));
+    TEST_ASSERT_EQUAL(0, (uintptr_t) pairs % alignof(GgKV));
+
+    // Freed blocks are reused by allocations of the same size class
+    gg_free(alloc, pairs);
+    GgKV *pairs_again = GG_ALLOCN(alloc, GgKV, 5);
+    TEST_ASSERT_EQUAL_PTR(pairs, pairs_again);
+
+    uint8_t *large = GG_ALLOCN(alloc, uint8_t, 3 * GG_POOL_SLAB_SIZE);
+    TEST_ASSERT_NOT_NULL(large);
+    large[3 * GG_POOL_SLAB_SIZE - 1] = 1;
+    gg_free(alloc, large);
+
+    TEST_ASSERT_NULL(gg_alloc(alloc, 8, 2 * alignof(max_align_t)));
+
+    gg_free(alloc, items);
+    gg_free(alloc, str);
+    gg_free(alloc, pairs_again);
+    gg_pool_destroy(&pool);
+    TEST_ASSERT_NULL(pool.slabs);
+}
+
+GG_TEST_DEFINE(pool_alloc_large_individual) {
+    GgPool pool;
+    GG_TEST_ASSERT_OK(gg_pool_init(&pool, false));
+    GgAlloc alloc = gg_pool_alloc(&pool);
+
+    // Just over the largest size class
+    uint8_t *large = GG_ALLOCN(alloc, uint8_t, 2100);
+    TEST_ASSERT_NOT_NULL(large);
+    TEST_ASSERT_EQUAL(0, (uintptr_t) large % alignof(max_align_t));
+    memset(large, 0xFF, 2100);
+
+    TEST_ASSERT_EQUAL_PTR(
+        large - offsetof(GgPoolSlab, mem), pool_slab_of(large)
+    );
+
+    // Blocks next to filled blocks still return to their class
+    uint8_t *first = GG_ALLOCN(alloc, uint8_t, 64);
+    uint8_t *second = GG_ALLOCN(alloc, uint8_t, 64);
+    TEST_ASSERT_EQUAL_PTR(first + 64, second);
+    memset(first, 0xFF, 64);
+    gg_free(alloc, second);
+    TEST_ASSERT_EQUAL_PTR(second, GG_ALLOCN(alloc, uint8_t, 64));
+
+    gg_free(alloc, large);
+    TEST_ASSERT_EQUAL_PTR(pool_slab_of(first), pool.slabs);
+    TEST_ASSERT_NULL(pool.slabs->next);
+
+    // Outstanding individual allocations are released on destroy
+    TEST_ASSERT_NOT_NULL(GG_ALLOCN(alloc, uint8_t, 4096));
+    gg_pool_destroy(&pool);
+    TEST_ASSERT_NULL(pool.slabs);
+}
+
+#endif
@@ -3,20 +3,31 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <assert.h>
+#include <gg/alloc.h>
 #include <gg/arena.h>
 #include <gg/buffer.h>
+#include <gg/cleanup.h>
 #include <gg/error.h>
 #include <gg/log.h>
 #include <gg/map.h>
 #include <gg/object.h>
-#include <gg/object_visit.h>
+#include <gg/scratch.h>
 #include <inttypes.h>
+#include <stdalign.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
-// NOLINTNEXTLINE(readability-redundant-declaration)
+// NOLINTBEGIN(readability-redundant-declaration)
 extern inline typeof(gg_arena_init) gg_arena_init;
+extern inline typeof(gg_arena_save) gg_arena_save;
+extern inline typeof(gg_arena_restore) gg_arena_restore;
+extern inline typeof(gg_peak_arena_init) gg_peak_arena_init;
+extern inline typeof(gg_peak_arena_restore) gg_peak_arena_restore;
+extern inline typeof(gg_peak_arena_peak) gg_peak_arena_peak;
+extern inline typeof(gg_peak_arena_reset_peak) gg_peak_arena_reset_peak;
+// NOLINTEND(readability-redundant-declaration)
 
 void *gg_arena_alloc(GgArena *arena, size_t size, size_t alignment) {
     if (arena == NULL) {
@@ -30,8 +41,10 @@ void *gg_arena_alloc(GgArena *arena, size_t size, size_t alignment) {
     // Allocation can't exceed ptrdiff_t, and this is likely a bug.
     assert(size <= PTRDIFF_MAX);
 
-    uint32_t align = (uint32_t) alignment;
-    uint32_t pad = (align - (arena->index & (align - 1))) & (align - 1);
+    // Pad relative to the address, as the arena buffer may be less aligned
+    uintptr_t addr = (uintptr_t) arena->mem + arena->index;
+    uint32_t pad = (uint32_t) ((alignment - (addr & (alignment - 1)))
+                               & (alignment - 1));
 
     if (pad > 0) {
         GG_LOGD("[%p] Need %" PRIu32 " padding.", arena, pad);
@@ -143,74 +156,511 @@ GgError gg_arena_claim_buf(GgBuffer buf[static 1], GgArena *arena) {
     return GG_ERR_OK;
 }
 
-static GgError claim_buf(void *ctx, GgBuffer val, GgObject obj[static 1]) {
-    GgArena *arena = ctx;
-    GgError ret = gg_arena_claim_buf(&val, arena);
-    *obj = gg_obj_buf(val);
-    return ret;
+typedef struct {
+    GgArena *arena;
+    // Lists and maps not in the arena are copied if set
+    bool copy_containers;
+    // Buffer copies are deferred so that data adjacent in both source and
+    // destination is copied with one memcpy.
+    const uint8_t *pending_src;
+    uint8_t *pending_dst;
+    size_t pending_len;
+    // If set, arena offsets of claimed references are recorded here
+    uint32_t *sites;
+    size_t sites_len;
+} ClaimCtx;
+
+typedef struct {
+    // Points into the arena if containers are copied
+    void *elems;
+    size_t len;
+    size_t index;
+    bool is_map;
+} ClaimLevel;
+
+static void claim_flush(ClaimCtx ctx[static 1]) {
+    if (ctx->pending_len > 0) {
+        memcpy(ctx->pending_dst, ctx->pending_src, ctx->pending_len);
+        ctx->pending_len = 0;
+    }
+}
+
+static void claim_record_site(ClaimCtx ctx[static 1], const void *ref) {
+    if (ctx->sites != NULL) {
+        assert(ctx->sites_len < GG_MAX_OBJECT_SUBOBJECTS);
+        ctx->sites[ctx->sites_len] = (uint32_t) ((uintptr_t) ref
+                                                 - (uintptr_t) ctx->arena->mem);
+        ctx->sites_len += 1;
+    }
 }
 
-static GgError claim_list(void *ctx, GgList val, GgObject obj[static 1]) {
-    GgArena *arena = ctx;
-    if (gg_arena_owns(arena, val.items)) {
+static GgError claim_deferred_buf(
+    ClaimCtx ctx[static 1], GgBuffer buf[static 1]
+) {
+    if (gg_arena_owns(ctx->arena, buf->data)) {
         return GG_ERR_OK;
     }
-    if (val.len == 0) {
-        *obj = gg_obj_list((GgList) { 0 });
+
+    if (buf->len == 0) {
+        buf->data = NULL;
         return GG_ERR_OK;
     }
-    GgObject *new_mem = GG_ARENA_ALLOCN(arena, GgObject, val.len);
-    if (new_mem == NULL) {
-        GG_LOGE("Insufficient memory when cloning list into %p.", arena);
+
+    // Byte allocations need no padding, so bump the index directly
+    GgArena *arena = ctx->arena;
+    if ((arena == NULL) || (buf->len > arena->capacity - arena->index)) {
+        GG_LOGE("Insufficient memory when cloning buffer into %p.", arena);
         return GG_ERR_NOMEM;
     }
-    memcpy(new_mem, val.items, val.len * sizeof(GgObject));
-    *obj = gg_obj_list((GgList) { .items = new_mem, .len = val.len });
+    uint8_t *new_mem = &arena->mem[arena->index];
+    arena->index += (uint32_t) buf->len;
+
+    if ((ctx->pending_len > 0)
+        && (buf->data == &ctx->pending_src[ctx->pending_len])
+        && (new_mem == &ctx->pending_dst[ctx->pending_len])) {
+        ctx->pending_len += buf->len;
+    } else {
+        claim_flush(ctx);
+        ctx->pending_src = buf->data;
+        ctx->pending_dst = new_mem;
+        ctx->pending_len = buf->len;
+    }
+
+    buf->data = new_mem;
     return GG_ERR_OK;
 }
 
-static GgError claim_map(void *ctx, GgMap val, GgObject obj[static 1]) {
-    GgArena *arena = ctx;
-    if (gg_arena_owns(arena, val.pairs)) {
-        return GG_ERR_OK;
+// Copies a container's elements in bulk if needed, and sets up a level to
+// claim the copied elements in place.
+static GgError claim_enter(
+    ClaimCtx ctx[static 1],
+    GgObject obj[static 1],
+    size_t remaining_subobjects[static 1],
+    ClaimLevel level[static 1]
+) {
+    bool is_map = gg_obj_type(*obj) == GG_TYPE_MAP;
+    void *elems;
+    size_t len;
+    size_t elem_size;
+    size_t elem_align;
+    if (is_map) {
+        GgMap map = gg_obj_into_map(*obj);
+        elems = map.pairs;
+        len = map.len;
+        elem_size = sizeof(GgKV);
+        elem_align = alignof(GgKV);
+        if (len > *remaining_subobjects / 2) {
+            GG_LOGE("Claimed object's subobjects exceeds maximum.");
+            return GG_ERR_RANGE;
+        }
+        *remaining_subobjects -= len * 2;
+    } else {
+        GgList list = gg_obj_into_list(*obj);
+        elems = list.items;
+        len = list.len;
+        elem_size = sizeof(GgObject);
+        elem_align = alignof(GgObject);
+        if (len > *remaining_subobjects) {
+            GG_LOGE("Claimed object's subobjects exceeds maximum.");
+            return GG_ERR_RANGE;
+        }
+        *remaining_subobjects -= len;
+    }
+
+    if (ctx->copy_containers && !gg_arena_owns(ctx->arena, elems)) {
+        void *new_mem = NULL;
+        if (len > 0) {
+            new_mem = gg_arena_alloc(ctx->arena, len * elem_size, elem_align);
+            if (new_mem == NULL) {
+                GG_LOGE(
+                    "Insufficient memory when cloning %s into %p.",
+                    is_map ? "map" : "list",
+                    ctx->arena
+                );
+                return GG_ERR_NOMEM;
+            }
+            memcpy(new_mem, elems, len * elem_size);
+        }
+        elems = new_mem;
+        *obj = is_map ? gg_obj_map((GgMap) { .pairs = elems, .len = len })
+                      : gg_obj_list((GgList) { .items = elems, .len = len });
+    }
+
+    *level = (ClaimLevel) { .elems = elems, .len = len, .is_map = is_map };
+    return GG_ERR_OK;
+}
+
+static GgError claim_levels(
+    ClaimCtx ctx[static 1],
+    GgObject obj[static 1],
+    GgObjectLimits limits,
+    ClaimLevel levels[static 1]
+) {
+    size_t remaining_subobjects = limits.max_subobjects;
+    GgError ret = claim_enter(ctx, obj, &remaining_subobjects, &levels[0]);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+
+    size_t depth = 0;
+    while (true) {
+        ClaimLevel *level = &levels[depth];
+        if (level->index == level->len) {
+            if (depth == 0) {
+                return GG_ERR_OK;
+            }
+            depth -= 1;
+            continue;
+        }
+
+        if (depth + 1 == limits.max_depth) {
+            GG_LOGE("Claimed object's depth exceeds maximum.");
+            return GG_ERR_RANGE;
+        }
+
+        GgObject *elem;
+        if (level->is_map) {
+            GgKV *kv = &((GgKV *) level->elems)[level->index];
+            claim_record_site(ctx, kv);
+            GgBuffer key = gg_kv_key(*kv);
+            ret = claim_deferred_buf(ctx, &key);
+            if (ret != GG_ERR_OK) {
+                return ret;
+            }
+            gg_kv_set_key(kv, key);
+            elem = gg_kv_val(kv);
+        } else {
+            elem = &((GgObject *) level->elems)[level->index];
+        }
+        level->index += 1;
+
+        switch (gg_obj_type(*elem)) {
+        case GG_TYPE_BUF: {
+            claim_record_site(ctx, elem);
+            GgBuffer buf = gg_obj_into_buf(*elem);
+            ret = claim_deferred_buf(ctx, &buf);
+            if (ret != GG_ERR_OK) {
+                return ret;
+            }
+            *elem = gg_obj_buf(buf);
+        } break;
+        case GG_TYPE_LIST:
+        case GG_TYPE_MAP:
+            claim_record_site(ctx, elem);
+            ret = claim_enter(
+                ctx, elem, &remaining_subobjects, &levels[depth + 1]
+            );
+            if (ret != GG_ERR_OK) {
+                return ret;
+            }
+            depth += 1;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+static GgError claim_with_levels(
+    ClaimCtx ctx[static 1], GgObject obj[static 1], GgObjectLimits limits
+) {
+    switch (gg_obj_type(*obj)) {
+    case GG_TYPE_BUF: {
+        GgBuffer buf = gg_obj_into_buf(*obj);
+        GgError ret = claim_deferred_buf(ctx, &buf);
+        *obj = gg_obj_buf(buf);
+        return ret;
     }
-    if (val.len == 0) {
-        *obj = gg_obj_map((GgMap) { 0 });
-        val.pairs = NULL;
+    case GG_TYPE_LIST:
+    case GG_TYPE_MAP:
+        break;
+    default:
         return GG_ERR_OK;
     }
 
-    GgKV *new_mem = GG_ARENA_ALLOCN(arena, GgKV, val.len);
-    if (new_mem == NULL) {
-        GG_LOGE("Insufficient memory when cloning map into %p.", arena);
+    if (limits.max_depth <= GG_MAX_OBJECT_DEPTH) {
+        ClaimLevel levels[GG_MAX_OBJECT_DEPTH];
+        return claim_levels(ctx, obj, limits, levels);
+    }
+
+    if (limits.max_depth > SIZE_MAX / sizeof(ClaimLevel)) {
+        GG_LOGE("Object depth limit too large.");
         return GG_ERR_NOMEM;
     }
-    memcpy(new_mem, val.pairs, val.len * sizeof(GgKV));
-    *obj = gg_obj_map((GgMap) { .pairs = new_mem, .len = val.len });
-    return GG_ERR_OK;
+
+    GgAlloc alloc = gg_libc_alloc();
+    ClaimLevel *levels = GG_ALLOCN(alloc, ClaimLevel, limits.max_depth);
+    if (levels == NULL) {
+        GG_LOGE("Failed to allocate object traversal state.");
+        return GG_ERR_NOMEM;
+    }
+    GgError ret = claim_levels(ctx, obj, limits, levels);
+    gg_free(alloc, levels);
+    return ret;
 }
 
-static GgError claim_map_key(void *ctx, GgBuffer key, GgKV kv[static 1]) {
-    GgArena *arena = ctx;
-    GgError ret = gg_arena_claim_buf(&key, arena);
-    gg_kv_set_key(kv, key);
+static GgError claim(
+    ClaimCtx ctx[static 1],
+    GgObject obj[static 1],
+    GgObjectLimits limits,
+    size_t *used
+) {
+    if (limits.max_depth == 0) {
+        GG_LOGE("Object depth limit must be at least 1.");
+        return GG_ERR_INVALID;
+    }
+
+    // Depth is bounded by subobject count, so avoid over-allocating
+    if (limits.max_depth - 1 > limits.max_subobjects) {
+        limits.max_depth = limits.max_subobjects + 1;
+    }
+
+    GgArena *arena = ctx->arena;
+    uint32_t start = (arena != NULL) ? arena->index : 0;
+    GgError ret = claim_with_levels(ctx, obj, limits);
+    // Flush even on failure, so claimed references remain valid
+    claim_flush(ctx);
+
+    if ((used != NULL) && (ret == GG_ERR_OK)) {
+        *used = (arena != NULL) ? arena->index - start : 0;
+    }
     return ret;
 }
 
 GgError gg_arena_claim_obj(GgObject obj[static 1], GgArena *arena) {
-    const GgObjectVisitHandlers VISIT_HANDLERS = {
-        .on_buf = claim_buf,
-        .on_list = claim_list,
-        .on_map = claim_map,
-        .on_map_key = claim_map_key,
-    };
-    return gg_obj_visit(&VISIT_HANDLERS, arena, obj);
+    return gg_arena_claim_obj_with_limits(obj, arena, GG_OBJECT_LIMITS_DEFAULT);
+}
+
+GgError gg_arena_claim_obj_with_limits(
+    GgObject obj[static 1], GgArena *arena, GgObjectLimits limits
+) {
+    return gg_arena_claim_obj_measured(obj, arena, limits, NULL);
+}
+
+GgError gg_arena_claim_obj_measured(
+    GgObject obj[static 1], GgArena *arena, GgObjectLimits limits, size_t *used
+) {
+    ClaimCtx ctx = { .arena = arena, .copy_containers = true };
+    return claim(&ctx, obj, limits, used);
 }
 
 GgError gg_arena_claim_obj_bufs(GgObject obj[static 1], GgArena *arena) {
-    const GgObjectVisitHandlers VISIT_HANDLERS = {
-        .on_buf = claim_buf,
-        .on_map_key = claim_map_key,
-    };
-    return gg_obj_visit(&VISIT_HANDLERS, arena, obj);
+    ClaimCtx ctx = { .arena = arena, .copy_containers = false };
+    return claim(&ctx, obj, GG_OBJECT_LIMITS_DEFAULT, NULL);
+}
+
+// Object and pair references are stored at the start of their storage.
+static void relocate_ref(
+    uint8_t ref[static sizeof(void *)],
+    uintptr_t old_base,
+    size_t len,
+    uint8_t *new_base
+) {
+    void *ptr;
+    memcpy(&ptr, ref, sizeof(void *));
+    uintptr_t offset = (uintptr_t) ptr - old_base;
+    if ((ptr != NULL) && (offset < len)) {
+        ptr = &new_base[offset];
+        memcpy(ref, &ptr, sizeof(void *));
+    }
 }
+
+static GgError clone_exact_with_scratch(
+    GgObject obj[static 1],
+    size_t scratch_size,
+    void *(*alloc_fn)(void *ctx, size_t size),
+    void *ctx,
+    bool scratch_full[static 1]
+) {
+    GgScratch scratch;
+    GgArena arena;
+    GgError ret = gg_scratch_borrow(scratch_size, &scratch, &arena);
+    GG_CLEANUP(cleanup_gg_scratch_return, scratch);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+
+    uint32_t sites[GG_MAX_OBJECT_SUBOBJECTS];
+    ClaimCtx claim_ctx
+        = { .arena = &arena, .copy_containers = true, .sites = sites };
+    GgObject copy = *obj;
+    size_t used;
+    ret = claim(&claim_ctx, &copy, GG_OBJECT_LIMITS_DEFAULT, &used);
+    if (ret != GG_ERR_OK) {
+        *scratch_full = ret == GG_ERR_NOMEM;
+        return ret;
+    }
+
+    if (used == 0) {
+        *obj = copy;
+        return GG_ERR_OK;
+    }
+
+    uint8_t *mem = alloc_fn(ctx, used);
+    if (mem == NULL) {
+        GG_LOGE("Failed to allocate %zu bytes to clone object.", used);
+        return GG_ERR_NOMEM;
+    }
+
+    // Scratch memory is aligned as `max_align_t`, so the layout is valid at
+    // the new location.
+    memcpy(mem, arena.mem, used);
+    for (size_t i = 0; i < claim_ctx.sites_len; i++) {
+        relocate_ref(&mem[sites[i]], (uintptr_t) arena.mem, used, mem);
+    }
+    GgObjectType type = gg_obj_type(copy);
+    if ((type == GG_TYPE_BUF) || (type == GG_TYPE_LIST)
+        || (type == GG_TYPE_MAP)) {
+        relocate_ref(copy._private, (uintptr_t) arena.mem, used, mem);
+    }
+
+    *obj = copy;
+    return GG_ERR_OK;
+}
+
+GgError gg_obj_clone_exact(
+    GgObject obj[static 1],
+    void *(*alloc_fn)(void *ctx, size_t size),
+    void *ctx
+) {
+    // Most objects fit in one scratch block, avoiding a measuring pass
+    bool scratch_full = false;
+    GgError ret = clone_exact_with_scratch(
+        obj, GG_SCRATCH_BLOCK_SIZE, alloc_fn, ctx, &scratch_full
+    );
+    if (!scratch_full) {
+        return ret;
+    }
+
+    size_t size;
+    ret = gg_obj_mem_usage(*obj, &size);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    scratch_full = false;
+    return clone_exact_with_scratch(obj, size, alloc_fn, ctx, &scratch_full);
+}
+
+#ifdef GG_SDK_TESTING
+
+#include <gg/object_compare.h>
+#include <gg/test.h>
+#include <stdlib.h>
+#include <unity.h>
+
+GG_TEST_DEFINE(arena_claim_obj_measured) {
+    GgObject obj = gg_obj_map(GG_MAP(
+        gg_kv(GG_STR("abc"), gg_obj_buf(GG_STR("def"))),
+        gg_kv(
+            GG_STR("list"),
+            gg_obj_list(GG_LIST(gg_obj_i64(1), gg_obj_buf(GG_STR("xyz"))))
+        ),
+        gg_kv(GG_STR("empty"), gg_obj_list((GgList) { 0 })),
+    ));
+
+    alignas(GgKV) uint8_t mem[512];
+    GgArena arena = gg_arena_init(GG_BUF(mem));
+    GgObject claimed = obj;
+    size_t used = 0;
+    GG_TEST_ASSERT_OK(gg_arena_claim_obj_measured(
+        &claimed, &arena, GG_OBJECT_LIMITS_DEFAULT, &used
+    ));
+    TEST_ASSERT_EQUAL(arena.index, used);
+    TEST_ASSERT(gg_obj_eq(obj, claimed));
+
+    size_t usage;
+    GG_TEST_ASSERT_OK(gg_obj_mem_usage(obj, &usage));
+    TEST_ASSERT(used <= usage);
+
+    // Claiming from one arena into another coalesces buffer copies
+    alignas(GgKV) uint8_t mem2[512];
+    GgArena arena2 = gg_arena_init(GG_BUF(mem2));
+    GgObject reclaimed = claimed;
+    size_t used2 = 0;
+    GG_TEST_ASSERT_OK(gg_arena_claim_obj_measured(
+        &reclaimed, &arena2, GG_OBJECT_LIMITS_DEFAULT, &used2
+    ));
+    TEST_ASSERT_EQUAL(used, used2);
+    TEST_ASSERT(gg_obj_eq(obj, reclaimed));
+    GgBuffer key = gg_kv_key(gg_obj_into_map(reclaimed).pairs[0]);
+    TEST_ASSERT(gg_arena_owns(&arena2, key.data));
+
+    GgArena small = gg_arena_init((GgBuffer) { .data = mem2, .len = 40 });
+    GgObject failed = obj;
+    TEST_ASSERT_EQUAL(
+        GG_ERR_NOMEM,
+        gg_arena_claim_obj_measured(
+            &failed, &small, GG_OBJECT_LIMITS_DEFAULT, &used2
+        )
+    );
+    TEST_ASSERT_EQUAL(used, used2);
+}
+
+static void *test_clone_alloc(void *ctx, size_t size) {
+    void **mem = ctx;
+    *mem = malloc(size);
+    return *mem;
+}
+
+GG_TEST_DEFINE(obj_clone_exact) {
+    GgObject obj = gg_obj_map(GG_MAP(
+        gg_kv(GG_STR("k"), gg_obj_buf(GG_STR("value"))),
+        gg_kv(
+            GG_STR("nested"),
+            gg_obj_map(GG_MAP(gg_kv(
+                GG_STR("list"),
+                gg_obj_list(GG_LIST(gg_obj_buf(GG_STR("a")), GG_OBJ_NULL))
+            )))
+        ),
+    ));
+
+    void *mem = NULL;
+    GgObject clone = obj;
+    GG_TEST_ASSERT_OK(gg_obj_clone_exact(&clone, test_clone_alloc, &mem));
+    TEST_ASSERT_NOT_NULL(mem);
+    TEST_ASSERT(gg_obj_eq(obj, clone));
+
+    // All references point into the allocation
+    GgMap map = gg_obj_into_map(clone);
+    TEST_ASSERT_EQUAL_PTR(mem, map.pairs);
+    GgObject *nested;
+    TEST_ASSERT(gg_map_get(map, GG_STR("nested"), &nested));
+    GgKV *inner = gg_obj_into_map(*nested).pairs;
+    GgList list = gg_obj_into_list(*gg_kv_val(inner));
+    GgBuffer item = gg_obj_into_buf(list.items[0]);
+    TEST_ASSERT((uintptr_t) item.data > (uintptr_t) mem);
+    TEST_ASSERT((uintptr_t) gg_kv_key(*inner).data > (uintptr_t) mem);
+    free(mem);
+
+    mem = NULL;
+    GgObject scalar = gg_obj_i64(5);
+    GG_TEST_ASSERT_OK(gg_obj_clone_exact(&scalar, test_clone_alloc, &mem));
+    TEST_ASSERT_NULL(mem);
+    TEST_ASSERT_EQUAL(5, gg_obj_into_i64(scalar));
+}
+
+GG_TEST_DEFINE(peak_arena) {
+    alignas(8) uint8_t mem[64];
+    GgPeakArena tracked = gg_peak_arena_init(GG_BUF(mem));
+    TEST_ASSERT_EQUAL(0, gg_peak_arena_peak(&tracked));
+
+    GgArenaState state = gg_arena_save(&tracked.arena);
+    TEST_ASSERT_NOT_NULL(GG_ARENA_ALLOCN(&tracked.arena, uint8_t, 3));
+    TEST_ASSERT_NOT_NULL(GG_ARENA_ALLOC(&tracked.arena, uint64_t));
+    TEST_ASSERT_EQUAL(16, gg_peak_arena_peak(&tracked));
+
+    // Peak is kept across restores
+    gg_peak_arena_restore(&tracked, state);
+    uint8_t *buf = GG_ARENA_ALLOCN(&tracked.arena, uint8_t, 10);
+    TEST_ASSERT_NOT_NULL(buf);
+    TEST_ASSERT_EQUAL(16, gg_peak_arena_peak(&tracked));
+    GG_TEST_ASSERT_OK(gg_arena_resize_last(&tracked.arena, buf, 10, 20));
+    TEST_ASSERT_EQUAL(20, gg_peak_arena_peak(&tracked));
+
+    gg_peak_arena_restore(&tracked, state);
+    TEST_ASSERT_EQUAL(20, gg_peak_arena_peak(&tracked));
+    gg_peak_arena_reset_peak(&tracked);
+    TEST_ASSERT_EQUAL(0, gg_peak_arena_peak(&tracked));
+}
+
+#endif
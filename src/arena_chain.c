@@ -0,0 +1,205 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <assert.h>
+#include <gg/alloc.h>
+#include <gg/arena.h>
+#include <gg/arena_chain.h>
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/log.h>
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct GgArenaBlock {
+    GgArenaBlock *next;
+    uint32_t capacity;
+    alignas(max_align_t) uint8_t mem[];
+};
+
+GgChainArena gg_chain_arena_init(GgAlloc alloc, uint32_t block_size) {
+    return (GgChainArena) { .alloc = alloc, .block_size = block_size };
+}
+
+static GgArenaBlock *take_spare(GgChainArena *chain, size_t min_capacity) {
+    GgArenaBlock **link = &chain->spare;
+    while (*link != NULL) {
+        GgArenaBlock *block = *link;
+        if (block->capacity >= min_capacity) {
+            *link = block->next;
+            return block;
+        }
+        link = &block->next;
+    }
+    return NULL;
+}
+
+static GgArenaBlock *new_block(GgChainArena *chain, size_t min_capacity) {
+    GgArenaBlock *block = take_spare(chain, min_capacity);
+    if (block != NULL) {
+        return block;
+    }
+
+    uint32_t capacity = (min_capacity > chain->block_size)
+        ? (uint32_t) min_capacity
+        : chain->block_size;
+    block = gg_alloc(
+        chain->alloc,
+        offsetof(GgArenaBlock, mem) + capacity,
+        alignof(GgArenaBlock)
+    );
+    if (block == NULL) {
+        return NULL;
+    }
+    block->capacity = capacity;
+    return block;
+}
+
+// Checked before allocating so that a full or empty current block is replaced
+// without gg_arena_alloc logging the failure.
+static bool cur_fits(const GgArena *cur, size_t size, size_t alignment) {
+    if (cur->mem == NULL) {
+        return false;
+    }
+    uintptr_t addr = (uintptr_t) cur->mem + cur->index;
+    size_t pad = (alignment - (addr & (alignment - 1))) & (alignment - 1);
+    size_t rest = cur->capacity - cur->index;
+    return (pad <= rest) && (size <= rest - pad);
+}
+
+void *gg_chain_arena_alloc(GgChainArena *chain, size_t size, size_t alignment) {
+    void *ret;
+    if (cur_fits(&chain->cur, size, alignment)) {
+        ret = gg_arena_alloc(&chain->cur, size, alignment);
+        assert(ret != NULL);
+        return ret;
+    }
+
+    // Block memory is aligned to max_align_t; larger alignment may need
+    // padding.
+    size_t pad = (alignment > alignof(max_align_t)) ? alignment - 1 : 0;
+    if (size > UINT32_MAX - offsetof(GgArenaBlock, mem) - pad) {
+        GG_LOGE("[%p] Chained arena allocation of %zu too large.", chain, size);
+        return NULL;
+    }
+
+    GgArenaBlock *block = new_block(chain, size + pad);
+    if (block == NULL) {
+        GG_LOGE("[%p] Failed to grow chained arena for %zu.", chain, size);
+        return NULL;
+    }
+
+    block->next = chain->blocks;
+    chain->blocks = block;
+    chain->cur = (GgArena) { .mem = block->mem, .capacity = block->capacity };
+
+    ret = gg_arena_alloc(&chain->cur, size, alignment);
+    assert(ret != NULL);
+    return ret;
+}
+
+GgError gg_chain_arena_sub(GgChainArena *chain, size_t size, GgArena *arena) {
+    if (size > UINT32_MAX) {
+        return GG_ERR_RANGE;
+    }
+    uint8_t *mem = gg_chain_arena_alloc(chain, size, alignof(max_align_t));
+    if (mem == NULL) {
+        return GG_ERR_NOMEM;
+    }
+    *arena = gg_arena_init((GgBuffer) { .data = mem, .len = size });
+    return GG_ERR_OK;
+}
+
+GgChainArenaState gg_chain_arena_save(const GgChainArena *chain) {
+    return (GgChainArenaState) { .block = chain->blocks,
+                                 .state = gg_arena_save(&chain->cur) };
+}
+
+void gg_chain_arena_restore(GgChainArena *chain, GgChainArenaState state) {
+    if (chain->blocks == state.block) {
+        if (state.block != NULL) {
+            gg_arena_restore(&chain->cur, state.state);
+        }
+        return;
+    }
+
+    while (chain->blocks != state.block) {
+        assert(chain->blocks != NULL);
+        GgArenaBlock *block = chain->blocks;
+        chain->blocks = block->next;
+        block->next = chain->spare;
+        chain->spare = block;
+    }
+
+    if (state.block == NULL) {
+        chain->cur = (GgArena) { 0 };
+    } else {
+        assert(state.state.index <= state.block->capacity);
+        chain->cur = (GgArena) { .mem = state.block->mem,
+                                 .capacity = state.block->capacity,
+                                 .index = state.state.index };
+    }
+}
+
+static void free_blocks(GgAlloc alloc, GgArenaBlock *block) {
+    while (block != NULL) {
+        GgArenaBlock *next = block->next;
+        gg_free(alloc, block);
+        block = next;
+    }
+}
+
+void gg_chain_arena_free(GgChainArena *chain) {
+    free_blocks(chain->alloc, chain->blocks);
+    free_blocks(chain->alloc, chain->spare);
+    chain->blocks = NULL;
+    chain->spare = NULL;
+    chain->cur = (GgArena) { 0 };
+}
+
+#ifdef GG_SDK_TESTING
+
+#include <gg/test.h>
+#include <unity.h>
+
+GG_TEST_DEFINE(chain_arena_grow_and_restore) {
+    GgChainArena chain = gg_chain_arena_init(gg_libc_alloc(), 64);
+
+    GgChainArenaState empty = gg_chain_arena_save(&chain);
+    uint64_t *first = GG_CHAIN_ARENA_ALLOCN(&chain, uint64_t, 4);
+    TEST_ASSERT_NOT_NULL(first);
+
+    GgChainArenaState mark = gg_chain_arena_save(&chain);
+    uint8_t *big = GG_CHAIN_ARENA_ALLOCN(&chain, uint8_t, 200);
+    TEST_ASSERT_NOT_NULL(big);
+    TEST_ASSERT(chain.blocks != mark.block);
+    void *aligned = gg_chain_arena_alloc(&chain, 8, 256);
+    TEST_ASSERT_NOT_NULL(aligned);
+    TEST_ASSERT_EQUAL(0, (uintptr_t) aligned % 256);
+
+    // Releasing back to the mark keeps the later blocks for reuse
+    gg_chain_arena_restore(&chain, mark);
+    TEST_ASSERT_EQUAL_PTR(mark.block, chain.blocks);
+    TEST_ASSERT_NOT_NULL(chain.spare);
+    uint8_t *again = GG_CHAIN_ARENA_ALLOCN(&chain, uint8_t, 200);
+    TEST_ASSERT_EQUAL_PTR(big, again);
+
+    GgArena sub;
+    GG_TEST_ASSERT_OK(gg_chain_arena_sub(&chain, 100, &sub));
+    TEST_ASSERT_EQUAL(100, sub.capacity);
+    TEST_ASSERT_NOT_NULL(GG_ARENA_ALLOCN(&sub, uint8_t, 100));
+
+    gg_chain_arena_restore(&chain, empty);
+    TEST_ASSERT_NULL(chain.blocks);
+    TEST_ASSERT_NULL(GG_ARENA_ALLOC(&chain.cur, uint8_t));
+    TEST_ASSERT_NOT_NULL(GG_CHAIN_ARENA_ALLOC(&chain, uint8_t));
+
+    gg_chain_arena_free(&chain);
+    TEST_ASSERT_NULL(chain.blocks);
+    TEST_ASSERT_NULL(chain.spare);
+}
+
+#endif
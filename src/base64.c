@@ -4,12 +4,44 @@
 
 #include <gg/arena.h>
 #include <gg/base64.h>
+#include <gg/base64_prefix.h>
+#include <gg/base64_vec.h>
 #include <gg/buffer.h>
 #include <gg/error.h>
+#include <gg/vector.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BASE64_X86 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define BASE64_NEON 1
+#endif
+
+#ifndef BASE64_X86
+#define BASE64_X86 0
+#endif
+#ifndef BASE64_NEON
+#define BASE64_NEON 0
+#endif
+
+// Kernels process a prefix of whole groups and return the number of input
+// bytes consumed; the remainder is handled by the scalar code.
+
+/// Encodes groups of 3 bytes from `src` into `dst`.
+typedef size_t Base64EncodeFn(const uint8_t *src, size_t len, uint8_t *dst);
+
+/// Decodes groups of 4 characters from `src` into `dst`, which has
+/// `dst_len` bytes of space. Stops before any group containing padding or
+/// invalid characters. `dst` may alias `src`.
+typedef size_t Base64DecodeFn(
+    const uint8_t *src, size_t len, uint8_t *dst, size_t dst_len
+);
+
 static bool base64_char_to_byte(char digit, uint8_t *value) {
     if ((digit >= 'A') && (digit <= 'Z')) {
         *value = (uint8_t) (digit - 'A');
@@ -96,16 +128,397 @@ static bool base64_decode_segment(
     return true;
 }
 
-bool gg_base64_decode(GgBuffer base64, GgBuffer target[static 1]) {
+static bool base64_decode_group(const uint8_t group[4U], uint8_t out[3U]) {
+    uint8_t value[4U];
+    for (size_t j = 0; j < 4U; j++) {
+        if (!base64_char_to_byte((char) group[j], &value[j])) {
+            return false;
+        }
+    }
+    out[0U] = (uint8_t) ((value[0U] << 2U) | (value[1U] >> 4U));
+    out[1U] = (uint8_t) ((value[1U] << 4U) | (value[2U] >> 2U));
+    out[2U] = (uint8_t) ((value[2U] << 6U) | value[3U]);
+    return true;
+}
+
+static size_t base64_decode_scalar(
+    const uint8_t *src, size_t len, uint8_t *dst, size_t dst_len
+) {
+    size_t i = 0;
+    size_t o = 0;
+    for (; ((len - i) >= 4) && ((dst_len - o) >= 3); i += 4, o += 3) {
+        uint8_t out[3U];
+        if (!base64_decode_group(&src[i], out)) {
+            break;
+        }
+        memcpy(&dst[o], out, sizeof(out));
+    }
+    return i;
+}
+
+static const uint8_t BASE64_TABLE[]
+    = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static size_t base64_encode_scalar(
+    const uint8_t *src, size_t len, uint8_t *dst
+) {
+    size_t chunks = len / 3;
+    for (size_t i = 0; i < chunks; i++) {
+        uint32_t chunk = (unsigned) src[i * 3] << 16;
+        chunk += (unsigned) src[(i * 3) + 1] << 8;
+        chunk += (unsigned) src[(i * 3) + 2];
+
+        dst[i * 4] = BASE64_TABLE[chunk >> 18];
+        dst[(i * 4) + 1] = BASE64_TABLE[(chunk >> 12) & 0x3F];
+        dst[(i * 4) + 2] = BASE64_TABLE[(chunk >> 6) & 0x3F];
+        dst[(i * 4) + 3] = BASE64_TABLE[chunk & 0x3F];
+    }
+    return chunks * 3;
+}
+
+#if BASE64_X86
+
+// Vector kernels use the algorithms from "Faster Base64 Encoding and Decoding
+// Using AVX2 Instructions" (Muła, Lemire). Encoding spreads each 3 byte group
+// over a 32-bit lane, splits it into 6-bit indices with multiplies, and maps
+// indices to characters by adding a per-range offset. Decoding classifies
+// characters by nibble lookups to reject invalid input, maps characters to
+// values with a per-range offset, and packs values back with multiply-adds.
+
+__attribute__((target("ssse3"))) static __m128i base64_enc_split_ssse3(
+    __m128i input
+) {
+    // Bytes b0 b1 b2 of each group become b1 b0 b2 b1
+    __m128i in = _mm_shuffle_epi8(
+        input, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10)
+    );
+    __m128i hi = _mm_mulhi_epu16(
+        _mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)),
+        _mm_set1_epi32(0x04000040)
+    );
+    __m128i lo = _mm_mullo_epi16(
+        _mm_and_si128(in, _mm_set1_epi32(0x003F03F0)),
+        _mm_set1_epi32(0x01000010)
+    );
+    return _mm_or_si128(hi, lo);
+}
+
+__attribute__((target("ssse3"))) static __m128i base64_enc_translate_ssse3(
+    __m128i indices
+) {
+    // Offsets for A-Z, a-z, 0-9 (ten entries), '+' and '/'
+    const __m128i offsets = _mm_setr_epi8(
+        'A', 'a' - 26, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0
+    );
+    __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    range = _mm_sub_epi8(range, _mm_cmpgt_epi8(indices, _mm_set1_epi8(25)));
+    return _mm_add_epi8(indices, _mm_shuffle_epi8(offsets, range));
+}
+
+__attribute__((target("ssse3"))) static size_t base64_encode_ssse3(
+    const uint8_t *src, size_t len, uint8_t *dst
+) {
+    size_t i = 0;
+    size_t o = 0;
+    // Loads 16 bytes to encode 12
+    for (; (len - i) >= 16; i += 12, o += 16) {
+        __m128i input = _mm_loadu_si128((const __m128i *) &src[i]);
+        _mm_storeu_si128(
+            (__m128i *) &dst[o],
+            base64_enc_translate_ssse3(base64_enc_split_ssse3(input))
+        );
+    }
+    return i + base64_encode_scalar(&src[i], len - i, &dst[o]);
+}
+
+__attribute__((target("avx2"))) static size_t base64_encode_avx2(
+    const uint8_t *src, size_t len, uint8_t *dst
+) {
+    const __m256i shuffle = _mm256_setr_epi8(
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10
+    );
+    const __m256i offsets = _mm256_setr_epi8(
+        'A', 'a' - 26, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0,
+        'A', 'a' - 26, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0
+    );
+    size_t i = 0;
+    size_t o = 0;
+    // Loads 28 bytes to encode 24, 12 per lane
+    for (; (len - i) >= 28; i += 24, o += 32) {
+        __m256i input = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *) &src[i])),
+            _mm_loadu_si128((const __m128i *) &src[i + 12]),
+            1
+        );
+        __m256i in = _mm256_shuffle_epi8(input, shuffle);
+        __m256i hi = _mm256_mulhi_epu16(
+            _mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00)),
+            _mm256_set1_epi32(0x04000040)
+        );
+        __m256i lo = _mm256_mullo_epi16(
+            _mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0)),
+            _mm256_set1_epi32(0x01000010)
+        );
+        __m256i indices = _mm256_or_si256(hi, lo);
+        __m256i range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        range = _mm256_sub_epi8(
+            range, _mm256_cmpgt_epi8(indices, _mm256_set1_epi8(25))
+        );
+        _mm256_storeu_si256(
+            (__m256i *) &dst[o],
+            _mm256_add_epi8(indices, _mm256_shuffle_epi8(offsets, range))
+        );
+    }
+    // Avoid AVX to SSE transition penalties in the tail
+    _mm256_zeroupper();
+    return i + base64_encode_ssse3(&src[i], len - i, &dst[o]);
+}
+
+// Classification of characters by low and high nibble; a character is
+// invalid if its two entries share a bit.
+static const uint8_t BASE64_DEC_LO[16] = {
+    0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+};
+
+static const uint8_t BASE64_DEC_HI[16] = {
+    0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+    0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+};
+
+// Offset from character to value, by high nibble; index 1 is '/'
+static const int8_t BASE64_DEC_ROLL[16] = {
+    0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+__attribute__((target("ssse3"))) static size_t base64_decode_ssse3(
+    const uint8_t *src, size_t len, uint8_t *dst, size_t dst_len
+) {
+    const __m128i lut_lo = _mm_loadu_si128((const __m128i *) BASE64_DEC_LO);
+    const __m128i lut_hi = _mm_loadu_si128((const __m128i *) BASE64_DEC_HI);
+    const __m128i lut_roll
+        = _mm_loadu_si128((const __m128i *) BASE64_DEC_ROLL);
+    const __m128i mask_2f = _mm_set1_epi8(0x2F);
+    size_t i = 0;
+    size_t o = 0;
+
+    // Stores 16 bytes to decode 12
+    for (; ((len - i) >= 16) && ((dst_len - o) >= 16); i += 16, o += 12) {
+        __m128i input = _mm_loadu_si128((const __m128i *) &src[i]);
+        __m128i hi_nibbles
+            = _mm_and_si128(_mm_srli_epi32(input, 4), mask_2f);
+        __m128i lo_nibbles = _mm_and_si128(input, mask_2f);
+        __m128i invalid = _mm_and_si128(
+            _mm_shuffle_epi8(lut_lo, lo_nibbles),
+            _mm_shuffle_epi8(lut_hi, hi_nibbles)
+        );
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(invalid, _mm_setzero_si128()))
+            != 0xFFFF) {
+            break;
+        }
+        __m128i roll = _mm_shuffle_epi8(
+            lut_roll,
+            _mm_add_epi8(_mm_cmpeq_epi8(input, mask_2f), hi_nibbles)
+        );
+        __m128i values = _mm_add_epi8(input, roll);
+        __m128i merged = _mm_madd_epi16(
+            _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140)),
+            _mm_set1_epi32(0x00011000)
+        );
+        __m128i packed = _mm_shuffle_epi8(
+            merged,
+            _mm_setr_epi8(
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1
+            )
+        );
+        _mm_storeu_si128((__m128i *) &dst[o], packed);
+    }
+    return i + base64_decode_scalar(&src[i], len - i, &dst[o], dst_len - o);
+}
+
+__attribute__((target("avx2"))) static size_t base64_decode_avx2(
+    const uint8_t *src, size_t len, uint8_t *dst, size_t dst_len
+) {
+    const __m256i lut_lo = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i *) BASE64_DEC_LO)
+    );
+    const __m256i lut_hi = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i *) BASE64_DEC_HI)
+    );
+    const __m256i lut_roll = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i *) BASE64_DEC_ROLL)
+    );
+    const __m256i mask_2f = _mm256_set1_epi8(0x2F);
+    const __m256i pack = _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1
+    );
+    size_t i = 0;
+    size_t o = 0;
+
+    // Stores 32 bytes to decode 24
+    for (; ((len - i) >= 32) && ((dst_len - o) >= 32); i += 32, o += 24) {
+        __m256i input = _mm256_loadu_si256((const __m256i *) &src[i]);
+        __m256i hi_nibbles
+            = _mm256_and_si256(_mm256_srli_epi32(input, 4), mask_2f);
+        __m256i lo_nibbles = _mm256_and_si256(input, mask_2f);
+        if (!_mm256_testz_si256(
+                _mm256_shuffle_epi8(lut_lo, lo_nibbles),
+                _mm256_shuffle_epi8(lut_hi, hi_nibbles)
+            )) {
+            break;
+        }
+        __m256i roll = _mm256_shuffle_epi8(
+            lut_roll,
+            _mm256_add_epi8(_mm256_cmpeq_epi8(input, mask_2f), hi_nibbles)
+        );
+        __m256i values = _mm256_add_epi8(input, roll);
+        __m256i merged = _mm256_madd_epi16(
+            _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140)),
+            _mm256_set1_epi32(0x00011000)
+        );
+        __m256i packed = _mm256_permutevar8x32_epi32(
+            _mm256_shuffle_epi8(merged, pack),
+            _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7)
+        );
+        _mm256_storeu_si256((__m256i *) &dst[o], packed);
+    }
+    _mm256_zeroupper();
+    return i + base64_decode_ssse3(&src[i], len - i, &dst[o], dst_len - o);
+}
+
+static Base64EncodeFn *base64_encode_impl = base64_encode_scalar;
+static Base64DecodeFn *base64_decode_impl = base64_decode_scalar;
+
+__attribute__((constructor)) static void base64_select_impl(void) {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        base64_encode_impl = base64_encode_avx2;
+        base64_decode_impl = base64_decode_avx2;
+    } else if (__builtin_cpu_supports("ssse3")) {
+        base64_encode_impl = base64_encode_ssse3;
+        base64_decode_impl = base64_decode_ssse3;
+    }
+}
+
+#elif BASE64_NEON
+
+static uint8x16x4_t base64_load_table(const uint8_t table[64]) {
+    uint8x16x4_t ret;
+    ret.val[0] = vld1q_u8(&table[0]);
+    ret.val[1] = vld1q_u8(&table[16]);
+    ret.val[2] = vld1q_u8(&table[32]);
+    ret.val[3] = vld1q_u8(&table[48]);
+    return ret;
+}
+
+static size_t base64_encode_neon(const uint8_t *src, size_t len, uint8_t *dst) {
+    const uint8x16x4_t table = base64_load_table(BASE64_TABLE);
+    const uint8x16_t mask = vdupq_n_u8(0x3F);
+    size_t i = 0;
+    size_t o = 0;
+
+    for (; (len - i) >= 48; i += 48, o += 64) {
+        uint8x16x3_t in = vld3q_u8(&src[i]);
+        uint8x16x4_t out;
+        out.val[0] = vshrq_n_u8(in.val[0], 2);
+        out.val[1] = vandq_u8(
+            vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), mask
+        );
+        out.val[2] = vandq_u8(
+            vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), mask
+        );
+        out.val[3] = vandq_u8(in.val[2], mask);
+        for (size_t j = 0; j < 4; j++) {
+            out.val[j] = vqtbl4q_u8(table, out.val[j]);
+        }
+        vst4q_u8(&dst[o], out);
+    }
+    return i + base64_encode_scalar(&src[i], len - i, &dst[o]);
+}
+
+// Character to value tables for characters 0-63 and 64-127; 0xFF is invalid.
+// Table lookups give 0 for out of range indices, so each character is looked
+// up in both tables and the results combined.
+static const uint8_t BASE64_DEC_TABLE_LO[64] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 62,   0xFF, 0xFF, 0xFF, 63,
+    52,   53,   54,   55,   56,   57,   58,   59,   60,   61,   0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+static const uint8_t BASE64_DEC_TABLE_HI[64] = {
+    0xFF, 0,    1,    2,    3,    4,    5,    6,    7,    8,    9,    10,
+    11,   12,   13,   14,   15,   16,   17,   18,   19,   20,   21,   22,
+    23,   24,   25,   0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 26,   27,   28,
+    29,   30,   31,   32,   33,   34,   35,   36,   37,   38,   39,   40,
+    41,   42,   43,   44,   45,   46,   47,   48,   49,   50,   51,   0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+static size_t base64_decode_neon(
+    const uint8_t *src, size_t len, uint8_t *dst, size_t dst_len
+) {
+    const uint8x16x4_t table_lo = base64_load_table(BASE64_DEC_TABLE_LO);
+    const uint8x16x4_t table_hi = base64_load_table(BASE64_DEC_TABLE_HI);
+    const uint8x16_t offset = vdupq_n_u8(64);
+    const uint8x16_t high_bit = vdupq_n_u8(0x80);
+    size_t i = 0;
+    size_t o = 0;
+
+    for (; ((len - i) >= 64) && ((dst_len - o) >= 48); i += 64, o += 48) {
+        uint8x16x4_t in = vld4q_u8(&src[i]);
+        uint8x16_t error = vdupq_n_u8(0);
+        for (size_t j = 0; j < 4; j++) {
+            uint8x16_t c = in.val[j];
+            uint8x16_t value = vorrq_u8(
+                vqtbl4q_u8(table_lo, c),
+                vqtbl4q_u8(table_hi, vsubq_u8(c, offset))
+            );
+            // Non-ASCII characters miss both tables
+            error = vorrq_u8(error, vorrq_u8(value, vandq_u8(c, high_bit)));
+            in.val[j] = value;
+        }
+        if (vmaxvq_u8(error) > 63) {
+            break;
+        }
+        uint8x16x3_t out;
+        out.val[0]
+            = vorrq_u8(vshlq_n_u8(in.val[0], 2), vshrq_n_u8(in.val[1], 4));
+        out.val[1]
+            = vorrq_u8(vshlq_n_u8(in.val[1], 4), vshrq_n_u8(in.val[2], 2));
+        out.val[2] = vorrq_u8(vshlq_n_u8(in.val[2], 6), in.val[3]);
+        vst3q_u8(&dst[o], out);
+    }
+    return i + base64_decode_scalar(&src[i], len - i, &dst[o], dst_len - o);
+}
+
+static Base64EncodeFn *const base64_encode_impl = base64_encode_neon;
+static Base64DecodeFn *const base64_decode_impl = base64_decode_neon;
+
+#else
+
+static Base64EncodeFn *const base64_encode_impl = base64_encode_scalar;
+static Base64DecodeFn *const base64_decode_impl = base64_decode_scalar;
+
+#endif
+
+static bool base64_decode_with(
+    Base64DecodeFn *decode, GgBuffer base64, GgBuffer target[static 1]
+) {
     if ((base64.len % 4) != 0) {
         return false;
     }
     if (target->len < ((base64.len / 4) * 3)) {
         return false;
     }
-    GgBuffer out = *target;
+    size_t done = decode(base64.data, base64.len, target->data, target->len);
+    GgBuffer out = gg_buffer_substr(*target, (done / 4) * 3, SIZE_MAX);
     bool last = false;
-    for (size_t i = 0; i < base64.len; i += 4) {
+    for (size_t i = done; i < base64.len; i += 4) {
         if (last) {
             // Data after padding
             return false;
@@ -119,34 +532,33 @@ bool gg_base64_decode(GgBuffer base64, GgBuffer target[static 1]) {
     return true;
 }
 
+bool gg_base64_decode(GgBuffer base64, GgBuffer target[static 1]) {
+    return base64_decode_with(base64_decode_impl, base64, target);
+}
+
 bool gg_base64_decode_in_place(GgBuffer target[static 1]) {
     return gg_base64_decode(*target, target);
 }
 
-static const uint8_t BASE64_TABLE[]
-    = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+size_t gg_base64_decode_prefix(GgBuffer base64, uint8_t *dst) {
+    size_t dst_len = (base64.len / 4) * 3;
+    size_t done = base64_decode_impl(base64.data, base64.len, dst, dst_len);
+    // Kernels may leave a partial block for the scalar code
+    done += base64_decode_scalar(
+        &base64.data[done],
+        base64.len - done,
+        &dst[(done / 4) * 3],
+        dst_len - ((done / 4) * 3)
+    );
+    return done;
+}
 
-GgError gg_base64_encode(
-    GgBuffer buf, GgArena *alloc, GgBuffer result[static 1]
+static void base64_encode_with(
+    Base64EncodeFn *encode, GgBuffer buf, uint8_t *mem
 ) {
-    size_t base64_len = ((buf.len + 2) / 3) * 4;
-    uint8_t *mem = GG_ARENA_ALLOCN(alloc, uint8_t, base64_len);
-    if (mem == NULL) {
-        return GG_ERR_NOMEM;
-    }
-
-    size_t chunks = buf.len / 3;
-    for (size_t i = 0; i < chunks; i++) {
-        uint32_t chunk = (unsigned) buf.data[i * 3] << 16;
-        chunk += (unsigned) buf.data[(i * 3) + 1] << 8;
-        chunk += (unsigned) buf.data[(i * 3) + 2];
-
-        mem[i * 4] = BASE64_TABLE[chunk >> 18];
-        mem[(i * 4) + 1] = BASE64_TABLE[(chunk >> 12) & 0x3F];
-        mem[(i * 4) + 2] = BASE64_TABLE[(chunk >> 6) & 0x3F];
-        mem[(i * 4) + 3] = BASE64_TABLE[chunk & 0x3F];
-    }
-    size_t remaining = buf.len % 3;
+    size_t done = encode(buf.data, buf.len, mem);
+    size_t chunks = done / 3;
+    size_t remaining = buf.len - done;
     if (remaining > 0) {
         uint32_t chunk = (unsigned) buf.data[chunks * 3] << 16;
         if (remaining > 1) {
@@ -161,7 +573,211 @@ GgError gg_base64_encode(
         }
         mem[(chunks * 4) + 3] = '=';
     }
+}
+
+GgError gg_base64_encode(
+    GgBuffer buf, GgArena *alloc, GgBuffer result[static 1]
+) {
+    size_t base64_len = ((buf.len + 2) / 3) * 4;
+    uint8_t *mem = GG_ARENA_ALLOCN(alloc, uint8_t, base64_len);
+    if (mem == NULL) {
+        return GG_ERR_NOMEM;
+    }
+
+    base64_encode_with(base64_encode_impl, buf, mem);
 
     *result = (GgBuffer) { .data = mem, .len = base64_len };
     return GG_ERR_OK;
 }
+
+GgError gg_byte_vec_append_base64(GgByteVec *vector, GgBuffer buf) {
+    if (buf.len > (SIZE_MAX / 4 * 3) - 2) {
+        return GG_ERR_NOMEM;
+    }
+    size_t base64_len = ((buf.len + 2) / 3) * 4;
+    GgBuffer remaining = gg_byte_vec_remaining_capacity(*vector);
+    if (remaining.len < base64_len) {
+        return GG_ERR_NOMEM;
+    }
+
+    base64_encode_with(base64_encode_impl, buf, remaining.data);
+    vector->buf.len += base64_len;
+    return GG_ERR_OK;
+}
+
+void gg_byte_vec_chain_append_base64(
+    GgError *err, GgByteVec *vector, GgBuffer buf
+) {
+    if (*err == GG_ERR_OK) {
+        *err = gg_byte_vec_append_base64(vector, buf);
+    }
+}
+
+#ifdef GG_SDK_TESTING
+#include <gg/test.h>
+#include <unity.h>
+
+typedef struct {
+    Base64EncodeFn *encode;
+    Base64DecodeFn *decode;
+} Base64Impl;
+
+static size_t base64_test_impls(Base64Impl impls[static 3]) {
+    size_t count = 0;
+    impls[count++]
+        = (Base64Impl) { base64_encode_scalar, base64_decode_scalar };
+#if BASE64_X86
+    if (__builtin_cpu_supports("ssse3")) {
+        impls[count++]
+            = (Base64Impl) { base64_encode_ssse3, base64_decode_ssse3 };
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        impls[count++]
+            = (Base64Impl) { base64_encode_avx2, base64_decode_avx2 };
+    }
+#elif BASE64_NEON
+    impls[count++] = (Base64Impl) { base64_encode_neon, base64_decode_neon };
+#endif
+    return count;
+}
+
+static size_t base64_decode_none(
+    const uint8_t *src, size_t len, uint8_t *dst, size_t dst_len
+) {
+    (void) src;
+    (void) len;
+    (void) dst;
+    (void) dst_len;
+    return 0;
+}
+
+// Reference decoder working one segment at a time
+static bool base64_decode_reference(GgBuffer base64, GgBuffer *target) {
+    return base64_decode_with(base64_decode_none, base64, target);
+}
+
+GG_TEST_DEFINE(base64_known_values) {
+    static const char *const VALUES[][2] = {
+        { "", "" },
+        { "f", "Zg==" },
+        { "fo", "Zm8=" },
+        { "foo", "Zm9v" },
+        { "foob", "Zm9vYg==" },
+        { "fooba", "Zm9vYmE=" },
+        { "foobar", "Zm9vYmFy" },
+        { "\xFF\xFE\xFD\xFC\xFB\xFA\xF9\xF8\xF7\xF6\xF5\xF4\xF3\xF2\xF1\xF0"
+          "\xEF\xEE\xED\xEC\xEB\xEA\xE9\xE8\xE7\xE6\xE5\xE4\xE3\xE2\xE1\xE0",
+          "//79/Pv6+fj39vX08/Lx8O/u7ezr6uno5+bl5OPi4eA=" },
+    };
+    Base64Impl impls[3];
+    size_t count = base64_test_impls(impls);
+    for (size_t i = 0; i < sizeof(VALUES) / sizeof(*VALUES); i++) {
+        GgBuffer raw = gg_buffer_from_null_term((char *) VALUES[i][0]);
+        GgBuffer b64 = gg_buffer_from_null_term((char *) VALUES[i][1]);
+        for (size_t j = 0; j < count; j++) {
+            uint8_t mem[64];
+            base64_encode_with(impls[j].encode, raw, mem);
+            GG_TEST_ASSERT_BUF_EQUAL(b64, ((GgBuffer) { mem, b64.len }));
+
+            GgBuffer out = GG_BUF(mem);
+            TEST_ASSERT_TRUE(base64_decode_with(impls[j].decode, b64, &out));
+            GG_TEST_ASSERT_BUF_EQUAL(raw, out);
+        }
+    }
+}
+
+GG_TEST_DEFINE(base64_impls_agree) {
+    Base64Impl impls[3];
+    size_t count = base64_test_impls(impls);
+    static uint8_t raw[300];
+    static uint8_t expected[400];
+    static uint8_t b64[400];
+    static uint8_t decoded[400];
+    uint32_t state = 4321;
+
+    for (size_t len = 0; len <= sizeof(raw); len++) {
+        for (size_t i = 0; i < len; i++) {
+            state = (state * 1103515245U) + 12345U;
+            raw[i] = (uint8_t) (state >> 16);
+        }
+        GgBuffer raw_buf = { .data = raw, .len = len };
+        size_t b64_len = ((len + 2) / 3) * 4;
+        base64_encode_with(base64_encode_scalar, raw_buf, expected);
+
+        for (size_t j = 0; j < count; j++) {
+            memset(b64, 0, sizeof(b64));
+            base64_encode_with(impls[j].encode, raw_buf, b64);
+            TEST_ASSERT_EQUAL_MEMORY(expected, b64, b64_len);
+
+            GgBuffer out = GG_BUF(decoded);
+            TEST_ASSERT_TRUE(base64_decode_with(
+                impls[j].decode, (GgBuffer) { b64, b64_len }, &out
+            ));
+            GG_TEST_ASSERT_BUF_EQUAL(raw_buf, out);
+
+            // Decoding in place, with exactly sized output
+            GgBuffer in_place = { .data = b64, .len = b64_len };
+            TEST_ASSERT_TRUE(
+                base64_decode_with(impls[j].decode, in_place, &in_place)
+            );
+            GG_TEST_ASSERT_BUF_EQUAL(raw_buf, in_place);
+        }
+    }
+}
+
+GG_TEST_DEFINE(base64_impls_reject_invalid) {
+    Base64Impl impls[3];
+    size_t count = base64_test_impls(impls);
+    uint8_t b64[128];
+    uint8_t decoded[96];
+    static const uint8_t BAD[] = { '=', '-', '_', ' ', '\0', '@', '[', '`',
+                                   '{', 0x7F, 0x80, 0xC3, 0xFF, '.', ':' };
+
+    for (size_t len = 4; len <= sizeof(b64); len += 4) {
+        memset(b64, 'A', len);
+        for (size_t pos = 0; pos < len; pos++) {
+            for (size_t k = 0; k < sizeof(BAD); k++) {
+                uint8_t saved = b64[pos];
+                b64[pos] = BAD[k];
+                GgBuffer in = { .data = b64, .len = len };
+                GgBuffer ref_out = GG_BUF(decoded);
+                bool expected = base64_decode_reference(in, &ref_out);
+                size_t expected_len = ref_out.len;
+                for (size_t j = 0; j < count; j++) {
+                    GgBuffer out = GG_BUF(decoded);
+                    bool ret = base64_decode_with(impls[j].decode, in, &out);
+                    TEST_ASSERT_EQUAL(expected, ret);
+                    if (ret) {
+                        TEST_ASSERT_EQUAL(expected_len, out.len);
+                    }
+                }
+                b64[pos] = saved;
+            }
+        }
+    }
+
+    // Trailing bits under padding must be zero
+    GgBuffer out = GG_BUF(decoded);
+    TEST_ASSERT_FALSE(gg_base64_decode(GG_STR("Zh=="), &out));
+}
+
+GG_TEST_DEFINE(base64_append_to_vec) {
+    uint8_t mem[12];
+    GgByteVec vec = GG_BYTE_VEC(mem);
+    GgError ret = GG_ERR_OK;
+    gg_byte_vec_chain_append(&ret, &vec, GG_STR("\""));
+    gg_byte_vec_chain_append_base64(&ret, &vec, GG_STR("foobar"));
+    gg_byte_vec_chain_push(&ret, &vec, '"');
+    GG_TEST_ASSERT_OK(ret);
+    GG_TEST_ASSERT_BUF_EQUAL_STR(GG_STR("\"Zm9vYmFy\""), vec.buf);
+
+    // Does not partially write when out of space
+    TEST_ASSERT_EQUAL(
+        GG_ERR_NOMEM, gg_byte_vec_append_base64(&vec, GG_STR("f"))
+    );
+    TEST_ASSERT_EQUAL(10, vec.buf.len);
+    GG_TEST_ASSERT_OK(gg_byte_vec_append_base64(&vec, GG_STR("")));
+    TEST_ASSERT_EQUAL(10, vec.buf.len);
+}
+
+#endif
@@ -17,14 +17,21 @@ GgBuffer gg_buffer_from_null_term(char str[static 1]) {
     return (GgBuffer) { .data = (uint8_t *) str, .len = strlen(str) };
 }
 
-bool gg_buffer_eq(GgBuffer buf1, GgBuffer buf2) {
-    if (buf1.len == buf2.len) {
-        if (buf1.len == 0) {
-            return true;
+// NOLINTNEXTLINE(readability-redundant-declaration)
+extern inline typeof(gg_buffer_eq) gg_buffer_eq;
+
+int gg_buffer_cmp(GgBuffer buf1, GgBuffer buf2) {
+    size_t len = buf1.len < buf2.len ? buf1.len : buf2.len;
+    if (len != 0) {
+        int ret = memcmp(buf1.data, buf2.data, len);
+        if (ret != 0) {
+            return ret;
         }
-        return memcmp(buf1.data, buf2.data, buf1.len) == 0;
     }
-    return false;
+    if (buf1.len == buf2.len) {
+        return 0;
+    }
+    return buf1.len < buf2.len ? -1 : 1;
 }
 
 bool gg_buffer_has_prefix(GgBuffer buf, GgBuffer prefix) {
@@ -0,0 +1,647 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <assert.h>
+#include <gg/arena.h>
+#include <gg/buffer.h>
+#include <gg/cbor_decode.h>
+#include <gg/error.h>
+#include <gg/log.h>
+#include <gg/map.h>
+#include <gg/object.h>
+#include <gg/utf8.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define CBOR_MAJOR_UINT 0U
+#define CBOR_MAJOR_NINT 1U
+#define CBOR_MAJOR_BYTES 2U
+#define CBOR_MAJOR_TEXT 3U
+#define CBOR_MAJOR_ARRAY 4U
+#define CBOR_MAJOR_MAP 5U
+#define CBOR_MAJOR_TAG 6U
+#define CBOR_MAJOR_SIMPLE 7U
+
+#define CBOR_FALSE 20U
+#define CBOR_TRUE 21U
+#define CBOR_NULL 22U
+#define CBOR_UNDEFINED 23U
+#define CBOR_FLOAT16 25U
+#define CBOR_FLOAT32 26U
+#define CBOR_FLOAT64 27U
+#define CBOR_INDEFINITE 31U
+
+typedef struct {
+    GgBuffer buf;
+    GgArena *arena;
+    GgObjectLimits limits;
+    size_t subobjects;
+} CborDecoder;
+
+typedef struct {
+    uint8_t major;
+    uint8_t info;
+    uint64_t arg;
+} CborHead;
+
+static uint64_t load_be(const uint8_t *src, size_t len) {
+    uint64_t val = 0;
+    for (size_t i = 0; i < len; i++) {
+        val = (val << 8) | src[i];
+    }
+    return val;
+}
+
+static GgError take_head(CborDecoder *dec, CborHead *head) {
+    if (dec->buf.len < 1) {
+        GG_LOGE("Unexpected end of CBOR data.");
+        return GG_ERR_PARSE;
+    }
+    uint8_t initial = dec->buf.data[0];
+    head->major = initial >> 5;
+    head->info = initial & 0x1FU;
+
+    size_t arg_len;
+    if (head->info < 24) {
+        arg_len = 0;
+    } else if (head->info <= 27) {
+        arg_len = (size_t) 1 << (head->info - 24);
+    } else if (head->info == CBOR_INDEFINITE) {
+        GG_LOGE("Indefinite-length CBOR items are not supported.");
+        return GG_ERR_PARSE;
+    } else {
+        GG_LOGE("Reserved CBOR additional information value.");
+        return GG_ERR_PARSE;
+    }
+
+    if (dec->buf.len - 1 < arg_len) {
+        GG_LOGE("Unexpected end of CBOR data.");
+        return GG_ERR_PARSE;
+    }
+    head->arg = (arg_len == 0) ? head->info
+                               : load_be(&dec->buf.data[1], arg_len);
+    dec->buf = gg_buffer_substr(dec->buf, 1 + arg_len, SIZE_MAX);
+    return GG_ERR_OK;
+}
+
+static GgError take_string(CborDecoder *dec, CborHead head, GgBuffer *str) {
+    if (head.arg > UINT16_MAX) {
+        GG_LOGE("CBOR string length exceeds maximum.");
+        return GG_ERR_RANGE;
+    }
+    if (head.arg > dec->buf.len) {
+        GG_LOGE("Unexpected end of CBOR data.");
+        return GG_ERR_PARSE;
+    }
+    GgBuffer val = { .data = dec->buf.data, .len = (size_t) head.arg };
+    if ((head.major == CBOR_MAJOR_TEXT) && !gg_utf8_validate(val)) {
+        GG_LOGE("CBOR text string is not valid UTF-8.");
+        return GG_ERR_PARSE;
+    }
+    dec->buf = gg_buffer_substr(dec->buf, val.len, SIZE_MAX);
+    *str = val;
+    return GG_ERR_OK;
+}
+
+static double f16_to_f64(uint16_t half) {
+    uint64_t sign = (uint64_t) (half >> 15) << 63;
+    uint64_t exp = (half >> 10) & 0x1FU;
+    uint64_t mant = half & 0x3FFU;
+
+    if (exp == 0) {
+        // Zero or subnormal; exact since scaling by a power of two
+        double val = (double) mant / 16777216.0;
+        return (sign != 0) ? -val : val;
+    }
+
+    uint64_t bits = sign | (mant << 42);
+    if (exp == 0x1F) {
+        bits |= (uint64_t) 0x7FF << 52;
+    } else {
+        bits |= (exp - 15 + 1023) << 52;
+    }
+    double val;
+    memcpy(&val, &bits, sizeof(val));
+    return val;
+}
+
+static GgError decode_simple(CborHead head, GgObject *obj) {
+    switch (head.info) {
+    case CBOR_FALSE:
+        *obj = gg_obj_bool(false);
+        return GG_ERR_OK;
+    case CBOR_TRUE:
+        *obj = gg_obj_bool(true);
+        return GG_ERR_OK;
+    case CBOR_NULL:
+    case CBOR_UNDEFINED:
+        *obj = GG_OBJ_NULL;
+        return GG_ERR_OK;
+    case CBOR_FLOAT16:
+        *obj = gg_obj_f64(f16_to_f64((uint16_t) head.arg));
+        return GG_ERR_OK;
+    case CBOR_FLOAT32: {
+        uint32_t bits = (uint32_t) head.arg;
+        float val;
+        memcpy(&val, &bits, sizeof(val));
+        *obj = gg_obj_f64((double) val);
+        return GG_ERR_OK;
+    }
+    case CBOR_FLOAT64: {
+        double val;
+        memcpy(&val, &head.arg, sizeof(val));
+        *obj = gg_obj_f64(val);
+        return GG_ERR_OK;
+    }
+    default:
+        GG_LOGE("Unsupported CBOR simple value.");
+        return GG_ERR_PARSE;
+    }
+}
+
+static GgError take_cbor_val(CborDecoder *dec, size_t depth, GgObject *obj);
+
+// NOLINTNEXTLINE(misc-no-recursion)
+static GgError decode_cbor_array(
+    CborDecoder *dec, size_t count, size_t depth, GgObject *obj
+) {
+    if (count > dec->limits.max_subobjects - dec->subobjects) {
+        GG_LOGE("CBOR object's subobjects exceeds maximum.");
+        return GG_ERR_RANGE;
+    }
+    dec->subobjects += count;
+
+    GgObject *items = NULL;
+    if ((count > 0) && (obj != NULL)) {
+        items = GG_ARENA_ALLOCN(dec->arena, GgObject, count);
+        if (items == NULL) {
+            GG_LOGE("Insufficent memory to decode CBOR.");
+            return GG_ERR_NOMEM;
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        GgError ret = take_cbor_val(
+            dec, depth + 1, (items == NULL) ? NULL : &items[i]
+        );
+        if (ret != GG_ERR_OK) {
+            return ret;
+        }
+    }
+
+    if (obj != NULL) {
+        *obj = gg_obj_list((GgList) { .items = items, .len = count });
+    }
+    return GG_ERR_OK;
+}
+
+// NOLINTNEXTLINE(misc-no-recursion)
+static GgError decode_cbor_map(
+    CborDecoder *dec, size_t count, size_t depth, GgObject *obj
+) {
+    if (count > (dec->limits.max_subobjects - dec->subobjects) / 2) {
+        GG_LOGE("CBOR object's subobjects exceeds maximum.");
+        return GG_ERR_RANGE;
+    }
+    dec->subobjects += count * 2;
+
+    GgKV *pairs = NULL;
+    if ((count > 0) && (obj != NULL)) {
+        pairs = GG_ARENA_ALLOCN(dec->arena, GgKV, count);
+        if (pairs == NULL) {
+            GG_LOGE("Insufficent memory to decode CBOR.");
+            return GG_ERR_NOMEM;
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        CborHead head;
+        GgError ret = take_head(dec, &head);
+        if (ret != GG_ERR_OK) {
+            return ret;
+        }
+        if ((head.major != CBOR_MAJOR_TEXT)
+            && (head.major != CBOR_MAJOR_BYTES)) {
+            GG_LOGE("Non-string key type when decoding CBOR map.");
+            return GG_ERR_PARSE;
+        }
+        GgBuffer key;
+        ret = take_string(dec, head, &key);
+        if (ret != GG_ERR_OK) {
+            return ret;
+        }
+        if (pairs != NULL) {
+            pairs[i] = gg_kv(key, GG_OBJ_NULL);
+        }
+
+        ret = take_cbor_val(
+            dec, depth + 1, (pairs == NULL) ? NULL : gg_kv_val(&pairs[i])
+        );
+        if (ret != GG_ERR_OK) {
+            return ret;
+        }
+    }
+
+    if (obj != NULL) {
+        GgMap map = { .pairs = pairs, .len = count };
+        gg_map_canonicalize_shallow(&map);
+        *obj = gg_obj_map(map);
+    }
+    return GG_ERR_OK;
+}
+
+// NOLINTNEXTLINE(misc-no-recursion)
+static GgError take_cbor_val(CborDecoder *dec, size_t depth, GgObject *obj) {
+    assert(dec != NULL);
+
+    if (depth > dec->limits.max_depth) {
+        GG_LOGE("CBOR object's depth exceeds maximum.");
+        return GG_ERR_RANGE;
+    }
+
+    CborHead head;
+    GgError ret;
+
+    // Tags carry no meaning for GgObjects; skip without recursing
+    do {
+        ret = take_head(dec, &head);
+        if (ret != GG_ERR_OK) {
+            return ret;
+        }
+    } while (head.major == CBOR_MAJOR_TAG);
+
+    GgObject val = GG_OBJ_NULL;
+
+    switch (head.major) {
+    case CBOR_MAJOR_UINT:
+        if (head.arg > INT64_MAX) {
+            GG_LOGE("CBOR integer out of range of int64_t.");
+            return GG_ERR_RANGE;
+        }
+        val = gg_obj_i64((int64_t) head.arg);
+        break;
+    case CBOR_MAJOR_NINT:
+        if (head.arg > INT64_MAX) {
+            GG_LOGE("CBOR integer out of range of int64_t.");
+            return GG_ERR_RANGE;
+        }
+        val = gg_obj_i64(-1 - (int64_t) head.arg);
+        break;
+    case CBOR_MAJOR_BYTES:
+    case CBOR_MAJOR_TEXT: {
+        GgBuffer str;
+        ret = take_string(dec, head, &str);
+        if (ret != GG_ERR_OK) {
+            return ret;
+        }
+        val = gg_obj_buf(str);
+        break;
+    }
+    case CBOR_MAJOR_ARRAY:
+        // Count is bounded by the subobject limit before use
+        return decode_cbor_array(
+            dec,
+            (head.arg > SIZE_MAX) ? SIZE_MAX : (size_t) head.arg,
+            depth,
+            obj
+        );
+    case CBOR_MAJOR_MAP:
+        return decode_cbor_map(
+            dec,
+            (head.arg > SIZE_MAX) ? SIZE_MAX : (size_t) head.arg,
+            depth,
+            obj
+        );
+    default:
+        ret = decode_simple(head, &val);
+        if (ret != GG_ERR_OK) {
+            return ret;
+        }
+        break;
+    }
+
+    if (obj != NULL) {
+        *obj = val;
+    }
+    return GG_ERR_OK;
+}
+
+GgError gg_cbor_decode(GgBuffer buf, GgArena *arena, GgObject *obj) {
+    return gg_cbor_decode_with_limits(
+        buf, arena, obj, GG_OBJECT_LIMITS_DEFAULT
+    );
+}
+
+GgError gg_cbor_decode_with_limits(
+    GgBuffer buf, GgArena *arena, GgObject *obj, GgObjectLimits limits
+) {
+    // Handle NULL arena arg
+    GgArena empty_arena = { 0 };
+    GgArena *result_arena = (arena == NULL) ? &empty_arena : arena;
+
+    // Copy to avoid committing allocation on error path
+    GgArena arena_copy = *result_arena;
+
+    CborDecoder dec = {
+        .buf = buf, .arena = &arena_copy, .limits = limits, .subobjects = 0
+    };
+
+    GgError ret = take_cbor_val(&dec, 1, obj);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+
+    if (dec.buf.len > 0) {
+        GG_LOGE("Trailing buffer content when decoding CBOR.");
+        return GG_ERR_PARSE;
+    }
+
+    if (obj != NULL) {
+        // Commit allocations
+        *result_arena = arena_copy;
+    }
+
+    return GG_ERR_OK;
+}
+
+#ifdef GG_SDK_TESTING
+#include <gg/cbor_encode.h>
+#include <gg/object_compare.h>
+#include <gg/test.h>
+#include <gg/vector.h>
+#include <unity.h>
+
+static void gg_test_cbor_decode(
+    GgObject expected, GgBuffer cbor, UNITY_UINT line_no
+) {
+    uint8_t arena_bytes[GG_CBOR_DECODE_MAX_ALLOC];
+    GgArena arena = gg_arena_init(GG_BUF(arena_bytes));
+    GgObject actual = GG_OBJ_NULL;
+    gg_test_assert_ok(
+        gg_cbor_decode(cbor, &arena, &actual), "Failed to decode CBOR.", line_no
+    );
+    if (!gg_obj_eq(expected, actual)) {
+        UnityFail("Decoded CBOR does not match expected object.", line_no);
+    }
+}
+
+static void gg_test_cbor_decode_err(
+    GgError expected, GgBuffer cbor, UNITY_UINT line_no
+) {
+    uint8_t arena_bytes[GG_CBOR_DECODE_MAX_ALLOC];
+    GgArena arena = gg_arena_init(GG_BUF(arena_bytes));
+    GgObject actual = GG_OBJ_NULL;
+    UnityAssertEqualNumber(
+        (UNITY_INT) expected,
+        (UNITY_INT) gg_cbor_decode(cbor, &arena, &actual),
+        "Wrong CBOR decode result.",
+        line_no,
+        UNITY_DISPLAY_STYLE_INT
+    );
+    UnityAssertEqualNumber(
+        0,
+        (UNITY_INT) arena.index,
+        "Arena allocations committed on error.",
+        line_no,
+        UNITY_DISPLAY_STYLE_UINT
+    );
+}
+
+#define GG_TEST_CBOR_DECODE(obj, ...) \
+    gg_test_cbor_decode(obj, GG_BUF(((uint8_t[]) { __VA_ARGS__ })), __LINE__)
+
+#define GG_TEST_CBOR_DECODE_ERR(err, ...) \
+    gg_test_cbor_decode_err( \
+        err, GG_BUF(((uint8_t[]) { __VA_ARGS__ })), __LINE__ \
+    )
+
+// Examples from RFC 8949 Appendix A
+GG_TEST_DEFINE(cbor_decode_scalars) {
+    GG_TEST_CBOR_DECODE(gg_obj_i64(0), 0x00);
+    GG_TEST_CBOR_DECODE(gg_obj_i64(100), 0x18, 0x64);
+    GG_TEST_CBOR_DECODE(gg_obj_i64(1000000), 0x1a, 0x00, 0x0f, 0x42, 0x40);
+    GG_TEST_CBOR_DECODE(gg_obj_i64(-100), 0x38, 0x63);
+    // Non-preferred serialization is accepted
+    GG_TEST_CBOR_DECODE(gg_obj_i64(10), 0x19, 0x00, 0x0a);
+    GG_TEST_CBOR_DECODE(
+        gg_obj_i64(INT64_MAX),
+        0x1b,
+        0x7f,
+        0xff,
+        0xff,
+        0xff,
+        0xff,
+        0xff,
+        0xff,
+        0xff
+    );
+    GG_TEST_CBOR_DECODE(gg_obj_f64(0.0), 0xf9, 0x00, 0x00);
+    GG_TEST_CBOR_DECODE(gg_obj_f64(1.5), 0xf9, 0x3e, 0x00);
+    GG_TEST_CBOR_DECODE(gg_obj_f64(65504.0), 0xf9, 0x7b, 0xff);
+    GG_TEST_CBOR_DECODE(gg_obj_f64(5.960464477539063e-8), 0xf9, 0x00, 0x01);
+    GG_TEST_CBOR_DECODE(gg_obj_f64(-4.0), 0xf9, 0xc4, 0x00);
+    GG_TEST_CBOR_DECODE(gg_obj_f64(100000.0), 0xfa, 0x47, 0xc3, 0x50, 0x00);
+    GG_TEST_CBOR_DECODE(
+        gg_obj_f64(-4.1), 0xfb, 0xc0, 0x10, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66
+    );
+    GG_TEST_CBOR_DECODE(gg_obj_bool(false), 0xf4);
+    GG_TEST_CBOR_DECODE(gg_obj_bool(true), 0xf5);
+    GG_TEST_CBOR_DECODE(GG_OBJ_NULL, 0xf6);
+    GG_TEST_CBOR_DECODE(GG_OBJ_NULL, 0xf7);
+    GG_TEST_CBOR_DECODE(
+        gg_obj_buf(GG_BUF(((uint8_t[]) { 1, 2, 3, 4 }))), 0x44, 1, 2, 3, 4
+    );
+    GG_TEST_CBOR_DECODE(gg_obj_buf(GG_STR("a")), 0x61, 0x61);
+    GG_TEST_CBOR_DECODE(gg_obj_buf(GG_STR("\xc3\xbc")), 0x62, 0xc3, 0xbc);
+    // Tags are skipped
+    GG_TEST_CBOR_DECODE(
+        gg_obj_i64(1363896240), 0xc1, 0x1a, 0x51, 0x4b, 0x67, 0xb0
+    );
+}
+
+GG_TEST_DEFINE(cbor_decode_containers) {
+    GG_TEST_CBOR_DECODE(gg_obj_list((GgList) { 0 }), 0x80);
+    GG_TEST_CBOR_DECODE(gg_obj_map((GgMap) { 0 }), 0xa0);
+    GG_TEST_CBOR_DECODE(
+        gg_obj_list(GG_LIST(
+            gg_obj_i64(1),
+            gg_obj_list(GG_LIST(gg_obj_i64(2), gg_obj_i64(3))),
+            gg_obj_list(GG_LIST(gg_obj_i64(4), gg_obj_i64(5)))
+        )),
+        0x83,
+        0x01,
+        0x82,
+        0x02,
+        0x03,
+        0x82,
+        0x04,
+        0x05
+    );
+    GG_TEST_CBOR_DECODE(
+        gg_obj_map(GG_MAP(
+            gg_kv(GG_STR("a"), gg_obj_buf(GG_STR("A"))),
+            gg_kv(GG_STR("b"), gg_obj_buf(GG_STR("B")))
+        )),
+        0xa2,
+        0x61,
+        0x62,
+        0x61,
+        0x42,
+        0x61,
+        0x61,
+        0x61,
+        0x41
+    );
+}
+
+GG_TEST_DEFINE(cbor_decode_invalid) {
+    // Empty and truncated input
+    GG_TEST_ASSERT_BAD(gg_cbor_decode(GG_STR(""), NULL, NULL));
+    GG_TEST_CBOR_DECODE_ERR(GG_ERR_PARSE, 0x19, 0x03);
+    GG_TEST_CBOR_DECODE_ERR(GG_ERR_PARSE, 0x64, 0x49, 0x45);
+    GG_TEST_CBOR_DECODE_ERR(GG_ERR_PARSE, 0x82, 0x01);
+    // Trailing data
+    GG_TEST_CBOR_DECODE_ERR(GG_ERR_PARSE, 0x01, 0x02);
+    // Reserved and indefinite lengths
+    GG_TEST_CBOR_DECODE_ERR(GG_ERR_PARSE, 0x1c);
+    GG_TEST_CBOR_DECODE_ERR(GG_ERR_PARSE, 0x9f, 0xff);
+    GG_TEST_CBOR_DECODE_ERR(GG_ERR_PARSE, 0x7f, 0xff);
+    // Unsupported simple values
+    GG_TEST_CBOR_DECODE_ERR(GG_ERR_PARSE, 0xf0);
+    GG_TEST_CBOR_DECODE_ERR(GG_ERR_PARSE, 0xf8, 0xff);
+    // Invalid UTF-8 in text string
+    GG_TEST_CBOR_DECODE_ERR(GG_ERR_PARSE, 0x61, 0xff);
+    // Non-string map key
+    GG_TEST_CBOR_DECODE_ERR(GG_ERR_PARSE, 0xa1, 0x01, 0x02);
+    // Integers out of range
+    GG_TEST_CBOR_DECODE_ERR(
+        GG_ERR_RANGE, 0x1b, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+    );
+    GG_TEST_CBOR_DECODE_ERR(
+        GG_ERR_RANGE, 0x3b, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+    );
+    // Huge lengths are rejected before allocation or reading
+    GG_TEST_CBOR_DECODE_ERR(GG_ERR_RANGE, 0x9a, 0xff, 0xff, 0xff, 0xff);
+    GG_TEST_CBOR_DECODE_ERR(GG_ERR_RANGE, 0xba, 0x00, 0x00, 0x00, 0x80);
+    GG_TEST_CBOR_DECODE_ERR(GG_ERR_RANGE, 0x5a, 0x00, 0x01, 0x00, 0x00);
+}
+
+GG_TEST_DEFINE(cbor_decode_limits) {
+    uint8_t cbor[GG_MAX_OBJECT_SUBOBJECTS + 3];
+
+    // [[[...[null]...]]] at maximum depth
+    memset(cbor, 0x81, GG_MAX_OBJECT_DEPTH - 1);
+    cbor[GG_MAX_OBJECT_DEPTH - 1] = 0xf6;
+    GG_TEST_ASSERT_OK(gg_cbor_decode(
+        (GgBuffer) { .data = cbor, .len = GG_MAX_OBJECT_DEPTH }, NULL, NULL
+    ));
+    memset(cbor, 0x81, GG_MAX_OBJECT_DEPTH);
+    cbor[GG_MAX_OBJECT_DEPTH] = 0xf6;
+    TEST_ASSERT_EQUAL(
+        GG_ERR_RANGE,
+        gg_cbor_decode(
+            (GgBuffer) { .data = cbor, .len = GG_MAX_OBJECT_DEPTH + 1 },
+            NULL,
+            NULL
+        )
+    );
+
+    // [null, ...] at maximum subobjects
+    cbor[0] = 0x98;
+    cbor[1] = GG_MAX_OBJECT_SUBOBJECTS;
+    memset(&cbor[2], 0xf6, GG_MAX_OBJECT_SUBOBJECTS);
+    {
+        // Maximum allocation fits in GG_CBOR_DECODE_MAX_ALLOC
+        uint8_t arena_bytes[GG_CBOR_DECODE_MAX_ALLOC];
+        GgArena arena = gg_arena_init(GG_BUF(arena_bytes));
+        GgObject obj;
+        GG_TEST_ASSERT_OK(gg_cbor_decode(
+            (GgBuffer) { .data = cbor, .len = GG_MAX_OBJECT_SUBOBJECTS + 2 },
+            &arena,
+            &obj
+        ));
+        TEST_ASSERT_EQUAL(
+            GG_MAX_OBJECT_SUBOBJECTS, gg_obj_into_list(obj).len
+        );
+    }
+    cbor[0] = 0x99;
+    cbor[1] = 0x01;
+    cbor[2] = 0x00;
+    TEST_ASSERT_EQUAL(
+        GG_ERR_RANGE,
+        gg_cbor_decode(
+            (GgBuffer) { .data = cbor, .len = sizeof(cbor) }, NULL, NULL
+        )
+    );
+
+    // Insufficient arena memory is not committed
+    uint8_t small[sizeof(GgObject)];
+    GgArena arena = gg_arena_init(GG_BUF(small));
+    GgObject obj;
+    TEST_ASSERT_EQUAL(
+        GG_ERR_NOMEM,
+        gg_cbor_decode(
+            GG_BUF(((uint8_t[]) { 0x81, 0x81, 0x01 })), &arena, &obj
+        )
+    );
+    TEST_ASSERT_EQUAL(0, arena.index);
+}
+
+GG_TEST_DEFINE(cbor_decode_with_limits) {
+    // [[[...[null]...]]] nested past the default depth
+    enum { DEPTH = GG_MAX_OBJECT_DEPTH * 3 };
+    uint8_t cbor[DEPTH];
+    memset(cbor, 0x81, DEPTH - 1);
+    cbor[DEPTH - 1] = 0xf6;
+    uint8_t mem[DEPTH * sizeof(GgObject)];
+    GgArena arena = gg_arena_init(GG_BUF(mem));
+    GgObject obj = GG_OBJ_NULL;
+
+    TEST_ASSERT_EQUAL(
+        GG_ERR_RANGE, gg_cbor_decode(GG_BUF(cbor), &arena, &obj)
+    );
+
+    GgObjectLimits limits = { .max_depth = DEPTH, .max_subobjects = DEPTH };
+    GG_TEST_ASSERT_OK(
+        gg_cbor_decode_with_limits(GG_BUF(cbor), &arena, &obj, limits)
+    );
+
+    uint8_t out[DEPTH];
+    GgByteVec vec = gg_byte_vec_init(GG_BUF(out));
+    TEST_ASSERT_EQUAL(
+        GG_ERR_RANGE, gg_cbor_encode(obj, gg_byte_vec_writer(&vec))
+    );
+    vec = gg_byte_vec_init(GG_BUF(out));
+    GG_TEST_ASSERT_OK(
+        gg_cbor_encode_with_limits(obj, gg_byte_vec_writer(&vec), limits)
+    );
+    GG_TEST_ASSERT_BUF_EQUAL(GG_BUF(cbor), vec.buf);
+}
+
+GG_TEST_DEFINE(cbor_round_trip) {
+    GgObject obj = gg_obj_map(GG_MAP(
+        gg_kv(GG_STR("bin"), gg_obj_buf(GG_BUF(((uint8_t[]) { 0, 0xff })))),
+        gg_kv(GG_STR("f"), gg_obj_f64(0.1)),
+        gg_kv(GG_STR("i"), gg_obj_i64(-123456789012)),
+        gg_kv(
+            GG_STR("list"),
+            gg_obj_list(GG_LIST(
+                GG_OBJ_NULL,
+                gg_obj_bool(true),
+                gg_obj_f64(2.5),
+                gg_obj_map(GG_MAP(gg_kv(GG_STR("k"), gg_obj_i64(300))))
+            ))
+        ),
+        gg_kv(GG_STR("str"), gg_obj_buf(GG_STR("hello \xe2\x82\xac")))
+    ));
+
+    uint8_t mem[128];
+    GgByteVec vec = gg_byte_vec_init(GG_BUF(mem));
+    GG_TEST_ASSERT_OK(gg_cbor_encode(obj, gg_byte_vec_writer(&vec)));
+    gg_test_cbor_decode(obj, vec.buf, __LINE__);
+}
+
+#endif
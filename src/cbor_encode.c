@@ -0,0 +1,350 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <float.h>
+#include <gg/buffer.h>
+#include <gg/cbor_encode.h>
+#include <gg/error.h>
+#include <gg/io.h>
+#include <gg/object.h>
+#include <gg/object_visit.h>
+#include <gg/utf8.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define CBOR_MAJOR_UINT 0U
+#define CBOR_MAJOR_NINT 1U
+#define CBOR_MAJOR_BYTES 2U
+#define CBOR_MAJOR_TEXT 3U
+#define CBOR_MAJOR_ARRAY 4U
+#define CBOR_MAJOR_MAP 5U
+#define CBOR_MAJOR_SIMPLE 7U
+
+#define CBOR_FALSE 20U
+#define CBOR_TRUE 21U
+#define CBOR_NULL 22U
+#define CBOR_FLOAT32 26U
+#define CBOR_FLOAT64 27U
+
+static void store_be(uint8_t *dest, uint64_t val, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        dest[len - 1 - i] = (uint8_t) (val >> (8 * i));
+    }
+}
+
+/// Writes an initial byte with argument in the shortest form.
+static GgError cbor_write_head(GgWriter writer, uint8_t major, uint64_t arg) {
+    uint8_t head[9];
+    size_t arg_len;
+    uint8_t info;
+
+    if (arg < 24) {
+        arg_len = 0;
+        info = (uint8_t) arg;
+    } else if (arg <= UINT8_MAX) {
+        arg_len = 1;
+        info = 24;
+    } else if (arg <= UINT16_MAX) {
+        arg_len = 2;
+        info = 25;
+    } else if (arg <= UINT32_MAX) {
+        arg_len = 4;
+        info = 26;
+    } else {
+        arg_len = 8;
+        info = 27;
+    }
+
+    head[0] = (uint8_t) (major << 5) | info;
+    store_be(&head[1], arg, arg_len);
+    return gg_writer_call(
+        writer, (GgBuffer) { .data = head, .len = arg_len + 1 }
+    );
+}
+
+static GgError cbor_write_simple(GgWriter writer, uint8_t val) {
+    uint8_t byte = (uint8_t) (CBOR_MAJOR_SIMPLE << 5) | val;
+    return gg_writer_call(writer, (GgBuffer) { .data = &byte, .len = 1 });
+}
+
+static GgError cbor_encode_on_null(void *ctx) {
+    GgWriter *writer = ctx;
+    return cbor_write_simple(*writer, CBOR_NULL);
+}
+
+static GgError cbor_encode_on_bool(void *ctx, bool val) {
+    GgWriter *writer = ctx;
+    return cbor_write_simple(*writer, val ? CBOR_TRUE : CBOR_FALSE);
+}
+
+static GgError cbor_encode_on_i64(void *ctx, int64_t val) {
+    GgWriter *writer = ctx;
+    if (val >= 0) {
+        return cbor_write_head(*writer, CBOR_MAJOR_UINT, (uint64_t) val);
+    }
+    // Negative integers are encoded as -1 - n
+    return cbor_write_head(*writer, CBOR_MAJOR_NINT, (uint64_t) (-(val + 1)));
+}
+
+static GgError cbor_encode_on_f64(void *ctx, double val) {
+    GgWriter *writer = ctx;
+    uint8_t encoded[9];
+    size_t len;
+
+    // Comparisons are false for NaN, so NaN is always encoded as double
+    bool fits_float = (val >= -FLT_MAX) && (val <= FLT_MAX)
+        && ((double) (float) val == val);
+
+    if (fits_float) {
+        float single = (float) val;
+        uint32_t bits;
+        memcpy(&bits, &single, sizeof(bits));
+        encoded[0] = (uint8_t) (CBOR_MAJOR_SIMPLE << 5) | CBOR_FLOAT32;
+        store_be(&encoded[1], bits, sizeof(bits));
+        len = 1 + sizeof(bits);
+    } else {
+        uint64_t bits;
+        memcpy(&bits, &val, sizeof(bits));
+        encoded[0] = (uint8_t) (CBOR_MAJOR_SIMPLE << 5) | CBOR_FLOAT64;
+        store_be(&encoded[1], bits, sizeof(bits));
+        len = 1 + sizeof(bits);
+    }
+
+    return gg_writer_call(*writer, (GgBuffer) { .data = encoded, .len = len });
+}
+
+static GgError cbor_write_buf(GgWriter writer, GgBuffer val) {
+    uint8_t major
+        = gg_utf8_validate(val) ? CBOR_MAJOR_TEXT : CBOR_MAJOR_BYTES;
+    GgError ret = cbor_write_head(writer, major, val.len);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    return gg_writer_call(writer, val);
+}
+
+static GgError cbor_encode_on_buf(void *ctx, GgBuffer val, GgObject *obj) {
+    GgWriter *writer = ctx;
+    (void) obj;
+    return cbor_write_buf(*writer, val);
+}
+
+static GgError cbor_encode_on_list(void *ctx, GgList val, GgObject *obj) {
+    GgWriter *writer = ctx;
+    (void) obj;
+    return cbor_write_head(*writer, CBOR_MAJOR_ARRAY, val.len);
+}
+
+static GgError cbor_encode_on_map(void *ctx, GgMap val, GgObject *obj) {
+    GgWriter *writer = ctx;
+    (void) obj;
+    return cbor_write_head(*writer, CBOR_MAJOR_MAP, val.len);
+}
+
+static GgError cbor_encode_on_map_key(void *ctx, GgBuffer key, GgKV *kv) {
+    GgWriter *writer = ctx;
+    (void) kv;
+    return cbor_write_buf(*writer, key);
+}
+
+GgError gg_cbor_encode(GgObject obj, GgWriter writer) {
+    return gg_cbor_encode_with_limits(obj, writer, GG_OBJECT_LIMITS_DEFAULT);
+}
+
+GgError gg_cbor_encode_with_limits(
+    GgObject obj, GgWriter writer, GgObjectLimits limits
+) {
+    // Containers have definite lengths, so no separators or terminators
+    const GgObjectVisitHandlers VISIT_HANDLERS = {
+        .on_null = cbor_encode_on_null,
+        .on_bool = cbor_encode_on_bool,
+        .on_i64 = cbor_encode_on_i64,
+        .on_f64 = cbor_encode_on_f64,
+        .on_buf = cbor_encode_on_buf,
+        .on_list = cbor_encode_on_list,
+        .on_map = cbor_encode_on_map,
+        .on_map_key = cbor_encode_on_map_key,
+    };
+    return gg_obj_visit_with_limits(&VISIT_HANDLERS, &writer, &obj, limits);
+}
+
+#ifdef GG_SDK_TESTING
+#include <gg/map.h>
+#include <gg/test.h>
+#include <gg/vector.h>
+#include <unity.h>
+
+static void gg_test_cbor_encode(
+    GgObject obj, GgBuffer expected, UNITY_UINT line_no
+) {
+    uint8_t mem[64];
+    GgByteVec vec = gg_byte_vec_init(GG_BUF(mem));
+    gg_test_assert_ok(
+        gg_cbor_encode(obj, gg_byte_vec_writer(&vec)),
+        "Failed to encode CBOR.",
+        line_no
+    );
+    UnityAssertEqualNumber(
+        (UNITY_INT) expected.len,
+        (UNITY_INT) vec.buf.len,
+        "Wrong encoded length.",
+        line_no,
+        UNITY_DISPLAY_STYLE_UINT
+    );
+    if (memcmp(expected.data, vec.buf.data, expected.len) != 0) {
+        UnityFail("Wrong encoded bytes.", line_no);
+    }
+}
+
+#define GG_TEST_CBOR_ENCODE(obj, ...) \
+    gg_test_cbor_encode( \
+        obj, GG_BUF(((uint8_t[]) { __VA_ARGS__ })), __LINE__ \
+    )
+
+// Examples from RFC 8949 Appendix A
+GG_TEST_DEFINE(cbor_encode_scalars) {
+    GG_TEST_CBOR_ENCODE(gg_obj_i64(0), 0x00);
+    GG_TEST_CBOR_ENCODE(gg_obj_i64(23), 0x17);
+    GG_TEST_CBOR_ENCODE(gg_obj_i64(24), 0x18, 0x18);
+    GG_TEST_CBOR_ENCODE(gg_obj_i64(1000), 0x19, 0x03, 0xe8);
+    GG_TEST_CBOR_ENCODE(gg_obj_i64(1000000), 0x1a, 0x00, 0x0f, 0x42, 0x40);
+    GG_TEST_CBOR_ENCODE(
+        gg_obj_i64(1000000000000),
+        0x1b,
+        0x00,
+        0x00,
+        0x00,
+        0xe8,
+        0xd4,
+        0xa5,
+        0x10,
+        0x00
+    );
+    GG_TEST_CBOR_ENCODE(gg_obj_i64(-1), 0x20);
+    GG_TEST_CBOR_ENCODE(gg_obj_i64(-1000), 0x39, 0x03, 0xe7);
+    GG_TEST_CBOR_ENCODE(
+        gg_obj_i64(INT64_MIN),
+        0x3b,
+        0x7f,
+        0xff,
+        0xff,
+        0xff,
+        0xff,
+        0xff,
+        0xff,
+        0xff
+    );
+    GG_TEST_CBOR_ENCODE(gg_obj_f64(100000.0), 0xfa, 0x47, 0xc3, 0x50, 0x00);
+    GG_TEST_CBOR_ENCODE(
+        gg_obj_f64(1.1), 0xfb, 0x3f, 0xf1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9a
+    );
+    GG_TEST_CBOR_ENCODE(
+        gg_obj_f64(1.0e+300),
+        0xfb,
+        0x7e,
+        0x37,
+        0xe4,
+        0x3c,
+        0x88,
+        0x00,
+        0x75,
+        0x9c
+    );
+    GG_TEST_CBOR_ENCODE(gg_obj_bool(false), 0xf4);
+    GG_TEST_CBOR_ENCODE(gg_obj_bool(true), 0xf5);
+    GG_TEST_CBOR_ENCODE(GG_OBJ_NULL, 0xf6);
+    GG_TEST_CBOR_ENCODE(gg_obj_buf(GG_STR("")), 0x60);
+    GG_TEST_CBOR_ENCODE(
+        gg_obj_buf(GG_STR("IETF")), 0x64, 0x49, 0x45, 0x54, 0x46
+    );
+    GG_TEST_CBOR_ENCODE(
+        gg_obj_buf(GG_STR("\xe6\xb0\xb4")), 0x63, 0xe6, 0xb0, 0xb4
+    );
+    // Invalid UTF-8 becomes a byte string
+    GG_TEST_CBOR_ENCODE(
+        gg_obj_buf(GG_BUF(((uint8_t[]) { 0x01, 0x02, 0xff }))),
+        0x43,
+        0x01,
+        0x02,
+        0xff
+    );
+}
+
+GG_TEST_DEFINE(cbor_encode_containers) {
+    GG_TEST_CBOR_ENCODE(gg_obj_list((GgList) { 0 }), 0x80);
+    GG_TEST_CBOR_ENCODE(gg_obj_map((GgMap) { 0 }), 0xa0);
+    GG_TEST_CBOR_ENCODE(
+        gg_obj_list(GG_LIST(
+            gg_obj_i64(1),
+            gg_obj_list(GG_LIST(gg_obj_i64(2), gg_obj_i64(3))),
+            gg_obj_list(GG_LIST(gg_obj_i64(4), gg_obj_i64(5)))
+        )),
+        0x83,
+        0x01,
+        0x82,
+        0x02,
+        0x03,
+        0x82,
+        0x04,
+        0x05
+    );
+    GG_TEST_CBOR_ENCODE(
+        gg_obj_map(GG_MAP(
+            gg_kv(GG_STR("a"), gg_obj_i64(1)),
+            gg_kv(
+                GG_STR("b"), gg_obj_list(GG_LIST(gg_obj_i64(2), gg_obj_i64(3)))
+            )
+        )),
+        0xa2,
+        0x61,
+        0x61,
+        0x01,
+        0x61,
+        0x62,
+        0x82,
+        0x02,
+        0x03
+    );
+}
+
+GG_TEST_DEFINE(cbor_encode_limits) {
+    GgObject too_nested[GG_MAX_OBJECT_DEPTH + 1];
+    size_t too_nested_len = sizeof(too_nested) / sizeof(too_nested[0]);
+    for (size_t i = 0; i != too_nested_len - 1; i++) {
+        too_nested[i]
+            = gg_obj_list((GgList) { .items = &too_nested[i + 1], .len = 1 });
+    }
+    too_nested[too_nested_len - 1] = GG_OBJ_NULL;
+
+    uint8_t mem[GG_MAX_OBJECT_SUBOBJECTS + 8];
+    GgByteVec vec = gg_byte_vec_init(GG_BUF(mem));
+    TEST_ASSERT_EQUAL(
+        GG_ERR_RANGE, gg_cbor_encode(too_nested[0], gg_byte_vec_writer(&vec))
+    );
+
+    GgObject too_large[GG_MAX_OBJECT_SUBOBJECTS + 1];
+    size_t too_large_len = sizeof(too_large) / sizeof(too_large[0]);
+    for (size_t i = 0; i != too_large_len; i++) {
+        too_large[i] = GG_OBJ_NULL;
+    }
+    vec = gg_byte_vec_init(GG_BUF(mem));
+    TEST_ASSERT_EQUAL(
+        GG_ERR_RANGE,
+        gg_cbor_encode(
+            gg_obj_list((GgList) { .items = too_large, .len = too_large_len }),
+            gg_byte_vec_writer(&vec)
+        )
+    );
+
+    // Output buffer too small
+    uint8_t small[3];
+    vec = gg_byte_vec_init(GG_BUF(small));
+    GG_TEST_ASSERT_BAD(
+        gg_cbor_encode(gg_obj_buf(GG_STR("IETF")), gg_byte_vec_writer(&vec))
+    );
+}
+
+#endif
@@ -0,0 +1,724 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <assert.h>
+#include <gg/arena.h>
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/frozen.h>
+#include <gg/log.h>
+#include <gg/map.h>
+#include <gg/object.h>
+#include <gg/object_visit.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Image layout (all integers native-endian, unaligned):
+//
+// Header: magic (4), version (u32), image size (u32), then the root record.
+//
+// Value record (12 bytes): tag (u32), payload (u64)
+//   tag bits 0-7 are the GgObjectType, bit 8 marks a map with sorted keys,
+//   and bits 16-31 hold the buffer/list/map length.
+//   payload holds the bool/i64/f64 value, or the offset of the buffer bytes,
+//   list records, or map entries.
+//
+// Map entry (20 bytes): key offset (u32), key length (u16), reserved (u16),
+//   then the value record.
+//
+// List records and map entries are always placed after the record that
+// references them, which bounds validation.
+
+#define FROZEN_MAGIC "GGFZ"
+#define FROZEN_VERSION 1U
+#define FROZEN_HEADER_LEN 12U
+#define FROZEN_RECORD_LEN 12U
+#define FROZEN_ENTRY_LEN 20U
+#define FROZEN_ENTRY_VAL 8U
+#define FROZEN_TAG_SORTED 0x100U
+
+static uint32_t load_u32(const uint8_t *ptr) {
+    uint32_t result;
+    memcpy(&result, ptr, sizeof(result));
+    return result;
+}
+
+static uint16_t load_u16(const uint8_t *ptr) {
+    uint16_t result;
+    memcpy(&result, ptr, sizeof(result));
+    return result;
+}
+
+static uint64_t load_u64(const uint8_t *ptr) {
+    uint64_t result;
+    memcpy(&result, ptr, sizeof(result));
+    return result;
+}
+
+static void store_u32(uint8_t *ptr, uint32_t val) {
+    memcpy(ptr, &val, sizeof(val));
+}
+
+static void store_u16(uint8_t *ptr, uint16_t val) {
+    memcpy(ptr, &val, sizeof(val));
+}
+
+static void store_u64(uint8_t *ptr, uint64_t val) {
+    memcpy(ptr, &val, sizeof(val));
+}
+
+static GgError size_buf(void *ctx, GgBuffer val, GgObject obj[static 1]) {
+    (void) obj;
+    size_t *size = ctx;
+    *size += val.len;
+    return GG_ERR_OK;
+}
+
+static GgError size_list(void *ctx, GgList val, GgObject obj[static 1]) {
+    (void) obj;
+    size_t *size = ctx;
+    *size += val.len * FROZEN_RECORD_LEN;
+    return GG_ERR_OK;
+}
+
+static GgError size_map(void *ctx, GgMap val, GgObject obj[static 1]) {
+    (void) obj;
+    size_t *size = ctx;
+    *size += val.len * FROZEN_ENTRY_LEN;
+    return GG_ERR_OK;
+}
+
+static GgError size_map_key(void *ctx, GgBuffer key, GgKV kv[static 1]) {
+    (void) kv;
+    size_t *size = ctx;
+    *size += key.len;
+    return GG_ERR_OK;
+}
+
+GgError gg_obj_frozen_size(GgObject obj, size_t *size) {
+    const GgObjectVisitHandlers VISIT_HANDLERS = {
+        .on_buf = size_buf,
+        .on_list = size_list,
+        .on_map = size_map,
+        .on_map_key = size_map_key,
+    };
+    size_t result = FROZEN_HEADER_LEN + FROZEN_RECORD_LEN;
+    GgError ret = gg_obj_visit(&VISIT_HANDLERS, &result, &obj);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    if (result > UINT32_MAX) {
+        GG_LOGE("Object too large to freeze.");
+        return GG_ERR_RANGE;
+    }
+    *size = result;
+    return GG_ERR_OK;
+}
+
+typedef struct {
+    uint8_t *image;
+    uint32_t cursor;
+} FreezeWriter;
+
+static uint32_t freeze_bytes(FreezeWriter *writer, GgBuffer buf) {
+    uint32_t offset = writer->cursor;
+    if (buf.len > 0) {
+        memcpy(&writer->image[offset], buf.data, buf.len);
+    }
+    writer->cursor += (uint32_t) buf.len;
+    return offset;
+}
+
+// Recursion is bounded by the object depth, checked by gg_obj_frozen_size.
+static void freeze_record(FreezeWriter *writer, uint32_t record, GgObject obj) {
+    GgObjectType type = gg_obj_type(obj);
+    uint32_t tag = type;
+    uint64_t payload = 0;
+
+    switch (type) {
+    case GG_TYPE_NULL:
+        break;
+    case GG_TYPE_BOOLEAN:
+        payload = gg_obj_into_bool(obj) ? 1 : 0;
+        break;
+    case GG_TYPE_I64: {
+        int64_t val = gg_obj_into_i64(obj);
+        memcpy(&payload, &val, sizeof(payload));
+    } break;
+    case GG_TYPE_F64: {
+        double val = gg_obj_into_f64(obj);
+        memcpy(&payload, &val, sizeof(payload));
+    } break;
+    case GG_TYPE_BUF: {
+        GgBuffer buf = gg_obj_into_buf(obj);
+        tag |= (uint32_t) buf.len << 16;
+        payload = freeze_bytes(writer, buf);
+    } break;
+    case GG_TYPE_LIST: {
+        GgList list = gg_obj_into_list(obj);
+        tag |= (uint32_t) list.len << 16;
+        uint32_t items = writer->cursor;
+        payload = items;
+        writer->cursor += (uint32_t) (list.len * FROZEN_RECORD_LEN);
+        for (size_t i = 0; i < list.len; i++) {
+            freeze_record(
+                writer,
+                items + (uint32_t) (i * FROZEN_RECORD_LEN),
+                list.items[i]
+            );
+        }
+    } break;
+    case GG_TYPE_MAP: {
+        GgMap map = gg_obj_into_map(obj);
+        tag |= (uint32_t) map.len << 16;
+        if (gg_map_is_canonical(map)) {
+            tag |= FROZEN_TAG_SORTED;
+        }
+        uint32_t entries = writer->cursor;
+        payload = entries;
+        writer->cursor += (uint32_t) (map.len * FROZEN_ENTRY_LEN);
+        for (size_t i = 0; i < map.len; i++) {
+            uint8_t *entry
+                = &writer->image[entries + (uint32_t) (i * FROZEN_ENTRY_LEN)];
+            GgBuffer key = gg_kv_key(map.pairs[i]);
+            store_u32(entry, freeze_bytes(writer, key));
+            store_u16(&entry[4], (uint16_t) key.len);
+            store_u16(&entry[6], 0);
+            freeze_record(
+                writer,
+                (uint32_t) (entry + FROZEN_ENTRY_VAL - writer->image),
+                *gg_kv_val(&map.pairs[i])
+            );
+        }
+    } break;
+    }
+
+    store_u32(&writer->image[record], tag);
+    store_u64(&writer->image[record + 4], payload);
+}
+
+GgError gg_obj_freeze(GgObject obj, GgArena *arena, GgBuffer *image) {
+    size_t size;
+    GgError ret = gg_obj_frozen_size(obj, &size);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+
+    uint8_t *mem = GG_ARENA_ALLOCN(arena, uint8_t, size);
+    if (mem == NULL) {
+        GG_LOGE("Insufficient memory to freeze object (needs %zu).", size);
+        return GG_ERR_NOMEM;
+    }
+
+    memcpy(mem, FROZEN_MAGIC, 4);
+    store_u32(&mem[4], FROZEN_VERSION);
+    store_u32(&mem[8], (uint32_t) size);
+
+    FreezeWriter writer = {
+        .image = mem, .cursor = FROZEN_HEADER_LEN + FROZEN_RECORD_LEN
+    };
+    freeze_record(&writer, FROZEN_HEADER_LEN, obj);
+    assert(writer.cursor == size);
+
+    *image = (GgBuffer) { .data = mem, .len = size };
+    return GG_ERR_OK;
+}
+
+typedef struct {
+    const uint8_t *image;
+    uint32_t size;
+    size_t subobjects;
+} FrozenValidator;
+
+static bool range_ok(FrozenValidator *val, uint64_t offset, uint64_t len) {
+    return (offset <= val->size) && (len <= val->size - offset);
+}
+
+static GgBuffer entry_key(const uint8_t *image, uint32_t entry) {
+    return (GgBuffer) { .data = (uint8_t *) &image[load_u32(&image[entry])],
+                        .len = load_u16(&image[entry + 4]) };
+}
+
+static GgError validate_record(
+    FrozenValidator *val, uint32_t record, size_t depth
+) {
+    if (!range_ok(val, record, FROZEN_RECORD_LEN)) {
+        GG_LOGE("Frozen record out of bounds.");
+        return GG_ERR_PARSE;
+    }
+    uint32_t tag = load_u32(&val->image[record]);
+    uint64_t payload = load_u64(&val->image[record + 4]);
+    uint32_t type = tag & 0xFFU;
+    uint32_t len = tag >> 16;
+    bool sorted = (tag & FROZEN_TAG_SORTED) != 0;
+
+    if ((type > GG_TYPE_MAP) || ((tag & 0xFE00U) != 0)
+        || (sorted && (type != GG_TYPE_MAP))) {
+        GG_LOGE("Invalid frozen record tag.");
+        return GG_ERR_PARSE;
+    }
+
+    if ((type == GG_TYPE_NULL) || (type == GG_TYPE_BOOLEAN)
+        || (type == GG_TYPE_I64) || (type == GG_TYPE_F64)) {
+        if ((len != 0) || ((type == GG_TYPE_NULL) && (payload != 0))
+            || ((type == GG_TYPE_BOOLEAN) && (payload > 1))) {
+            GG_LOGE("Invalid frozen scalar record.");
+            return GG_ERR_PARSE;
+        }
+        return GG_ERR_OK;
+    }
+
+    if (type == GG_TYPE_BUF) {
+        if (!range_ok(val, payload, len)) {
+            GG_LOGE("Frozen buffer out of bounds.");
+            return GG_ERR_PARSE;
+        }
+        return GG_ERR_OK;
+    }
+
+    if ((len > 0) && (depth + 1 >= GG_MAX_OBJECT_DEPTH)) {
+        GG_LOGE("Frozen object exceeds max depth.");
+        return GG_ERR_RANGE;
+    }
+
+    size_t elem_len = type == GG_TYPE_LIST ? FROZEN_RECORD_LEN
+                                           : FROZEN_ENTRY_LEN;
+    val->subobjects += type == GG_TYPE_LIST ? len : 2U * len;
+    if (val->subobjects > GG_MAX_OBJECT_SUBOBJECTS) {
+        GG_LOGE("Frozen object exceeds max subobjects.");
+        return GG_ERR_RANGE;
+    }
+    // Children must follow their parent, so validation terminates
+    if ((payload <= record) || !range_ok(val, payload, len * elem_len)) {
+        GG_LOGE("Frozen container out of bounds.");
+        return GG_ERR_PARSE;
+    }
+    uint32_t elems = (uint32_t) payload;
+
+    for (uint32_t i = 0; i < len; i++) {
+        uint32_t elem = elems + (uint32_t) (i * elem_len);
+        if (type == GG_TYPE_MAP) {
+            if (!range_ok(
+                    val,
+                    load_u32(&val->image[elem]),
+                    load_u16(&val->image[elem + 4])
+                )) {
+                GG_LOGE("Frozen map key out of bounds.");
+                return GG_ERR_PARSE;
+            }
+            if (sorted && (i > 0)
+                && (gg_buffer_cmp(
+                        entry_key(val->image, elem - FROZEN_ENTRY_LEN),
+                        entry_key(val->image, elem)
+                    )
+                    >= 0)) {
+                GG_LOGE("Frozen map marked sorted has unsorted keys.");
+                return GG_ERR_PARSE;
+            }
+            elem += FROZEN_ENTRY_VAL;
+        }
+        GgError ret = validate_record(val, elem, depth + 1);
+        if (ret != GG_ERR_OK) {
+            return ret;
+        }
+    }
+
+    return GG_ERR_OK;
+}
+
+GgError gg_frozen_open(GgBuffer image, GgFrozenObject *root) {
+    if ((image.len < FROZEN_HEADER_LEN + FROZEN_RECORD_LEN)
+        || (memcmp(image.data, FROZEN_MAGIC, 4) != 0)) {
+        GG_LOGE("Buffer is not a frozen object image.");
+        return GG_ERR_PARSE;
+    }
+    if (load_u32(&image.data[4]) != FROZEN_VERSION) {
+        GG_LOGE("Unsupported frozen object image version.");
+        return GG_ERR_UNSUPPORTED;
+    }
+    uint32_t size = load_u32(&image.data[8]);
+    if ((size > image.len) || (size < FROZEN_HEADER_LEN + FROZEN_RECORD_LEN)) {
+        GG_LOGE("Frozen object image size is invalid.");
+        return GG_ERR_PARSE;
+    }
+
+    FrozenValidator val = { .image = image.data, .size = size };
+    GgError ret = validate_record(&val, FROZEN_HEADER_LEN, 0);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+
+    *root = (GgFrozenObject) { .image = image.data,
+                               .record = FROZEN_HEADER_LEN };
+    return GG_ERR_OK;
+}
+
+static uint32_t frozen_tag(GgFrozenObject obj) {
+    return load_u32(&obj.image[obj.record]);
+}
+
+static uint64_t frozen_payload(GgFrozenObject obj) {
+    return load_u64(&obj.image[obj.record + 4]);
+}
+
+GgObjectType gg_frozen_type(GgFrozenObject obj) {
+    return (GgObjectType) (frozen_tag(obj) & 0xFFU);
+}
+
+bool gg_frozen_into_bool(GgFrozenObject obj) {
+    assert(gg_frozen_type(obj) == GG_TYPE_BOOLEAN);
+    return frozen_payload(obj) != 0;
+}
+
+int64_t gg_frozen_into_i64(GgFrozenObject obj) {
+    assert(gg_frozen_type(obj) == GG_TYPE_I64);
+    uint64_t payload = frozen_payload(obj);
+    int64_t result;
+    memcpy(&result, &payload, sizeof(result));
+    return result;
+}
+
+double gg_frozen_into_f64(GgFrozenObject obj) {
+    assert(gg_frozen_type(obj) == GG_TYPE_F64);
+    uint64_t payload = frozen_payload(obj);
+    double result;
+    memcpy(&result, &payload, sizeof(result));
+    return result;
+}
+
+GgBuffer gg_frozen_into_buf(GgFrozenObject obj) {
+    assert(gg_frozen_type(obj) == GG_TYPE_BUF);
+    return (GgBuffer) { .data = (uint8_t *) &obj.image[frozen_payload(obj)],
+                        .len = frozen_tag(obj) >> 16 };
+}
+
+size_t gg_frozen_len(GgFrozenObject obj) {
+    assert(
+        (gg_frozen_type(obj) == GG_TYPE_LIST)
+        || (gg_frozen_type(obj) == GG_TYPE_MAP)
+    );
+    return frozen_tag(obj) >> 16;
+}
+
+GgFrozenObject gg_frozen_list_get(GgFrozenObject list, size_t index) {
+    assert(gg_frozen_type(list) == GG_TYPE_LIST);
+    assert(index < gg_frozen_len(list));
+    return (GgFrozenObject) {
+        .image = list.image,
+        .record = (uint32_t) (frozen_payload(list) + index * FROZEN_RECORD_LEN),
+    };
+}
+
+static uint32_t map_entry(GgFrozenObject map, size_t index) {
+    assert(gg_frozen_type(map) == GG_TYPE_MAP);
+    assert(index < gg_frozen_len(map));
+    return (uint32_t) (frozen_payload(map) + index * FROZEN_ENTRY_LEN);
+}
+
+GgBuffer gg_frozen_map_key(GgFrozenObject map, size_t index) {
+    return entry_key(map.image, map_entry(map, index));
+}
+
+GgFrozenObject gg_frozen_map_val(GgFrozenObject map, size_t index) {
+    return (GgFrozenObject) {
+        .image = map.image,
+        .record = map_entry(map, index) + FROZEN_ENTRY_VAL,
+    };
+}
+
+bool gg_frozen_map_get(
+    GgFrozenObject map, GgBuffer key, GgFrozenObject *result
+) {
+    size_t len = gg_frozen_len(map);
+
+    if ((frozen_tag(map) & FROZEN_TAG_SORTED) != 0) {
+        size_t low = 0;
+        size_t high = len;
+        while (low < high) {
+            size_t mid = low + (high - low) / 2;
+            int cmp = gg_buffer_cmp(gg_frozen_map_key(map, mid), key);
+            if (cmp == 0) {
+                if (result != NULL) {
+                    *result = gg_frozen_map_val(map, mid);
+                }
+                return true;
+            }
+            if (cmp < 0) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return false;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        if (gg_buffer_eq(gg_frozen_map_key(map, i), key)) {
+            if (result != NULL) {
+                *result = gg_frozen_map_val(map, i);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+// Recursion is bounded by the object depth, checked by gg_frozen_open.
+static GgError thaw_record(
+    GgFrozenObject obj, GgArena *arena, GgObject *result
+) {
+    switch (gg_frozen_type(obj)) {
+    case GG_TYPE_NULL:
+        *result = GG_OBJ_NULL;
+        return GG_ERR_OK;
+    case GG_TYPE_BOOLEAN:
+        *result = gg_obj_bool(gg_frozen_into_bool(obj));
+        return GG_ERR_OK;
+    case GG_TYPE_I64:
+        *result = gg_obj_i64(gg_frozen_into_i64(obj));
+        return GG_ERR_OK;
+    case GG_TYPE_F64:
+        *result = gg_obj_f64(gg_frozen_into_f64(obj));
+        return GG_ERR_OK;
+    case GG_TYPE_BUF:
+        *result = gg_obj_buf(gg_frozen_into_buf(obj));
+        return GG_ERR_OK;
+    case GG_TYPE_LIST: {
+        size_t len = gg_frozen_len(obj);
+        GgObject *items = GG_ARENA_ALLOCN(arena, GgObject, len);
+        if ((len > 0) && (items == NULL)) {
+            GG_LOGE("Insufficient memory to thaw frozen list.");
+            return GG_ERR_NOMEM;
+        }
+        for (size_t i = 0; i < len; i++) {
+            GgError ret
+                = thaw_record(gg_frozen_list_get(obj, i), arena, &items[i]);
+            if (ret != GG_ERR_OK) {
+                return ret;
+            }
+        }
+        *result = gg_obj_list((GgList) { .items = items, .len = len });
+        return GG_ERR_OK;
+    }
+    case GG_TYPE_MAP: {
+        size_t len = gg_frozen_len(obj);
+        GgKV *pairs = GG_ARENA_ALLOCN(arena, GgKV, len);
+        if ((len > 0) && (pairs == NULL)) {
+            GG_LOGE("Insufficient memory to thaw frozen map.");
+            return GG_ERR_NOMEM;
+        }
+        for (size_t i = 0; i < len; i++) {
+            gg_kv_set_key(&pairs[i], gg_frozen_map_key(obj, i));
+            GgError ret = thaw_record(
+                gg_frozen_map_val(obj, i), arena, gg_kv_val(&pairs[i])
+            );
+            if (ret != GG_ERR_OK) {
+                return ret;
+            }
+        }
+        *result = gg_obj_map((GgMap) { .pairs = pairs, .len = len });
+        return GG_ERR_OK;
+    }
+    }
+
+    assert(false);
+    return GG_ERR_FAILURE;
+}
+
+GgError gg_frozen_thaw(GgFrozenObject obj, GgArena *arena, GgObject *result) {
+    // Only commit allocations on success
+    GgArena arena_copy = { 0 };
+    if (arena != NULL) {
+        arena_copy = *arena;
+    }
+    GgObject obj_result;
+    GgError ret = thaw_record(obj, &arena_copy, &obj_result);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    if (arena != NULL) {
+        *arena = arena_copy;
+    }
+    *result = obj_result;
+    return GG_ERR_OK;
+}
+
+#ifdef GG_SDK_TESTING
+
+#include <gg/object_compare.h>
+#include <gg/test.h>
+#include <unity.h>
+
+static GgObject test_frozen_obj(void) {
+    static GgObject list_items[3];
+    static GgKV nested[2];
+    static GgKV pairs[6];
+    list_items[0] = gg_obj_i64(-5);
+    list_items[1] = gg_obj_f64(2.5);
+    list_items[2] = GG_OBJ_NULL;
+    nested[0] = gg_kv(GG_STR("b"), gg_obj_bool(true));
+    nested[1] = gg_kv(GG_STR("a"), gg_obj_buf(GG_STR("")));
+    pairs[0] = gg_kv(GG_STR("name"), gg_obj_buf(GG_STR("value")));
+    pairs[1] = gg_kv(GG_STR("count"), gg_obj_i64(INT64_MIN));
+    pairs[2] = gg_kv(
+        GG_STR("list"), gg_obj_list((GgList) { .items = list_items, .len = 3 })
+    );
+    pairs[3] = gg_kv(
+        GG_STR("nested"), gg_obj_map((GgMap) { .pairs = nested, .len = 2 })
+    );
+    pairs[4] = gg_kv(GG_STR("empty"), gg_obj_list((GgList) { 0 }));
+    pairs[5] = gg_kv(GG_STR(""), gg_obj_bool(false));
+    return gg_obj_map((GgMap) { .pairs = pairs, .len = 6 });
+}
+
+GG_TEST_DEFINE(frozen_round_trip) {
+    GgObject obj = test_frozen_obj();
+
+    static uint8_t mem[1024];
+    GgArena arena = gg_arena_init(GG_BUF(mem));
+    GgBuffer image;
+    GG_TEST_ASSERT_OK(gg_obj_freeze(obj, &arena, &image));
+    size_t size;
+    GG_TEST_ASSERT_OK(gg_obj_frozen_size(obj, &size));
+    TEST_ASSERT_EQUAL(size, image.len);
+
+    // Relocate image to an unaligned address
+    static uint8_t copy[512];
+    memcpy(&copy[1], image.data, image.len);
+    memset(image.data, 0, image.len);
+    GgBuffer moved = { .data = &copy[1], .len = image.len };
+
+    GgFrozenObject root;
+    GG_TEST_ASSERT_OK(gg_frozen_open(moved, &root));
+    TEST_ASSERT_EQUAL(GG_TYPE_MAP, gg_frozen_type(root));
+    TEST_ASSERT_EQUAL(6, gg_frozen_len(root));
+
+    GgFrozenObject val;
+    TEST_ASSERT(gg_frozen_map_get(root, GG_STR("name"), &val));
+    GG_TEST_ASSERT_BUF_EQUAL_STR(GG_STR("value"), gg_frozen_into_buf(val));
+    // Zero-copy: buffer references the image
+    TEST_ASSERT(gg_frozen_into_buf(val).data > moved.data);
+    TEST_ASSERT(gg_frozen_into_buf(val).data < &moved.data[moved.len]);
+    TEST_ASSERT(gg_frozen_map_get(root, GG_STR("count"), &val));
+    TEST_ASSERT(gg_frozen_into_i64(val) == INT64_MIN);
+    TEST_ASSERT(gg_frozen_map_get(root, GG_STR("list"), &val));
+    TEST_ASSERT_EQUAL(3, gg_frozen_len(val));
+    TEST_ASSERT(gg_frozen_into_f64(gg_frozen_list_get(val, 1)) == 2.5);
+    TEST_ASSERT(gg_frozen_map_get(root, GG_STR(""), &val));
+    TEST_ASSERT_FALSE(gg_frozen_into_bool(val));
+    TEST_ASSERT_FALSE(gg_frozen_map_get(root, GG_STR("missing"), NULL));
+    GG_TEST_ASSERT_BUF_EQUAL_STR(
+        GG_STR("nested"), gg_frozen_map_key(root, 3)
+    );
+
+    GgObject thawed;
+    GG_TEST_ASSERT_OK(gg_frozen_thaw(root, &arena, &thawed));
+    TEST_ASSERT(gg_obj_eq(obj, thawed));
+}
+
+GG_TEST_DEFINE(frozen_sorted_lookup) {
+    GgObject obj = gg_obj_map(GG_MAP(
+        gg_kv(GG_STR("a"), gg_obj_i64(1)),
+        gg_kv(GG_STR("ab"), gg_obj_i64(2)),
+        gg_kv(GG_STR("b"), gg_obj_i64(3)),
+        gg_kv(GG_STR("c"), gg_obj_i64(4)),
+        gg_kv(GG_STR("d"), gg_obj_i64(5)),
+    ));
+
+    uint8_t mem[256];
+    GgArena arena = gg_arena_init(GG_BUF(mem));
+    GgBuffer image;
+    GG_TEST_ASSERT_OK(gg_obj_freeze(obj, &arena, &image));
+    GgFrozenObject root;
+    GG_TEST_ASSERT_OK(gg_frozen_open(image, &root));
+
+    GgMap map = gg_obj_into_map(obj);
+    for (size_t i = 0; i < map.len; i++) {
+        GgFrozenObject val;
+        TEST_ASSERT(gg_frozen_map_get(root, gg_kv_key(map.pairs[i]), &val));
+        TEST_ASSERT(gg_frozen_into_i64(val) == (int64_t) i + 1);
+    }
+    TEST_ASSERT_FALSE(gg_frozen_map_get(root, GG_STR("aa"), NULL));
+    TEST_ASSERT_FALSE(gg_frozen_map_get(root, GG_STR("e"), NULL));
+    TEST_ASSERT_FALSE(gg_frozen_map_get(root, GG_STR(""), NULL));
+
+    // Swapping keys of a sorted map must fail validation
+    uint8_t entry[FROZEN_ENTRY_LEN];
+    uint32_t entries = (uint32_t) load_u64(&image.data[FROZEN_HEADER_LEN + 4]);
+    memcpy(entry, &image.data[entries], FROZEN_ENTRY_LEN);
+    memcpy(
+        &image.data[entries],
+        &image.data[entries + FROZEN_ENTRY_LEN],
+        FROZEN_ENTRY_LEN
+    );
+    memcpy(&image.data[entries + FROZEN_ENTRY_LEN], entry, FROZEN_ENTRY_LEN);
+    TEST_ASSERT_EQUAL(GG_ERR_PARSE, gg_frozen_open(image, &root));
+}
+
+GG_TEST_DEFINE(frozen_invalid) {
+    GgObject obj = gg_obj_list(GG_LIST(gg_obj_buf(GG_STR("abc"))));
+    uint8_t mem[256];
+    GgArena arena = gg_arena_init(GG_BUF(mem));
+    GgBuffer image;
+    GG_TEST_ASSERT_OK(gg_obj_freeze(obj, &arena, &image));
+    GgFrozenObject root;
+    GG_TEST_ASSERT_OK(gg_frozen_open(image, &root));
+
+    // Truncated
+    GgBuffer truncated = { .data = image.data, .len = image.len - 1 };
+    TEST_ASSERT_EQUAL(GG_ERR_PARSE, gg_frozen_open(truncated, &root));
+    TEST_ASSERT_EQUAL(
+        GG_ERR_PARSE,
+        gg_frozen_open((GgBuffer) { .data = image.data, .len = 4 }, &root)
+    );
+
+    // Bad magic
+    image.data[0] = 'X';
+    TEST_ASSERT_EQUAL(GG_ERR_PARSE, gg_frozen_open(image, &root));
+    image.data[0] = 'G';
+
+    // Buffer offset out of bounds
+    uint32_t items = (uint32_t) load_u64(&image.data[FROZEN_HEADER_LEN + 4]);
+    store_u64(&image.data[items + 4], image.len);
+    TEST_ASSERT_EQUAL(GG_ERR_PARSE, gg_frozen_open(image, &root));
+
+    // List pointing back at itself
+    store_u64(&image.data[FROZEN_HEADER_LEN + 4], FROZEN_HEADER_LEN);
+    TEST_ASSERT_EQUAL(GG_ERR_PARSE, gg_frozen_open(image, &root));
+
+    // Bad type tag
+    store_u32(&image.data[FROZEN_HEADER_LEN], 7);
+    TEST_ASSERT_EQUAL(GG_ERR_PARSE, gg_frozen_open(image, &root));
+
+    // Insufficient memory to freeze
+    GgArena small = gg_arena_init((GgBuffer) { .data = mem, .len = 8 });
+    TEST_ASSERT_EQUAL(GG_ERR_NOMEM, gg_obj_freeze(obj, &small, &image));
+}
+
+GG_TEST_DEFINE(frozen_depth) {
+    // Empty list at max depth, as allowed by gg_obj_visit
+    GgObject lists[GG_MAX_OBJECT_DEPTH];
+    lists[GG_MAX_OBJECT_DEPTH - 1] = gg_obj_list((GgList) { 0 });
+    for (size_t i = GG_MAX_OBJECT_DEPTH - 1; i > 0; i--) {
+        lists[i - 1] = gg_obj_list((GgList) { .items = &lists[i], .len = 1 });
+    }
+
+    uint8_t mem[512];
+    GgArena arena = gg_arena_init(GG_BUF(mem));
+    GgBuffer image;
+    GG_TEST_ASSERT_OK(gg_obj_freeze(lists[0], &arena, &image));
+    GgFrozenObject root;
+    GG_TEST_ASSERT_OK(gg_frozen_open(image, &root));
+
+    // One level deeper is rejected by both
+    GgObject item = GG_OBJ_NULL;
+    lists[GG_MAX_OBJECT_DEPTH - 1] = gg_obj_list((GgList) { &item, 1 });
+    TEST_ASSERT_EQUAL(
+        GG_ERR_RANGE, gg_obj_freeze(lists[0], &arena, &image)
+    );
+}
+
+#endif
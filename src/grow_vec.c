@@ -0,0 +1,564 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gg/alloc.h>
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/grow_vec.h>
+#include <gg/io.h>
+#include <gg/log.h>
+#include <gg/object.h>
+#include <gg/vector.h>
+#include <stdalign.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Initial capacity in elements; bytes start at 64.
+#define GROW_VEC_MIN_CAPACITY 8U
+#define GROW_VEC_MIN_BYTES 64U
+
+// Ensures `data` holds at least `needed` elements, reallocating with
+// geometrically growing capacity, then copies `append_len` elements from
+// `append` after the first `len`. Old data is freed only after copying, so
+// `append` may point into it. On failure, `data` is unchanged.
+static GgError grow(
+    GgAlloc alloc,
+    void *data[static 1],
+    size_t len,
+    const void *append,
+    size_t append_len,
+    size_t capacity[static 1],
+    size_t needed,
+    size_t elem_size,
+    size_t alignment,
+    size_t min_capacity
+) {
+    if (needed <= *capacity) {
+        if (append_len > 0) {
+            memmove(
+                (uint8_t *) *data + (len * elem_size),
+                append,
+                append_len * elem_size
+            );
+        }
+        return GG_ERR_OK;
+    }
+
+    size_t new_capacity = (*capacity > 0) ? *capacity : min_capacity;
+    while (new_capacity < needed) {
+        if (new_capacity > SIZE_MAX / 2) {
+            new_capacity = needed;
+            break;
+        }
+        new_capacity *= 2;
+    }
+    if (new_capacity > SIZE_MAX / elem_size) {
+        GG_LOGE("Growable vector capacity overflow.");
+        return GG_ERR_NOMEM;
+    }
+
+    uint8_t *new_data = gg_alloc(alloc, new_capacity * elem_size, alignment);
+    if (new_data == NULL) {
+        GG_LOGE("Failed to grow vector to %zu elements.", new_capacity);
+        return GG_ERR_NOMEM;
+    }
+    if (len > 0) {
+        memcpy(new_data, *data, len * elem_size);
+    }
+    if (append_len > 0) {
+        memcpy(&new_data[len * elem_size], append, append_len * elem_size);
+    }
+    gg_free(alloc, *data);
+    *data = new_data;
+    *capacity = new_capacity;
+    return GG_ERR_OK;
+}
+
+static GgError grow_additional(
+    size_t len, size_t additional, size_t needed[static 1]
+) {
+    if (additional > SIZE_MAX - len) {
+        return GG_ERR_NOMEM;
+    }
+    *needed = len + additional;
+    return GG_ERR_OK;
+}
+
+GgObjGrowVec gg_obj_grow_vec_init(GgAlloc alloc) {
+    return (GgObjGrowVec) { .alloc = alloc };
+}
+
+GgError gg_obj_grow_vec_reserve(GgObjGrowVec *vector, size_t additional) {
+    size_t needed;
+    GgError ret = grow_additional(vector->list.len, additional, &needed);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    void *items = vector->list.items;
+    ret = grow(
+        vector->alloc,
+        &items,
+        vector->list.len,
+        NULL,
+        0,
+        &vector->capacity,
+        needed,
+        sizeof(GgObject),
+        alignof(GgObject),
+        GROW_VEC_MIN_CAPACITY
+    );
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    vector->list.items = items;
+    return GG_ERR_OK;
+}
+
+GgError gg_obj_grow_vec_push(GgObjGrowVec *vector, GgObject object) {
+    GgError ret = gg_obj_grow_vec_reserve(vector, 1);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    vector->list.items[vector->list.len] = object;
+    vector->list.len++;
+    return GG_ERR_OK;
+}
+
+void gg_obj_grow_vec_chain_push(
+    GgError *err, GgObjGrowVec *vector, GgObject object
+) {
+    if (*err == GG_ERR_OK) {
+        *err = gg_obj_grow_vec_push(vector, object);
+    }
+}
+
+GgError gg_obj_grow_vec_append(GgObjGrowVec *vector, GgList list) {
+    size_t needed;
+    GgError ret = grow_additional(vector->list.len, list.len, &needed);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    void *items = vector->list.items;
+    ret = grow(
+        vector->alloc,
+        &items,
+        vector->list.len,
+        list.items,
+        list.len,
+        &vector->capacity,
+        needed,
+        sizeof(GgObject),
+        alignof(GgObject),
+        GROW_VEC_MIN_CAPACITY
+    );
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    vector->list.items = items;
+    vector->list.len = needed;
+    return GG_ERR_OK;
+}
+
+GgObjGrowVec gg_obj_grow_vec_move(GgObjGrowVec *vector) {
+    GgObjGrowVec moved = *vector;
+    vector->list = (GgList) { 0 };
+    vector->capacity = 0;
+    return moved;
+}
+
+GgList gg_obj_grow_vec_steal(GgObjGrowVec *vector) {
+    return gg_obj_grow_vec_move(vector).list;
+}
+
+void gg_obj_grow_vec_free(GgObjGrowVec *vector) {
+    gg_free(vector->alloc, gg_obj_grow_vec_steal(vector).items);
+}
+
+GgKVGrowVec gg_kv_grow_vec_init(GgAlloc alloc) {
+    return (GgKVGrowVec) { .alloc = alloc };
+}
+
+GgError gg_kv_grow_vec_reserve(GgKVGrowVec *vector, size_t additional) {
+    size_t needed;
+    GgError ret = grow_additional(vector->map.len, additional, &needed);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    void *pairs = vector->map.pairs;
+    ret = grow(
+        vector->alloc,
+        &pairs,
+        vector->map.len,
+        NULL,
+        0,
+        &vector->capacity,
+        needed,
+        sizeof(GgKV),
+        alignof(GgKV),
+        GROW_VEC_MIN_CAPACITY
+    );
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    vector->map.pairs = pairs;
+    return GG_ERR_OK;
+}
+
+GgError gg_kv_grow_vec_push(GgKVGrowVec *vector, GgKV kv) {
+    GgError ret = gg_kv_grow_vec_reserve(vector, 1);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    vector->map.pairs[vector->map.len] = kv;
+    vector->map.len++;
+    return GG_ERR_OK;
+}
+
+void gg_kv_grow_vec_chain_push(GgError *err, GgKVGrowVec *vector, GgKV kv) {
+    if (*err == GG_ERR_OK) {
+        *err = gg_kv_grow_vec_push(vector, kv);
+    }
+}
+
+GgError gg_kv_grow_vec_append(GgKVGrowVec *vector, GgMap map) {
+    size_t needed;
+    GgError ret = grow_additional(vector->map.len, map.len, &needed);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    void *pairs = vector->map.pairs;
+    ret = grow(
+        vector->alloc,
+        &pairs,
+        vector->map.len,
+        map.pairs,
+        map.len,
+        &vector->capacity,
+        needed,
+        sizeof(GgKV),
+        alignof(GgKV),
+        GROW_VEC_MIN_CAPACITY
+    );
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    vector->map.pairs = pairs;
+    vector->map.len = needed;
+    return GG_ERR_OK;
+}
+
+GgKVGrowVec gg_kv_grow_vec_move(GgKVGrowVec *vector) {
+    GgKVGrowVec moved = *vector;
+    vector->map = (GgMap) { 0 };
+    vector->capacity = 0;
+    return moved;
+}
+
+GgMap gg_kv_grow_vec_steal(GgKVGrowVec *vector) {
+    return gg_kv_grow_vec_move(vector).map;
+}
+
+void gg_kv_grow_vec_free(GgKVGrowVec *vector) {
+    gg_free(vector->alloc, gg_kv_grow_vec_steal(vector).pairs);
+}
+
+GgByteGrowVec gg_byte_grow_vec_init(GgAlloc alloc) {
+    return (GgByteGrowVec) { .alloc = alloc };
+}
+
+GgError gg_byte_grow_vec_reserve(GgByteGrowVec *vector, size_t additional) {
+    size_t needed;
+    GgError ret = grow_additional(vector->buf.len, additional, &needed);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    void *data = vector->buf.data;
+    ret = grow(
+        vector->alloc,
+        &data,
+        vector->buf.len,
+        NULL,
+        0,
+        &vector->capacity,
+        needed,
+        1,
+        1,
+        GROW_VEC_MIN_BYTES
+    );
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    vector->buf.data = data;
+    return GG_ERR_OK;
+}
+
+GgError gg_byte_grow_vec_push(GgByteGrowVec *vector, uint8_t byte) {
+    GgError ret = gg_byte_grow_vec_reserve(vector, 1);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    vector->buf.data[vector->buf.len] = byte;
+    vector->buf.len++;
+    return GG_ERR_OK;
+}
+
+void gg_byte_grow_vec_chain_push(
+    GgError *err, GgByteGrowVec *vector, uint8_t byte
+) {
+    if (*err == GG_ERR_OK) {
+        *err = gg_byte_grow_vec_push(vector, byte);
+    }
+}
+
+GgError gg_byte_grow_vec_append(GgByteGrowVec *vector, GgBuffer buf) {
+    size_t needed;
+    GgError ret = grow_additional(vector->buf.len, buf.len, &needed);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    void *data = vector->buf.data;
+    ret = grow(
+        vector->alloc,
+        &data,
+        vector->buf.len,
+        buf.data,
+        buf.len,
+        &vector->capacity,
+        needed,
+        1,
+        1,
+        GROW_VEC_MIN_BYTES
+    );
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    vector->buf.data = data;
+    vector->buf.len = needed;
+    return GG_ERR_OK;
+}
+
+void gg_byte_grow_vec_chain_append(
+    GgError *err, GgByteGrowVec *vector, GgBuffer buf
+) {
+    if (*err == GG_ERR_OK) {
+        *err = gg_byte_grow_vec_append(vector, buf);
+    }
+}
+
+GgByteGrowVec gg_byte_grow_vec_move(GgByteGrowVec *vector) {
+    GgByteGrowVec moved = *vector;
+    vector->buf = (GgBuffer) { 0 };
+    vector->capacity = 0;
+    return moved;
+}
+
+GgBuffer gg_byte_grow_vec_steal(GgByteGrowVec *vector) {
+    return gg_byte_grow_vec_move(vector).buf;
+}
+
+void gg_byte_grow_vec_free(GgByteGrowVec *vector) {
+    gg_free(vector->alloc, gg_byte_grow_vec_steal(vector).data);
+}
+
+static GgError byte_grow_vec_write(void *ctx, GgBuffer buf) {
+    GgByteGrowVec *target = ctx;
+    return gg_byte_grow_vec_append(target, buf);
+}
+
+GgWriter gg_byte_grow_vec_writer(GgByteGrowVec *byte_vec) {
+    return (GgWriter) { .ctx = byte_vec, .write = &byte_grow_vec_write };
+}
+
+GgBufGrowVec gg_buf_grow_vec_init(GgAlloc alloc) {
+    return (GgBufGrowVec) { .alloc = alloc };
+}
+
+GgError gg_buf_grow_vec_reserve(GgBufGrowVec *vector, size_t additional) {
+    size_t needed;
+    GgError ret = grow_additional(vector->buf_list.len, additional, &needed);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    void *bufs = vector->buf_list.bufs;
+    ret = grow(
+        vector->alloc,
+        &bufs,
+        vector->buf_list.len,
+        NULL,
+        0,
+        &vector->capacity,
+        needed,
+        sizeof(GgBuffer),
+        alignof(GgBuffer),
+        GROW_VEC_MIN_CAPACITY
+    );
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    vector->buf_list.bufs = bufs;
+    return GG_ERR_OK;
+}
+
+GgError gg_buf_grow_vec_push(GgBufGrowVec *vector, GgBuffer buf) {
+    GgError ret = gg_buf_grow_vec_reserve(vector, 1);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    vector->buf_list.bufs[vector->buf_list.len] = buf;
+    vector->buf_list.len++;
+    return GG_ERR_OK;
+}
+
+void gg_buf_grow_vec_chain_push(
+    GgError *err, GgBufGrowVec *vector, GgBuffer buf
+) {
+    if (*err == GG_ERR_OK) {
+        *err = gg_buf_grow_vec_push(vector, buf);
+    }
+}
+
+GgBufGrowVec gg_buf_grow_vec_move(GgBufGrowVec *vector) {
+    GgBufGrowVec moved = *vector;
+    vector->buf_list = (GgBufList) { 0 };
+    vector->capacity = 0;
+    return moved;
+}
+
+GgBufList gg_buf_grow_vec_steal(GgBufGrowVec *vector) {
+    return gg_buf_grow_vec_move(vector).buf_list;
+}
+
+void gg_buf_grow_vec_free(GgBufGrowVec *vector) {
+    gg_free(vector->alloc, gg_buf_grow_vec_steal(vector).bufs);
+}
+
+#ifdef GG_SDK_TESTING
+
+#include <gg/json_encode.h>
+#include <gg/map.h>
+#include <gg/object_compare.h>
+#include <gg/test.h>
+#include <unity.h>
+
+GG_TEST_DEFINE(grow_vec_obj_kv) {
+    GgObjGrowVec objs = gg_obj_grow_vec_init(gg_libc_alloc());
+    GgError ret = GG_ERR_OK;
+    for (int64_t i = 0; i < 100; i++) {
+        gg_obj_grow_vec_chain_push(&ret, &objs, gg_obj_i64(i));
+    }
+    GG_TEST_ASSERT_OK(ret);
+    GG_TEST_ASSERT_OK(gg_obj_grow_vec_append(
+        &objs, GG_LIST(gg_obj_bool(true), GG_OBJ_NULL)
+    ));
+    TEST_ASSERT_EQUAL(102, objs.list.len);
+    TEST_ASSERT(objs.capacity >= 102);
+    TEST_ASSERT_EQUAL(99, gg_obj_into_i64(objs.list.items[99]));
+
+    // Moving transfers ownership without copying
+    GgObject *items = objs.list.items;
+    GgObjGrowVec moved = gg_obj_grow_vec_move(&objs);
+    TEST_ASSERT_EQUAL(0, objs.list.len);
+    TEST_ASSERT_EQUAL(0, objs.capacity);
+    TEST_ASSERT_EQUAL_PTR(items, moved.list.items);
+
+    GgKVGrowVec kvs = gg_kv_grow_vec_init(gg_libc_alloc());
+    GG_TEST_ASSERT_OK(gg_kv_grow_vec_push(
+        &kvs, gg_kv(GG_STR("list"), gg_obj_list(moved.list))
+    ));
+    GG_TEST_ASSERT_OK(gg_kv_grow_vec_append(
+        &kvs, GG_MAP(gg_kv(GG_STR("a"), gg_obj_i64(1)))
+    ));
+
+    GgMap map = gg_kv_grow_vec_steal(&kvs);
+    TEST_ASSERT_NULL(kvs.map.pairs);
+    TEST_ASSERT_EQUAL(2, map.len);
+    GgObject *list;
+    TEST_ASSERT(gg_map_get(map, GG_STR("list"), &list));
+    TEST_ASSERT_EQUAL(102, gg_obj_into_list(*list).len);
+
+    gg_free(gg_libc_alloc(), map.pairs);
+    gg_obj_grow_vec_free(&moved);
+    TEST_ASSERT_NULL(moved.list.items);
+}
+
+GG_TEST_DEFINE(grow_vec_byte_buf) {
+    GgByteGrowVec bytes = gg_byte_grow_vec_init(gg_libc_alloc());
+    GgObject obj = gg_obj_map(
+        GG_MAP(gg_kv(GG_STR("key"), gg_obj_buf(GG_STR("value"))))
+    );
+    for (size_t i = 0; i < 50; i++) {
+        GG_TEST_ASSERT_OK(
+            gg_json_encode(obj, gg_byte_grow_vec_writer(&bytes))
+        );
+    }
+    TEST_ASSERT_EQUAL(50 * sizeof("{\"key\":\"value\"}") - 50, bytes.buf.len);
+    GG_TEST_ASSERT_OK(gg_byte_grow_vec_push(&bytes, '!'));
+
+    GgBufGrowVec bufs = gg_buf_grow_vec_init(gg_libc_alloc());
+    GG_TEST_ASSERT_OK(gg_buf_grow_vec_push(&bufs, GG_STR("a")));
+    GG_TEST_ASSERT_OK(gg_buf_grow_vec_push(&bufs, bytes.buf));
+    GgBufList list = gg_buf_grow_vec_steal(&bufs);
+    TEST_ASSERT_EQUAL(2, list.len);
+    TEST_ASSERT_EQUAL('!', list.bufs[1].data[list.bufs[1].len - 1]);
+
+    gg_free(gg_libc_alloc(), list.bufs);
+    GgBuffer buf = gg_byte_grow_vec_steal(&bytes);
+    gg_free(gg_libc_alloc(), buf.data);
+    gg_byte_grow_vec_free(&bytes);
+}
+
+GG_TEST_DEFINE(grow_vec_append_self) {
+    // Appending to an empty vector from nothing needs no allocation
+    GgObjGrowVec objs = gg_obj_grow_vec_init(gg_libc_alloc());
+    GG_TEST_ASSERT_OK(gg_obj_grow_vec_append(&objs, (GgList) { 0 }));
+    TEST_ASSERT_EQUAL(0, objs.list.len);
+
+    for (int64_t i = 0; i < 8; i++) {
+        GG_TEST_ASSERT_OK(gg_obj_grow_vec_push(&objs, gg_obj_i64(i)));
+    }
+    TEST_ASSERT_EQUAL(8, objs.capacity);
+    // Grows, freeing the buffer being appended from
+    GG_TEST_ASSERT_OK(gg_obj_grow_vec_append(&objs, objs.list));
+    // Fits in place
+    GG_TEST_ASSERT_OK(gg_obj_grow_vec_reserve(&objs, 4));
+    GgObject *items = objs.list.items;
+    GG_TEST_ASSERT_OK(gg_obj_grow_vec_append(
+        &objs, (GgList) { .items = &objs.list.items[2], .len = 4 }
+    ));
+    TEST_ASSERT_EQUAL_PTR(items, objs.list.items);
+    TEST_ASSERT_EQUAL(20, objs.list.len);
+    for (size_t i = 0; i < 16; i++) {
+        TEST_ASSERT_EQUAL(i % 8, gg_obj_into_i64(objs.list.items[i]));
+    }
+    for (size_t i = 16; i < 20; i++) {
+        TEST_ASSERT_EQUAL(i - 14, gg_obj_into_i64(objs.list.items[i]));
+    }
+    gg_obj_grow_vec_free(&objs);
+
+    GgKVGrowVec kvs = gg_kv_grow_vec_init(gg_libc_alloc());
+    GG_TEST_ASSERT_OK(
+        gg_kv_grow_vec_push(&kvs, gg_kv(GG_STR("a"), GG_OBJ_NULL))
+    );
+    for (size_t i = 0; i < 4; i++) {
+        GG_TEST_ASSERT_OK(gg_kv_grow_vec_append(&kvs, kvs.map));
+    }
+    TEST_ASSERT_EQUAL(16, kvs.map.len);
+    GG_TEST_ASSERT_BUF_EQUAL_STR(GG_STR("a"), gg_kv_key(kvs.map.pairs[15]));
+    gg_kv_grow_vec_free(&kvs);
+
+    GgByteGrowVec bytes = gg_byte_grow_vec_init(gg_libc_alloc());
+    GG_TEST_ASSERT_OK(gg_byte_grow_vec_append(&bytes, GG_STR("abcd")));
+    for (size_t i = 0; i < 5; i++) {
+        GG_TEST_ASSERT_OK(gg_byte_grow_vec_append(&bytes, bytes.buf));
+    }
+    TEST_ASSERT_EQUAL(128, bytes.buf.len);
+    TEST_ASSERT(bytes.capacity > GROW_VEC_MIN_BYTES);
+    GG_TEST_ASSERT_BUF_EQUAL_STR(
+        GG_STR("abcd"), gg_buffer_substr(bytes.buf, 124, SIZE_MAX)
+    );
+    gg_byte_grow_vec_free(&bytes);
+}
+
+#endif
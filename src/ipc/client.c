@@ -21,11 +21,13 @@
 #include <gg/ipc/client_priv.h>
 #include <gg/ipc/client_raw.h>
 #include <gg/ipc/limits.h>
+#include <gg/ipc/stats_priv.h>
 #include <gg/json_decode.h>
 #include <gg/json_encode.h>
 #include <gg/log.h>
 #include <gg/map.h>
 #include <gg/object.h>
+#include <gg/probe.h>
 #include <gg/socket.h>
 #include <gg/socket_epoll.h>
 #include <inttypes.h>
@@ -52,6 +54,7 @@ typedef struct {
     GgIpcSubscribeCallback *fn;
     void *ctx;
     void *aux_ctx;
+    const GgBufList *b64_path;
 } StreamHandler;
 
 static_assert(
@@ -175,6 +178,7 @@ static void clear_stream_index(uint16_t index) {
 }
 
 // After connected, requires holding stream_state_mtx
+// Headers must start with :message-type, :message-flags, and :stream-id.
 static GgError ipc_send_packet(
     int conn,
     const EventStreamHeader *headers,
@@ -184,12 +188,43 @@ static GgError ipc_send_packet(
     static uint8_t ipc_send_mem[GG_IPC_MAX_MSG_LEN];
     GgBuffer es_packet = GG_BUF(ipc_send_mem);
 
+    assert(headers_len >= 3);
+    assert(gg_buffer_eq(headers[0].name, GG_STR(":message-type")));
+    assert(gg_buffer_eq(headers[2].name, GG_STR(":stream-id")));
+
     GgError ret = eventstream_encode(&es_packet, headers, headers_len, payload);
     if (ret != GG_ERR_OK) {
         return ret;
     }
+    ggipc_stats_record_send_buf(es_packet.len);
 
-    return gg_socket_write(conn, es_packet);
+    ret = gg_socket_write(conn, es_packet);
+    if (ret == GG_ERR_OK) {
+        ggipc_stats_record_sent(es_packet.len);
+        GG_PROBE3(
+            ipc_frame_send,
+            headers[2].value.int32,
+            headers[0].value.int32,
+            es_packet.len
+        );
+    }
+    return ret;
+}
+
+// Packets are read into ipc_recv_mem without their 12 byte prelude, and the
+// payload is followed by the 4 byte message CRC.
+static size_t recv_mem_used(EventStreamMessage msg) {
+    uint8_t *payload_end = &msg.payload.data[msg.payload.len];
+    return (size_t) (payload_end - ipc_recv_mem) + 4U;
+}
+
+static size_t received_packet_len(EventStreamMessage msg) {
+    return 12U + recv_mem_used(msg);
+}
+
+static void record_received(EventStreamMessage msg) {
+    ggipc_stats_record_received(received_packet_len(msg));
+    ggipc_stats_record_recv_buf(recv_mem_used(msg));
 }
 
 static bool connected(void) {
@@ -253,6 +288,7 @@ GgError ggipc_connect_with_payload(GgBuffer socket_path, GgObject payload) {
         GG_LOGE("Failed to receive GG-IPC connect ack on fd %d.", conn);
         return ret;
     }
+    record_received(msg);
 
     EventStreamCommonHeaders common_headers;
     ret = eventstream_get_common_headers(&msg, &common_headers);
@@ -338,8 +374,11 @@ static GgError handle_application_error(
     GgArena error_alloc = gg_arena_init(GG_BUF(ipc_recv_decode_mem));
 
     GgObject err_result;
+    uint64_t decode_start = ggipc_stats_now();
     GgError ret
         = gg_json_decode_destructive(payload, &error_alloc, &err_result);
+    ggipc_stats_record_decode(ret, decode_start);
+    ggipc_stats_record_decode_mem(error_alloc.index);
     if (ret != GG_ERR_OK) {
         GG_LOGE("Failed to decode IPC error payload.");
         return ret;
@@ -412,7 +451,10 @@ static GgError response_handler_inner(
     GgArena alloc = gg_arena_init(GG_BUF(ipc_recv_decode_mem));
     GgObject result = GG_OBJ_NULL;
 
+    uint64_t decode_start = ggipc_stats_now();
     GgError ret = gg_json_decode_destructive(msg.payload, &alloc, &result);
+    ggipc_stats_record_decode(ret, decode_start);
+    ggipc_stats_record_decode_mem(alloc.index);
     if (ret != GG_ERR_OK) {
         GG_LOGE("Failed to decode IPC response payload.");
         return ret;
@@ -436,6 +478,7 @@ typedef struct {
     GgIpcSubscribeCallback *sub_callback;
     void *sub_callback_ctx;
     void *sub_callback_aux_ctx;
+    const GgBufList *sub_b64_path;
 } ResponseHandlerCtx;
 
 // Must hold stream_state_mtx
@@ -475,6 +518,7 @@ static void response_handler(
                     .fn = call_ctx->sub_callback,
                     .ctx = call_ctx->sub_callback_ctx,
                     .aux_ctx = call_ctx->sub_callback_aux_ctx,
+                    .b64_path = call_ctx->sub_b64_path,
                 }
             );
         }
@@ -484,38 +528,17 @@ static void response_handler(
     pthread_cond_signal(call_ctx->cond);
 }
 
-GgError ggipc_call(
+static GgError subscribe_with_reader(
     GgBuffer operation,
     GgBuffer service_model_type,
-    GgMap params,
-    GgIpcResultCallback *result_callback,
-    GgIpcErrorCallback *error_callback,
-    void *response_ctx
-) {
-    return ggipc_subscribe(
-        operation,
-        service_model_type,
-        params,
-        result_callback,
-        error_callback,
-        response_ctx,
-        NULL,
-        NULL,
-        NULL,
-        NULL
-    );
-}
-
-GgError ggipc_subscribe(
-    GgBuffer operation,
-    GgBuffer service_model_type,
-    GgMap params,
+    GgReader params,
     GgIpcResultCallback *result_callback,
     GgIpcErrorCallback *error_callback,
     void *response_ctx,
     GgIpcSubscribeCallback *sub_callback,
     void *sub_callback_ctx,
     void *sub_callback_aux_ctx,
+    const GgBufList *b64_path,
     GgIpcSubscriptionHandle *sub_handle
 ) {
     if (!connected()) {
@@ -547,6 +570,7 @@ GgError ggipc_subscribe(
         .sub_callback = sub_callback,
         .sub_callback_ctx = sub_callback_ctx,
         .sub_callback_aux_ctx = sub_callback_aux_ctx,
+        .sub_b64_path = b64_path,
     };
 
     uint16_t stream_index;
@@ -588,14 +612,15 @@ GgError ggipc_subscribe(
     };
     size_t headers_len = sizeof(headers) / sizeof(headers[0]);
 
-    GgObject params_obj = gg_obj_map(params);
-    GgError ret = ipc_send_packet(
-        ipc_conn_fd, headers, headers_len, gg_json_reader(&params_obj)
-    );
+    GG_PROBE3(ipc_call_start, stream_id, operation.data, operation.len);
+    uint64_t call_start = ggipc_stats_now();
+    GgError ret = ipc_send_packet(ipc_conn_fd, headers, headers_len, params);
 
     if (ret != GG_ERR_OK) {
         GG_LOGE("Failed to send EventStream packet.");
         clear_stream_index(stream_index);
+        ggipc_stats_record_call(operation, ret, false, call_start);
+        GG_PROBE2(ipc_call_done, stream_id, ret);
         return ret;
     }
 
@@ -610,19 +635,130 @@ GgError ggipc_subscribe(
             assert(cond_ret == ETIMEDOUT);
             GG_LOGW("Timed out waiting for a response.");
             clear_stream_index(stream_index);
+            ggipc_stats_record_call(
+                operation, GG_ERR_TIMEOUT, false, call_start
+            );
+            // Enum constants are int; cast so the probe argument is a GgError
+            GG_PROBE2(ipc_call_done, stream_id, (GgError) GG_ERR_TIMEOUT);
             return GG_ERR_TIMEOUT;
         }
     }
 
+    ggipc_stats_record_call(
+        operation, response_handler_ctx.ret, true, call_start
+    );
+    GG_PROBE2(ipc_call_done, stream_id, response_handler_ctx.ret);
     return response_handler_ctx.ret;
 }
 
+GgError ggipc_subscribe(
+    GgBuffer operation,
+    GgBuffer service_model_type,
+    GgMap params,
+    GgIpcResultCallback *result_callback,
+    GgIpcErrorCallback *error_callback,
+    void *response_ctx,
+    GgIpcSubscribeCallback *sub_callback,
+    void *sub_callback_ctx,
+    void *sub_callback_aux_ctx,
+    GgIpcSubscriptionHandle *sub_handle
+) {
+    return ggipc_subscribe_b64(
+        operation,
+        service_model_type,
+        params,
+        result_callback,
+        error_callback,
+        response_ctx,
+        sub_callback,
+        sub_callback_ctx,
+        sub_callback_aux_ctx,
+        NULL,
+        sub_handle
+    );
+}
+
+GgError ggipc_subscribe_b64(
+    GgBuffer operation,
+    GgBuffer service_model_type,
+    GgMap params,
+    GgIpcResultCallback *result_callback,
+    GgIpcErrorCallback *error_callback,
+    void *response_ctx,
+    GgIpcSubscribeCallback *sub_callback,
+    void *sub_callback_ctx,
+    void *sub_callback_aux_ctx,
+    const GgBufList *b64_path,
+    GgIpcSubscriptionHandle *sub_handle
+) {
+    GgObject params_obj = gg_obj_map(params);
+    return subscribe_with_reader(
+        operation,
+        service_model_type,
+        gg_json_reader(&params_obj),
+        result_callback,
+        error_callback,
+        response_ctx,
+        sub_callback,
+        sub_callback_ctx,
+        sub_callback_aux_ctx,
+        b64_path,
+        sub_handle
+    );
+}
+
+GgError ggipc_call(
+    GgBuffer operation,
+    GgBuffer service_model_type,
+    GgMap params,
+    GgIpcResultCallback *result_callback,
+    GgIpcErrorCallback *error_callback,
+    void *response_ctx
+) {
+    return ggipc_subscribe(
+        operation,
+        service_model_type,
+        params,
+        result_callback,
+        error_callback,
+        response_ctx,
+        NULL,
+        NULL,
+        NULL,
+        NULL
+    );
+}
+
+GgError ggipc_call_with_reader(
+    GgBuffer operation,
+    GgBuffer service_model_type,
+    GgReader params,
+    GgIpcResultCallback *result_callback,
+    GgIpcErrorCallback *error_callback,
+    void *response_ctx
+) {
+    return subscribe_with_reader(
+        operation,
+        service_model_type,
+        params,
+        result_callback,
+        error_callback,
+        response_ctx,
+        NULL,
+        NULL,
+        NULL,
+        NULL,
+        NULL
+    );
+}
+
 // Must hold stream_state_mtx
 static GgError call_sub_callback(
     GgIpcSubscriptionHandle handle,
     GgIpcSubscribeCallback *sub_callback,
     void *sub_callback_ctx,
     void *sub_callback_aux_ctx,
+    const GgBufList *b64_path,
     EventStreamCommonHeaders common_headers,
     EventStreamMessage msg
 ) {
@@ -671,12 +807,20 @@ static GgError call_sub_callback(
     GgArena arena = gg_arena_init(GG_BUF(ipc_recv_decode_mem));
     GgObject response;
 
-    GgError ret = gg_json_decode_destructive(msg.payload, &arena, &response);
+    uint64_t decode_start = ggipc_stats_now();
+    GgError ret = (b64_path == NULL)
+        ? gg_json_decode_destructive(msg.payload, &arena, &response)
+        : gg_json_decode_destructive_b64(
+              msg.payload, *b64_path, &arena, &response
+          );
+    ggipc_stats_record_decode(ret, decode_start);
+    ggipc_stats_record_decode_mem(arena.index);
     if (ret == GG_ERR_NOMEM) {
         GG_LOGE(
             "IPC response payload too large on stream %" PRId32 ". Skipping.",
             common_headers.stream_id
         );
+        ggipc_stats_record_sub_too_large();
         return GG_ERR_OK;
     }
     if (ret != GG_ERR_OK) {
@@ -692,13 +836,17 @@ static GgError call_sub_callback(
         return GG_ERR_INVALID;
     }
 
-    return sub_callback(
+    ggipc_stats_record_sub_message();
+    GG_PROBE2(ipc_sub_dispatch_start, common_headers.stream_id, handle.val);
+    ret = sub_callback(
         sub_callback_ctx,
         sub_callback_aux_ctx,
         handle,
         service_model_type,
         gg_obj_into_map(response)
     );
+    GG_PROBE2(ipc_sub_dispatch_end, common_headers.stream_id, ret);
+    return ret;
 }
 
 static GgError dispatch_incoming_packet(int conn) {
@@ -708,17 +856,29 @@ static GgError dispatch_incoming_packet(int conn) {
     );
     if (ret != GG_ERR_OK) {
         GG_LOGE("Failed to read eventstream packet.");
+        if ((ret == GG_ERR_PARSE) || (ret == GG_ERR_RANGE)
+            || (ret == GG_ERR_NOMEM)) {
+            ggipc_stats_record_frame_error();
+        }
         return ret;
     }
+    record_received(msg);
 
     EventStreamCommonHeaders common_headers;
     ret = eventstream_get_common_headers(&msg, &common_headers);
     if (ret != GG_ERR_OK) {
         GG_LOGE("Eventstream packet missing required headers.");
+        ggipc_stats_record_frame_error();
         return ret;
     }
 
     int32_t stream_id = common_headers.stream_id;
+    GG_PROBE3(
+        ipc_frame_receive,
+        stream_id,
+        common_headers.message_type,
+        received_packet_len(msg)
+    );
 
     if (stream_id < 0) {
         GG_LOGE("Eventstream packet has negative stream id.");
@@ -735,6 +895,7 @@ static GgError dispatch_incoming_packet(int conn) {
             "Unhandled eventstream packet with stream id %" PRId32 " dropped.",
             stream_id
         );
+        ggipc_stats_record_unhandled();
         return GG_ERR_OK;
     }
 
@@ -751,6 +912,7 @@ static GgError dispatch_incoming_packet(int conn) {
         stream_state_handler[index].fn,
         stream_state_handler[index].ctx,
         stream_state_handler[index].aux_ctx,
+        stream_state_handler[index].b64_path,
         common_headers,
         msg
     );
@@ -0,0 +1,38 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gg/arena.h>
+#include <gg/buffer.h>
+#include <gg/cbor_encode.h>
+#include <gg/cleanup.h>
+#include <gg/error.h>
+#include <gg/ipc/client.h>
+#include <gg/ipc/limits.h>
+#include <gg/log.h>
+#include <gg/object.h>
+#include <gg/scratch.h>
+#include <gg/vector.h>
+
+// The base64 encoded payload must fit in a packet of GG_IPC_MAX_MSG_LEN
+#define IPC_CBOR_ENCODE_MAX_LEN (GG_IPC_MAX_MSG_LEN / 4 * 3)
+
+GgError ggipc_publish_to_topic_cbor(GgBuffer topic, GgMap payload) {
+    GgScratch scratch;
+    GgArena arena;
+    GgError ret
+        = gg_scratch_borrow(IPC_CBOR_ENCODE_MAX_LEN, &scratch, &arena);
+    GG_CLEANUP(cleanup_gg_scratch_return, scratch);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    GgByteVec vec = gg_byte_vec_init(gg_arena_alloc_rest(&arena));
+
+    ret = gg_cbor_encode(gg_obj_map(payload), gg_byte_vec_writer(&vec));
+    if (ret != GG_ERR_OK) {
+        GG_LOGE("Failed to CBOR encode PublishToTopic payload.");
+        return ret;
+    }
+
+    return ggipc_publish_to_topic_binary(topic, vec.buf);
+}
@@ -2,13 +2,18 @@
 // Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
 // SPDX-License-Identifier: Apache-2.0
 
+#include <gg/base64_vec.h>
 #include <gg/buffer.h>
 #include <gg/error.h>
+#include <gg/io.h>
 #include <gg/ipc/client.h>
+#include <gg/ipc/client_priv.h>
 #include <gg/ipc/client_raw.h>
+#include <gg/json_encode.h>
 #include <gg/log.h>
 #include <gg/map.h>
 #include <gg/object.h>
+#include <gg/vector.h>
 #include <string.h>
 #include <stdint.h>
 
@@ -48,3 +53,54 @@ GgError ggipc_publish_to_iot_core_b64(
         NULL
     );
 }
+
+typedef struct {
+    GgBuffer topic_name;
+    GgBuffer payload;
+    uint8_t qos;
+} PublishToIotCoreArgs;
+
+// Writes the request JSON, base64 encoding the payload directly into the
+// packet buffer.
+static GgError publish_to_iot_core_read(void *ctx, GgBuffer *buf) {
+    const PublishToIotCoreArgs *args = ctx;
+    GgByteVec vec = gg_byte_vec_init(*buf);
+
+    GgError ret = gg_byte_vec_append(&vec, GG_STR("{\"topicName\":"));
+    if (ret == GG_ERR_OK) {
+        ret = gg_json_encode(
+            gg_obj_buf(args->topic_name), gg_byte_vec_writer(&vec)
+        );
+    }
+    gg_byte_vec_chain_append(&ret, &vec, GG_STR(",\"payload\":\""));
+    gg_byte_vec_chain_append_base64(&ret, &vec, args->payload);
+    gg_byte_vec_chain_append(&ret, &vec, GG_STR("\",\"qos\":\""));
+    gg_byte_vec_chain_push(&ret, &vec, (uint8_t) (args->qos + (uint8_t) '0'));
+    gg_byte_vec_chain_append(&ret, &vec, GG_STR("\"}"));
+    if (ret != GG_ERR_OK) {
+        GG_LOGE(
+            "Insufficient space to encode PublishToIoTCore request (payload "
+            "%zu bytes).",
+            args->payload.len
+        );
+        return ret;
+    }
+
+    *buf = vec.buf;
+    return GG_ERR_OK;
+}
+
+GgError ggipc_publish_to_iot_core(
+    GgBuffer topic_name, GgBuffer payload, uint8_t qos
+) {
+    PublishToIotCoreArgs args
+        = { .topic_name = topic_name, .payload = payload, .qos = qos };
+    return ggipc_call_with_reader(
+        GG_STR("aws.greengrass#PublishToIoTCore"),
+        GG_STR("aws.greengrass#PublishToIoTCoreRequest"),
+        (GgReader) { .read = publish_to_iot_core_read, .ctx = &args },
+        NULL,
+        &error_handler,
+        NULL
+    );
+}
@@ -2,13 +2,18 @@
 // Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
 // SPDX-License-Identifier: Apache-2.0
 
+#include <gg/base64_vec.h>
 #include <gg/buffer.h>
 #include <gg/error.h>
+#include <gg/io.h>
 #include <gg/ipc/client.h>
+#include <gg/ipc/client_priv.h>
 #include <gg/ipc/client_raw.h>
+#include <gg/json_encode.h>
 #include <gg/log.h>
 #include <gg/map.h>
 #include <gg/object.h>
+#include <gg/vector.h>
 #include <string.h>
 
 static GgError error_handler(void *ctx, GgBuffer error_code, GgBuffer message) {
@@ -62,3 +67,50 @@ GgError ggipc_publish_to_topic_binary_b64(
 
     return publish_to_topic_common(topic, publish_message);
 }
+
+typedef struct {
+    GgBuffer topic;
+    GgBuffer payload;
+} PublishBinaryArgs;
+
+// Writes the request JSON, base64 encoding the payload directly into the
+// packet buffer.
+static GgError publish_binary_read(void *ctx, GgBuffer *buf) {
+    const PublishBinaryArgs *args = ctx;
+    GgByteVec vec = gg_byte_vec_init(*buf);
+
+    GgError ret = gg_byte_vec_append(&vec, GG_STR("{\"topic\":"));
+    if (ret == GG_ERR_OK) {
+        ret = gg_json_encode(gg_obj_buf(args->topic), gg_byte_vec_writer(&vec));
+    }
+    gg_byte_vec_chain_append(
+        &ret,
+        &vec,
+        GG_STR(",\"publishMessage\":{\"binaryMessage\":{\"message\":\"")
+    );
+    gg_byte_vec_chain_append_base64(&ret, &vec, args->payload);
+    gg_byte_vec_chain_append(&ret, &vec, GG_STR("\"}}}"));
+    if (ret != GG_ERR_OK) {
+        GG_LOGE(
+            "Insufficient space to encode PublishToTopic request (payload %zu "
+            "bytes).",
+            args->payload.len
+        );
+        return ret;
+    }
+
+    *buf = vec.buf;
+    return GG_ERR_OK;
+}
+
+GgError ggipc_publish_to_topic_binary(GgBuffer topic, GgBuffer payload) {
+    PublishBinaryArgs args = { .topic = topic, .payload = payload };
+    return ggipc_call_with_reader(
+        GG_STR("aws.greengrass#PublishToTopic"),
+        GG_STR("aws.greengrass#PublishToTopicRequest"),
+        (GgReader) { .read = publish_binary_read, .ctx = &args },
+        NULL,
+        &error_handler,
+        NULL
+    );
+}
@@ -2,11 +2,11 @@
 // Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
 // SPDX-License-Identifier: Apache-2.0
 
-#include <gg/base64.h>
 #include <gg/buffer.h>
 #include <gg/error.h>
 #include <gg/flags.h>
 #include <gg/ipc/client.h>
+#include <gg/ipc/client_priv.h>
 #include <gg/ipc/client_raw.h>
 #include <gg/log.h>
 #include <gg/map.h>
@@ -14,6 +14,11 @@
 #include <inttypes.h>
 #include <string.h>
 
+// Payloads are base64 decoded along with the message JSON
+static GgBuffer payload_keys[] = { GG_STR("message"), GG_STR("payload") };
+static const GgBufList PAYLOAD_PATH
+    = { .bufs = payload_keys, .len = sizeof(payload_keys) / sizeof(GgBuffer) };
+
 static GgError subscribe_to_iot_core_resp_handler(
     void *ctx,
     void *aux_ctx,
@@ -59,11 +64,6 @@ static GgError subscribe_to_iot_core_resp_handler(
     GgBuffer topic = gg_obj_into_buf(*topic_obj);
     GgBuffer payload = gg_obj_into_buf(*payload_obj);
 
-    if (!gg_base64_decode_in_place(&payload)) {
-        GG_LOGE("Failed to decode IoT Core subscription response payload.");
-        return GG_ERR_INVALID;
-    }
-
     callback(aux_ctx, topic, payload, handle);
     return GG_ERR_OK;
 }
@@ -102,7 +102,7 @@ GgError ggipc_subscribe_to_iot_core(
         gg_kv(GG_STR("qos"), gg_obj_buf(qos_buffer))
     );
 
-    return ggipc_subscribe(
+    return ggipc_subscribe_b64(
         GG_STR("aws.greengrass#SubscribeToIoTCore"),
         GG_STR("aws.greengrass#SubscribeToIoTCoreRequest"),
         args,
@@ -112,6 +112,7 @@ GgError ggipc_subscribe_to_iot_core(
         &subscribe_to_iot_core_resp_handler,
         callback,
         ctx,
+        &PAYLOAD_PATH,
         handle
     );
 }
@@ -2,27 +2,38 @@
 // Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
 // SPDX-License-Identifier: Apache-2.0
 
-#include <gg/base64.h>
+#include <gg/arena.h>
 #include <gg/buffer.h>
+#include <gg/cbor_decode.h>
 #include <gg/error.h>
 #include <gg/flags.h>
 #include <gg/ipc/client.h>
+#include <gg/ipc/client_priv.h>
 #include <gg/ipc/client_raw.h>
 #include <gg/log.h>
 #include <gg/map.h>
 #include <gg/object.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
 
-static GgError subscribe_to_topic_resp_handler(
-    void *ctx,
-    void *aux_ctx,
-    GgIpcSubscriptionHandle handle,
+// Binary payloads are base64 decoded along with the message JSON
+static GgBuffer binary_message_keys[]
+    = { GG_STR("binaryMessage"), GG_STR("message") };
+static const GgBufList BINARY_MESSAGE_PATH
+    = { .bufs = binary_message_keys,
+        .len = sizeof(binary_message_keys) / sizeof(GgBuffer) };
+
+// Only used by the receiving thread. Decoded objects are bounded by object
+// limits, so this always suffices.
+static uint8_t cbor_decode_mem[GG_CBOR_DECODE_MAX_ALLOC];
+
+static GgError parse_subscription_response(
     GgBuffer service_model_type,
-    GgMap data
+    GgMap data,
+    GgBuffer *topic,
+    GgObject *payload
 ) {
-    GgIpcSubscribeToTopicCallback *callback = ctx;
-
     if (!gg_buffer_eq(
             service_model_type,
             GG_STR("aws.greengrass#SubscriptionResponseMessage")
@@ -87,23 +98,73 @@ static GgError subscribe_to_topic_resp_handler(
         return GG_ERR_INVALID;
     }
 
-    GgBuffer topic = gg_obj_into_buf(*topic_obj);
+    *topic = gg_obj_into_buf(*topic_obj);
+    *payload = *message_obj;
+    return GG_ERR_OK;
+}
 
-    GgObject payload = *message_obj;
+static GgError subscribe_to_topic_resp_handler(
+    void *ctx,
+    void *aux_ctx,
+    GgIpcSubscriptionHandle handle,
+    GgBuffer service_model_type,
+    GgMap data
+) {
+    GgIpcSubscribeToTopicCallback *callback = ctx;
 
-    if (!is_json) {
-        GgBuffer payload_buf = gg_obj_into_buf(*message_obj);
-        if (!gg_base64_decode_in_place(&payload_buf)) {
-            GG_LOGE("Failed to decode pubsub subscription response payload.");
-            return GG_ERR_INVALID;
-        }
-        payload = gg_obj_buf(payload_buf);
+    GgBuffer topic;
+    GgObject payload;
+    GgError ret = parse_subscription_response(
+        service_model_type, data, &topic, &payload
+    );
+    if (ret != GG_ERR_OK) {
+        return ret;
     }
 
     callback(aux_ctx, topic, payload, handle);
     return GG_ERR_OK;
 }
 
+static GgError subscribe_to_topic_cbor_resp_handler(
+    void *ctx,
+    void *aux_ctx,
+    GgIpcSubscriptionHandle handle,
+    GgBuffer service_model_type,
+    GgMap data
+) {
+    GgIpcSubscribeToTopicCborCallback *callback = ctx;
+
+    GgBuffer topic;
+    GgObject payload;
+    GgError ret = parse_subscription_response(
+        service_model_type, data, &topic, &payload
+    );
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+
+    GgArena arena = gg_arena_init(GG_BUF(cbor_decode_mem));
+
+    // JSON messages are already maps; binary messages hold the CBOR encoding.
+    // Bad messages are dropped without closing the subscription, as they come
+    // from other publishers.
+    if (gg_obj_type(payload) == GG_TYPE_BUF) {
+        ret = gg_cbor_decode(gg_obj_into_buf(payload), &arena, &payload);
+        if (ret != GG_ERR_OK) {
+            GG_LOGW("Dropping pubsub message that is not valid CBOR.");
+            return GG_ERR_OK;
+        }
+    }
+
+    if (gg_obj_type(payload) != GG_TYPE_MAP) {
+        GG_LOGW("Dropping pubsub CBOR message that is not a map.");
+        return GG_ERR_OK;
+    }
+
+    callback(aux_ctx, topic, gg_obj_into_map(payload), handle);
+    return GG_ERR_OK;
+}
+
 static GgError error_handler(void *ctx, GgBuffer error_code, GgBuffer message) {
     (void) ctx;
 
@@ -129,7 +190,7 @@ GgError ggipc_subscribe_to_topic(
 ) {
     GgMap args = GG_MAP(gg_kv(GG_STR("topic"), gg_obj_buf(topic)), );
 
-    return ggipc_subscribe(
+    return ggipc_subscribe_b64(
         GG_STR("aws.greengrass#SubscribeToTopic"),
         GG_STR("aws.greengrass#SubscribeToTopicRequest"),
         args,
@@ -139,6 +200,30 @@ GgError ggipc_subscribe_to_topic(
         &subscribe_to_topic_resp_handler,
         callback,
         ctx,
+        &BINARY_MESSAGE_PATH,
+        handle
+    );
+}
+
+GgError ggipc_subscribe_to_topic_cbor(
+    GgBuffer topic,
+    GgIpcSubscribeToTopicCborCallback callback,
+    void *ctx,
+    GgIpcSubscriptionHandle *handle
+) {
+    GgMap args = GG_MAP(gg_kv(GG_STR("topic"), gg_obj_buf(topic)), );
+
+    return ggipc_subscribe_b64(
+        GG_STR("aws.greengrass#SubscribeToTopic"),
+        GG_STR("aws.greengrass#SubscribeToTopicRequest"),
+        args,
+        NULL,
+        &error_handler,
+        NULL,
+        &subscribe_to_topic_cbor_resp_handler,
+        callback,
+        ctx,
+        &BINARY_MESSAGE_PATH,
         handle
     );
 }
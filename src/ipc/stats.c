@@ -0,0 +1,337 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gg/buffer.h>
+#include <gg/cleanup.h>
+#include <gg/error.h>
+#include <gg/ipc/limits.h>
+#include <gg/ipc/stats.h>
+#include <gg/ipc/stats_priv.h>
+#include <gg/object.h>
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    atomic_uint_fast64_t calls;
+    atomic_uint_fast64_t errors;
+    atomic_uint_fast64_t timeouts;
+    atomic_uint_fast64_t latency_ns_total;
+    atomic_uint_fast64_t latency_hist[GG_IPC_LATENCY_BUCKETS];
+} OpCounters;
+
+typedef struct {
+    atomic_uint_fast64_t frames_sent;
+    atomic_uint_fast64_t bytes_sent;
+    atomic_uint_fast64_t frames_received;
+    atomic_uint_fast64_t bytes_received;
+    atomic_uint_fast64_t payloads_decoded;
+    atomic_uint_fast64_t decode_ns_total;
+    atomic_uint_fast64_t decode_failures;
+    atomic_uint_fast64_t sub_messages;
+    atomic_uint_fast64_t sub_dropped_too_large;
+    atomic_uint_fast64_t unhandled_dropped;
+    OpCounters total;
+    OpCounters ops[GG_IPC_STATS_MAX_OPS];
+} IpcCounters;
+
+static IpcCounters counters;
+
+typedef struct {
+    atomic_size_t send_buf;
+    atomic_size_t recv_buf;
+    atomic_size_t decode_mem;
+} IpcMemPeaks;
+
+static IpcMemPeaks mem_peaks;
+
+// Names are written once before op_count is incremented past them
+static char op_names[GG_IPC_STATS_MAX_OPS][GG_IPC_STATS_OP_NAME_MAX];
+static size_t op_name_lens[GG_IPC_STATS_MAX_OPS];
+static atomic_size_t op_count = 0;
+static pthread_mutex_t op_claim_mtx = PTHREAD_MUTEX_INITIALIZER;
+
+static void count(atomic_uint_fast64_t *counter, uint64_t amount) {
+    atomic_fetch_add_explicit(counter, amount, memory_order_relaxed);
+}
+
+static uint64_t load(const atomic_uint_fast64_t *counter) {
+    return atomic_load_explicit(counter, memory_order_relaxed);
+}
+
+static void raise_peak(atomic_size_t *peak, size_t used) {
+    size_t cur = atomic_load_explicit(peak, memory_order_relaxed);
+    while (used > cur) {
+        if (atomic_compare_exchange_weak_explicit(
+                peak, &cur, used, memory_order_relaxed, memory_order_relaxed
+            )) {
+            return;
+        }
+    }
+}
+
+static OpCounters *find_op(GgBuffer operation, size_t limit) {
+    for (size_t i = 0; i < limit; i++) {
+        if ((op_name_lens[i] == operation.len)
+            && (memcmp(op_names[i], operation.data, operation.len) == 0)) {
+            return &counters.ops[i];
+        }
+    }
+    return NULL;
+}
+
+static OpCounters *op_counters(GgBuffer operation) {
+    if (operation.len >= GG_IPC_STATS_OP_NAME_MAX) {
+        return NULL;
+    }
+
+    OpCounters *op = find_op(
+        operation, atomic_load_explicit(&op_count, memory_order_acquire)
+    );
+    if (op != NULL) {
+        return op;
+    }
+
+    GG_MTX_SCOPE_GUARD(&op_claim_mtx);
+
+    size_t claimed = atomic_load_explicit(&op_count, memory_order_relaxed);
+    op = find_op(operation, claimed);
+    if ((op != NULL) || (claimed == GG_IPC_STATS_MAX_OPS)) {
+        return op;
+    }
+
+    if (operation.len > 0) {
+        memcpy(op_names[claimed], operation.data, operation.len);
+    }
+    op_name_lens[claimed] = operation.len;
+    atomic_store_explicit(&op_count, claimed + 1, memory_order_release);
+    return &counters.ops[claimed];
+}
+
+static size_t latency_bucket(uint64_t latency_ns) {
+    uint64_t latency_us = latency_ns / 1000U;
+    if (latency_us == 0) {
+        return 0;
+    }
+    size_t bucket = (size_t) (64 - __builtin_clzll(latency_us));
+    return (bucket < GG_IPC_LATENCY_BUCKETS) ? bucket
+                                             : GG_IPC_LATENCY_BUCKETS - 1;
+}
+
+static void record_op(
+    OpCounters *op, GgError ret, bool responded, uint64_t latency_ns
+) {
+    count(&op->calls, 1);
+    if (ret != GG_ERR_OK) {
+        count(&op->errors, 1);
+    }
+    if (ret == GG_ERR_TIMEOUT) {
+        count(&op->timeouts, 1);
+    }
+    if (responded) {
+        count(&op->latency_ns_total, latency_ns);
+        count(&op->latency_hist[latency_bucket(latency_ns)], 1);
+    }
+}
+
+uint64_t ggipc_stats_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t) now.tv_sec * 1000000000U) + (uint64_t) now.tv_nsec;
+}
+
+void ggipc_stats_record_call(
+    GgBuffer operation, GgError ret, bool responded, uint64_t start_ns
+) {
+    uint64_t latency_ns = ggipc_stats_now() - start_ns;
+    record_op(&counters.total, ret, responded, latency_ns);
+    OpCounters *op = op_counters(operation);
+    if (op != NULL) {
+        record_op(op, ret, responded, latency_ns);
+    }
+}
+
+void ggipc_stats_record_sent(size_t bytes) {
+    count(&counters.frames_sent, 1);
+    count(&counters.bytes_sent, bytes);
+}
+
+void ggipc_stats_record_received(size_t bytes) {
+    count(&counters.frames_received, 1);
+    count(&counters.bytes_received, bytes);
+}
+
+void ggipc_stats_record_decode(GgError ret, uint64_t start_ns) {
+    count(&counters.payloads_decoded, 1);
+    count(&counters.decode_ns_total, ggipc_stats_now() - start_ns);
+    // Payloads too large for decode memory are counted as drops instead
+    if ((ret != GG_ERR_OK) && (ret != GG_ERR_NOMEM)) {
+        count(&counters.decode_failures, 1);
+    }
+}
+
+void ggipc_stats_record_frame_error(void) {
+    count(&counters.decode_failures, 1);
+}
+
+void ggipc_stats_record_sub_message(void) {
+    count(&counters.sub_messages, 1);
+}
+
+void ggipc_stats_record_sub_too_large(void) {
+    count(&counters.sub_dropped_too_large, 1);
+}
+
+void ggipc_stats_record_unhandled(void) {
+    count(&counters.unhandled_dropped, 1);
+}
+
+void ggipc_stats_record_send_buf(size_t used) {
+    raise_peak(&mem_peaks.send_buf, used);
+}
+
+void ggipc_stats_record_recv_buf(size_t used) {
+    raise_peak(&mem_peaks.recv_buf, used);
+}
+
+void ggipc_stats_record_decode_mem(size_t used) {
+    raise_peak(&mem_peaks.decode_mem, used);
+}
+
+static void load_op(const OpCounters *op, GgIpcOpStats *stats) {
+    stats->calls = load(&op->calls);
+    stats->errors = load(&op->errors);
+    stats->timeouts = load(&op->timeouts);
+    stats->latency_ns_total = load(&op->latency_ns_total);
+    for (size_t i = 0; i < GG_IPC_LATENCY_BUCKETS; i++) {
+        stats->latency_hist[i] = load(&op->latency_hist[i]);
+    }
+}
+
+void ggipc_get_stats(GgIpcStats *stats) {
+    *stats = (GgIpcStats) {
+        .frames_sent = load(&counters.frames_sent),
+        .bytes_sent = load(&counters.bytes_sent),
+        .frames_received = load(&counters.frames_received),
+        .bytes_received = load(&counters.bytes_received),
+        .payloads_decoded = load(&counters.payloads_decoded),
+        .decode_ns_total = load(&counters.decode_ns_total),
+        .decode_failures = load(&counters.decode_failures),
+        .sub_messages = load(&counters.sub_messages),
+        .sub_dropped_too_large = load(&counters.sub_dropped_too_large),
+        .unhandled_dropped = load(&counters.unhandled_dropped),
+    };
+
+    GgIpcOpStats total;
+    load_op(&counters.total, &total);
+    stats->calls = total.calls;
+    stats->errors = total.errors;
+    stats->timeouts = total.timeouts;
+
+    stats->op_count = atomic_load_explicit(&op_count, memory_order_acquire);
+    for (size_t i = 0; i < stats->op_count; i++) {
+        memcpy(stats->ops[i].operation, op_names[i], op_name_lens[i]);
+        stats->ops[i].operation[op_name_lens[i]] = '\0';
+        load_op(&counters.ops[i], &stats->ops[i]);
+    }
+}
+
+static GgIpcBufferUsage load_usage(const atomic_size_t *peak, size_t capacity) {
+    return (GgIpcBufferUsage) {
+        .peak = atomic_load_explicit(peak, memory_order_relaxed),
+        .capacity = capacity,
+    };
+}
+
+void ggipc_get_memory_usage(GgIpcMemoryUsage *usage) {
+    // Capacities match the buffers in client.c
+    *usage = (GgIpcMemoryUsage) {
+        .send_buf = load_usage(&mem_peaks.send_buf, GG_IPC_MAX_MSG_LEN),
+        .recv_buf = load_usage(&mem_peaks.recv_buf, GG_IPC_MAX_MSG_LEN),
+        .decode_mem = load_usage(
+            &mem_peaks.decode_mem, sizeof(GgObject[GG_MAX_OBJECT_SUBOBJECTS])
+        ),
+    };
+}
+
+void ggipc_reset_memory_peaks(void) {
+    atomic_store_explicit(&mem_peaks.send_buf, 0, memory_order_relaxed);
+    atomic_store_explicit(&mem_peaks.recv_buf, 0, memory_order_relaxed);
+    atomic_store_explicit(&mem_peaks.decode_mem, 0, memory_order_relaxed);
+}
+
+#ifdef GG_SDK_TESTING
+
+#include <gg/test.h>
+#include <unity.h>
+
+GG_TEST_DEFINE(ipc_stats_ops) {
+    GgIpcStats before;
+    ggipc_get_stats(&before);
+
+    uint64_t start = ggipc_stats_now();
+    ggipc_stats_record_call(GG_STR("test#StatsA"), GG_ERR_OK, true, start);
+    ggipc_stats_record_call(GG_STR("test#StatsB"), GG_ERR_REMOTE, true, start);
+    ggipc_stats_record_call(
+        GG_STR("test#StatsA"), GG_ERR_TIMEOUT, false, start
+    );
+
+    GgIpcStats stats;
+    ggipc_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT64(before.calls + 3, stats.calls);
+    TEST_ASSERT_EQUAL_UINT64(before.errors + 2, stats.errors);
+    TEST_ASSERT_EQUAL_UINT64(before.timeouts + 1, stats.timeouts);
+
+    const GgIpcOpStats *op_a = NULL;
+    for (size_t i = 0; i < stats.op_count; i++) {
+        if (strcmp(stats.ops[i].operation, "test#StatsA") == 0) {
+            op_a = &stats.ops[i];
+        }
+    }
+    TEST_ASSERT_NOT_NULL(op_a);
+    TEST_ASSERT_EQUAL_UINT64(2, op_a->calls);
+    TEST_ASSERT_EQUAL_UINT64(1, op_a->errors);
+    TEST_ASSERT_EQUAL_UINT64(1, op_a->timeouts);
+
+    // Only the call with a response has its latency recorded
+    uint64_t recorded = 0;
+    for (size_t i = 0; i < GG_IPC_LATENCY_BUCKETS; i++) {
+        recorded += op_a->latency_hist[i];
+    }
+    TEST_ASSERT_EQUAL_UINT64(1, recorded);
+}
+
+GG_TEST_DEFINE(ipc_stats_latency_buckets) {
+    TEST_ASSERT_EQUAL(0, latency_bucket(999));
+    TEST_ASSERT_EQUAL(1, latency_bucket(1000));
+    TEST_ASSERT_EQUAL(2, latency_bucket(2000));
+    TEST_ASSERT_EQUAL(2, latency_bucket(3999));
+    TEST_ASSERT_EQUAL(11, latency_bucket(1024000));
+    TEST_ASSERT_EQUAL(GG_IPC_LATENCY_BUCKETS - 1, latency_bucket(UINT64_MAX));
+}
+
+GG_TEST_DEFINE(ipc_memory_peaks) {
+    ggipc_reset_memory_peaks();
+    ggipc_stats_record_send_buf(100);
+    ggipc_stats_record_send_buf(40);
+    ggipc_stats_record_decode_mem(300);
+
+    GgIpcMemoryUsage usage;
+    ggipc_get_memory_usage(&usage);
+    TEST_ASSERT_EQUAL(100, usage.send_buf.peak);
+    TEST_ASSERT_EQUAL(GG_IPC_MAX_MSG_LEN, usage.send_buf.capacity);
+    TEST_ASSERT_EQUAL(0, usage.recv_buf.peak);
+    TEST_ASSERT_EQUAL(300, usage.decode_mem.peak);
+
+    ggipc_reset_memory_peaks();
+    ggipc_get_memory_usage(&usage);
+    TEST_ASSERT_EQUAL(0, usage.send_buf.peak);
+    TEST_ASSERT_EQUAL(0, usage.decode_mem.peak);
+}
+
+#endif
@@ -3,18 +3,21 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <assert.h>
-#include <errno.h>
 #include <gg/arena.h>
+#include <gg/base64.h>
+#include <gg/base64_prefix.h>
 #include <gg/buffer.h>
 #include <gg/error.h>
 #include <gg/json_decode.h>
+#include <gg/json_number.h>
+#include <gg/json_str.h>
 #include <gg/log.h>
 #include <gg/map.h>
 #include <gg/object.h>
+#include <gg/utf8.h>
 #include <string.h>
 #include <stdbool.h>
 #include <stdint.h>
-#include <stdlib.h>
 
 // Parses JSON using a parser-combinator strategy
 // Parsers take a buffer, and if they match a prefix of the buffer, they consume
@@ -274,60 +277,45 @@ static const Parser PARSER_JSON_STR_ESCAPE = COMB_SEQUENCE(
     )
 );
 
-static bool parser_json_str_codepoint_fn(
+static bool parser_json_str_body_fn(
     const void *parser_ctx, GgBuffer *buf, ParseResult *output
 ) {
     (void) parser_ctx;
     (void) output;
 
-    if (buf->len < 1) {
-        return false;
-    }
-    if (buf->data[0] <= 0x1F) {
-        // control character
-        return false;
-    }
-    if ((char) buf->data[0] == '"') {
-        return false;
-    }
-    if ((char) buf->data[0] == '\\') {
-        return false;
-    }
-    if ((buf->data[0] & 0b11000000) == 0b10000000) {
-        // UTF-8 continuation byte
-        return false;
-    }
-
-    size_t utf8_len = 0;
-    if ((buf->data[0] & 0b10000000) == 0) {
-        utf8_len = 1;
-    } else if ((buf->data[0] & 0b11100000) == 0b11000000) {
-        utf8_len = 2;
-    } else if ((buf->data[0] & 0b11110000) == 0b11100000) {
-        utf8_len = 3;
-    } else if ((buf->data[0] & 0b11111000) == 0b11110000) {
-        utf8_len = 4;
-    } else {
-        return false;
+    GgBuffer rest = *buf;
+    while (true) {
+        rest = gg_buffer_substr(
+            rest, gg_json_str_find_special(rest), SIZE_MAX
+        );
+        if (rest.len < 1) {
+            return false;
+        }
+        if ((char) rest.data[0] == '"') {
+            break;
+        }
+        if ((char) rest.data[0] != '\\') {
+            // control character
+            return false;
+        }
+        if (!parser_call(&PARSER_JSON_STR_ESCAPE, &rest, NULL)) {
+            return false;
+        }
     }
 
-    if (buf->len < utf8_len) {
+    // Escapes are ASCII, so the raw body can be validated as a whole
+    GgBuffer body = { .data = buf->data,
+                      .len = (size_t) (rest.data - buf->data) };
+    if (!gg_utf8_validate(body)) {
         return false;
     }
 
-    for (size_t i = 1; i < utf8_len; i++) {
-        if ((buf->data[i] & 0b11000000) != 0b10000000) {
-            // Not a UTF-8 continuation byte
-            return false;
-        }
-    }
-
-    *buf = gg_buffer_substr(*buf, utf8_len, SIZE_MAX);
+    *buf = rest;
     return true;
 }
 
-static const Parser PARSER_JSON_STR_CODEPOINT = {
-    .fn = parser_json_str_codepoint_fn,
+static const Parser PARSER_JSON_STR_BODY = {
+    .fn = parser_json_str_body_fn,
 };
 
 static const Parser PARSER_JSON_WHITESPACE = COMB_ZERO_OR_MORE(&COMB_ONE_OF(
@@ -339,43 +327,31 @@ static const Parser PARSER_JSON_WHITESPACE = COMB_ZERO_OR_MORE(&COMB_ONE_OF(
 
 static const Parser PARSER_JSON_STR = COMB_SEQUENCE(
     &PARSER_CHAR('"'),
-    &COMB_RESULT_VAL(
-        JSON_TYPE_STR,
-        &COMB_ZERO_OR_MORE(
-            &COMB_ONE_OF(&PARSER_JSON_STR_CODEPOINT, &PARSER_JSON_STR_ESCAPE)
-        )
-    ),
+    &COMB_RESULT_VAL(JSON_TYPE_STR, &PARSER_JSON_STR_BODY),
     &PARSER_CHAR('"')
 );
 
-static const Parser PARSER_INT_PART = COMB_SEQUENCE(
-    &COMB_MAYBE(&PARSER_CHAR('-')),
-    &COMB_ONE_OF(
-        &PARSER_CHAR('0'),
-        &COMB_SEQUENCE(
-            &PARSER_CHAR_RANGE('1', '9'), &COMB_ZERO_OR_MORE(&PARSER_DIGIT)
-        )
-    )
-);
+static bool parser_json_number_fn(
+    const void *parser_ctx, GgBuffer *buf, ParseResult *output
+) {
+    (void) parser_ctx;
 
-static const Parser PARSER_FRAC_PART
-    = COMB_SEQUENCE(&PARSER_CHAR('.'), &COMB_ZERO_OR_MORE(&PARSER_DIGIT));
+    size_t len = gg_json_number_scan(*buf);
+    if (len == 0) {
+        return false;
+    }
 
-static const Parser PARSER_EXPONENT = COMB_SEQUENCE(
-    &COMB_ONE_OF(&PARSER_CHAR('e'), &PARSER_CHAR('E')),
-    &COMB_MAYBE(&COMB_ONE_OF(&PARSER_CHAR('+'), &PARSER_CHAR('-'))),
-    &PARSER_DIGIT,
-    &COMB_ZERO_OR_MORE(&PARSER_DIGIT)
-);
+    if (output != NULL) {
+        output->json_type = JSON_TYPE_NUMBER;
+        output->content = gg_buffer_substr(*buf, 0, len);
+    }
+    *buf = gg_buffer_substr(*buf, len, SIZE_MAX);
+    return true;
+}
 
-static const Parser PARSER_JSON_NUMBER = COMB_RESULT_VAL(
-    JSON_TYPE_NUMBER,
-    &COMB_SEQUENCE(
-        &PARSER_INT_PART,
-        &COMB_MAYBE(&PARSER_FRAC_PART),
-        &COMB_MAYBE(&PARSER_EXPONENT)
-    )
-);
+static const Parser PARSER_JSON_NUMBER = {
+    .fn = parser_json_number_fn,
+};
 
 static bool comb_increment_count_fn(
     const void *parser_ctx, GgBuffer *buf, ParseResult *output
@@ -409,13 +385,14 @@ static const Parser PARSER_JSON_OBJECT = COMB_SEQUENCE(
     &PARSER_JSON_WHITESPACE,
     &COMB_RESULT_VAL(
         JSON_TYPE_OBJECT,
+        // Each member is parsed once; nesting cost is linear in depth
         &COMB_MAYBE(&COMB_SEQUENCE(
+            &COMB_INCREMENT_COUNT(&PARSER_JSON_OBJECT_KV),
             &COMB_ZERO_OR_MORE(&COMB_INCREMENT_COUNT(&COMB_SEQUENCE(
-                &PARSER_JSON_OBJECT_KV,
                 &PARSER_CHAR(','),
-                &PARSER_JSON_WHITESPACE
-            ))),
-            &COMB_INCREMENT_COUNT(&PARSER_JSON_OBJECT_KV)
+                &PARSER_JSON_WHITESPACE,
+                &PARSER_JSON_OBJECT_KV
+            )))
         ))
     ),
     &PARSER_CHAR('}')
@@ -429,10 +406,10 @@ static const Parser PARSER_JSON_ARRAY = COMB_SEQUENCE(
     &COMB_RESULT_VAL(
         JSON_TYPE_ARRAY,
         &COMB_MAYBE(&COMB_SEQUENCE(
+            &COMB_INCREMENT_COUNT(&PARSER_JSON_ARRAY_ELEM),
             &COMB_ZERO_OR_MORE(&COMB_INCREMENT_COUNT(
-                &COMB_SEQUENCE(&PARSER_JSON_ARRAY_ELEM, &PARSER_CHAR(','))
-            )),
-            &COMB_INCREMENT_COUNT(&PARSER_JSON_ARRAY_ELEM)
+                &COMB_SEQUENCE(&PARSER_CHAR(','), &PARSER_JSON_ARRAY_ELEM)
+            ))
         ))
     ),
     &PARSER_CHAR(']')
@@ -613,15 +590,20 @@ static bool unescape_string(GgBuffer *str) {
     uint8_t *write_ptr = str->data;
     GgBuffer buf = *str;
     while (buf.len > 0) {
-        if (buf.data[0] == '\\') {
+        // Copy the run up to the next escape in bulk
+        const uint8_t *escape = memchr(buf.data, '\\', buf.len);
+        size_t run = (escape == NULL) ? buf.len : (size_t) (escape - buf.data);
+        if (write_ptr != buf.data) {
+            memmove(write_ptr, buf.data, run);
+        }
+        write_ptr = &write_ptr[run];
+        buf = gg_buffer_substr(buf, run, SIZE_MAX);
+
+        if (buf.len > 0) {
             bool ret = str_conv_handle_escape(&buf, &write_ptr);
             if (!ret) {
                 return false;
             }
-        } else {
-            *write_ptr = buf.data[0];
-            write_ptr = &write_ptr[1];
-            buf = gg_buffer_substr(buf, 1, SIZE_MAX);
         }
     }
     str->len = (size_t) (write_ptr - str->data);
@@ -642,53 +624,46 @@ static GgError decode_json_str(GgBuffer content, GgObject *obj) {
 }
 
 static GgError decode_json_number(GgBuffer content, GgObject *obj) {
-    GgBuffer buf = content;
-
-    bool result = parser_call(&PARSER_INT_PART, &buf, NULL);
-    if (!result) {
-        GG_LOGE("Failed to parse JSON number.");
-        return GG_ERR_PARSE;
-    }
-
-    bool has_frac_part = parser_call(&PARSER_FRAC_PART, &buf, NULL);
-    bool has_exp_part = parser_call(&PARSER_EXPONENT, &buf, NULL);
-
-    if (!has_frac_part && !has_exp_part) {
-        int64_t val;
-        GgError parse_ret = gg_str_to_int64(content, &val);
-        if (parse_ret != GG_ERR_OK) {
-            GG_LOGE("JSON integer out of range of int64_t.");
-            return parse_ret;
-        }
-        if (obj != NULL) {
-            *obj = gg_obj_i64(val);
-        }
-        return GG_ERR_OK;
-    }
-
-    errno = 0;
-    double val = strtod((char *) content.data, NULL);
-    if (errno == ERANGE) {
-        GG_LOGE("JSON float out of range of double.");
-        return GG_ERR_RANGE;
+    GgObject val;
+    GgError ret = gg_json_number_decode(content, &val);
+    if (ret != GG_ERR_OK) {
+        return ret;
     }
     if (obj != NULL) {
-        *obj = gg_obj_f64(val);
+        *obj = val;
     }
     return GG_ERR_OK;
 }
 
-static GgError take_json_val(GgBuffer *buf, GgArena *arena, GgObject *obj);
+typedef struct {
+    GgArena *arena;
+    GgObjectLimits limits;
+    size_t subobjects;
+} JsonDecoder;
+
+static GgError take_json_val(
+    GgBuffer *buf, JsonDecoder *dec, size_t depth, GgObject *obj
+);
 
 // NOLINTNEXTLINE(misc-no-recursion)
 static GgError decode_json_array(
-    GgBuffer content, size_t count, GgArena *arena, GgObject *obj
+    GgBuffer content,
+    size_t count,
+    JsonDecoder *dec,
+    size_t depth,
+    GgObject *obj
 ) {
-    assert(arena != NULL);
+    assert(dec->arena != NULL);
+
+    if (count > dec->limits.max_subobjects - dec->subobjects) {
+        GG_LOGE("JSON object's subobjects exceeds maximum.");
+        return GG_ERR_RANGE;
+    }
+    dec->subobjects += count;
 
     GgObject *items = NULL;
     if ((count > 0) && (obj != NULL)) {
-        items = GG_ARENA_ALLOCN(arena, GgObject, count);
+        items = GG_ARENA_ALLOCN(dec->arena, GgObject, count);
         if (items == NULL) {
             GG_LOGE("Insufficent memory to decode JSON.");
             return GG_ERR_NOMEM;
@@ -699,7 +674,7 @@ static GgError decode_json_array(
 
     for (size_t i = 0; i < count; i++) {
         GgError ret = take_json_val(
-            &buf_copy, arena, (items == NULL) ? NULL : &items[i]
+            &buf_copy, dec, depth + 1, (items == NULL) ? NULL : &items[i]
         );
         if (ret != GG_ERR_OK) {
             return ret;
@@ -721,11 +696,21 @@ static GgError decode_json_array(
 
 // NOLINTNEXTLINE(misc-no-recursion)
 static GgError decode_json_object(
-    GgBuffer content, size_t count, GgArena *arena, GgObject *obj
+    GgBuffer content,
+    size_t count,
+    JsonDecoder *dec,
+    size_t depth,
+    GgObject *obj
 ) {
+    if (count > (dec->limits.max_subobjects - dec->subobjects) / 2) {
+        GG_LOGE("JSON object's subobjects exceeds maximum.");
+        return GG_ERR_RANGE;
+    }
+    dec->subobjects += count * 2;
+
     GgKV *pairs = NULL;
     if ((count > 0) && (obj != NULL)) {
-        pairs = GG_ARENA_ALLOCN(arena, GgKV, count);
+        pairs = GG_ARENA_ALLOCN(dec->arena, GgKV, count);
         if (pairs == NULL) {
             GG_LOGE("Insufficent memory to decode JSON.");
             return GG_ERR_NOMEM;
@@ -736,7 +721,7 @@ static GgError decode_json_object(
 
     for (size_t i = 0; i < count; i++) {
         GgObject key_obj = { 0 };
-        GgError ret = take_json_val(&buf_copy, arena, &key_obj);
+        GgError ret = take_json_val(&buf_copy, dec, depth + 1, &key_obj);
         if (ret != GG_ERR_OK) {
             return ret;
         }
@@ -755,7 +740,10 @@ static GgError decode_json_object(
         }
 
         ret = take_json_val(
-            &buf_copy, arena, (pairs == NULL) ? NULL : gg_kv_val(&pairs[i])
+            &buf_copy,
+            dec,
+            depth + 1,
+            (pairs == NULL) ? NULL : gg_kv_val(&pairs[i])
         );
         if (ret != GG_ERR_OK) {
             return ret;
@@ -778,9 +766,16 @@ static GgError decode_json_object(
 }
 
 // NOLINTNEXTLINE(misc-no-recursion)
-static GgError take_json_val(GgBuffer *buf, GgArena *arena, GgObject *obj) {
+static GgError take_json_val(
+    GgBuffer *buf, JsonDecoder *dec, size_t depth, GgObject *obj
+) {
     assert(buf != NULL);
-    assert(arena != NULL);
+    assert(dec != NULL);
+
+    if (depth > dec->limits.max_depth) {
+        GG_LOGE("JSON object's depth exceeds maximum.");
+        return GG_ERR_RANGE;
+    }
 
     ParseResult output = PARSE_RESULT_INIT;
     bool matches = parser_call(&PARSER_JSON_VALUE, buf, &output);
@@ -810,17 +805,192 @@ static GgError take_json_val(GgBuffer *buf, GgArena *arena, GgObject *obj) {
         }
         return GG_ERR_OK;
     case JSON_TYPE_ARRAY:
-        return decode_json_array(output.content, output.count, arena, obj);
+        return decode_json_array(
+            output.content, output.count, dec, depth, obj
+        );
     case JSON_TYPE_OBJECT:
-        return decode_json_object(output.content, output.count, arena, obj);
+        return decode_json_object(
+            output.content, output.count, dec, depth, obj
+        );
     }
 
     assert(false);
     return GG_ERR_FAILURE;
 }
 
-GgError gg_json_decode_destructive(
-    GgBuffer buf, GgArena *arena, GgObject *obj
+// Objects on a base64 path are decoded member by member, so their pairs are
+// gathered on the stack before being copied to the arena.
+#define JSON_B64_PATH_MAX_MEMBERS 16
+
+// Decodes a JSON string of base64 into its raw bytes in place.
+// `buf` starts after the opening quote. The bulk of the string is decoded by
+// the same scan that finds its end; only a padded final group or escaped
+// characters are left for the string parser.
+static GgError take_json_b64_str(GgBuffer *buf, GgObject *obj) {
+    uint8_t *start = buf->data;
+    size_t done = gg_base64_decode_prefix(*buf, start);
+    size_t decoded_len = (done / 4) * 3;
+
+    GgBuffer rest = gg_buffer_substr(*buf, done, SIZE_MAX);
+    if (!parser_call(&PARSER_JSON_STR_BODY, &rest, NULL)) {
+        GG_LOGE("Failed to parse buffer.");
+        return GG_ERR_PARSE;
+    }
+
+    GgBuffer tail = { .data = &start[done],
+                      .len = (size_t) (rest.data - &start[done]) };
+    if (!unescape_string(&tail)) {
+        GG_LOGE("Error decoding JSON string.");
+        return GG_ERR_PARSE;
+    }
+    GgBuffer tail_decoded = { .data = &start[decoded_len], .len = tail.len };
+    if (!gg_base64_decode(tail, &tail_decoded)) {
+        GG_LOGE("JSON string is not valid base64.");
+        return GG_ERR_PARSE;
+    }
+
+    // Skip closing quote
+    *buf = gg_buffer_substr(rest, 1, SIZE_MAX);
+    *obj = gg_obj_buf((GgBuffer) { .data = start,
+                                   .len = decoded_len + tail_decoded.len });
+    return GG_ERR_OK;
+}
+
+static GgError take_json_b64_path(
+    GgBuffer *buf,
+    JsonDecoder *dec,
+    GgBufList path,
+    size_t depth,
+    GgObject *obj
+);
+
+// NOLINTNEXTLINE(misc-no-recursion)
+static GgError take_json_b64_path_object(
+    GgBuffer *buf,
+    JsonDecoder *dec,
+    GgBufList path,
+    size_t depth,
+    GgObject *obj
+) {
+    GgKV pairs[JSON_B64_PATH_MAX_MEMBERS];
+    size_t count = 0;
+    bool found = false;
+
+    (void) parser_call(&PARSER_CHAR('{'), buf, NULL);
+    (void) parser_call(&PARSER_JSON_WHITESPACE, buf, NULL);
+    bool more = !parser_call(&PARSER_CHAR('}'), buf, NULL);
+
+    while (more) {
+        if (count == JSON_B64_PATH_MAX_MEMBERS) {
+            GG_LOGE("JSON object on base64 path has too many members.");
+            return GG_ERR_RANGE;
+        }
+        if (dec->limits.max_subobjects - dec->subobjects < 2) {
+            GG_LOGE("JSON object's subobjects exceeds maximum.");
+            return GG_ERR_RANGE;
+        }
+        dec->subobjects += 2;
+
+        GgObject key_obj = { 0 };
+        GgError ret = take_json_val(buf, dec, depth + 1, &key_obj);
+        if (ret != GG_ERR_OK) {
+            return ret;
+        }
+        if (gg_obj_type(key_obj) != GG_TYPE_BUF) {
+            GG_LOGE("Non-string key type when decoding object.");
+            return GG_ERR_PARSE;
+        }
+        GgBuffer key = gg_obj_into_buf(key_obj);
+
+        if (!parser_call(&PARSER_CHAR(':'), buf, NULL)) {
+            GG_LOGE("Failed to match colon while decoding object.");
+            return GG_ERR_PARSE;
+        }
+
+        GgObject val = GG_OBJ_NULL;
+        if (!found && gg_buffer_eq(key, path.bufs[0])) {
+            found = true;
+            ret = take_json_b64_path(
+                buf,
+                dec,
+                (GgBufList) { .bufs = &path.bufs[1], .len = path.len - 1 },
+                depth + 1,
+                &val
+            );
+        } else {
+            ret = take_json_val(buf, dec, depth + 1, &val);
+        }
+        if (ret != GG_ERR_OK) {
+            return ret;
+        }
+        pairs[count] = gg_kv(key, val);
+        count += 1;
+
+        more = parser_call(&PARSER_CHAR(','), buf, NULL);
+        if (!more && !parser_call(&PARSER_CHAR('}'), buf, NULL)) {
+            GG_LOGE("Failed to match comma while decoding object.");
+            return GG_ERR_PARSE;
+        }
+    }
+
+    GgMap map = { .pairs = NULL, .len = count };
+    if (count > 0) {
+        map.pairs = GG_ARENA_ALLOCN(dec->arena, GgKV, count);
+        if (map.pairs == NULL) {
+            GG_LOGE("Insufficent memory to decode JSON.");
+            return GG_ERR_NOMEM;
+        }
+        memcpy(map.pairs, pairs, count * sizeof(GgKV));
+    }
+    gg_map_canonicalize_shallow(&map);
+    *obj = gg_obj_map(map);
+    return GG_ERR_OK;
+}
+
+// Decodes a JSON value, base64 decoding the string at key path `path`.
+// Objects along the path are decoded as they are scanned, so the base64
+// string is read once rather than once per enclosing object. Values that do
+// not have the shape of the path are decoded as usual.
+// NOLINTNEXTLINE(misc-no-recursion)
+static GgError take_json_b64_path(
+    GgBuffer *buf,
+    JsonDecoder *dec,
+    GgBufList path,
+    size_t depth,
+    GgObject *obj
+) {
+    if (depth > dec->limits.max_depth) {
+        GG_LOGE("JSON object's depth exceeds maximum.");
+        return GG_ERR_RANGE;
+    }
+
+    (void) parser_call(&PARSER_JSON_WHITESPACE, buf, NULL);
+    char expected = (path.len == 0) ? '"' : '{';
+    if ((buf->len == 0) || ((char) buf->data[0] != expected)) {
+        return take_json_val(buf, dec, depth, obj);
+    }
+
+    GgError ret;
+    if (path.len == 0) {
+        *buf = gg_buffer_substr(*buf, 1, SIZE_MAX);
+        ret = take_json_b64_str(buf, obj);
+    } else {
+        ret = take_json_b64_path_object(buf, dec, path, depth, obj);
+    }
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+
+    (void) parser_call(&PARSER_JSON_WHITESPACE, buf, NULL);
+    return GG_ERR_OK;
+}
+
+static GgError json_decode_destructive(
+    GgBuffer buf,
+    const GgBufList *b64_path,
+    GgArena *arena,
+    GgObject *obj,
+    GgObjectLimits limits
 ) {
     // Handle NULL arena arg
     GgArena empty_arena = { 0 };
@@ -832,7 +1002,12 @@ GgError gg_json_decode_destructive(
     // Copy since we treat arguments as read-only
     GgBuffer buf_copy = buf;
 
-    GgError ret = take_json_val(&buf_copy, &arena_copy, obj);
+    JsonDecoder dec
+        = { .arena = &arena_copy, .limits = limits, .subobjects = 0 };
+
+    GgError ret = (b64_path == NULL)
+        ? take_json_val(&buf_copy, &dec, 1, obj)
+        : take_json_b64_path(&buf_copy, &dec, *b64_path, 1, obj);
     if (ret != GG_ERR_OK) {
         return ret;
     }
@@ -850,10 +1025,36 @@ GgError gg_json_decode_destructive(
     return GG_ERR_OK;
 }
 
+GgError gg_json_decode_destructive(
+    GgBuffer buf, GgArena *arena, GgObject *obj
+) {
+    return json_decode_destructive(
+        buf, NULL, arena, obj, GG_OBJECT_LIMITS_DEFAULT
+    );
+}
+
+GgError gg_json_decode_destructive_with_limits(
+    GgBuffer buf, GgArena *arena, GgObject *obj, GgObjectLimits limits
+) {
+    return json_decode_destructive(buf, NULL, arena, obj, limits);
+}
+
+GgError gg_json_decode_destructive_b64(
+    GgBuffer buf, GgBufList b64_path, GgArena *arena, GgObject *obj
+) {
+    return json_decode_destructive(
+        buf, &b64_path, arena, obj, GG_OBJECT_LIMITS_DEFAULT
+    );
+}
+
 #ifdef GG_SDK_TESTING
+#include <gg/base64_vec.h>
+#include <gg/json_encode.h>
 #include <gg/object_compare.h>
 #include <gg/test.h>
+#include <gg/vector.h>
 #include <unity_internals.h>
+#include <stdalign.h>
 
 GG_TEST_DEFINE(json_decode_unescape_string_identity) {
     uint8_t escaped[] = "\"string\"";
@@ -931,6 +1132,79 @@ GG_TEST_DEFINE(json_decode_scalar_types) {
     GG_TEST_JSON_DECODE_STR(gg_obj_buf(GG_STR("string")), "\"string\"");
 }
 
+GG_TEST_DEFINE(json_decode_numbers) {
+    GG_TEST_JSON_DECODE_STR(
+        gg_obj_list(GG_LIST(
+            gg_obj_i64(0),
+            gg_obj_i64(-17),
+            gg_obj_f64(1.5e3),
+            gg_obj_f64(-0.25),
+            gg_obj_f64(1013.25)
+        )),
+        "[0, -17,1.5e3 ,-0.25,\n1013.25]"
+    );
+
+    uint8_t bytes[1024];
+    GgArena arena = gg_arena_init(GG_BUF(bytes));
+    GgObject actual = GG_OBJ_NULL;
+    GG_TEST_ASSERT_BAD(
+        gg_json_decode_destructive(GG_STR("[1e]"), &arena, &actual)
+    );
+    GG_TEST_ASSERT_BAD(
+        gg_json_decode_destructive(GG_STR("[01]"), &arena, &actual)
+    );
+}
+
+GG_TEST_DEFINE(json_decode_strings) {
+    GG_TEST_JSON_DECODE_STR(
+        gg_obj_buf(GG_STR("tab\there \"quoted\" back\\slash/\xE2\x82\xAC")),
+        "\"tab\\there \\\"quoted\\\" back\\\\slash\\/\\u20ac\""
+    );
+    GG_TEST_JSON_DECODE_STR(
+        gg_obj_buf(GG_STR("caf\xC3\xA9 \xF0\x9F\x98\x80 escapes at end\n")),
+        "\"caf\xC3\xA9 \xF0\x9F\x98\x80 escapes at end\\n\""
+    );
+
+    // Long value spanning many vector blocks
+    uint8_t expected[300];
+    memset(expected, 'A', sizeof(expected));
+    uint8_t json[sizeof(expected) + 2];
+    json[0] = '"';
+    memcpy(&json[1], expected, sizeof(expected));
+    json[sizeof(json) - 1] = '"';
+    gg_test_json_decode(
+        gg_obj_buf(GG_BUF(expected)), GG_BUF(json), __LINE__
+    );
+}
+
+GG_TEST_DEFINE(json_decode_strings_invalid) {
+    const char *invalid[] = {
+        "\"unterminated",
+        "\"control \n char\"",
+        "\"bad escape \\x\"",
+        "\"short escape \\u12\"",
+        "\"overlong \xC0\xAF\"",
+        "\"surrogate \xED\xA0\x80\"",
+        "\"truncated \xE2\x82\"",
+    };
+    uint8_t bytes[64];
+    uint8_t mem[256];
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        size_t len = strlen(invalid[i]);
+        TEST_ASSERT(len <= sizeof(bytes));
+        memcpy(bytes, invalid[i], len);
+        GgArena arena = gg_arena_init(GG_BUF(mem));
+        GgObject actual = GG_OBJ_NULL;
+        TEST_ASSERT_EQUAL_MESSAGE(
+            GG_ERR_PARSE,
+            gg_json_decode_destructive(
+                (GgBuffer) { .data = bytes, .len = len }, &arena, &actual
+            ),
+            invalid[i]
+        );
+    }
+}
+
 GG_TEST_DEFINE(json_decode_canon) {
     GG_TEST_JSON_DECODE_STR(
         gg_obj_map(GG_MAP(
@@ -942,4 +1216,222 @@ GG_TEST_DEFINE(json_decode_canon) {
     );
 }
 
+GG_TEST_DEFINE(json_decode_limits) {
+    // [[[...[]...]]] nested past the default depth
+    enum { DEPTH = GG_MAX_OBJECT_DEPTH * 3 };
+    uint8_t json[DEPTH * 2];
+    memset(json, '[', DEPTH);
+    memset(&json[DEPTH], ']', DEPTH);
+    uint8_t mem[DEPTH * sizeof(GgObject)];
+    GgArena arena = gg_arena_init(GG_BUF(mem));
+    GgObject obj = GG_OBJ_NULL;
+
+    TEST_ASSERT_EQUAL(
+        GG_ERR_RANGE, gg_json_decode_destructive(GG_BUF(json), &arena, &obj)
+    );
+    TEST_ASSERT_EQUAL(0, arena.index);
+
+    GgObjectLimits limits = { .max_depth = DEPTH - 1, .max_subobjects = 300 };
+    TEST_ASSERT_EQUAL(
+        GG_ERR_RANGE,
+        gg_json_decode_destructive_with_limits(
+            GG_BUF(json), &arena, &obj, limits
+        )
+    );
+    limits.max_depth = DEPTH;
+    GG_TEST_ASSERT_OK(gg_json_decode_destructive_with_limits(
+        GG_BUF(json), &arena, &obj, limits
+    ));
+
+    // Encoding needs the same limits
+    uint8_t out[sizeof(json)];
+    GgByteVec vec = gg_byte_vec_init(GG_BUF(out));
+    TEST_ASSERT_EQUAL(
+        GG_ERR_RANGE, gg_json_encode(obj, gg_byte_vec_writer(&vec))
+    );
+    vec = gg_byte_vec_init(GG_BUF(out));
+    GG_TEST_ASSERT_OK(
+        gg_json_encode_with_limits(obj, gg_byte_vec_writer(&vec), limits)
+    );
+    GG_TEST_ASSERT_BUF_EQUAL(GG_BUF(json), vec.buf);
+}
+
+GG_TEST_DEFINE(json_decode_limits_subobjects) {
+    // [null,null,...] with more items than the default subobject limit
+    enum { COUNT = GG_MAX_OBJECT_SUBOBJECTS + 45 };
+    uint8_t json[(COUNT * 5) + 1];
+    json[0] = '[';
+    for (size_t i = 0; i < COUNT; i++) {
+        memcpy(&json[1 + (i * 5)], "null,", 5);
+    }
+    json[sizeof(json) - 1] = ']';
+    alignas(GgObject) static uint8_t mem[COUNT * sizeof(GgObject)];
+    GgArena arena = gg_arena_init(GG_BUF(mem));
+    GgObject obj = GG_OBJ_NULL;
+
+    TEST_ASSERT_EQUAL(
+        GG_ERR_RANGE, gg_json_decode_destructive(GG_BUF(json), &arena, &obj)
+    );
+
+    GgObjectLimits limits = { .max_depth = 2, .max_subobjects = COUNT };
+    GG_TEST_ASSERT_OK(gg_json_decode_destructive_with_limits(
+        GG_BUF(json), &arena, &obj, limits
+    ));
+    TEST_ASSERT_EQUAL(COUNT, gg_obj_into_list(obj).len);
+
+    size_t usage = 0;
+    GG_TEST_ASSERT_BAD(gg_obj_mem_usage(obj, &usage));
+    GG_TEST_ASSERT_OK(gg_obj_mem_usage_with_limits(obj, &usage, limits));
+    // Usage includes worst-case padding for the list allocation
+    TEST_ASSERT_EQUAL(sizeof(mem) + alignof(GgObject) - 1, usage);
+
+    alignas(GgObject) static uint8_t claim_mem[COUNT * sizeof(GgObject)];
+    GgArena claim_arena = gg_arena_init(GG_BUF(claim_mem));
+    GG_TEST_ASSERT_BAD(gg_arena_claim_obj(&obj, &claim_arena));
+    GG_TEST_ASSERT_OK(
+        gg_arena_claim_obj_with_limits(&obj, &claim_arena, limits)
+    );
+    TEST_ASSERT(gg_arena_owns(&claim_arena, gg_obj_into_list(obj).items));
+}
+
+
+static void gg_test_json_decode_b64(
+    GgObject expected, GgBuffer json, UNITY_UINT line_no
+) {
+    uint8_t arena_bytes[2048];
+    GgArena arena = gg_arena_init(GG_BUF(arena_bytes));
+    GgObject actual = GG_OBJ_NULL;
+
+    gg_test_assert_ok(
+        gg_json_decode_destructive_b64(
+            json,
+            GG_BUF_LIST(GG_STR("binaryMessage"), GG_STR("message")),
+            &arena,
+            &actual
+        ),
+        "Could not decode json",
+        line_no
+    );
+    gg_test_assert_obj_equal(expected, actual, NULL, line_no);
+}
+
+#define GG_TEST_JSON_DECODE_B64_STR(expected, json_strlit) \
+    do { \
+        uint8_t json_bytes[] = "" json_strlit ""; \
+        GgBuffer json_buf = (GgBuffer) { .data = json_bytes, \
+                                         .len = sizeof(json_bytes) - 1 }; \
+        gg_test_json_decode_b64((expected), json_buf, __LINE__); \
+    } while (0)
+
+GG_TEST_DEFINE(json_decode_b64_path) {
+    GG_TEST_JSON_DECODE_B64_STR(
+        gg_obj_map(GG_MAP(gg_kv(
+            GG_STR("binaryMessage"),
+            gg_obj_map(GG_MAP(
+                gg_kv(
+                    GG_STR("context"),
+                    gg_obj_map(GG_MAP(
+                        gg_kv(GG_STR("topic"), gg_obj_buf(GG_STR("t")))
+                    ))
+                ),
+                gg_kv(GG_STR("message"), gg_obj_buf(GG_STR("foobar")))
+            ))
+        ))),
+        "{ \"binaryMessage\" : { \"message\" : \"Zm9vYmFy\" , "
+        "\"context\":{\"topic\":\"t\"}} }"
+    );
+
+    // Padding and escaped characters
+    GG_TEST_JSON_DECODE_B64_STR(
+        gg_obj_map(GG_MAP(gg_kv(
+            GG_STR("binaryMessage"),
+            gg_obj_map(GG_MAP(
+                gg_kv(GG_STR("message"), gg_obj_buf(GG_STR("foo\xFE" "a")))
+            ))
+        ))),
+        "{\"binaryMessage\":{\"message\":\"Zm9v\\/mE=\"}}"
+    );
+    GG_TEST_JSON_DECODE_B64_STR(
+        gg_obj_map(GG_MAP(gg_kv(
+            GG_STR("binaryMessage"),
+            gg_obj_map(
+                GG_MAP(gg_kv(GG_STR("message"), gg_obj_buf(GG_STR(""))))
+            )
+        ))),
+        "{\"binaryMessage\":{\"message\":\"\"}}"
+    );
+
+    // Values elsewhere, or not of the path's shape, are decoded as usual
+    GG_TEST_JSON_DECODE_B64_STR(
+        gg_obj_map(GG_MAP(
+            gg_kv(
+                GG_STR("jsonMessage"),
+                gg_obj_map(GG_MAP(
+                    gg_kv(GG_STR("message"), gg_obj_buf(GG_STR("Zm9v")))
+                ))
+            ),
+            gg_kv(GG_STR("message"), gg_obj_buf(GG_STR("Zm9v")))
+        )),
+        "{\"message\":\"Zm9v\",\"jsonMessage\":{\"message\":\"Zm9v\"}}"
+    );
+    GG_TEST_JSON_DECODE_B64_STR(
+        gg_obj_map(GG_MAP(gg_kv(
+            GG_STR("binaryMessage"),
+            gg_obj_map(GG_MAP(gg_kv(GG_STR("message"), GG_OBJ_NULL)))
+        ))),
+        "{\"binaryMessage\":{\"message\":null}}"
+    );
+    GG_TEST_JSON_DECODE_B64_STR(gg_obj_i64(5), "5");
+
+    static const char *const INVALID[] = {
+        "{\"binaryMessage\":{\"message\":\"Zm9\"}}",
+        "{\"binaryMessage\":{\"message\":\"Zg==Zg==\"}}",
+        "{\"binaryMessage\":{\"message\":\"Zm9v\"}",
+        "{\"binaryMessage\":{\"message\":\"Zm9v\"}} x",
+        "{\"binaryMessage\":{\"message\":\"Zm9v}}",
+        "{\"binaryMessage\":{\"message\":\"Zm9v\" \"a\":1}}",
+    };
+    for (size_t i = 0; i < sizeof(INVALID) / sizeof(*INVALID); i++) {
+        uint8_t json[64];
+        size_t len = strlen(INVALID[i]);
+        memcpy(json, INVALID[i], len);
+        uint8_t mem[256];
+        GgArena arena = gg_arena_init(GG_BUF(mem));
+        GgObject obj = GG_OBJ_NULL;
+        GG_TEST_ASSERT_BAD(gg_json_decode_destructive_b64(
+            (GgBuffer) { .data = json, .len = len },
+            GG_BUF_LIST(GG_STR("binaryMessage"), GG_STR("message")),
+            &arena,
+            &obj
+        ));
+    }
+}
+
+GG_TEST_DEFINE(json_decode_b64_path_long) {
+    static uint8_t raw[1000];
+    static uint8_t json[1500];
+    for (size_t i = 0; i < sizeof(raw); i++) {
+        raw[i] = (uint8_t) ((i * 7U) + 3U);
+    }
+
+    GgByteVec vec = GG_BYTE_VEC(json);
+    GgError ret = GG_ERR_OK;
+    gg_byte_vec_chain_append(&ret, &vec, GG_STR("{\"message\":\""));
+    gg_byte_vec_chain_append_base64(&ret, &vec, GG_BUF(raw));
+    gg_byte_vec_chain_append(&ret, &vec, GG_STR("\"}"));
+    GG_TEST_ASSERT_OK(ret);
+
+    uint8_t mem[64];
+    GgArena arena = gg_arena_init(GG_BUF(mem));
+    GgObject obj = GG_OBJ_NULL;
+    GG_TEST_ASSERT_OK(gg_json_decode_destructive_b64(
+        vec.buf, GG_BUF_LIST(GG_STR("message")), &arena, &obj
+    ));
+    GgObject *message = NULL;
+    TEST_ASSERT_TRUE(
+        gg_map_get(gg_obj_into_map(obj), GG_STR("message"), &message)
+    );
+    GG_TEST_ASSERT_BUF_EQUAL(GG_BUF(raw), gg_obj_into_buf(*message));
+}
+
 #endif
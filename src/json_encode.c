@@ -172,6 +172,12 @@ static GgError json_encode_end_map(void *ctx) {
 }
 
 GgError gg_json_encode(GgObject obj, GgWriter writer) {
+    return gg_json_encode_with_limits(obj, writer, GG_OBJECT_LIMITS_DEFAULT);
+}
+
+GgError gg_json_encode_with_limits(
+    GgObject obj, GgWriter writer, GgObjectLimits limits
+) {
     const GgObjectVisitHandlers VISIT_HANDLERS = {
         .on_null = json_encode_on_null,
         .on_bool = json_encode_on_bool,
@@ -186,7 +192,7 @@ GgError gg_json_encode(GgObject obj, GgWriter writer) {
         .cont_map = json_encode_cont_map,
         .end_map = json_encode_end_map,
     };
-    return gg_obj_visit(&VISIT_HANDLERS, &writer, &obj);
+    return gg_obj_visit_with_limits(&VISIT_HANDLERS, &writer, &obj, limits);
 }
 
 static GgError obj_read(void *ctx, GgBuffer *buf) {
@@ -0,0 +1,769 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "pow10_table.h"
+#include <float.h>
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/json_number.h>
+#include <gg/log.h>
+#include <gg/object.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Number parsing works directly on the buffer slice in a single pass. Floats
+// first try the exact double fast path (Clinger), then the Eisel-Lemire
+// algorithm using 128-bit powers of ten. If Eisel-Lemire cannot determine the
+// rounding, falls back to exact decimal arithmetic.
+
+/// Decimal digits that always fit in a uint64_t.
+#define MAX_MANTISSA_DIGITS 19U
+
+/// Exponent magnitudes are saturated at this value; any input with a larger
+/// exponent is already out of range of double.
+#define EXP10_SATURATE INT64_C(1000000000000000)
+
+#define F64_MANT_BITS 52
+#define F64_EXP_BITS 11
+#define F64_BIAS (-1023)
+#define F64_SIGN_BIT (UINT64_C(1) << 63)
+#define F64_INF_BITS UINT64_C(0x7FF0000000000000)
+
+typedef struct {
+    /// First MAX_MANTISSA_DIGITS significant digits.
+    uint64_t mantissa;
+    /// Value is mantissa * 10^exp10 if not truncated.
+    int64_t exp10;
+    /// Digits in integer part, excluding a lone zero.
+    size_t int_digits;
+    bool negative;
+    /// Nonzero digits were dropped from mantissa.
+    bool truncated;
+    /// No fraction or exponent part.
+    bool is_int;
+} ParsedNumber;
+
+static bool is_digit(uint8_t c) {
+    return (c >= '0') && (c <= '9');
+}
+
+static void push_digit(
+    ParsedNumber num[static 1],
+    size_t sig_digits[static 1],
+    uint8_t digit,
+    bool frac
+) {
+    if ((*sig_digits == 0) && (digit == 0)) {
+        // Leading zero in fraction
+        num->exp10 -= 1;
+        return;
+    }
+    if (*sig_digits < MAX_MANTISSA_DIGITS) {
+        num->mantissa = (num->mantissa * 10U) + digit;
+        if (frac) {
+            num->exp10 -= 1;
+        }
+    } else {
+        if (!frac) {
+            num->exp10 += 1;
+        }
+        if (digit != 0) {
+            num->truncated = true;
+        }
+    }
+    *sig_digits += 1;
+}
+
+static size_t scan_exponent(
+    GgBuffer str, size_t start, int64_t exp[static 1]
+) {
+    size_t i = start;
+    bool negative = false;
+    if ((i < str.len) && ((str.data[i] == '+') || (str.data[i] == '-'))) {
+        negative = str.data[i] == '-';
+        i += 1;
+    }
+    if ((i >= str.len) || !is_digit(str.data[i])) {
+        return 0;
+    }
+    int64_t val = 0;
+    for (; (i < str.len) && is_digit(str.data[i]); i++) {
+        if (val < EXP10_SATURATE) {
+            val = (val * 10) + (str.data[i] - '0');
+        }
+    }
+    *exp = negative ? -val : val;
+    return i;
+}
+
+/// Scans the longest prefix of str matching the JSON number grammar.
+/// Returns the prefix length, or 0 if there is no match.
+static size_t scan_number(GgBuffer str, ParsedNumber num[static 1]) {
+    *num = (ParsedNumber) { .is_int = true };
+    size_t sig_digits = 0;
+    size_t i = 0;
+
+    if ((i < str.len) && (str.data[i] == '-')) {
+        num->negative = true;
+        i += 1;
+    }
+
+    if (i >= str.len) {
+        return 0;
+    }
+    if (str.data[i] == '0') {
+        i += 1;
+    } else if (is_digit(str.data[i])) {
+        for (; (i < str.len) && is_digit(str.data[i]); i++) {
+            push_digit(
+                num, &sig_digits, (uint8_t) (str.data[i] - '0'), false
+            );
+            num->int_digits += 1;
+        }
+    } else {
+        return 0;
+    }
+
+    if ((i < str.len) && (str.data[i] == '.')) {
+        num->is_int = false;
+        for (i += 1; (i < str.len) && is_digit(str.data[i]); i++) {
+            push_digit(
+                num, &sig_digits, (uint8_t) (str.data[i] - '0'), true
+            );
+        }
+    }
+
+    if ((i < str.len) && ((str.data[i] == 'e') || (str.data[i] == 'E'))) {
+        int64_t exp = 0;
+        size_t end = scan_exponent(str, i + 1, &exp);
+        if (end != 0) {
+            num->is_int = false;
+            num->exp10 += exp;
+            i = end;
+        }
+    }
+
+    return i;
+}
+
+size_t gg_json_number_scan(GgBuffer buf) {
+    ParsedNumber num;
+    return scan_number(buf, &num);
+}
+
+static GgError int_from_parsed(
+    const ParsedNumber num[static 1], GgObject obj[static 1]
+) {
+    uint64_t limit = (uint64_t) INT64_MAX + (num->negative ? 1U : 0U);
+    if ((num->int_digits > MAX_MANTISSA_DIGITS) || (num->mantissa > limit)) {
+        GG_LOGE("JSON integer out of range of int64_t.");
+        return GG_ERR_RANGE;
+    }
+
+    int64_t val;
+    if (!num->negative) {
+        val = (int64_t) num->mantissa;
+    } else if (num->mantissa > (uint64_t) INT64_MAX) {
+        val = INT64_MIN;
+    } else {
+        val = -(int64_t) num->mantissa;
+    }
+    *obj = gg_obj_i64(val);
+    return GG_ERR_OK;
+}
+
+static void mul_u64(
+    uint64_t a, uint64_t b, uint64_t hi[static 1], uint64_t lo[static 1]
+) {
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 product = (unsigned __int128) a * b;
+    *hi = (uint64_t) (product >> 64);
+    *lo = (uint64_t) product;
+#else
+    uint64_t a_lo = a & UINT32_MAX;
+    uint64_t a_hi = a >> 32;
+    uint64_t b_lo = b & UINT32_MAX;
+    uint64_t b_hi = b >> 32;
+    uint64_t p0 = a_lo * b_lo;
+    uint64_t p1 = a_lo * b_hi;
+    uint64_t p2 = a_hi * b_lo;
+    uint64_t p3 = a_hi * b_hi;
+    uint64_t mid = (p0 >> 32) + (p1 & UINT32_MAX) + (p2 & UINT32_MAX);
+    *lo = (mid << 32) | (p0 & UINT32_MAX);
+    *hi = p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+#endif
+}
+
+/// floor(log2(10^exp10)) for the range of the power table.
+static int64_t floor_log2_pow10(int64_t exp10) {
+    int64_t scaled = exp10 * 217706;
+    if (scaled < 0) {
+        scaled -= 65535;
+    }
+    return scaled / 65536;
+}
+
+/// Eisel-Lemire conversion of mantissa * 10^exp10 to double bits.
+/// Returns false if the result is ambiguous, subnormal, or infinite.
+/// mantissa must be non-zero and exp10 within the power table range.
+static bool eisel_lemire(
+    uint64_t mantissa, int64_t exp10, uint64_t bits[static 1]
+) {
+    const uint64_t *pow10 = POW10_TABLE[exp10 - POW10_TABLE_MIN_EXP10];
+
+    uint32_t clz = (uint32_t) __builtin_clzll(mantissa);
+    uint64_t man = mantissa << clz;
+    // Wraps for subnormal results; caught by the range check below
+    uint64_t ret_exp2
+        = (uint64_t) (floor_log2_pow10(exp10) + 64 - F64_BIAS) - clz;
+
+    uint64_t x_hi;
+    uint64_t x_lo;
+    mul_u64(man, pow10[0], &x_hi, &x_lo);
+
+    // Truncated table entry may have lost a carry into the upper bits
+    if (((x_hi & 0x1FF) == 0x1FF) && ((x_lo + man) < man)) {
+        uint64_t y_hi;
+        uint64_t y_lo;
+        mul_u64(man, pow10[1], &y_hi, &y_lo);
+        uint64_t merged_hi = x_hi;
+        uint64_t merged_lo = x_lo + y_hi;
+        if (merged_lo < x_lo) {
+            merged_hi += 1;
+        }
+        if (((merged_hi & 0x1FF) == 0x1FF) && (merged_lo == UINT64_MAX)
+            && ((y_lo + man) < man)) {
+            return false;
+        }
+        x_hi = merged_hi;
+        x_lo = merged_lo;
+    }
+
+    uint64_t msb = x_hi >> 63;
+    uint64_t ret_mantissa = x_hi >> (msb + 9);
+    ret_exp2 -= 1 ^ msb;
+
+    // Possibly exactly halfway between two doubles
+    if ((x_lo == 0) && ((x_hi & 0x1FF) == 0) && ((ret_mantissa & 3) == 1)) {
+        return false;
+    }
+
+    ret_mantissa += ret_mantissa & 1;
+    ret_mantissa >>= 1;
+    if ((ret_mantissa >> (F64_MANT_BITS + 1)) > 0) {
+        ret_mantissa >>= 1;
+        ret_exp2 += 1;
+    }
+
+    if ((ret_exp2 - 1) >= (0x7FF - 1)) {
+        return false;
+    }
+
+    *bits = (ret_exp2 << F64_MANT_BITS)
+        | (ret_mantissa & ((UINT64_C(1) << F64_MANT_BITS) - 1));
+    return true;
+}
+
+/// Tries the fast conversions. Returns false if the slow path is needed.
+static bool f64_bits_fast(
+    const ParsedNumber num[static 1], uint64_t bits[static 1]
+) {
+    if (num->mantissa == 0) {
+        *bits = 0;
+        return true;
+    }
+
+#if FLT_EVAL_METHOD == 0
+    // Both operands and the single rounding are exact.
+    static const double POW10_EXACT[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+    if (!num->truncated && (num->mantissa <= (UINT64_C(1) << 53))
+        && (num->exp10 >= -22) && (num->exp10 <= 22)) {
+        double val = (double) num->mantissa;
+        if (num->exp10 < 0) {
+            val /= POW10_EXACT[-num->exp10];
+        } else {
+            val *= POW10_EXACT[num->exp10];
+        }
+        memcpy(bits, &val, sizeof(*bits));
+        return true;
+    }
+#endif
+
+    if ((num->exp10 < POW10_TABLE_MIN_EXP10)
+        || (num->exp10 > POW10_TABLE_MAX_EXP10)) {
+        return false;
+    }
+    if (!eisel_lemire(num->mantissa, num->exp10, bits)) {
+        return false;
+    }
+    if (num->truncated) {
+        // True value is between mantissa and mantissa + 1
+        uint64_t upper_bits;
+        if (!eisel_lemire(num->mantissa + 1, num->exp10, &upper_bits)) {
+            return false;
+        }
+        if (upper_bits != *bits) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Slow path: arbitrary precision decimal, enough digits to round correctly.
+
+#define DECIMAL_MAX_DIGITS 800
+/// Room for the digits a single left shift can add before truncation.
+#define DECIMAL_SHIFT_SLACK 20
+#define DECIMAL_MAX_SHIFT 60
+#define DECIMAL_DP_LIMIT 100000
+
+typedef struct {
+    /// Digit values (not ASCII), most significant first, no leading zeros.
+    uint8_t digits[DECIMAL_MAX_DIGITS + DECIMAL_SHIFT_SLACK];
+    int32_t nd;
+    /// Value is 0.digits * 10^dp.
+    int32_t dp;
+    /// Nonzero digits were dropped past DECIMAL_MAX_DIGITS.
+    bool trunc;
+} Decimal;
+
+static void decimal_trim(Decimal dec[static 1]) {
+    while ((dec->nd > 0) && (dec->digits[dec->nd - 1] == 0)) {
+        dec->nd -= 1;
+    }
+    if (dec->nd == 0) {
+        dec->dp = 0;
+    }
+}
+
+/// Initializes from a string already validated by scan_number.
+static void decimal_init(Decimal dec[static 1], GgBuffer str) {
+    dec->nd = 0;
+    dec->trunc = false;
+
+    int64_t dp = 0;
+    int64_t total_digits = 0;
+    bool saw_dot = false;
+    size_t i = (str.data[0] == '-') ? 1 : 0;
+
+    for (; i < str.len; i++) {
+        uint8_t c = str.data[i];
+        if (c == '.') {
+            saw_dot = true;
+            dp = total_digits;
+            continue;
+        }
+        if (!is_digit(c)) {
+            break;
+        }
+        uint8_t digit = (uint8_t) (c - '0');
+        if ((digit == 0) && (total_digits == 0)) {
+            dp -= 1;
+            continue;
+        }
+        if (dec->nd < DECIMAL_MAX_DIGITS) {
+            dec->digits[dec->nd] = digit;
+            dec->nd += 1;
+        } else if (digit != 0) {
+            dec->trunc = true;
+        }
+        total_digits += 1;
+    }
+    if (!saw_dot) {
+        dp = total_digits;
+    }
+
+    if (i < str.len) {
+        int64_t exp = 0;
+        (void) scan_exponent(str, i + 1, &exp);
+        dp += exp;
+    }
+
+    if (dp > DECIMAL_DP_LIMIT) {
+        dp = DECIMAL_DP_LIMIT;
+    } else if (dp < -DECIMAL_DP_LIMIT) {
+        dp = -DECIMAL_DP_LIMIT;
+    }
+    dec->dp = (int32_t) dp;
+    decimal_trim(dec);
+}
+
+static void decimal_right_shift(Decimal dec[static 1], uint32_t k) {
+    int32_t r = 0;
+    int32_t w = 0;
+    uint64_t n = 0;
+
+    // Read enough leading digits to produce the first output digit
+    for (; (n >> k) == 0; r++) {
+        if (r >= dec->nd) {
+            if (n == 0) {
+                dec->nd = 0;
+                return;
+            }
+            while ((n >> k) == 0) {
+                n *= 10;
+                r++;
+            }
+            break;
+        }
+        n = (n * 10) + dec->digits[r];
+    }
+    dec->dp -= r - 1;
+
+    uint64_t mask = (UINT64_C(1) << k) - 1;
+
+    for (; r < dec->nd; r++) {
+        uint8_t c = dec->digits[r];
+        dec->digits[w] = (uint8_t) (n >> k);
+        w++;
+        n &= mask;
+        n = (n * 10) + c;
+    }
+
+    while (n > 0) {
+        uint8_t digit = (uint8_t) (n >> k);
+        n &= mask;
+        if (w < DECIMAL_MAX_DIGITS) {
+            dec->digits[w] = digit;
+            w++;
+        } else if (digit > 0) {
+            dec->trunc = true;
+        }
+        n *= 10;
+    }
+
+    dec->nd = w;
+    decimal_trim(dec);
+}
+
+static void decimal_left_shift(Decimal dec[static 1], uint32_t k) {
+    // Multiplying by 2^k adds at most floor(k * log10(2)) + 1 digits
+    int32_t end = dec->nd + (int32_t) ((k * 1233U) >> 12) + 1;
+    int32_t w = end;
+    uint64_t n = 0;
+
+    for (int32_t r = dec->nd - 1; r >= 0; r--) {
+        n += (uint64_t) dec->digits[r] << k;
+        uint64_t quo = n / 10;
+        w--;
+        dec->digits[w] = (uint8_t) (n - (quo * 10));
+        n = quo;
+    }
+    while (n > 0) {
+        uint64_t quo = n / 10;
+        w--;
+        dec->digits[w] = (uint8_t) (n - (quo * 10));
+        n = quo;
+    }
+
+    int32_t nd = end - w;
+    memmove(dec->digits, &dec->digits[w], (size_t) nd);
+    dec->dp += nd - dec->nd;
+    if (nd > DECIMAL_MAX_DIGITS) {
+        for (int32_t i = DECIMAL_MAX_DIGITS; i < nd; i++) {
+            if (dec->digits[i] != 0) {
+                dec->trunc = true;
+            }
+        }
+        nd = DECIMAL_MAX_DIGITS;
+    }
+    dec->nd = nd;
+    decimal_trim(dec);
+}
+
+static void decimal_shift(Decimal dec[static 1], int32_t k) {
+    if (dec->nd == 0) {
+        return;
+    }
+    int32_t remaining = k;
+    while (remaining > DECIMAL_MAX_SHIFT) {
+        decimal_left_shift(dec, DECIMAL_MAX_SHIFT);
+        remaining -= DECIMAL_MAX_SHIFT;
+    }
+    while (remaining < -DECIMAL_MAX_SHIFT) {
+        decimal_right_shift(dec, DECIMAL_MAX_SHIFT);
+        remaining += DECIMAL_MAX_SHIFT;
+    }
+    if (remaining > 0) {
+        decimal_left_shift(dec, (uint32_t) remaining);
+    } else if (remaining < 0) {
+        decimal_right_shift(dec, (uint32_t) -remaining);
+    }
+}
+
+static bool decimal_should_round_up(const Decimal dec[static 1], int32_t nd) {
+    if ((nd < 0) || (nd >= dec->nd)) {
+        return false;
+    }
+    if ((dec->digits[nd] == 5) && ((nd + 1) == dec->nd)) {
+        // Exactly halfway unless digits were dropped; round to even
+        if (dec->trunc) {
+            return true;
+        }
+        return (nd > 0) && ((dec->digits[nd - 1] % 2) != 0);
+    }
+    return dec->digits[nd] >= 5;
+}
+
+static uint64_t decimal_rounded_integer(const Decimal dec[static 1]) {
+    if (dec->dp > 20) {
+        return UINT64_MAX;
+    }
+    int32_t i = 0;
+    uint64_t n = 0;
+    for (; (i < dec->dp) && (i < dec->nd); i++) {
+        n = (n * 10) + dec->digits[i];
+    }
+    for (; i < dec->dp; i++) {
+        n *= 10;
+    }
+    if (decimal_should_round_up(dec, dec->dp)) {
+        n += 1;
+    }
+    return n;
+}
+
+static uint64_t decimal_to_f64_bits(Decimal dec[static 1]) {
+    // Binary shift amounts that keep the decimal point at dp or below
+    static const uint8_t POWTAB[] = { 1, 3, 6, 9, 13, 16, 19, 23, 26 };
+    static const int32_t POWTAB_LEN = sizeof(POWTAB) / sizeof(POWTAB[0]);
+    const int32_t max_exp = (1 << F64_EXP_BITS) - 1;
+
+    if ((dec->nd == 0) || (dec->dp < -330)) {
+        return 0;
+    }
+    if (dec->dp > 310) {
+        return F64_INF_BITS;
+    }
+
+    // Scale by powers of two until in [0.5, 1)
+    int32_t exp = 0;
+    while (dec->dp > 0) {
+        int32_t n = (dec->dp >= POWTAB_LEN) ? 27 : POWTAB[dec->dp];
+        decimal_shift(dec, -n);
+        exp += n;
+    }
+    while ((dec->dp < 0) || ((dec->dp == 0) && (dec->digits[0] < 5))) {
+        int32_t n = (-dec->dp >= POWTAB_LEN) ? 27 : POWTAB[-dec->dp];
+        decimal_shift(dec, n);
+        exp -= n;
+    }
+
+    // Range is [0.5, 1) but double significand is [1, 2)
+    exp -= 1;
+
+    if (exp < (F64_BIAS + 1)) {
+        int32_t n = F64_BIAS + 1 - exp;
+        decimal_shift(dec, -n);
+        exp += n;
+    }
+    if ((exp - F64_BIAS) >= max_exp) {
+        return F64_INF_BITS;
+    }
+
+    decimal_shift(dec, 1 + F64_MANT_BITS);
+    uint64_t mant = decimal_rounded_integer(dec);
+
+    // Rounding may have carried into a new bit
+    if (mant == (UINT64_C(2) << F64_MANT_BITS)) {
+        mant >>= 1;
+        exp += 1;
+        if ((exp - F64_BIAS) >= max_exp) {
+            return F64_INF_BITS;
+        }
+    }
+
+    // Subnormal
+    if ((mant & (UINT64_C(1) << F64_MANT_BITS)) == 0) {
+        exp = F64_BIAS;
+    }
+
+    return (mant & ((UINT64_C(1) << F64_MANT_BITS) - 1))
+        | ((uint64_t) (exp - F64_BIAS) << F64_MANT_BITS);
+}
+
+GgError gg_json_number_decode(GgBuffer str, GgObject obj[static 1]) {
+    ParsedNumber num;
+    if ((str.len == 0) || (scan_number(str, &num) != str.len)) {
+        GG_LOGE("Failed to parse JSON number.");
+        return GG_ERR_PARSE;
+    }
+
+    if (num.is_int) {
+        return int_from_parsed(&num, obj);
+    }
+
+    uint64_t bits;
+    if (!f64_bits_fast(&num, &bits)) {
+        Decimal dec;
+        decimal_init(&dec, str);
+        bits = decimal_to_f64_bits(&dec);
+    }
+
+    if ((bits == F64_INF_BITS) || ((bits == 0) && (num.mantissa != 0))) {
+        GG_LOGE("JSON float out of range of double.");
+        return GG_ERR_RANGE;
+    }
+
+    if (num.negative) {
+        bits |= F64_SIGN_BIT;
+    }
+    double val;
+    memcpy(&val, &bits, sizeof(val));
+    *obj = gg_obj_f64(val);
+    return GG_ERR_OK;
+}
+
+#ifdef GG_SDK_TESTING
+#include <gg/test.h>
+#include <unity.h>
+
+static void gg_test_number_f64(
+    const char *str, double expected, UNITY_UINT line_no
+) {
+    // Copy without terminator so reading past the end is caught by ASAN
+    size_t len = strlen(str);
+    uint8_t bytes[1024];
+    TEST_ASSERT(len <= sizeof(bytes));
+    memcpy(bytes, str, len);
+
+    GgObject obj;
+    gg_test_assert_ok(
+        gg_json_number_decode((GgBuffer) { .data = bytes, .len = len }, &obj),
+        "Could not decode number",
+        line_no
+    );
+    if (gg_obj_type(obj) != GG_TYPE_F64) {
+        UnityFail("Expected f64 result.", line_no);
+    }
+    double actual = gg_obj_into_f64(obj);
+    if (memcmp(&expected, &actual, sizeof(double)) != 0) {
+        UnityFail("Parsed float is not correctly rounded.", line_no);
+    }
+}
+
+#define GG_TEST_NUMBER_F64(str, expected) \
+    gg_test_number_f64((str), (expected), __LINE__)
+
+static void gg_test_number_i64(
+    const char *str, int64_t expected, UNITY_UINT line_no
+) {
+    GgObject obj;
+    gg_test_assert_ok(
+        gg_json_number_decode(
+            (GgBuffer) { .data = (uint8_t *) str, .len = strlen(str) }, &obj
+        ),
+        "Could not decode number",
+        line_no
+    );
+    if (gg_obj_type(obj) != GG_TYPE_I64) {
+        UnityFail("Expected i64 result.", line_no);
+    }
+    gg_test_assert_int64_equal(expected, gg_obj_into_i64(obj), NULL, line_no);
+}
+
+#define GG_TEST_NUMBER_I64(str, expected) \
+    gg_test_number_i64((str), (expected), __LINE__)
+
+GG_TEST_DEFINE(json_number_integers) {
+    GG_TEST_NUMBER_I64("0", 0);
+    GG_TEST_NUMBER_I64("-0", 0);
+    GG_TEST_NUMBER_I64("7", 7);
+    GG_TEST_NUMBER_I64("-42", -42);
+    GG_TEST_NUMBER_I64("9223372036854775807", INT64_MAX);
+    GG_TEST_NUMBER_I64("-9223372036854775808", INT64_MIN);
+
+    GgObject obj;
+    TEST_ASSERT_EQUAL(
+        GG_ERR_RANGE,
+        gg_json_number_decode(GG_STR("9223372036854775808"), &obj)
+    );
+    TEST_ASSERT_EQUAL(
+        GG_ERR_RANGE,
+        gg_json_number_decode(GG_STR("-9223372036854775809"), &obj)
+    );
+    TEST_ASSERT_EQUAL(
+        GG_ERR_RANGE,
+        gg_json_number_decode(GG_STR("100000000000000000000"), &obj)
+    );
+}
+
+GG_TEST_DEFINE(json_number_floats) {
+    GG_TEST_NUMBER_F64("123.456", 123.456);
+    GG_TEST_NUMBER_F64("-0.0", -0.0);
+    GG_TEST_NUMBER_F64("0e10", 0.0);
+    GG_TEST_NUMBER_F64("1e0", 1.0);
+    GG_TEST_NUMBER_F64("1.", 1.0);
+    GG_TEST_NUMBER_F64("2.5E-3", 2.5e-3);
+    GG_TEST_NUMBER_F64("1e+22", 1e22);
+    GG_TEST_NUMBER_F64("1e23", 1e23);
+    GG_TEST_NUMBER_F64("0.1", 0.1);
+    GG_TEST_NUMBER_F64("0.3", 0.3);
+    GG_TEST_NUMBER_F64("23.4567891234", 23.4567891234);
+    GG_TEST_NUMBER_F64("9007199254740993.0", 9007199254740992.0);
+    GG_TEST_NUMBER_F64("1.7976931348623157e308", DBL_MAX);
+    GG_TEST_NUMBER_F64("2.2250738585072014e-308", DBL_MIN);
+    GG_TEST_NUMBER_F64("4.9406564584124654e-324", 4.9406564584124654e-324);
+    GG_TEST_NUMBER_F64("1e-320", 1e-320);
+}
+
+GG_TEST_DEFINE(json_number_float_rounding) {
+    // Exactly halfway between 1 and the next double rounds to even
+    GG_TEST_NUMBER_F64(
+        "1.00000000000000011102230246251565404236316680908203125", 1.0
+    );
+    // Just above halfway rounds up, even past the 19th digit
+    GG_TEST_NUMBER_F64(
+        "1.000000000000000111022302462515654042363166809082031250001",
+        1.0000000000000002
+    );
+    GG_TEST_NUMBER_F64(
+        "9007199254740993.0000000000000000000000000000000001",
+        9007199254740994.0
+    );
+    GG_TEST_NUMBER_F64(
+        "123456789012345678901234567890.0", 123456789012345678901234567890.0
+    );
+    GG_TEST_NUMBER_F64("2.4703282292062328e-324", 4.9406564584124654e-324);
+}
+
+GG_TEST_DEFINE(json_number_errors) {
+    GgObject obj;
+    TEST_ASSERT_EQUAL(
+        GG_ERR_RANGE, gg_json_number_decode(GG_STR("1e309"), &obj)
+    );
+    TEST_ASSERT_EQUAL(
+        GG_ERR_RANGE,
+        gg_json_number_decode(GG_STR("-1e99999999999999999999"), &obj)
+    );
+    TEST_ASSERT_EQUAL(
+        GG_ERR_RANGE, gg_json_number_decode(GG_STR("1e-400"), &obj)
+    );
+    // Below half of the smallest subnormal
+    TEST_ASSERT_EQUAL(
+        GG_ERR_RANGE,
+        gg_json_number_decode(GG_STR("2.4703282292062327e-324"), &obj)
+    );
+
+    const char *invalid[] = { "", "-", "01", "+1", ".5", "1e", "1e+", "1,5",
+                              "1.5 ", "0x10", "NaN", "Infinity" };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        TEST_ASSERT_EQUAL_MESSAGE(
+            GG_ERR_PARSE,
+            gg_json_number_decode(
+                (GgBuffer) { .data = (uint8_t *) invalid[i],
+                             .len = strlen(invalid[i]) },
+                &obj
+            ),
+            invalid[i]
+        );
+    }
+}
+
+#endif
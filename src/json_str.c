@@ -0,0 +1,203 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gg/buffer.h>
+#include <gg/json_str.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define JSON_STR_X86 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define JSON_STR_NEON 1
+#endif
+
+#ifndef JSON_STR_X86
+#define JSON_STR_X86 0
+#endif
+#ifndef JSON_STR_NEON
+#define JSON_STR_NEON 0
+#endif
+
+typedef size_t FindSpecialFn(const uint8_t *data, size_t len);
+
+static bool is_special(uint8_t c) {
+    return (c == '"') || (c == '\\') || (c <= 0x1F);
+}
+
+static size_t find_special_scalar(const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        if (is_special(data[i])) {
+            return i;
+        }
+    }
+    return len;
+}
+
+#if JSON_STR_X86
+
+__attribute__((target("sse2"))) static size_t find_special_sse2(
+    const uint8_t *data, size_t len
+) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control_max = _mm_set1_epi8(0x1F);
+    size_t i = 0;
+
+    for (; (len - i) >= 16; i += 16) {
+        __m128i input = _mm_loadu_si128((const __m128i *) &data[i]);
+        __m128i special = _mm_or_si128(
+            _mm_or_si128(
+                _mm_cmpeq_epi8(input, quote), _mm_cmpeq_epi8(input, backslash)
+            ),
+            _mm_cmpeq_epi8(_mm_min_epu8(input, control_max), input)
+        );
+        unsigned mask = (unsigned) _mm_movemask_epi8(special);
+        if (mask != 0) {
+            return i + (size_t) __builtin_ctz(mask);
+        }
+    }
+
+    return i + find_special_scalar(&data[i], len - i);
+}
+
+__attribute__((target("avx2"))) static size_t find_special_avx2(
+    const uint8_t *data, size_t len
+) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i control_max = _mm256_set1_epi8(0x1F);
+    size_t i = 0;
+
+    for (; (len - i) >= 32; i += 32) {
+        __m256i input = _mm256_loadu_si256((const __m256i *) &data[i]);
+        __m256i special = _mm256_or_si256(
+            _mm256_or_si256(
+                _mm256_cmpeq_epi8(input, quote),
+                _mm256_cmpeq_epi8(input, backslash)
+            ),
+            _mm256_cmpeq_epi8(_mm256_min_epu8(input, control_max), input)
+        );
+        unsigned mask = (unsigned) _mm256_movemask_epi8(special);
+        if (mask != 0) {
+            return i + (size_t) __builtin_ctz(mask);
+        }
+    }
+
+    return i + find_special_sse2(&data[i], len - i);
+}
+
+static FindSpecialFn *find_special_impl = find_special_scalar;
+
+__attribute__((constructor)) static void json_str_select_impl(void) {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        find_special_impl = find_special_avx2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        find_special_impl = find_special_sse2;
+    }
+}
+
+#elif JSON_STR_NEON
+
+static size_t find_special_neon(const uint8_t *data, size_t len) {
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    const uint8x16_t control_max = vdupq_n_u8(0x1F);
+    size_t i = 0;
+
+    for (; (len - i) >= 16; i += 16) {
+        uint8x16_t input = vld1q_u8(&data[i]);
+        uint8x16_t special = vorrq_u8(
+            vorrq_u8(vceqq_u8(input, quote), vceqq_u8(input, backslash)),
+            vcleq_u8(input, control_max)
+        );
+        // Narrow to 4 bits per byte to get a scalar mask
+        uint64_t mask = vget_lane_u64(
+            vreinterpret_u64_u8(
+                vshrn_n_u16(vreinterpretq_u16_u8(special), 4)
+            ),
+            0
+        );
+        if (mask != 0) {
+            return i + ((size_t) __builtin_ctzll(mask) / 4);
+        }
+    }
+
+    return i + find_special_scalar(&data[i], len - i);
+}
+
+static FindSpecialFn *const find_special_impl = find_special_neon;
+
+#else
+
+static FindSpecialFn *const find_special_impl = find_special_scalar;
+
+#endif
+
+size_t gg_json_str_find_special(GgBuffer buf) {
+    if (buf.len == 0) {
+        return 0;
+    }
+    return find_special_impl(buf.data, buf.len);
+}
+
+#ifdef GG_SDK_TESTING
+#include <gg/test.h>
+#include <string.h>
+#include <unity.h>
+
+static void json_str_test_all_impls(
+    const uint8_t *data, size_t len, size_t expected, UNITY_UINT line_no
+) {
+    FindSpecialFn *impls[3] = { find_special_scalar };
+    size_t count = 1;
+#if JSON_STR_X86
+    impls[count++] = find_special_sse2;
+    if (__builtin_cpu_supports("avx2")) {
+        impls[count++] = find_special_avx2;
+    }
+#elif JSON_STR_NEON
+    impls[count++] = find_special_neon;
+#endif
+    for (size_t i = 0; i < count; i++) {
+        UnityAssertEqualNumber(
+            (UNITY_INT) expected,
+            (UNITY_INT) impls[i](data, len),
+            "Wrong special character index.",
+            line_no,
+            UNITY_DISPLAY_STYLE_UINT
+        );
+    }
+}
+
+GG_TEST_DEFINE(json_str_find_special) {
+    static const uint8_t SPECIAL[] = { '"', '\\', 0x00, 0x0A, 0x1F };
+    uint8_t buf[100];
+
+    memset(buf, 'x', sizeof(buf));
+    json_str_test_all_impls(buf, sizeof(buf), sizeof(buf), __LINE__);
+
+    // Non-ASCII and boundary bytes are not special
+    memset(buf, 0x20, sizeof(buf));
+    buf[7] = 0x7F;
+    buf[40] = 0x80;
+    buf[41] = 0xFF;
+    json_str_test_all_impls(buf, sizeof(buf), sizeof(buf), __LINE__);
+
+    for (size_t s = 0; s < sizeof(SPECIAL); s++) {
+        for (size_t pos = 0; pos < sizeof(buf); pos++) {
+            memset(buf, 0xC3, sizeof(buf));
+            buf[pos] = SPECIAL[s];
+            json_str_test_all_impls(buf, sizeof(buf), pos, __LINE__);
+            // Special character past the end is not found
+            json_str_test_all_impls(buf, pos, pos, __LINE__);
+        }
+    }
+}
+
+#endif
@@ -2,20 +2,56 @@
 // Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
 // SPDX-License-Identifier: Apache-2.0
 
+#include <errno.h>
+#include <gg/alloc.h>
+#include <gg/buffer.h>
 #include <gg/cleanup.h>
+#include <gg/error.h>
 #include <gg/log.h>
+#include <gg/log_config.h>
+#include <gg/vector.h>
+#include <inttypes.h>
 #include <pthread.h>
+#include <string.h>
 #include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <time.h>
 #include <unistd.h>
+#include <stdalign.h>
 #include <stdarg.h>
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+/// Size of each thread's async log buffer. Must be a power of two.
+#define LOG_RING_SIZE 16384U
+/// Maximum captured argument bytes per line; long strings are truncated.
+#define LOG_ARGS_MAX 2048U
+/// Maximum length of a conversion spec that can be deferred.
+#define LOG_SPEC_MAX 32U
+#define LOG_BATCH_IOV 256U
+#define LOG_BATCH_SCRATCH 8192U
+/// Interval at which the writer polls for lines while logging is active.
+#define LOG_POLL_MS 10U
+/// Polls without lines after which the writer waits to be woken instead.
+#define LOG_IDLE_POLLS 100U
+/// Safety net wait while idle, in case a wakeup races the writer going idle.
+#define LOG_IDLE_WAIT_MS 1000U
+
 static bool enable_systemd_log_prefix = false;
+static bool async_requested = false;
 
 __attribute__((constructor)) static void configure_logging(void) {
+    // NOLINTNEXTLINE(concurrency-mt-unsafe)
+    const char *async_env = getenv("GG_LOG_ASYNC");
+    if ((async_env != NULL) && (strcmp(async_env, "1") == 0)) {
+        async_requested = true;
+    }
+
     // NOLINTNEXTLINE(concurrency-mt-unsafe)
     const char *journal_stream = getenv("JOURNAL_STREAM");
     if (journal_stream == NULL) {
@@ -42,70 +78,1256 @@ __attribute__((constructor)) static void configure_logging(void) {
     }
 }
 
-void gg_log(
+static const char *level_prefix(uint32_t level) {
+    if (!enable_systemd_log_prefix) {
+        return "";
+    }
+
+    switch (level) {
+    case GG_LOG_ERROR:
+        return "<3>";
+    case GG_LOG_WARN:
+        return "<4>";
+    case GG_LOG_INFO:
+        return "<6>";
+    case GG_LOG_DEBUG:
+    case GG_LOG_TRACE:
+        return "<7>";
+    default:
+        return "";
+    }
+}
+
+static char level_char(uint32_t level) {
+    switch (level) {
+    case GG_LOG_ERROR:
+        return 'E';
+    case GG_LOG_WARN:
+        return 'W';
+    case GG_LOG_INFO:
+        return 'I';
+    case GG_LOG_DEBUG:
+        return 'D';
+    case GG_LOG_TRACE:
+        return 'T';
+    default:
+        return '?';
+    }
+}
+
+static void log_sync(
     uint32_t level,
     const char *file,
     int line,
     const char *tag,
     const char *format,
-    ...
+    va_list args
 ) {
     static pthread_mutex_t log_mutex = PTHREAD_MUTEX_INITIALIZER;
 
-    const char *prefix = "";
+    GG_MTX_SCOPE_GUARD(&log_mutex);
+
+    fprintf(
+        stderr,
+        "%s%c[%s] %s:%d: ",
+        level_prefix(level),
+        level_char(level),
+        tag,
+        file,
+        line
+    );
+    vfprintf(stderr, format, args);
+    fprintf(stderr, "\n");
+    fflush(stderr);
+}
+
+// Async logging
+//
+// Each logging thread owns a single-producer ring of records, each holding
+// the format string pointer and the raw values of its arguments. Strings are
+// copied, since they may not outlive the call. The writer drains all rings
+// in sequence order, formatting each conversion separately, and writes
+// batches with writev; literal text and strings are written straight from
+// the format string and ring.
+
+typedef enum {
+    LOG_ARG_INT,
+    LOG_ARG_LONG,
+    LOG_ARG_LLONG,
+    LOG_ARG_INTMAX,
+    LOG_ARG_SIZE,
+    LOG_ARG_PTRDIFF,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_LDOUBLE,
+    LOG_ARG_PTR,
+    LOG_ARG_STR,
+} LogArgType;
+
+typedef struct {
+    const char *end;
+    size_t len;
+    int width;
+    int precision;
+    bool left;
+    bool width_star;
+    bool precision_star;
+    // Plain %d, %i or %u, which have a fast path
+    bool decimal;
+    bool is_signed;
+    LogArgType type;
+} LogSpec;
+
+static int parse_spec_int(const char **pos) {
+    int value = 0;
+    while ((**pos >= '0') && (**pos <= '9')) {
+        if (value < (INT32_MAX / 10)) {
+            value = (value * 10) + (**pos - '0');
+        }
+        *pos = &(*pos)[1];
+    }
+    return value;
+}
+
+// Parses the printf conversion spec starting at the '%' at `start`.
+// Returns false for conversions that cannot be deferred.
+static bool parse_spec(const char *start, LogSpec *spec) {
+    *spec = (LogSpec) { .width = -1, .precision = -1 };
+    const char *pos = &start[1];
+
+    bool flags = false;
+    while ((*pos != '\0') && (strchr("-+ #0'", *pos) != NULL)) {
+        spec->left = spec->left || (*pos == '-');
+        flags = true;
+        pos = &pos[1];
+    }
 
-    if (enable_systemd_log_prefix) {
-        switch (level) {
-        case GG_LOG_ERROR:
-            prefix = "<3>";
+    if (*pos == '*') {
+        spec->width_star = true;
+        pos = &pos[1];
+    } else if ((*pos >= '0') && (*pos <= '9')) {
+        spec->width = parse_spec_int(&pos);
+    }
+
+    if (*pos == '.') {
+        pos = &pos[1];
+        if (*pos == '*') {
+            spec->precision_star = true;
+            pos = &pos[1];
+        } else {
+            spec->precision = parse_spec_int(&pos);
+        }
+    }
+
+    char length = '\0';
+    if ((pos[0] == 'h') && (pos[1] == 'h')) {
+        length = 'H';
+        pos = &pos[2];
+    } else if ((pos[0] == 'l') && (pos[1] == 'l')) {
+        length = 'q';
+        pos = &pos[2];
+    } else if ((*pos != '\0') && (strchr("hljztL", *pos) != NULL)) {
+        length = *pos;
+        pos = &pos[1];
+    }
+
+    char conv = *pos;
+    if (conv == '\0') {
+        return false;
+    }
+    spec->end = &pos[1];
+    spec->len = (size_t) (spec->end - start);
+    if (spec->len >= LOG_SPEC_MAX) {
+        return false;
+    }
+
+    if (strchr("diouxX", conv) != NULL) {
+        spec->decimal = !flags && (spec->width < 0) && !spec->width_star
+            && (spec->precision < 0) && !spec->precision_star
+            && (strchr("diu", conv) != NULL) && (length != 'H')
+            && (length != 'h');
+        spec->is_signed = conv != 'u';
+        switch (length) {
+        case '\0':
+        case 'H':
+        case 'h':
+            spec->type = LOG_ARG_INT;
+            return true;
+        case 'l':
+            spec->type = LOG_ARG_LONG;
+            return true;
+        case 'q':
+            spec->type = LOG_ARG_LLONG;
+            return true;
+        case 'j':
+            spec->type = LOG_ARG_INTMAX;
+            return true;
+        case 'z':
+            spec->type = LOG_ARG_SIZE;
+            return true;
+        case 't':
+            spec->type = LOG_ARG_PTRDIFF;
+            return true;
+        default:
+            return false;
+        }
+    }
+    if (strchr("fFeEgGaA", conv) != NULL) {
+        if ((length == '\0') || (length == 'l')) {
+            spec->type = LOG_ARG_DOUBLE;
+            return true;
+        }
+        if (length == 'L') {
+            spec->type = LOG_ARG_LDOUBLE;
+            return true;
+        }
+        return false;
+    }
+    if (length != '\0') {
+        return false;
+    }
+    switch (conv) {
+    case 'c':
+        spec->type = LOG_ARG_INT;
+        return true;
+    case 'p':
+        spec->type = LOG_ARG_PTR;
+        return true;
+    case 's':
+        spec->type = LOG_ARG_STR;
+        return true;
+    default:
+        return false;
+    }
+}
+
+#define CAPTURE_ARG(type) \
+    do { \
+        type value = va_arg(args, type); \
+        gg_byte_vec_chain_append( \
+            &ret, vec, (GgBuffer) { (uint8_t *) &value, sizeof(value) } \
+        ); \
+    } while (0)
+
+// Records the argument values of `format` into `vec`.
+// Returns false if the format cannot be deferred or its arguments do not fit.
+static bool capture_args(GgByteVec *vec, const char *format, va_list args) {
+    GgError ret = GG_ERR_OK;
+
+    const char *pos = strchr(format, '%');
+    while (pos != NULL) {
+        if (pos[1] == '%') {
+            pos = strchr(&pos[2], '%');
+            continue;
+        }
+
+        LogSpec spec;
+        if (!parse_spec(pos, &spec)) {
+            return false;
+        }
+        if (spec.width_star) {
+            CAPTURE_ARG(int);
+        }
+        int precision = spec.precision;
+        if (spec.precision_star) {
+            precision = va_arg(args, int);
+            gg_byte_vec_chain_append(
+                &ret,
+                vec,
+                (GgBuffer) { (uint8_t *) &precision, sizeof(precision) }
+            );
+        }
+
+        switch (spec.type) {
+        case LOG_ARG_INT:
+            CAPTURE_ARG(int);
             break;
-        case GG_LOG_WARN:
-            prefix = "<4>";
+        case LOG_ARG_LONG:
+            CAPTURE_ARG(long);
             break;
-        case GG_LOG_INFO:
-            prefix = "<6>";
+        case LOG_ARG_LLONG:
+            CAPTURE_ARG(long long);
             break;
-        case GG_LOG_DEBUG:
-        case GG_LOG_TRACE:
-            prefix = "<7>";
+        case LOG_ARG_INTMAX:
+            CAPTURE_ARG(intmax_t);
             break;
-        default:
+        case LOG_ARG_SIZE:
+            CAPTURE_ARG(size_t);
+            break;
+        case LOG_ARG_PTRDIFF:
+            CAPTURE_ARG(ptrdiff_t);
+            break;
+        case LOG_ARG_DOUBLE:
+            CAPTURE_ARG(double);
+            break;
+        case LOG_ARG_LDOUBLE:
+            CAPTURE_ARG(long double);
+            break;
+        case LOG_ARG_PTR:
+            CAPTURE_ARG(void *);
+            break;
+        case LOG_ARG_STR: {
+            const char *str = va_arg(args, const char *);
+            if (str == NULL) {
+                str = "(null)";
+            }
+            size_t len = (precision >= 0) ? strnlen(str, (size_t) precision)
+                                          : strlen(str);
+            size_t space = gg_byte_vec_remaining_capacity(*vec).len;
+            space = (space > sizeof(uint32_t)) ? space - sizeof(uint32_t) : 0;
+            uint32_t stored = (uint32_t) ((len < space) ? len : space);
+            gg_byte_vec_chain_append(
+                &ret, vec, (GgBuffer) { (uint8_t *) &stored, sizeof(stored) }
+            );
+            gg_byte_vec_chain_append(
+                &ret, vec, (GgBuffer) { (uint8_t *) str, stored }
+            );
             break;
         }
+        }
+
+        if (ret != GG_ERR_OK) {
+            return false;
+        }
+        pos = strchr(spec.end, '%');
     }
+    return true;
+}
 
-    unsigned char level_c;
-    switch (level) {
-    case GG_LOG_ERROR:
-        level_c = 'E';
-        break;
-    case GG_LOG_WARN:
-        level_c = 'W';
-        break;
-    case GG_LOG_INFO:
-        level_c = 'I';
-        break;
-    case GG_LOG_DEBUG:
-        level_c = 'D';
-        break;
-    case GG_LOG_TRACE:
-        level_c = 'T';
-        break;
-    default:
-        level_c = '?';
+typedef struct {
+    struct iovec iov[LOG_BATCH_IOV];
+    size_t iov_len;
+    char scratch[LOG_BATCH_SCRATCH];
+    size_t scratch_len;
+} LogBatch;
+
+typedef struct {
+    size_t iov_len;
+    size_t last_iov_len;
+    size_t scratch_len;
+} LogBatchMark;
+
+static LogBatchMark batch_mark(const LogBatch *batch) {
+    return (LogBatchMark) {
+        .iov_len = batch->iov_len,
+        .last_iov_len = (batch->iov_len > 0)
+            ? batch->iov[batch->iov_len - 1].iov_len
+            : 0,
+        .scratch_len = batch->scratch_len,
+    };
+}
+
+static void batch_restore(LogBatch *batch, LogBatchMark mark) {
+    batch->iov_len = mark.iov_len;
+    if (mark.iov_len > 0) {
+        batch->iov[mark.iov_len - 1].iov_len = mark.last_iov_len;
+    }
+    batch->scratch_len = mark.scratch_len;
+}
+
+static bool batch_add(LogBatch *batch, const void *data, size_t len) {
+    if (len == 0) {
+        return true;
+    }
+    if (batch->iov_len > 0) {
+        // Extend the last entry if contiguous, as with scratch output
+        struct iovec *last = &batch->iov[batch->iov_len - 1];
+        if (&((uint8_t *) last->iov_base)[last->iov_len] == data) {
+            last->iov_len += len;
+            return true;
+        }
+    }
+    if (batch->iov_len == LOG_BATCH_IOV) {
+        return false;
+    }
+    batch->iov[batch->iov_len]
+        = (struct iovec) { .iov_base = (void *) data, .iov_len = len };
+    batch->iov_len += 1;
+    return true;
+}
+
+static bool batch_copy(LogBatch *batch, const void *data, size_t len) {
+    if (len > LOG_BATCH_SCRATCH - batch->scratch_len) {
+        return false;
+    }
+    char *dst = &batch->scratch[batch->scratch_len];
+    memcpy(dst, data, len);
+    if (!batch_add(batch, dst, len)) {
+        return false;
+    }
+    batch->scratch_len += len;
+    return true;
+}
+
+static bool batch_str(LogBatch *batch, const char *str) {
+    return batch_copy(batch, str, strlen(str));
+}
+
+static bool batch_decimal(LogBatch *batch, bool negative, uint64_t magnitude) {
+    char buf[21];
+    size_t pos = sizeof(buf);
+    do {
+        pos -= 1;
+        buf[pos] = (char) ('0' + (magnitude % 10));
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (negative) {
+        pos -= 1;
+        buf[pos] = '-';
+    }
+    return batch_copy(batch, &buf[pos], sizeof(buf) - pos);
+}
+
+static bool batch_signed(LogBatch *batch, int64_t value) {
+    return batch_decimal(
+        batch,
+        value < 0,
+        (value < 0) ? (uint64_t) 0 - (uint64_t) value : (uint64_t) value
+    );
+}
+
+// Not marked as printf-like, as formats include specs from deferred log
+// formats, which were checked at their call sites.
+static bool batch_printf(LogBatch *batch, const char *format, ...) {
+    char *dst = &batch->scratch[batch->scratch_len];
+    size_t space = LOG_BATCH_SCRATCH - batch->scratch_len;
+
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(dst, space, format, args);
+    va_end(args);
+
+    if ((len < 0) || ((size_t) len >= space)) {
+        return false;
+    }
+    if (!batch_add(batch, dst, (size_t) len)) {
+        return false;
+    }
+    batch->scratch_len += (size_t) len;
+    return true;
+}
+
+static bool batch_pad(LogBatch *batch, size_t count) {
+    static const char SPACES[] = "                                ";
+    while (count > 0) {
+        size_t len = (count < sizeof(SPACES) - 1) ? count : sizeof(SPACES) - 1;
+        if (!batch_add(batch, SPACES, len)) {
+            return false;
+        }
+        count -= len;
+    }
+    return true;
+}
+
+static void read_arg(const uint8_t **args, void *value, size_t size) {
+    memcpy(value, *args, size);
+    *args = &(*args)[size];
+}
+
+#define RENDER_INT_ARG(type, signed_type, unsigned_type) \
+    do { \
+        type value; \
+        read_arg(&args, &value, sizeof(value)); \
+        if (!spec.decimal) { \
+            ok = (stars == 0) \
+                ? batch_printf(batch, spec_str, value) \
+                : ((stars == 1) \
+                       ? batch_printf(batch, spec_str, star[0], value) \
+                       : batch_printf( \
+                             batch, spec_str, star[0], star[1], value \
+                         )); \
+        } else if (spec.is_signed) { \
+            ok = batch_signed(batch, (int64_t) (signed_type) value); \
+        } else { \
+            ok = batch_decimal( \
+                batch, false, (uint64_t) (unsigned_type) value \
+            ); \
+        } \
+    } while (0)
+
+#define RENDER_ARG(type) \
+    do { \
+        type value; \
+        read_arg(&args, &value, sizeof(value)); \
+        ok = (stars == 0) \
+            ? batch_printf(batch, spec_str, value) \
+            : ((stars == 1) \
+                   ? batch_printf(batch, spec_str, star[0], value) \
+                   : batch_printf(batch, spec_str, star[0], star[1], value)); \
+    } while (0)
+
+// Renders `format` with arguments recorded by `capture_args`.
+static bool render_message(
+    LogBatch *batch, const char *format, const uint8_t *args
+) {
+    const char *pos = format;
+    while (true) {
+        const char *pct = strchr(pos, '%');
+        if (pct == NULL) {
+            return batch_add(batch, pos, strlen(pos));
+        }
+        if (!batch_add(batch, pos, (size_t) (pct - pos))) {
+            return false;
+        }
+        if (pct[1] == '%') {
+            if (!batch_add(batch, pct, 1)) {
+                return false;
+            }
+            pos = &pct[2];
+            continue;
+        }
+
+        LogSpec spec;
+        (void) parse_spec(pct, &spec);
+        int star[2];
+        int stars = 0;
+        if (spec.width_star) {
+            read_arg(&args, &star[stars++], sizeof(int));
+        }
+        if (spec.precision_star) {
+            read_arg(&args, &star[stars++], sizeof(int));
+        }
+
+        char spec_str[LOG_SPEC_MAX];
+        memcpy(spec_str, pct, spec.len);
+        spec_str[spec.len] = '\0';
+
+        bool ok = true;
+        switch (spec.type) {
+        case LOG_ARG_INT:
+            RENDER_INT_ARG(int, int, unsigned);
+            break;
+        case LOG_ARG_LONG:
+            RENDER_INT_ARG(long, long, unsigned long);
+            break;
+        case LOG_ARG_LLONG:
+            RENDER_INT_ARG(long long, long long, unsigned long long);
+            break;
+        case LOG_ARG_INTMAX:
+            RENDER_INT_ARG(intmax_t, intmax_t, uintmax_t);
+            break;
+        case LOG_ARG_SIZE:
+            RENDER_INT_ARG(size_t, ssize_t, size_t);
+            break;
+        case LOG_ARG_PTRDIFF:
+            RENDER_INT_ARG(ptrdiff_t, ptrdiff_t, size_t);
+            break;
+        case LOG_ARG_DOUBLE:
+            RENDER_ARG(double);
+            break;
+        case LOG_ARG_LDOUBLE:
+            RENDER_ARG(long double);
+            break;
+        case LOG_ARG_PTR:
+            RENDER_ARG(void *);
+            break;
+        case LOG_ARG_STR: {
+            // Precision was applied on capture
+            uint32_t len;
+            read_arg(&args, &len, sizeof(len));
+            const uint8_t *str = args;
+            args = &args[len];
+
+            int width = spec.width_star ? star[0] : spec.width;
+            bool left = spec.left || (width < 0);
+            size_t abs_width = (width < 0) ? (size_t) -(int64_t) width
+                                           : (size_t) width;
+            size_t pad = (abs_width > len) ? abs_width - len : 0;
+            if (!spec.width_star && (spec.width < 0)) {
+                pad = 0;
+            }
+            ok = (left || batch_pad(batch, pad)) && batch_add(batch, str, len)
+                && (!left || batch_pad(batch, pad));
+            break;
+        }
+        }
+        if (!ok) {
+            return false;
+        }
+        pos = spec.end;
     }
+}
+
+typedef struct {
+    uint32_t size; // Zero marks a skip to the start of the ring
+    uint32_t level;
+    uint64_t seq;
+    const char *file;
+    const char *tag;
+    const char *format; // NULL if args hold the formatted message
+    int32_t line;
+    uint32_t args_len;
+} LogRecord;
+
+typedef struct LogRing {
+    struct LogRing *next;
+    atomic_bool owned;
+    atomic_size_t head;
+    atomic_size_t tail;
+    // Position read up to by the writer; tail is advanced once written
+    size_t drain_pos;
+    alignas(LogRecord) uint8_t mem[LOG_RING_SIZE];
+} LogRing;
+
+static _Atomic(LogRing *) log_rings = NULL;
+static _Thread_local LogRing *thread_ring = NULL;
+// Set once the thread's ring is released on exit, after which it logs
+// synchronously
+static _Thread_local bool thread_ring_released = false;
+static pthread_key_t ring_key;
+static pthread_once_t ring_key_once = PTHREAD_ONCE_INIT;
+static int ring_key_err = 0;
+
+static atomic_uint_fast64_t log_seq = 0;
+static atomic_uint_fast64_t log_dropped = 0;
+static atomic_bool log_async = false;
+
+static pthread_mutex_t drain_mtx = PTHREAD_MUTEX_INITIALIZER;
+static atomic_bool wake_requested = false;
+static atomic_bool writer_idle = true;
+static pthread_mutex_t wake_mtx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t wake_cond;
+
+static void release_thread_ring(void *ptr) {
+    LogRing *ring = ptr;
+    // Other key destructors may still log; they must not push into a ring that
+    // another thread can now claim.
+    thread_ring = NULL;
+    thread_ring_released = true;
+    // Records left in the ring are written after the thread exits; the ring
+    // is then reused by a new thread.
+    atomic_store(&ring->owned, false);
+}
+
+static void init_ring_key(void) {
+    ring_key_err = pthread_key_create(&ring_key, release_thread_ring);
+}
+
+static LogRing *get_thread_ring(void) {
+    if (thread_ring != NULL) {
+        return thread_ring;
+    }
+    if (thread_ring_released) {
+        return NULL;
+    }
+
+    pthread_once(&ring_key_once, init_ring_key);
+    if (ring_key_err != 0) {
+        return NULL;
+    }
+
+    LogRing *ring = atomic_load(&log_rings);
+    while (ring != NULL) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&ring->owned, &expected, true)) {
+            break;
+        }
+        ring = ring->next;
+    }
+
+    if (ring == NULL) {
+        ring = GG_ALLOC(gg_libc_alloc(), LogRing);
+        if (ring == NULL) {
+            return NULL;
+        }
+        atomic_init(&ring->owned, true);
+        atomic_init(&ring->head, 0);
+        atomic_init(&ring->tail, 0);
+        ring->drain_pos = 0;
+        ring->next = atomic_load(&log_rings);
+        while (!atomic_compare_exchange_weak(&log_rings, &ring->next, ring)) { }
+    }
+
+    if (pthread_setspecific(ring_key, ring) != 0) {
+        atomic_store(&ring->owned, false);
+        return NULL;
+    }
+    thread_ring = ring;
+    return ring;
+}
+
+static bool ring_push(LogRing *ring, LogRecord header, GgBuffer args) {
+    size_t size = sizeof(LogRecord) + args.len;
+    size = (size + alignof(LogRecord) - 1) & ~(alignof(LogRecord) - 1);
+
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    size_t offset = head & (LOG_RING_SIZE - 1);
+    size_t skip = (LOG_RING_SIZE - offset < size) ? LOG_RING_SIZE - offset : 0;
+    if (skip + size > LOG_RING_SIZE - (head - tail)) {
+        return false;
+    }
+
+    if (skip > 0) {
+        uint32_t marker = 0;
+        memcpy(&ring->mem[offset], &marker, sizeof(marker));
+        head += skip;
+        offset = 0;
+    }
+
+    header.size = (uint32_t) size;
+    header.args_len = (uint32_t) args.len;
+    header.seq = atomic_fetch_add_explicit(&log_seq, 1, memory_order_relaxed);
+    LogRecord *rec = (LogRecord *) &ring->mem[offset];
+    *rec = header;
+    if (args.len > 0) {
+        memcpy(&rec[1], args.data, args.len);
+    }
+
+    atomic_store_explicit(&ring->head, head + size, memory_order_release);
+    return true;
+}
+
+// Requires holding drain_mtx
+static const LogRecord *ring_peek(LogRing *ring) {
+    size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    while (ring->drain_pos != head) {
+        size_t offset = ring->drain_pos & (LOG_RING_SIZE - 1);
+        const LogRecord *rec = (const LogRecord *) &ring->mem[offset];
+        if (rec->size == 0) {
+            ring->drain_pos += LOG_RING_SIZE - offset;
+            continue;
+        }
+        return rec;
+    }
+    return NULL;
+}
+
+static bool render_record(LogBatch *batch, const LogRecord *rec) {
+    const uint8_t *args = (const uint8_t *) &rec[1];
+    char level = level_char(rec->level);
+    bool ok = batch_str(batch, level_prefix(rec->level))
+        && batch_copy(batch, &level, 1) && batch_copy(batch, "[", 1)
+        && batch_str(batch, rec->tag) && batch_copy(batch, "] ", 2)
+        && batch_str(batch, rec->file) && batch_copy(batch, ":", 1)
+        && batch_signed(batch, rec->line) && batch_copy(batch, ": ", 2);
+    if (ok) {
+        ok = (rec->format == NULL) ? batch_add(batch, args, rec->args_len)
+                                   : render_message(batch, rec->format, args);
+    }
+    return ok && batch_add(batch, "\n", 1);
+}
+
+static void write_batch(int fd, LogBatch *batch) {
+    struct iovec *iov = batch->iov;
+    size_t count = batch->iov_len;
+    while (count > 0) {
+        ssize_t ret = writev(fd, iov, (int) count);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        size_t written = (size_t) ret;
+        while ((count > 0) && (written >= iov->iov_len)) {
+            written -= iov->iov_len;
+            iov = &iov[1];
+            count -= 1;
+        }
+        if (count > 0) {
+            iov->iov_base = &((uint8_t *) iov->iov_base)[written];
+            iov->iov_len -= written;
+        }
+    }
+    batch->iov_len = 0;
+    batch->scratch_len = 0;
+}
+
+// Requires holding drain_mtx
+static void write_batch_and_release(int fd, LogBatch *batch) {
+    write_batch(fd, batch);
+    for (LogRing *ring = atomic_load(&log_rings); ring != NULL;
+         ring = ring->next) {
+        atomic_store_explicit(
+            &ring->tail, ring->drain_pos, memory_order_release
+        );
+    }
+}
+
+// Requires holding drain_mtx
+// Returns whether any lines were written.
+static bool drain_rings(int fd) {
+    static LogBatch batch;
+    static uint64_t reported_drops = 0;
+
+    bool wrote = false;
+    while (true) {
+        LogRing *next_ring = NULL;
+        const LogRecord *next = NULL;
+        for (LogRing *ring = atomic_load(&log_rings); ring != NULL;
+             ring = ring->next) {
+            const LogRecord *rec = ring_peek(ring);
+            if ((rec != NULL) && ((next == NULL) || (rec->seq < next->seq))) {
+                next = rec;
+                next_ring = ring;
+            }
+        }
+        if (next == NULL) {
+            break;
+        }
+
+        LogBatchMark mark = batch_mark(&batch);
+        if (!render_record(&batch, next)) {
+            batch_restore(&batch, mark);
+            write_batch_and_release(fd, &batch);
+            if (!render_record(&batch, next)) {
+                batch.iov_len = 0;
+                batch.scratch_len = 0;
+                (void) batch_printf(
+                    &batch,
+                    "%s%c[%s] %s:%" PRId32 ": Log line too long.\n",
+                    level_prefix(next->level),
+                    level_char(next->level),
+                    next->tag,
+                    next->file,
+                    next->line
+                );
+            }
+        }
+        next_ring->drain_pos += next->size;
+        wrote = true;
+    }
+
+    uint64_t dropped = atomic_load(&log_dropped);
+    if (dropped != reported_drops) {
+        (void) batch_printf(
+            &batch,
+            "%sW[%s] %s:%d: Dropped %" PRIu64 " log lines.\n",
+            level_prefix(GG_LOG_WARN),
+            GG_MODULE,
+            __FILE_NAME__,
+            __LINE__,
+            dropped - reported_drops
+        );
+        reported_drops = dropped;
+    }
+
+    write_batch_and_release(fd, &batch);
+    return wrote;
+}
+
+static void wake_writer(void) {
+    if (!atomic_exchange(&wake_requested, true)) {
+        GG_MTX_SCOPE_GUARD(&wake_mtx);
+        pthread_cond_signal(&wake_cond);
+    }
+}
+
+static bool drain_all(void) {
+    GG_MTX_SCOPE_GUARD(&drain_mtx);
+    return drain_rings(STDERR_FILENO);
+}
+
+static void *log_writer_thread(void *arg) {
+    (void) arg;
+
+    // The writer polls while lines are being logged, so that loggers do not
+    // need to signal it. Once idle, it waits for loggers to wake it.
+    unsigned idle_polls = 0;
+    while (true) {
+        {
+            GG_MTX_SCOPE_GUARD(&wake_mtx);
+            if (!atomic_load(&wake_requested)) {
+                bool idle = idle_polls >= LOG_IDLE_POLLS;
+                atomic_store(&writer_idle, idle);
+                struct timespec deadline;
+                clock_gettime(CLOCK_MONOTONIC, &deadline);
+                uint64_t wait_ms = idle ? LOG_IDLE_WAIT_MS : LOG_POLL_MS;
+                deadline.tv_nsec += (long) (wait_ms * 1000000U);
+                deadline.tv_sec += deadline.tv_nsec / 1000000000;
+                deadline.tv_nsec %= 1000000000;
+                (void) pthread_cond_timedwait(
+                    &wake_cond, &wake_mtx, &deadline
+                );
+                atomic_store(&writer_idle, false);
+            }
+        }
+        // Cleared before draining, so lines logged after are not missed
+        atomic_store(&wake_requested, false);
+        if (drain_all()) {
+            idle_polls = 0;
+        } else if (idle_polls < LOG_IDLE_POLLS) {
+            idle_polls += 1;
+        }
+    }
+
+    return NULL;
+}
+
+static void log_async_record(
+    uint32_t level,
+    const char *file,
+    int line,
+    const char *tag,
+    const char *format,
+    va_list args
+) {
+    LogRing *ring = get_thread_ring();
+    if (ring == NULL) {
+        log_sync(level, file, line, tag, format, args);
+        return;
+    }
+
+    uint8_t mem[LOG_ARGS_MAX];
+    GgByteVec vec = GG_BYTE_VEC(mem);
+    LogRecord header = {
+        .level = level,
+        .file = file,
+        .tag = tag,
+        .format = format,
+        .line = line,
+    };
+
+    va_list capture;
+    va_copy(capture, args);
+    bool captured = capture_args(&vec, format, capture);
+    va_end(capture);
+
+    if (!captured) {
+        // Conversions that cannot be deferred are formatted now
+        int len = vsnprintf((char *) mem, sizeof(mem), format, args);
+        vec.buf.len = (len < 0) ? 0 : (size_t) len;
+        if (vec.buf.len >= sizeof(mem)) {
+            vec.buf.len = sizeof(mem) - 1;
+        }
+        header.format = NULL;
+    }
+
+    if (ring_push(ring, header, vec.buf)) {
+        size_t used = atomic_load_explicit(&ring->head, memory_order_relaxed)
+            - atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        if ((used >= LOG_RING_SIZE / 4)
+            || atomic_load_explicit(&writer_idle, memory_order_relaxed)) {
+            wake_writer();
+        }
+    } else {
+        atomic_fetch_add_explicit(&log_dropped, 1, memory_order_relaxed);
+    }
+
+    if (level <= GG_LOG_ERROR) {
+        gg_log_flush();
+    }
+}
+
+static void before_fork(void) {
+    // Keeps the writer from holding the lock across the fork
+    pthread_mutex_lock(&drain_mtx);
+}
+
+static void after_fork_parent(void) {
+    pthread_mutex_unlock(&drain_mtx);
+}
+
+static void after_fork_child(void) {
+    // The child has no writer thread, so it logs synchronously. Records
+    // inherited from the parent are written by the parent.
+    atomic_store(&log_async, false);
+    async_requested = false;
+    for (LogRing *ring = atomic_load(&log_rings); ring != NULL;
+         ring = ring->next) {
+        size_t head = atomic_load(&ring->head);
+        ring->drain_pos = head;
+        atomic_store(&ring->tail, head);
+    }
+    pthread_mutex_unlock(&drain_mtx);
+}
+
+static pthread_once_t async_once = PTHREAD_ONCE_INIT;
+static GgError async_start_err = GG_ERR_OK;
+
+static void start_async(void) {
+    if (pthread_atfork(before_fork, after_fork_parent, after_fork_child)
+        != 0) {
+        async_start_err = GG_ERR_FAILURE;
+        return;
+    }
+
+    pthread_condattr_t wake_condattr;
+    pthread_condattr_init(&wake_condattr);
+    pthread_condattr_setclock(&wake_condattr, CLOCK_MONOTONIC);
+    pthread_cond_init(&wake_cond, &wake_condattr);
+    pthread_condattr_destroy(&wake_condattr);
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, log_writer_thread, NULL) != 0) {
+        async_start_err = GG_ERR_FAILURE;
+        return;
+    }
+    pthread_detach(thread);
+    (void) atexit(gg_log_flush);
+    atomic_store(&log_async, true);
+}
+
+GgError gg_log_start_async(void) {
+    pthread_once(&async_once, start_async);
+    return async_start_err;
+}
+
+void gg_log_flush(void) {
+    (void) drain_all();
+}
+
+uint64_t gg_log_dropped_count(void) {
+    return atomic_load(&log_dropped);
+}
+
+void gg_log(
+    uint32_t level,
+    const char *file,
+    int line,
+    const char *tag,
+    const char *format,
+    ...
+) {
+    if (async_requested
+        && !atomic_load_explicit(&log_async, memory_order_relaxed)) {
+        (void) gg_log_start_async();
+    }
+
+    va_list args;
+    va_start(args, format);
+    if (atomic_load_explicit(&log_async, memory_order_relaxed)) {
+        log_async_record(level, file, line, tag, format, args);
+    } else {
+        log_sync(level, file, line, tag, format, args);
+    }
+    va_end(args);
+}
+
+#ifdef GG_SDK_TESTING
+
+#include <fcntl.h>
+#include <gg/test.h>
+#include <sys/wait.h>
+#include <unity.h>
+
+static void check_deferred(const char *format, ...) {
+    char expected[512];
+    va_list args;
+    va_start(args, format);
+    va_list capture;
+    va_copy(capture, args);
+    int expected_len = vsnprintf(expected, sizeof(expected), format, args);
+    va_end(args);
+
+    uint8_t mem[LOG_ARGS_MAX];
+    GgByteVec vec = GG_BYTE_VEC(mem);
+    bool captured = capture_args(&vec, format, capture);
+    va_end(capture);
+    TEST_ASSERT_TRUE_MESSAGE(captured, format);
+
+    static LogBatch batch;
+    batch.iov_len = 0;
+    batch.scratch_len = 0;
+    TEST_ASSERT_TRUE(render_message(&batch, format, mem));
+
+    char actual[512];
+    size_t actual_len = 0;
+    for (size_t i = 0; i < batch.iov_len; i++) {
+        TEST_ASSERT_LESS_OR_EQUAL(
+            sizeof(actual), actual_len + batch.iov[i].iov_len
+        );
+        memcpy(
+            &actual[actual_len], batch.iov[i].iov_base, batch.iov[i].iov_len
+        );
+        actual_len += batch.iov[i].iov_len;
+    }
+    TEST_ASSERT_EQUAL_MESSAGE(expected_len, actual_len, format);
+    TEST_ASSERT_EQUAL_STRING_LEN_MESSAGE(expected, actual, actual_len, format);
+}
+
+GG_TEST_DEFINE(log_deferred_format) {
+    int local = 0;
+    char unterminated[3] = { 'a', 'b', 'c' };
+
+    check_deferred("plain text");
+    check_deferred("");
+    check_deferred("%d %i %u %x %X %o %c %%", -5, 7, 8U, 255U, 255U, 8U, 'q');
+    check_deferred(
+        "%ld|%lld|%zu|%zd|%jd|%td|%hhu|%hd",
+        -1L,
+        -2LL,
+        (size_t) 3,
+        (ssize_t) -4,
+        (intmax_t) 5,
+        (ptrdiff_t) -6,
+        (unsigned char) 7,
+        (short) -8
+    );
+    check_deferred("%5.2f|%-10.3e|%g|%Lf|%a", 3.14159, 1e10, 0.5, 2.5L, 1.0);
+    check_deferred("%p %p", (void *) &local, NULL);
+    check_deferred(
+        "[%s] [%-6s] [%6s] [%.2s] [%.*s] [%*s] [%*d] [%-*.*s]",
+        "str",
+        "ab",
+        "ab",
+        "abcdef",
+        (int) sizeof(unterminated),
+        unterminated,
+        -5,
+        "ab",
+        4,
+        42,
+        6,
+        2,
+        "abcdef"
+    );
+    check_deferred("%08.3f %+d % d %#x", 1.5, 3, 4, 16U);
+}
+
+static void *push_from_thread(void *ctx) {
+    LogRing *ring = get_thread_ring();
+    GgBuffer args = GG_STR("b");
+    return (void *) (uintptr_t) (ring_push(
+                                     ring,
+                                     (LogRecord) { .level = GG_LOG_INFO,
+                                                   .file = "f.c",
+                                                   .tag = "t",
+                                                   .line = 2 },
+                                     args
+                                 )
+                                 && (ctx == NULL));
+}
+
+GG_TEST_DEFINE(log_ring_drain) {
+    int fds[2];
+    TEST_ASSERT_EQUAL(0, pipe(fds));
+
+    LogRing *ring = get_thread_ring();
+    TEST_ASSERT_NOT_NULL(ring);
+    TEST_ASSERT_EQUAL_PTR(ring, get_thread_ring());
+
+    // Lines from other threads are written in order
+    int value = 1;
+    uint8_t args[sizeof(int)];
+    memcpy(args, &value, sizeof(value));
+    TEST_ASSERT_TRUE(ring_push(
+        ring,
+        (LogRecord) {
+            .level = GG_LOG_WARN, .file = "f.c", .tag = "t", .format = "a%d"
+        },
+        GG_BUF(args)
+    ));
+    pthread_t thread;
+    TEST_ASSERT_EQUAL(
+        0, pthread_create(&thread, NULL, push_from_thread, NULL)
+    );
+    void *pushed = NULL;
+    TEST_ASSERT_EQUAL(0, pthread_join(thread, &pushed));
+    TEST_ASSERT_NOT_NULL(pushed);
+    TEST_ASSERT_TRUE(ring_push(
+        ring,
+        (LogRecord) {
+            .level = GG_LOG_ERROR, .file = "g.c", .tag = "t", .format = "c"
+        },
+        (GgBuffer) { 0 }
+    ));
 
     {
-        GG_MTX_SCOPE_GUARD(&log_mutex);
+        GG_MTX_SCOPE_GUARD(&drain_mtx);
+        (void) drain_rings(fds[1]);
+    }
 
-        fprintf(stderr, "%s%c[%s] %s:%d: ", prefix, level_c, tag, file, line);
+    char out[128];
+    ssize_t len = read(fds[0], out, sizeof(out));
+    const char *expected = "W[t] f.c:0: a1\nI[t] f.c:2: b\nE[t] g.c:0: c\n";
+    TEST_ASSERT_EQUAL(strlen(expected), len);
+    TEST_ASSERT_EQUAL_MEMORY(expected, out, strlen(expected));
 
-        va_list args;
-        va_start(args, format);
-        vfprintf(stderr, format, args);
-        va_end(args);
+    // A full ring refuses lines, and has space again once drained
+    size_t pushed_count = 0;
+    while (ring_push(
+        ring,
+        (LogRecord) { .level = GG_LOG_INFO, .file = "f", .tag = "t" },
+        GG_STR("0123456789")
+    )) {
+        pushed_count += 1;
+    }
+    TEST_ASSERT_GREATER_THAN(100, pushed_count);
+    {
+        GG_MTX_SCOPE_GUARD(&drain_mtx);
+        (void) drain_rings(fds[1]);
+    }
+    size_t lines = 0;
+    while (lines < pushed_count) {
+        len = read(fds[0], out, sizeof(out));
+        TEST_ASSERT_GREATER_THAN(0, len);
+        for (ssize_t i = 0; i < len; i++) {
+            lines += (out[i] == '\n') ? 1 : 0;
+        }
+    }
+    TEST_ASSERT_EQUAL(pushed_count, lines);
+    TEST_ASSERT_TRUE(ring_push(
+        ring,
+        (LogRecord) { .level = GG_LOG_INFO, .file = "f", .tag = "t" },
+        GG_STR("0123456789")
+    ));
+    {
+        GG_MTX_SCOPE_GUARD(&drain_mtx);
+        (void) drain_rings(fds[1]);
+    }
 
-        fprintf(stderr, "\n");
-        fflush(stderr);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+static void *log_after_release(void *ctx) {
+    (void) ctx;
+    LogRing *ring = get_thread_ring();
+    if (ring == NULL) {
+        return NULL;
     }
+    // As run by the key destructor on thread exit
+    (void) pthread_setspecific(ring_key, NULL);
+    release_thread_ring(ring);
+    bool ok = (get_thread_ring() == NULL) && !atomic_load(&ring->owned);
+    return (void *) (uintptr_t) ok;
 }
+
+GG_TEST_DEFINE(log_ring_released_on_exit) {
+    pthread_t thread;
+    TEST_ASSERT_EQUAL(
+        0, pthread_create(&thread, NULL, log_after_release, NULL)
+    );
+    void *ok = NULL;
+    TEST_ASSERT_EQUAL(0, pthread_join(thread, &ok));
+    TEST_ASSERT_NOT_NULL(ok);
+}
+
+GG_TEST_DEFINE(log_fork_child_sync) {
+    LogRing *ring = get_thread_ring();
+    TEST_ASSERT_NOT_NULL(ring);
+    TEST_ASSERT_TRUE(ring_push(
+        ring,
+        (LogRecord) { .level = GG_LOG_INFO, .file = "f", .tag = "t" },
+        GG_STR("parent")
+    ));
+
+    pid_t pid = fork();
+    TEST_ASSERT_GREATER_OR_EQUAL(0, pid);
+    if (pid == 0) {
+        before_fork();
+        after_fork_child();
+        bool ok;
+        {
+            GG_MTX_SCOPE_GUARD(&drain_mtx);
+            ok = (ring_peek(ring) == NULL) && !atomic_load(&log_async);
+        }
+        _exit(ok ? 0 : 1);
+    }
+
+    int status;
+    TEST_ASSERT_EQUAL(pid, waitpid(pid, &status, 0));
+    TEST_ASSERT_TRUE(WIFEXITED(status));
+    TEST_ASSERT_EQUAL(0, WEXITSTATUS(status));
+
+    // The parent still writes its records
+    GG_MTX_SCOPE_GUARD(&drain_mtx);
+    TEST_ASSERT_NOT_NULL(ring_peek(ring));
+    int fd = open("/dev/null", O_WRONLY | O_CLOEXEC);
+    TEST_ASSERT_GREATER_OR_EQUAL(0, fd);
+    (void) drain_rings(fd);
+    close(fd);
+}
+
+#endif
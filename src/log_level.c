@@ -0,0 +1,240 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gg/buffer.h>
+#include <gg/cleanup.h>
+#include <gg/error.h>
+#include <gg/log.h>
+#include <gg/log_config.h>
+#include <pthread.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define LOG_LEVELS_MAX 512U
+
+static pthread_mutex_t levels_mtx = PTHREAD_MUTEX_INITIALIZER;
+static GgLogModule *log_modules = NULL;
+static uint8_t levels_mem[LOG_LEVELS_MAX];
+static GgBuffer levels_spec = { .data = levels_mem, .len = 0 };
+static bool levels_env_loaded = false;
+
+GgLogModule gg_log_module_default = { .tag = "",
+                                      .file = "",
+                                      .max_level = GG_LOG_TRACE };
+
+__attribute__((constructor)) static void register_default_module(void) {
+    gg_log_register_module(&gg_log_module_default);
+}
+
+static const GgBuffer LEVEL_NAMES[] = {
+    [GG_LOG_NONE] = GG_STR("none"),   [GG_LOG_ERROR] = GG_STR("error"),
+    [GG_LOG_WARN] = GG_STR("warn"),   [GG_LOG_INFO] = GG_STR("info"),
+    [GG_LOG_DEBUG] = GG_STR("debug"), [GG_LOG_TRACE] = GG_STR("trace"),
+};
+
+/// Split the next comma-separated entry off of `rest`.
+static bool next_entry(GgBuffer *rest, GgBuffer *entry) {
+    if (rest->len == 0) {
+        return false;
+    }
+    size_t end;
+    if (!gg_buffer_contains(*rest, GG_STR(","), &end)) {
+        end = rest->len;
+    }
+    *entry = gg_buffer_substr(*rest, 0, end);
+    size_t next = (end < rest->len) ? end + 1 : end;
+    *rest = gg_buffer_substr(*rest, next, SIZE_MAX);
+    return true;
+}
+
+static GgError parse_level(GgBuffer str, uint32_t *level) {
+    for (uint32_t i = 0; i < sizeof(LEVEL_NAMES) / sizeof(*LEVEL_NAMES); i++) {
+        if (gg_buffer_eq(str, LEVEL_NAMES[i])) {
+            *level = i;
+            return GG_ERR_OK;
+        }
+    }
+    return GG_ERR_PARSE;
+}
+
+/// Parse `[name=]level`; `name` is left empty for the default level.
+static GgError parse_entry(GgBuffer entry, GgBuffer *name, uint32_t *level) {
+    *name = (GgBuffer) { 0 };
+    size_t eq;
+    if (gg_buffer_contains(entry, GG_STR("="), &eq)) {
+        if (eq == 0) {
+            return GG_ERR_PARSE;
+        }
+        *name = gg_buffer_substr(entry, 0, eq);
+        entry = gg_buffer_substr(entry, eq + 1, SIZE_MAX);
+    }
+    return parse_level(entry, level);
+}
+
+/// Match a module's tag, or its file name with or without extension.
+static bool module_matches(const GgLogModule *module, GgBuffer name) {
+    if (gg_buffer_eq(name, gg_buffer_from_null_term((char *) module->tag))) {
+        return true;
+    }
+    const char *file = module->file;
+    const char *slash = strrchr(file, '/');
+    if (slash != NULL) {
+        file = &slash[1];
+    }
+    GgBuffer file_buf = gg_buffer_from_null_term((char *) file);
+    if (gg_buffer_eq(name, file_buf)) {
+        return true;
+    }
+    const char *dot = strrchr(file, '.');
+    if (dot == NULL) {
+        return false;
+    }
+    GgBuffer stem = gg_buffer_substr(file_buf, 0, (size_t) (dot - file));
+    return gg_buffer_eq(name, stem);
+}
+
+/// Later entries override earlier ones; unmatched modules print all levels
+/// compiled in.
+static uint32_t module_level(const GgLogModule *module, GgBuffer spec) {
+    uint32_t level = GG_LOG_TRACE;
+    GgBuffer rest = spec;
+    GgBuffer entry;
+    while (next_entry(&rest, &entry)) {
+        GgBuffer name;
+        uint32_t entry_level;
+        if ((entry.len == 0)
+            || (parse_entry(entry, &name, &entry_level) != GG_ERR_OK)) {
+            continue;
+        }
+        if ((name.len == 0) || module_matches(module, name)) {
+            level = entry_level;
+        }
+    }
+    return level;
+}
+
+static GgError store_levels(GgBuffer spec) {
+    GgBuffer rest = spec;
+    GgBuffer entry;
+    while (next_entry(&rest, &entry)) {
+        GgBuffer name;
+        uint32_t level;
+        if ((entry.len != 0)
+            && (parse_entry(entry, &name, &level) != GG_ERR_OK)) {
+            GG_LOGE(
+                "Invalid log level entry \"%.*s\".",
+                (int) entry.len,
+                entry.data
+            );
+            return GG_ERR_PARSE;
+        }
+    }
+    if (spec.len > sizeof(levels_mem)) {
+        GG_LOGE("Log level configuration too long.");
+        return GG_ERR_NOMEM;
+    }
+    if (spec.len > 0) {
+        memcpy(levels_mem, spec.data, spec.len);
+    }
+    levels_spec.len = spec.len;
+    return GG_ERR_OK;
+}
+
+static void apply_levels(GgLogModule *module) {
+    uint32_t level = module_level(module, levels_spec);
+    atomic_store_explicit(&module->max_level, level, memory_order_relaxed);
+}
+
+/// Must be called with levels_mtx held.
+static void load_env_levels(void) {
+    if (levels_env_loaded) {
+        return;
+    }
+    levels_env_loaded = true;
+
+    // NOLINTNEXTLINE(concurrency-mt-unsafe)
+    char *env = getenv("GG_LOG_LEVELS");
+    if (env != NULL) {
+        (void) store_levels(gg_buffer_from_null_term(env));
+    }
+}
+
+void gg_log_register_module(GgLogModule *module) {
+    GG_MTX_SCOPE_GUARD(&levels_mtx);
+    load_env_levels();
+    module->next = log_modules;
+    log_modules = module;
+    apply_levels(module);
+}
+
+GgError gg_log_set_levels(GgBuffer spec) {
+    GG_MTX_SCOPE_GUARD(&levels_mtx);
+    load_env_levels();
+    GgError ret = store_levels(spec);
+    if (ret != GG_ERR_OK) {
+        return ret;
+    }
+    for (GgLogModule *module = log_modules; module != NULL;
+         module = module->next) {
+        apply_levels(module);
+    }
+    return GG_ERR_OK;
+}
+
+#ifdef GG_SDK_TESTING
+
+#include <gg/test.h>
+#include <unity.h>
+
+static GgLogModule test_module = { .tag = "gg-level-test",
+                                   .file = "dir/widget.c",
+                                   .max_level = GG_LOG_LEVEL };
+
+static uint32_t test_module_level(void) {
+    return atomic_load_explicit(&test_module.max_level, memory_order_relaxed);
+}
+
+static int evaluated_count = 0;
+
+static int count_evaluation(void) {
+    evaluated_count += 1;
+    return evaluated_count;
+}
+
+GG_TEST_DEFINE(log_levels_runtime) {
+    gg_log_register_module(&test_module);
+
+    GG_TEST_ASSERT_OK(gg_log_set_levels(GG_STR("warn")));
+    TEST_ASSERT_EQUAL(GG_LOG_WARN, test_module_level());
+
+    // Later entries win; files match with or without extension
+    GG_TEST_ASSERT_OK(gg_log_set_levels(GG_STR("warn,widget=trace")));
+    TEST_ASSERT_EQUAL(GG_LOG_TRACE, test_module_level());
+    GG_TEST_ASSERT_OK(gg_log_set_levels(GG_STR("widget.c=debug,error,")));
+    TEST_ASSERT_EQUAL(GG_LOG_ERROR, test_module_level());
+    GG_TEST_ASSERT_OK(gg_log_set_levels(GG_STR("info,gg-level-test=none")));
+    TEST_ASSERT_EQUAL(GG_LOG_NONE, test_module_level());
+    GG_TEST_ASSERT_OK(gg_log_set_levels(GG_STR("dir/widget=error")));
+    TEST_ASSERT_EQUAL(GG_LOG_TRACE, test_module_level());
+
+    // Invalid configuration is rejected without changing levels
+    GG_TEST_ASSERT_OK(gg_log_set_levels(GG_STR("info")));
+    GG_TEST_ASSERT_BAD(gg_log_set_levels(GG_STR("info,widget=loud")));
+    GG_TEST_ASSERT_BAD(gg_log_set_levels(GG_STR("=debug")));
+    TEST_ASSERT_EQUAL(GG_LOG_INFO, test_module_level());
+
+    // Disabled lines do not evaluate their arguments
+    GG_TEST_ASSERT_OK(gg_log_set_levels(GG_STR("log_level=error")));
+    GG_LOGW("Evaluated %d.", count_evaluation());
+    TEST_ASSERT_EQUAL(0, evaluated_count);
+
+    GG_TEST_ASSERT_OK(gg_log_set_levels(GG_STR("")));
+    TEST_ASSERT_EQUAL(GG_LOG_TRACE, test_module_level());
+}
+
+#endif
@@ -20,6 +20,14 @@ static_assert(
     "GgKV must be at most the size of two GgObjects."
 );
 
+// NOLINTBEGIN(readability-redundant-declaration)
+extern inline typeof(gg_kv_key) gg_kv_key;
+extern inline typeof(gg_kv_val) gg_kv_val;
+// NOLINTEND(readability-redundant-declaration)
+
+// Value is stored at the end of the KV, after the key pointer and length
+#define KV_VAL_OFFSET (sizeof(GgKV) - sizeof(GgObject))
+
 COLD
 static void length_err(size_t *len) {
     GG_LOGE(
@@ -35,24 +43,16 @@ GgKV gg_kv(GgBuffer key, GgObject val) {
     GgKV result = { 0 };
 
     static_assert(
-        sizeof(result._private) >= sizeof(void *) + 2 + sizeof(GgObject),
+        KV_VAL_OFFSET >= sizeof(void *) + 2,
         "GgKV must be able to hold key pointer, 16-bit key length, and value."
     );
 
     gg_kv_set_key(&result, key);
 
-    memcpy(&result._private[sizeof(void *) + 2], &val, sizeof(GgObject));
+    memcpy(&result._private[KV_VAL_OFFSET], &val, sizeof(GgObject));
     return result;
 }
 
-GgBuffer gg_kv_key(GgKV kv) {
-    void *ptr;
-    uint16_t len;
-    memcpy(&ptr, kv._private, sizeof(void *));
-    memcpy(&len, &kv._private[sizeof(void *)], 2);
-    return (GgBuffer) { .data = ptr, .len = len };
-}
-
 void gg_kv_set_key(GgKV *kv, GgBuffer key) {
     if (key.len > UINT16_MAX) {
         length_err(&key.len);
@@ -62,10 +62,6 @@ void gg_kv_set_key(GgKV *kv, GgBuffer key) {
     memcpy(&kv->_private[sizeof(void *)], &key_len, 2);
 }
 
-GgObject *gg_kv_val(GgKV *kv) {
-    return (GgObject *) &kv->_private[sizeof(void *) + 2];
-}
-
 bool gg_map_get(GgMap map, GgBuffer key, GgObject **result) {
     GG_MAP_FOREACH (pair, map) {
         if (gg_buffer_eq(key, gg_kv_key(*pair))) {
@@ -99,66 +95,292 @@ bool gg_map_get_path(GgMap map, GgBufList path, GgObject **result) {
     return gg_map_get(current, path.bufs[path.len - 1], result);
 }
 
-GgError gg_map_validate(GgMap map, GgMapSchema schema) {
-    for (size_t i = 0; i < schema.entry_count; i++) {
-        const GgMapSchemaEntry *entry = &schema.entries[i];
-        GgObject *value;
-        bool found = gg_map_get(map, entry->key, &value);
-        if (!found) {
-            if (entry->required.val == GG_PRESENCE_REQUIRED) {
-                GG_LOGE(
-                    "Map missing required key %.*s.",
-                    (int) entry->key.len,
-                    entry->key.data
-                );
-                return GG_ERR_NOENTRY;
-            }
+// Returns the index of the first pair at or after start whose key is not less
+// than key. Gallops forward so ascending lookups cost O(log distance) each.
+static size_t sorted_lower_bound(GgMap map, size_t start, GgBuffer key) {
+    size_t low = start;
+    size_t high = start;
+    size_t step = 1;
+    while ((high < map.len)
+           && (gg_buffer_cmp(gg_kv_key(map.pairs[high]), key) < 0)) {
+        low = high + 1;
+        high = low + step;
+        step *= 2;
+    }
+    if (high > map.len) {
+        high = map.len;
+    }
 
-            if (entry->required.val == GG_PRESENCE_OPTIONAL) {
-                GG_LOGT(
-                    "Missing optional key %.*s.",
-                    (int) entry->key.len,
-                    entry->key.data
-                );
-            }
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (gg_buffer_cmp(gg_kv_key(map.pairs[mid]), key) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
 
-            if (entry->value != NULL) {
-                *entry->value = NULL;
-            }
-            continue;
+GgError gg_sorted_map(GgMap map, GgSortedMap *result) {
+    if (!gg_map_is_canonical(map)) {
+        return GG_ERR_INVALID;
+    }
+    *result = (GgSortedMap) { .map = map };
+    return GG_ERR_OK;
+}
+
+static GgObject *sorted_map_find(GgMap map, size_t *pos, GgBuffer key) {
+    *pos = sorted_lower_bound(map, *pos, key);
+    if ((*pos < map.len) && gg_buffer_eq(gg_kv_key(map.pairs[*pos]), key)) {
+        return gg_kv_val(&map.pairs[*pos]);
+    }
+    return NULL;
+}
+
+bool gg_sorted_map_get(GgSortedMap map, GgBuffer key, GgObject **result) {
+    size_t pos = 0;
+    GgObject *found = sorted_map_find(map.map, &pos, key);
+    if (result != NULL) {
+        *result = found;
+    }
+    return found != NULL;
+}
+
+static GgError validate_entry(const GgMapSchemaEntry *entry, GgObject *value) {
+    if (value == NULL) {
+        if (entry->required.val == GG_PRESENCE_REQUIRED) {
+            GG_LOGE(
+                "Map missing required key %.*s.",
+                (int) entry->key.len,
+                entry->key.data
+            );
+            return GG_ERR_NOENTRY;
         }
 
-        GG_LOGT(
-            "Found key %.*s with len %zu",
+        if (entry->required.val == GG_PRESENCE_OPTIONAL) {
+            GG_LOGT(
+                "Missing optional key %.*s.",
+                (int) entry->key.len,
+                entry->key.data
+            );
+        }
+
+        if (entry->value != NULL) {
+            *entry->value = NULL;
+        }
+        return GG_ERR_OK;
+    }
+
+    GG_LOGT(
+        "Found key %.*s with len %zu",
+        (int) entry->key.len,
+        entry->key.data,
+        entry->key.len
+    );
+
+    if (entry->required.val == GG_PRESENCE_MISSING) {
+        GG_LOGE(
+            "Map has required missing key %.*s.",
             (int) entry->key.len,
-            entry->key.data,
-            entry->key.len
+            entry->key.data
         );
+        return GG_ERR_PARSE;
+    }
 
-        if (entry->required.val == GG_PRESENCE_MISSING) {
+    if (entry->type != GG_TYPE_NULL) {
+        if (entry->type != gg_obj_type(*value)) {
             GG_LOGE(
-                "Map has required missing key %.*s.",
+                "Key %.*s is of invalid type.",
                 (int) entry->key.len,
                 entry->key.data
             );
             return GG_ERR_PARSE;
         }
+    }
 
-        if (entry->type != GG_TYPE_NULL) {
-            if (entry->type != gg_obj_type(*value)) {
-                GG_LOGE(
-                    "Key %.*s is of invalid type.",
-                    (int) entry->key.len,
-                    entry->key.data
-                );
-                return GG_ERR_PARSE;
-            }
+    if (entry->value != NULL) {
+        *entry->value = value;
+    }
+    return GG_ERR_OK;
+}
+
+GgError gg_sorted_map_validate(GgSortedMap map, GgMapSchema schema) {
+    size_t pos = 0;
+    for (size_t i = 0; i < schema.entry_count; i++) {
+        const GgMapSchemaEntry *entry = &schema.entries[i];
+        // Restart the merge if the schema is not in canonical order here
+        if ((i > 0)
+            && (gg_buffer_cmp(entry->key, schema.entries[i - 1].key) < 0)) {
+            pos = 0;
+        }
+        GgError ret
+            = validate_entry(entry, sorted_map_find(map.map, &pos, entry->key));
+        if (ret != GG_ERR_OK) {
+            return ret;
         }
+    }
+    return GG_ERR_OK;
+}
 
-        if (entry->value != NULL) {
-            *entry->value = value;
+GgError gg_map_validate(GgMap map, GgMapSchema schema) {
+    for (size_t i = 0; i < schema.entry_count; i++) {
+        const GgMapSchemaEntry *entry = &schema.entries[i];
+        GgObject *value;
+        (void) gg_map_get(map, entry->key, &value);
+        GgError ret = validate_entry(entry, value);
+        if (ret != GG_ERR_OK) {
+            return ret;
         }
     }
 
     return GG_ERR_OK;
 }
+
+#ifdef GG_SDK_TESTING
+
+#include <gg/test.h>
+#include <unity.h>
+
+GG_TEST_DEFINE(buffer_cmp) {
+    TEST_ASSERT(gg_buffer_cmp(GG_STR("a"), GG_STR("b")) < 0);
+    TEST_ASSERT(gg_buffer_cmp(GG_STR("b"), GG_STR("a")) > 0);
+    TEST_ASSERT(gg_buffer_cmp(GG_STR("abc"), GG_STR("abcd")) < 0);
+    TEST_ASSERT(gg_buffer_cmp(GG_STR("abcd"), GG_STR("abc")) > 0);
+    TEST_ASSERT(gg_buffer_cmp(GG_STR(""), GG_STR("a")) < 0);
+    TEST_ASSERT_EQUAL(0, gg_buffer_cmp(GG_STR("abc"), GG_STR("abc")));
+    TEST_ASSERT_EQUAL(0, gg_buffer_cmp(GG_STR(""), GG_STR("")));
+    TEST_ASSERT(gg_buffer_cmp(GG_STR("\x7F"), GG_STR("\x80")) < 0);
+}
+
+GG_TEST_DEFINE(sorted_map_get) {
+    GgMap map = GG_MAP(
+        gg_kv(GG_STR(""), gg_obj_i64(0)),
+        gg_kv(GG_STR("a"), gg_obj_i64(1)),
+        gg_kv(GG_STR("ab"), gg_obj_i64(2)),
+        gg_kv(GG_STR("b"), gg_obj_i64(3)),
+        gg_kv(GG_STR("c"), gg_obj_i64(4)),
+    );
+    GgSortedMap sorted;
+    GG_TEST_ASSERT_OK(gg_sorted_map(map, &sorted));
+
+    const char *keys[] = { "", "a", "ab", "b", "c" };
+    for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++) {
+        GgObject *value;
+        TEST_ASSERT(gg_sorted_map_get(
+            sorted, gg_buffer_from_null_term((char *) keys[i]), &value
+        ));
+        TEST_ASSERT(value == gg_kv_val(&map.pairs[i]));
+    }
+
+    GgObject *value = gg_kv_val(&map.pairs[0]);
+    TEST_ASSERT_FALSE(gg_sorted_map_get(sorted, GG_STR("aa"), &value));
+    TEST_ASSERT_NULL(value);
+    TEST_ASSERT_FALSE(gg_sorted_map_get(sorted, GG_STR("d"), NULL));
+    TEST_ASSERT_FALSE(
+        gg_sorted_map_get((GgSortedMap) { 0 }, GG_STR("a"), NULL)
+    );
+
+    GG_TEST_ASSERT_BAD(gg_sorted_map(
+        GG_MAP(
+            gg_kv(GG_STR("b"), GG_OBJ_NULL), gg_kv(GG_STR("a"), GG_OBJ_NULL)
+        ),
+        &sorted
+    ));
+}
+
+GG_TEST_DEFINE(sorted_map_validate) {
+    GgMap map = GG_MAP(
+        gg_kv(GG_STR("a"), gg_obj_i64(1)),
+        gg_kv(GG_STR("b"), gg_obj_buf(GG_STR("x"))),
+        gg_kv(GG_STR("d"), gg_obj_bool(true)),
+        gg_kv(GG_STR("e"), GG_OBJ_NULL),
+    );
+    GgSortedMap sorted;
+    GG_TEST_ASSERT_OK(gg_sorted_map(map, &sorted));
+
+    GgObject *a = NULL;
+    GgObject *c = gg_kv_val(&map.pairs[0]);
+    GgObject *d = NULL;
+    GgObject *e = NULL;
+    GgMapSchema schema = GG_MAP_SCHEMA(
+        { GG_STR("a"), GG_REQUIRED, GG_TYPE_I64, &a },
+        { GG_STR("c"), GG_OPTIONAL, GG_TYPE_I64, &c },
+        { GG_STR("d"), GG_REQUIRED, GG_TYPE_BOOLEAN, &d },
+        { GG_STR("e"), GG_OPTIONAL, GG_TYPE_NULL, &e },
+    );
+    GG_TEST_ASSERT_OK(gg_sorted_map_validate(sorted, schema));
+    TEST_ASSERT(a == gg_kv_val(&map.pairs[0]));
+    TEST_ASSERT_NULL(c);
+    TEST_ASSERT(d == gg_kv_val(&map.pairs[2]));
+    TEST_ASSERT(e == gg_kv_val(&map.pairs[3]));
+
+    // Schema entries out of canonical order
+    GgObject *b = NULL;
+    a = NULL;
+    d = NULL;
+    GG_TEST_ASSERT_OK(gg_sorted_map_validate(
+        sorted,
+        GG_MAP_SCHEMA(
+            { GG_STR("d"), GG_REQUIRED, GG_TYPE_BOOLEAN, &d },
+            { GG_STR("b"), GG_REQUIRED, GG_TYPE_BUF, &b },
+            { GG_STR("a"), GG_REQUIRED, GG_TYPE_I64, &a },
+            { GG_STR("a"), GG_REQUIRED, GG_TYPE_I64, NULL },
+        )
+    ));
+    TEST_ASSERT(a == gg_kv_val(&map.pairs[0]));
+    TEST_ASSERT(b == gg_kv_val(&map.pairs[1]));
+    TEST_ASSERT(d == gg_kv_val(&map.pairs[2]));
+
+    TEST_ASSERT_EQUAL(
+        GG_ERR_NOENTRY,
+        gg_sorted_map_validate(
+            sorted,
+            GG_MAP_SCHEMA({ GG_STR("c"), GG_REQUIRED, GG_TYPE_NULL, NULL }, )
+        )
+    );
+    TEST_ASSERT_EQUAL(
+        GG_ERR_PARSE,
+        gg_sorted_map_validate(
+            sorted,
+            GG_MAP_SCHEMA({ GG_STR("b"), GG_REQUIRED, GG_TYPE_I64, NULL }, )
+        )
+    );
+    TEST_ASSERT_EQUAL(
+        GG_ERR_PARSE,
+        gg_sorted_map_validate(
+            sorted,
+            GG_MAP_SCHEMA({ GG_STR("e"), GG_MISSING, GG_TYPE_NULL, NULL }, )
+        )
+    );
+}
+
+GG_TEST_DEFINE(map_validate_unsorted) {
+    // Non-canonical maps use the first occurrence of a key
+    GgMap map = GG_MAP(
+        gg_kv(GG_STR("b"), gg_obj_i64(1)),
+        gg_kv(GG_STR("a"), gg_obj_i64(2)),
+        gg_kv(GG_STR("b"), gg_obj_i64(3)),
+    );
+    GgObject *a = NULL;
+    GgObject *b = NULL;
+    GG_TEST_ASSERT_OK(gg_map_validate(
+        map,
+        GG_MAP_SCHEMA(
+            { GG_STR("a"), GG_REQUIRED, GG_TYPE_I64, &a },
+            { GG_STR("b"), GG_REQUIRED, GG_TYPE_I64, &b },
+        )
+    ));
+    TEST_ASSERT(a == gg_kv_val(&map.pairs[1]));
+    TEST_ASSERT(b == gg_kv_val(&map.pairs[0]));
+
+    TEST_ASSERT_EQUAL(
+        GG_ERR_NOENTRY,
+        gg_map_validate(
+            map,
+            GG_MAP_SCHEMA({ GG_STR("c"), GG_REQUIRED, GG_TYPE_NULL, NULL }, )
+        )
+    );
+}
+
+#endif
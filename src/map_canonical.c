@@ -1,70 +1,187 @@
 #include "gg/map.h"
+#include <gg/buffer.h>
 #include <gg/log.h>
+#include <gg/object.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
-static void swap_pairs(GgKV *lhs, GgKV *rhs) {
-    GgKV temp = *lhs;
-    *lhs = *rhs;
-    *rhs = temp;
-}
+// Pairs of scratch space for merging; longer runs are merged by rotation
+#define SORT_BUFFER_PAIRS 64
+// Runs at most this long are insertion sorted before merging
+#define SORT_RUN_LEN 8
 
 static bool is_key_less(GgKV lhs, GgKV rhs) {
-    GgBuffer lhs_buf = gg_kv_key(lhs);
-    GgBuffer rhs_buf = gg_kv_key(rhs);
+    return gg_buffer_cmp(gg_kv_key(lhs), gg_kv_key(rhs)) < 0;
+}
 
-    size_t len = lhs_buf.len > rhs_buf.len ? rhs_buf.len : lhs_buf.len;
-    for (size_t i = 0; i != len; ++i) {
-        if (lhs_buf.data[i] < rhs_buf.data[i]) {
-            return true;
-        }
-        if (rhs_buf.data[i] < lhs_buf.data[i]) {
-            return false;
+static void insertion_sort(GgKV *pairs, size_t len) {
+    for (size_t i = 1; i < len; ++i) {
+        GgKV pair = pairs[i];
+        size_t j = i;
+        while ((j > 0) && is_key_less(pair, pairs[j - 1])) {
+            pairs[j] = pairs[j - 1];
+            --j;
         }
+        pairs[j] = pair;
     }
+}
 
-    return lhs_buf.len < rhs_buf.len;
+// First index in sorted pairs whose key is not less than pair's.
+static size_t lower_bound(const GgKV *pairs, size_t len, GgKV pair) {
+    size_t low = 0;
+    while (low < len) {
+        size_t mid = low + (len - low) / 2;
+        if (is_key_less(pairs[mid], pair)) {
+            low = mid + 1;
+        } else {
+            len = mid;
+        }
+    }
+    return low;
 }
 
-static void prune_duplicates(GgMap *val) {
-    // The last occurrence of a key must be a duplicate
-    // if the first occurrence of that key appears elsewhere.
-    for (size_t i = val->len; i > 0; --i) {
-        GgKV *pair = &val->pairs[i - 1];
-        GgObject *last = gg_kv_val(pair);
-        GgObject *first = NULL;
-        (void) gg_map_get(*val, gg_kv_key(*pair), &first);
-        if (first == last) {
-            continue;
+// First index in sorted pairs whose key is greater than pair's.
+static size_t upper_bound(const GgKV *pairs, size_t len, GgKV pair) {
+    size_t low = 0;
+    while (low < len) {
+        size_t mid = low + (len - low) / 2;
+        if (is_key_less(pair, pairs[mid])) {
+            len = mid;
+        } else {
+            low = mid + 1;
         }
+    }
+    return low;
+}
 
-        GG_LOGW(
-            "Duplicate key \"%.*s\" found in map",
-            (int) gg_kv_key(*pair).len,
-            gg_kv_key(*pair).data
-        );
+static void reverse(GgKV *pairs, size_t len) {
+    for (size_t i = 0; i < len / 2; ++i) {
+        GgKV tmp = pairs[i];
+        pairs[i] = pairs[len - 1 - i];
+        pairs[len - 1 - i] = tmp;
+    }
+}
+
+// Swaps the ranges [0, mid) and [mid, len) of pairs.
+static void rotate(GgKV *pairs, size_t mid, size_t len) {
+    reverse(pairs, mid);
+    reverse(&pairs[mid], len - mid);
+    reverse(pairs, len);
+}
 
-        if (i != val->len) {
-            *pair = val->pairs[val->len - 1];
+// Stable merge of the sorted ranges [0, mid) and [mid, len) of pairs.
+// Ranges too long for the buffer are split and rotated until they fit, so
+// this never allocates.
+static void merge_runs(GgKV *pairs, size_t mid, size_t len, GgKV *buffer) {
+    if ((mid == 0) || (mid == len)
+        || !is_key_less(pairs[mid], pairs[mid - 1])) {
+        return;
+    }
+
+    if (mid <= SORT_BUFFER_PAIRS) {
+        memcpy(buffer, pairs, mid * sizeof(GgKV));
+        size_t left = 0;
+        size_t right = mid;
+        size_t out = 0;
+        while ((left < mid) && (right < len)) {
+            if (is_key_less(pairs[right], buffer[left])) {
+                pairs[out++] = pairs[right++];
+            } else {
+                pairs[out++] = buffer[left++];
+            }
+        }
+        memcpy(&pairs[out], &buffer[left], (mid - left) * sizeof(GgKV));
+        return;
+    }
+
+    if (len - mid <= SORT_BUFFER_PAIRS) {
+        memcpy(buffer, &pairs[mid], (len - mid) * sizeof(GgKV));
+        size_t left = mid;
+        size_t right = len - mid;
+        size_t out = len;
+        while ((left > 0) && (right > 0)) {
+            if (is_key_less(buffer[right - 1], pairs[left - 1])) {
+                pairs[--out] = pairs[--left];
+            } else {
+                pairs[--out] = buffer[--right];
+            }
         }
-        gg_kv_set_key(&val->pairs[val->len - 1], GG_STR("<pruned>"));
-        *gg_kv_val(&val->pairs[val->len - 1]) = GG_OBJ_NULL;
-        val->len--;
+        memcpy(&pairs[out - right], buffer, right * sizeof(GgKV));
+        return;
     }
+
+    // Split the longer range in half, and the other where its middle pair
+    // would go, keeping equal keys in their original order
+    size_t left_cut;
+    size_t right_cut;
+    if (mid >= len - mid) {
+        left_cut = mid / 2;
+        right_cut = mid
+            + lower_bound(&pairs[mid], len - mid, pairs[left_cut]);
+    } else {
+        right_cut = mid + (len - mid) / 2;
+        left_cut = upper_bound(pairs, mid, pairs[right_cut]);
+    }
+    rotate(&pairs[left_cut], mid - left_cut, right_cut - left_cut);
+    size_t new_mid = left_cut + (right_cut - mid);
+    merge_runs(pairs, left_cut, new_mid, buffer);
+    merge_runs(
+        &pairs[new_mid], right_cut - new_mid, len - new_mid, buffer
+    );
 }
 
+// Bottom-up stable merge sort.
 static void sort_keys(GgMap *val) {
-    // insertion sort
-    for (size_t i = 0; i < val->len; ++i) {
-        size_t j = i;
-        while ((j > 0) && (is_key_less(val->pairs[j], val->pairs[j - 1]))) {
-            swap_pairs(&val->pairs[j], &val->pairs[j - 1]);
-            --j;
+    GgKV *pairs = val->pairs;
+    size_t len = val->len;
+    for (size_t i = 0; i < len; i += SORT_RUN_LEN) {
+        size_t run = len - i < SORT_RUN_LEN ? len - i : SORT_RUN_LEN;
+        insertion_sort(&pairs[i], run);
+    }
+    if (len <= SORT_RUN_LEN) {
+        return;
+    }
+
+    GgKV buffer[SORT_BUFFER_PAIRS];
+    for (size_t width = SORT_RUN_LEN; width < len; width *= 2) {
+        for (size_t i = 0; i + width < len; i += 2 * width) {
+            size_t end = len - i < 2 * width ? len - i : 2 * width;
+            merge_runs(&pairs[i], width, end, buffer);
+        }
+    }
+}
+
+// Requires that the map is sorted. Keeps the first of each run of equal keys.
+static void prune_duplicates(GgMap *val) {
+    if (val->len == 0) {
+        return;
+    }
+
+    size_t kept = 1;
+    for (size_t i = 1; i < val->len; ++i) {
+        GgBuffer key = gg_kv_key(val->pairs[i]);
+        if (gg_buffer_eq(key, gg_kv_key(val->pairs[kept - 1]))) {
+            GG_LOGW(
+                "Duplicate key \"%.*s\" found in map", (int) key.len, key.data
+            );
+            continue;
         }
+        val->pairs[kept++] = val->pairs[i];
+    }
+
+    for (size_t i = kept; i < val->len; ++i) {
+        gg_kv_set_key(&val->pairs[i], GG_STR("<pruned>"));
+        *gg_kv_val(&val->pairs[i]) = GG_OBJ_NULL;
     }
+    val->len = kept;
 }
 
 void gg_map_canonicalize_shallow(GgMap *map) {
-    prune_duplicates(map);
+    // Stable sort keeps the first occurrence of a key first among duplicates
     sort_keys(map);
+    prune_duplicates(map);
 }
 
 bool gg_map_is_canonical(GgMap map) {
@@ -149,15 +266,6 @@ GG_TEST_DEFINE(map_prune_duplicates) {
             gg_kv(GG_STR("c"), gg_obj_i64(2))
         )
     );
-    GG_TEST_PRUNE_DUPLICATES(
-        identity,
-        GG_MAP(
-            gg_kv(GG_STR("a"), gg_obj_i64(3)),
-            gg_kv(GG_STR("b"), gg_obj_f64(1.0)),
-            gg_kv(GG_STR("c"), gg_obj_bool(false)),
-            gg_kv(GG_STR("b"), gg_obj_i64(2))
-        )
-    );
     GG_TEST_PRUNE_DUPLICATES(
         identity,
         GG_MAP(
@@ -168,16 +276,12 @@ GG_TEST_DEFINE(map_prune_duplicates) {
         )
     );
 
-    GgMap unstable = GG_MAP(
-        gg_kv(GG_STR("a"), gg_obj_i64(3)),
-        gg_kv(GG_STR("c"), gg_obj_bool(false)),
-        gg_kv(GG_STR("b"), gg_obj_f64(1.0)),
-    );
     GG_TEST_PRUNE_DUPLICATES(
-        unstable,
+        identity,
         GG_MAP(
             gg_kv(GG_STR("a"), gg_obj_i64(3)),
             gg_kv(GG_STR("a"), gg_obj_i64(2)),
+            gg_kv(GG_STR("a"), gg_obj_i64(1)),
             gg_kv(GG_STR("b"), gg_obj_f64(1.0)),
             gg_kv(GG_STR("c"), gg_obj_bool(false)),
         )
@@ -319,4 +423,66 @@ GG_TEST_DEFINE(map_canonicalize) {
         )
     );
 }
+
+GG_TEST_DEFINE(map_canonicalize_large) {
+    // Enough keys to merge by rotation; each key appears three times
+    static char keys[300][4];
+    static GgKV pairs[900];
+    for (size_t i = 0; i < 300; i++) {
+        keys[i][0] = (char) ('a' + (i * 7 % 300) / 100);
+        keys[i][1] = (char) ('0' + (i * 7 % 100) / 10);
+        keys[i][2] = (char) ('0' + (i * 7 % 10));
+        keys[i][3] = '\0';
+    }
+    for (size_t i = 0; i < 900; i++) {
+        size_t key = 299 - i % 300;
+        pairs[i] = gg_kv(
+            (GgBuffer) { .data = (uint8_t *) keys[key], .len = 3 },
+            gg_obj_i64((int64_t) i)
+        );
+    }
+
+    GgMap map = { .pairs = pairs, .len = 900 };
+    gg_map_canonicalize_shallow(&map);
+    TEST_ASSERT_EQUAL(300, map.len);
+    TEST_ASSERT(gg_map_is_canonical(map));
+    GG_MAP_FOREACH (pair, map) {
+        // First occurrence of each key is within the first 300 pairs
+        TEST_ASSERT(gg_obj_into_i64(*gg_kv_val(pair)) < 300);
+    }
+    TEST_ASSERT(gg_buffer_eq(GG_STR("<pruned>"), gg_kv_key(pairs[899])));
+}
+
+GG_TEST_DEFINE(map_sort_large_stable) {
+    // Keys repeat in a scrambled order; values record original positions
+    static char keys[97][3];
+    static GgKV pairs[2000];
+    for (size_t i = 0; i < 97; i++) {
+        keys[i][0] = (char) ('a' + i / 10);
+        keys[i][1] = (char) ('0' + i % 10);
+        keys[i][2] = '\0';
+    }
+    uint32_t state = 1;
+    for (size_t i = 0; i < 2000; i++) {
+        state = state * 1103515245U + 12345U;
+        size_t key = (state >> 16) % 97;
+        pairs[i] = gg_kv(
+            (GgBuffer) { .data = (uint8_t *) keys[key], .len = 2 },
+            gg_obj_i64((int64_t) i)
+        );
+    }
+
+    GgMap map = { .pairs = pairs, .len = 2000 };
+    sort_keys(&map);
+    for (size_t i = 1; i < 2000; i++) {
+        TEST_ASSERT_FALSE(is_key_less(pairs[i], pairs[i - 1]));
+        if (!is_key_less(pairs[i - 1], pairs[i])) {
+            // Equal keys keep their original order
+            TEST_ASSERT_LESS_THAN(
+                gg_obj_into_i64(*gg_kv_val(&pairs[i])),
+                gg_obj_into_i64(*gg_kv_val(&pairs[i - 1]))
+            );
+        }
+    }
+}
 #endif
@@ -0,0 +1,133 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gg/arena.h>
+#include <gg/buffer.h>
+#include <gg/error.h>
+#include <gg/log.h>
+#include <gg/map.h>
+#include <gg/map_soa.h>
+#include <gg/object.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+GgError gg_map_soa_from_map(GgMap map, GgArena *arena, GgMapSoa *result) {
+    if (map.len > UINT16_MAX) {
+        GG_LOGE("Map too long to convert to struct-of-arrays form.");
+        return GG_ERR_RANGE;
+    }
+
+    // Only commit allocations if all succeed
+    GgArena arena_copy = *arena;
+    uint16_t *key_lens = GG_ARENA_ALLOCN(&arena_copy, uint16_t, map.len);
+    uint8_t **keys = GG_ARENA_ALLOCN(&arena_copy, uint8_t *, map.len);
+    GgObject *values = GG_ARENA_ALLOCN(&arena_copy, GgObject, map.len);
+    if ((map.len > 0)
+        && ((key_lens == NULL) || (keys == NULL) || (values == NULL))) {
+        GG_LOGE("Insufficient memory to convert map to struct-of-arrays.");
+        return GG_ERR_NOMEM;
+    }
+    *arena = arena_copy;
+
+    for (size_t i = 0; i < map.len; i++) {
+        GgBuffer key = gg_kv_key(map.pairs[i]);
+        key_lens[i] = (uint16_t) key.len;
+        keys[i] = key.data;
+        values[i] = *gg_kv_val(&map.pairs[i]);
+    }
+
+    *result = (GgMapSoa) {
+        .key_lens = key_lens,
+        .keys = keys,
+        .values = values,
+        .len = map.len,
+    };
+    return GG_ERR_OK;
+}
+
+GgError gg_map_soa_to_map(GgMapSoa map, GgArena *arena, GgMap *result) {
+    GgKV *pairs = GG_ARENA_ALLOCN(arena, GgKV, map.len);
+    if ((map.len > 0) && (pairs == NULL)) {
+        GG_LOGE("Insufficient memory to convert struct-of-arrays to map.");
+        return GG_ERR_NOMEM;
+    }
+
+    for (size_t i = 0; i < map.len; i++) {
+        pairs[i] = gg_kv(
+            (GgBuffer) { .data = map.keys[i], .len = map.key_lens[i] },
+            map.values[i]
+        );
+    }
+
+    *result = (GgMap) { .pairs = pairs, .len = map.len };
+    return GG_ERR_OK;
+}
+
+bool gg_map_soa_get(GgMapSoa map, GgBuffer key, GgObject **result) {
+    if (key.len <= UINT16_MAX) {
+        for (size_t i = 0; i < map.len; i++) {
+            if ((map.key_lens[i] == key.len)
+                && ((key.len == 0)
+                    || (memcmp(map.keys[i], key.data, key.len) == 0))) {
+                if (result != NULL) {
+                    *result = &map.values[i];
+                }
+                return true;
+            }
+        }
+    }
+    if (result != NULL) {
+        *result = NULL;
+    }
+    return false;
+}
+
+#ifdef GG_SDK_TESTING
+
+#include <gg/object_compare.h>
+#include <gg/test.h>
+#include <unity.h>
+
+GG_TEST_DEFINE(map_soa_round_trip) {
+    GgMap map = GG_MAP(
+        gg_kv(GG_STR("b"), gg_obj_i64(1)),
+        gg_kv(GG_STR(""), gg_obj_bool(true)),
+        gg_kv(GG_STR("abc"), gg_obj_buf(GG_STR("x"))),
+        gg_kv(GG_STR("abd"), gg_obj_list(GG_LIST(GG_OBJ_NULL))),
+        gg_kv(GG_STR("b"), gg_obj_i64(2)),
+    );
+
+    uint8_t mem[512];
+    GgArena arena = gg_arena_init(GG_BUF(mem));
+    GgMapSoa soa;
+    GG_TEST_ASSERT_OK(gg_map_soa_from_map(map, &arena, &soa));
+    TEST_ASSERT_EQUAL(5, soa.len);
+
+    GG_MAP_FOREACH (pair, map) {
+        GgObject *value;
+        TEST_ASSERT(gg_map_soa_get(soa, gg_kv_key(*pair), &value));
+        GgObject *expected;
+        TEST_ASSERT(gg_map_get(map, gg_kv_key(*pair), &expected));
+        TEST_ASSERT(gg_obj_eq(*expected, *value));
+    }
+    GgObject *value = &soa.values[0];
+    TEST_ASSERT_FALSE(gg_map_soa_get(soa, GG_STR("ab"), &value));
+    TEST_ASSERT_NULL(value);
+    TEST_ASSERT_FALSE(gg_map_soa_get(soa, GG_STR("abe"), NULL));
+
+    GgMap back;
+    GG_TEST_ASSERT_OK(gg_map_soa_to_map(soa, &arena, &back));
+    gg_test_assert_map_equal(map, back, NULL, __LINE__);
+
+    GgArena small = gg_arena_init((GgBuffer) { .data = mem, .len = 8 });
+    GgMapSoa soa_small;
+    TEST_ASSERT_EQUAL(
+        GG_ERR_NOMEM, gg_map_soa_from_map(map, &small, &soa_small)
+    );
+    TEST_ASSERT_EQUAL(0, small.index);
+}
+
+#endif
@@ -3,24 +3,28 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <assert.h>
+#include <gg/alloc.h>
 #include <gg/error.h>
 #include <gg/log.h>
 #include <gg/map.h>
 #include <gg/object.h>
-#include <gg/object_iter.h>
 #include <gg/object_visit.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
-static_assert(
-    GG_MAX_OBJECT_DEPTH <= UINT8_MAX,
-    "GG_MAX_OBJECT_DEPTH must fit in a uint8_t."
-);
-static_assert(
-    GG_MAX_OBJECT_SUBOBJECTS <= UINT8_MAX,
-    "GG_MAX_OBJECT_SUBOBJECTS must fit in a uint8_t."
-);
+typedef enum {
+    LEVEL_DEFAULT,
+    LEVEL_LIST,
+    LEVEL_MAP,
+} VisitLevelState;
+
+typedef struct {
+    GgObject *obj;
+    // List and map lengths are limited to UINT16_MAX
+    uint16_t elem_index;
+    uint8_t state;
+} VisitLevel;
 
 #define TRY_HANDLER(name, ...) \
     if (handlers->name != NULL) { \
@@ -31,26 +35,24 @@ static_assert(
     }
 
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
-GgError gg_obj_visit(
+static GgError visit_levels(
     const GgObjectVisitHandlers handlers[static 1],
     void *ctx,
-    GgObject obj[static 1]
+    GgObject obj[static 1],
+    GgObjectLimits limits,
+    VisitLevel levels[static 1]
 ) {
-    IterLevels state;
-
-    state.index = 0;
-    state.obj[0] = obj;
-    state.state[0] = LEVEL_DEFAULT;
-    state.elem_index[0] = 0;
+    size_t index = 0;
+    levels[0] = (VisitLevel) { .obj = obj, .state = LEVEL_DEFAULT };
 
-    uint8_t subobjects = 0;
+    size_t subobjects = 0;
 
     while (true) {
-        GgObject *cur_obj = state.obj[state.index];
-        IterLevelState cur_state = state.state[state.index];
-        uint8_t cur_index = state.elem_index[state.index];
+        VisitLevel *level = &levels[index];
+        GgObject *cur_obj = level->obj;
+        size_t cur_index = level->elem_index;
 
-        switch (cur_state) {
+        switch ((VisitLevelState) level->state) {
         case LEVEL_DEFAULT: {
             switch (gg_obj_type(*cur_obj)) {
             case GG_TYPE_NULL:
@@ -70,26 +72,26 @@ GgError gg_obj_visit(
                 break;
             case GG_TYPE_LIST: {
                 GgList list = gg_obj_into_list(*cur_obj);
-                if (list.len > GG_MAX_OBJECT_SUBOBJECTS - subobjects) {
+                if (list.len > limits.max_subobjects - subobjects) {
                     GG_LOGE("Visited object's subobjects exceeds maximum.");
                     return GG_ERR_RANGE;
                 }
-                subobjects += (uint8_t) list.len;
+                subobjects += list.len;
 
                 TRY_HANDLER(on_list, ctx, list, cur_obj);
-                state.state[state.index] = LEVEL_LIST;
+                level->state = LEVEL_LIST;
                 continue;
             }
             case GG_TYPE_MAP: {
                 GgMap map = gg_obj_into_map(*cur_obj);
-                if (map.len > (GG_MAX_OBJECT_SUBOBJECTS - subobjects) / 2) {
+                if (map.len > (limits.max_subobjects - subobjects) / 2) {
                     GG_LOGE("Visited object's subobjects exceeds maximum.");
                     return GG_ERR_RANGE;
                 }
-                subobjects += (uint8_t) (map.len * 2);
+                subobjects += map.len * 2;
 
                 TRY_HANDLER(on_map, ctx, gg_obj_into_map(*cur_obj), cur_obj);
-                state.state[state.index] = LEVEL_MAP;
+                level->state = LEVEL_MAP;
                 continue;
             }
             }
@@ -105,17 +107,15 @@ GgError gg_obj_visit(
                 TRY_HANDLER(cont_list, ctx);
             }
 
-            state.index += 1;
-            if (state.index == GG_MAX_OBJECT_DEPTH) {
+            if (index + 1 == limits.max_depth) {
                 GG_LOGE("Visited object's depth exceeds maximum.");
                 return GG_ERR_RANGE;
             }
 
-            state.obj[state.index] = &list.items[cur_index];
-            state.state[state.index] = LEVEL_DEFAULT;
-            state.elem_index[state.index] = 0;
-
-            state.elem_index[state.index - 1] += 1;
+            level->elem_index += 1;
+            index += 1;
+            levels[index] = (VisitLevel) { .obj = &list.items[cur_index],
+                                           .state = LEVEL_DEFAULT };
             continue;
         }
         case LEVEL_MAP: {
@@ -132,27 +132,72 @@ GgError gg_obj_visit(
             GgKV *kv = &map.pairs[cur_index];
             TRY_HANDLER(on_map_key, ctx, gg_kv_key(*kv), kv);
 
-            state.index += 1;
-            if (state.index == GG_MAX_OBJECT_DEPTH) {
+            if (index + 1 == limits.max_depth) {
                 GG_LOGE("Visited object's depth exceeds maximum.");
                 return GG_ERR_RANGE;
             }
 
-            state.obj[state.index] = gg_kv_val(kv);
-            state.state[state.index] = LEVEL_DEFAULT;
-            state.elem_index[state.index] = 0;
-
-            state.elem_index[state.index - 1] += 1;
+            level->elem_index += 1;
+            index += 1;
+            levels[index]
+                = (VisitLevel) { .obj = gg_kv_val(kv), .state = LEVEL_DEFAULT };
             continue;
         }
         }
 
-        if (state.index == 0) {
+        if (index == 0) {
             break;
         }
 
-        state.index -= 1;
+        index -= 1;
     }
 
     return GG_ERR_OK;
 }
+
+GgError gg_obj_visit(
+    const GgObjectVisitHandlers handlers[static 1],
+    void *ctx,
+    GgObject obj[static 1]
+) {
+    return gg_obj_visit_with_limits(
+        handlers, ctx, obj, GG_OBJECT_LIMITS_DEFAULT
+    );
+}
+
+GgError gg_obj_visit_with_limits(
+    const GgObjectVisitHandlers handlers[static 1],
+    void *ctx,
+    GgObject obj[static 1],
+    GgObjectLimits limits
+) {
+    if (limits.max_depth == 0) {
+        GG_LOGE("Object depth limit must be at least 1.");
+        return GG_ERR_INVALID;
+    }
+
+    // Depth is bounded by subobject count, so avoid over-allocating
+    if (limits.max_depth - 1 > limits.max_subobjects) {
+        limits.max_depth = limits.max_subobjects + 1;
+    }
+
+    if (limits.max_depth <= GG_MAX_OBJECT_DEPTH) {
+        VisitLevel levels[GG_MAX_OBJECT_DEPTH];
+        return visit_levels(handlers, ctx, obj, limits, levels);
+    }
+
+    if (limits.max_depth > SIZE_MAX / sizeof(VisitLevel)) {
+        GG_LOGE("Object depth limit too large.");
+        return GG_ERR_NOMEM;
+    }
+
+    GgAlloc alloc = gg_libc_alloc();
+    VisitLevel *levels = GG_ALLOCN(alloc, VisitLevel, limits.max_depth);
+    if (levels == NULL) {
+        GG_LOGE("Failed to allocate object traversal state.");
+        return GG_ERR_NOMEM;
+    }
+    GgError ret = visit_levels(handlers, ctx, obj, limits, levels);
+    gg_free(alloc, levels);
+    return ret;
+}
@@ -0,0 +1,142 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gg/alloc.h>
+#include <gg/arena.h>
+#include <gg/arena_chain.h>
+#include <gg/error.h>
+#include <gg/log.h>
+#include <gg/scratch.h>
+#include <pthread.h>
+#include <string.h>
+#include <stddef.h>
+
+static pthread_key_t scratch_key;
+static pthread_once_t scratch_key_once = PTHREAD_ONCE_INIT;
+static int scratch_key_err = 0;
+
+static void free_thread_scratch(void *ptr) {
+    GgChainArena *chain = ptr;
+    GgAlloc alloc = gg_libc_alloc();
+    gg_chain_arena_free(chain);
+    gg_free(alloc, chain);
+}
+
+static void init_scratch_key(void) {
+    scratch_key_err = pthread_key_create(&scratch_key, free_thread_scratch);
+}
+
+static GgChainArena *thread_scratch(void) {
+    pthread_once(&scratch_key_once, init_scratch_key);
+    if (scratch_key_err != 0) {
+        GG_LOGE("Failed to create scratch arena thread key.");
+        return NULL;
+    }
+
+    GgChainArena *chain = pthread_getspecific(scratch_key);
+    if (chain != NULL) {
+        return chain;
+    }
+
+    GgAlloc alloc = gg_libc_alloc();
+    chain = GG_ALLOC(alloc, GgChainArena);
+    if (chain == NULL) {
+        return NULL;
+    }
+    // GgChainArena has const members, so it can only be copied in whole
+    GgChainArena init = gg_chain_arena_init(alloc, GG_SCRATCH_BLOCK_SIZE);
+    memcpy(chain, &init, sizeof(init));
+
+    if (pthread_setspecific(scratch_key, chain) != 0) {
+        GG_LOGE("Failed to register scratch arena for thread.");
+        gg_free(alloc, chain);
+        return NULL;
+    }
+    return chain;
+}
+
+GgError gg_scratch_borrow(size_t size, GgScratch *scratch, GgArena *arena) {
+    *scratch = (GgScratch) { 0 };
+
+    GgChainArena *chain = thread_scratch();
+    if (chain == NULL) {
+        return GG_ERR_NOMEM;
+    }
+
+    GgChainArenaState state = gg_chain_arena_save(chain);
+    GgError ret = gg_chain_arena_sub(chain, size, arena);
+    if (ret != GG_ERR_OK) {
+        GG_LOGE("Failed to borrow %zu bytes of scratch memory.", size);
+        return ret;
+    }
+
+    *scratch = (GgScratch) { .chain = chain, .state = state };
+    return GG_ERR_OK;
+}
+
+void gg_scratch_return(GgScratch *scratch) {
+    if (scratch->chain != NULL) {
+        gg_chain_arena_restore(scratch->chain, scratch->state);
+        scratch->chain = NULL;
+    }
+}
+
+#ifdef GG_SDK_TESTING
+
+#include <gg/cleanup.h>
+#include <gg/test.h>
+#include <unity.h>
+
+static void *borrow_on_thread(void *ctx) {
+    GgScratch scratch;
+    GgArena arena;
+    if (gg_scratch_borrow(16, &scratch, &arena) != GG_ERR_OK) {
+        return NULL;
+    }
+    void *mem = arena.mem;
+    gg_scratch_return(&scratch);
+    return (mem == ctx) ? NULL : mem;
+}
+
+GG_TEST_DEFINE(scratch_borrow_nested) {
+    GgScratch outer;
+    GgArena outer_arena;
+    GG_TEST_ASSERT_OK(gg_scratch_borrow(100, &outer, &outer_arena));
+    TEST_ASSERT_EQUAL(100, outer_arena.capacity);
+    uint8_t *outer_mem = outer_arena.mem;
+
+    {
+        GgScratch inner;
+        GgArena inner_arena;
+        GG_TEST_ASSERT_OK(gg_scratch_borrow(
+            GG_SCRATCH_BLOCK_SIZE * 2, &inner, &inner_arena
+        ));
+        GG_CLEANUP(cleanup_gg_scratch_return, inner);
+        TEST_ASSERT_NOT_NULL(
+            GG_ARENA_ALLOCN(&inner_arena, uint8_t, GG_SCRATCH_BLOCK_SIZE * 2)
+        );
+        TEST_ASSERT_FALSE(gg_arena_owns(&outer_arena, inner_arena.mem));
+    }
+
+    // Other threads have their own scratch memory
+    pthread_t thread;
+    TEST_ASSERT_EQUAL(
+        0, pthread_create(&thread, NULL, borrow_on_thread, outer_mem)
+    );
+    void *thread_mem = NULL;
+    TEST_ASSERT_EQUAL(0, pthread_join(thread, &thread_mem));
+    TEST_ASSERT_NOT_NULL(thread_mem);
+
+    gg_scratch_return(&outer);
+    TEST_ASSERT_NULL(outer.chain);
+
+    // Returned memory is reused
+    GgScratch again;
+    GgArena again_arena;
+    GG_TEST_ASSERT_OK(gg_scratch_borrow(100, &again, &again_arena));
+    TEST_ASSERT_EQUAL_PTR(outer_mem, again_arena.mem);
+    gg_scratch_return(&again);
+}
+
+#endif
@@ -0,0 +1,560 @@
+// aws-greengrass-component-sdk - Lightweight AWS IoT Greengrass SDK
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gg/buffer.h>
+#include <gg/utf8.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define UTF8_X86 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define UTF8_NEON 1
+#endif
+
+#ifndef UTF8_X86
+#define UTF8_X86 0
+#endif
+#ifndef UTF8_NEON
+#define UTF8_NEON 0
+#endif
+
+typedef bool Utf8ValidateFn(const uint8_t *data, size_t len);
+
+static bool utf8_validate_scalar(const uint8_t *data, size_t len) {
+    size_t i = 0;
+    while (i < len) {
+        if ((len - i) >= 8) {
+            uint64_t word;
+            memcpy(&word, &data[i], sizeof(word));
+            if ((word & UINT64_C(0x8080808080808080)) == 0) {
+                i += 8;
+                continue;
+            }
+        }
+
+        uint8_t c = data[i];
+        if (c < 0x80) {
+            i += 1;
+            continue;
+        }
+
+        size_t seq_len;
+        uint8_t min = 0x80;
+        uint8_t max = 0xBF;
+        if (c < 0xC2) {
+            // Continuation byte or overlong two byte sequence
+            return false;
+        }
+        if (c < 0xE0) {
+            seq_len = 2;
+        } else if (c < 0xF0) {
+            seq_len = 3;
+            if (c == 0xE0) {
+                min = 0xA0;
+            } else if (c == 0xED) {
+                // Surrogates
+                max = 0x9F;
+            }
+        } else if (c < 0xF5) {
+            seq_len = 4;
+            if (c == 0xF0) {
+                min = 0x90;
+            } else if (c == 0xF4) {
+                max = 0x8F;
+            }
+        } else {
+            return false;
+        }
+
+        if ((len - i) < seq_len) {
+            return false;
+        }
+        if ((data[i + 1] < min) || (data[i + 1] > max)) {
+            return false;
+        }
+        for (size_t j = 2; j < seq_len; j++) {
+            if ((data[i + j] & 0xC0) != 0x80) {
+                return false;
+            }
+        }
+        i += seq_len;
+    }
+    return true;
+}
+
+#if UTF8_X86 || UTF8_NEON
+
+// Vector validation uses the lookup algorithm from "Validating UTF-8 In Less
+// Than One Instruction Per Byte" (Keiser, Lemire). Each byte is classified by
+// the high nibble of the previous byte, the low nibble of the previous byte,
+// and its own high nibble; the AND of the three lookups is non-zero for every
+// invalid two byte pattern. Three and four byte sequences are checked by
+// requiring continuation bytes exactly where earlier lead bytes need them.
+
+#define TOO_SHORT (1U << 0)
+#define TOO_LONG (1U << 1)
+#define OVERLONG_3 (1U << 2)
+#define TOO_LARGE (1U << 3)
+#define SURROGATE (1U << 4)
+#define OVERLONG_2 (1U << 5)
+#define TOO_LARGE_1000 (1U << 6)
+#define OVERLONG_4 (1U << 6)
+#define TWO_CONTS (1U << 7)
+#define CARRY (TOO_SHORT | TOO_LONG | TWO_CONTS)
+
+static const uint8_t BYTE_1_HIGH[16] = {
+    // 0_______ ASCII
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    // 10______ continuation
+    TWO_CONTS,
+    TWO_CONTS,
+    TWO_CONTS,
+    TWO_CONTS,
+    // 1100____ two byte lead
+    TOO_SHORT | OVERLONG_2,
+    // 1101____ two byte lead
+    TOO_SHORT,
+    // 1110____ three byte lead
+    TOO_SHORT | OVERLONG_3 | SURROGATE,
+    // 1111____ four byte lead
+    TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4,
+};
+
+static const uint8_t BYTE_1_LOW[16] = {
+    // ____0000
+    CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+    // ____0001
+    CARRY | OVERLONG_2,
+    // ____001_
+    CARRY,
+    CARRY,
+    // ____0100
+    CARRY | TOO_LARGE,
+    // ____0101
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    // ____011_
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    // ____1___
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    // ____1101
+    CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+};
+
+static const uint8_t BYTE_2_HIGH[16] = {
+    // 0_______ ASCII
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    // 1000____
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000
+        | OVERLONG_4,
+    // 1001____
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+    // 101_____
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+    // 11______ lead
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+};
+
+/// Whether the last bytes of a block start a sequence that continues into the
+/// next block.
+static bool utf8_block_incomplete(const uint8_t *block_end) {
+    return (block_end[-1] >= 0xC0) || (block_end[-2] >= 0xE0)
+        || (block_end[-3] >= 0xF0);
+}
+
+#endif
+
+#if UTF8_X86
+
+__attribute__((target("ssse3"))) static __m128i utf8_check_ssse3(
+    __m128i input, __m128i prev
+) {
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    __m128i prev1 = _mm_alignr_epi8(input, prev, 15);
+    __m128i byte_1_high = _mm_shuffle_epi8(
+        _mm_loadu_si128((const __m128i *) BYTE_1_HIGH),
+        _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)
+    );
+    __m128i byte_1_low = _mm_shuffle_epi8(
+        _mm_loadu_si128((const __m128i *) BYTE_1_LOW),
+        _mm_and_si128(prev1, nibble)
+    );
+    __m128i byte_2_high = _mm_shuffle_epi8(
+        _mm_loadu_si128((const __m128i *) BYTE_2_HIGH),
+        _mm_and_si128(_mm_srli_epi16(input, 4), nibble)
+    );
+    __m128i special
+        = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+    __m128i prev2 = _mm_alignr_epi8(input, prev, 14);
+    __m128i prev3 = _mm_alignr_epi8(input, prev, 13);
+    __m128i third = _mm_subs_epu8(prev2, _mm_set1_epi8((char) (0xE0 - 0x80)));
+    __m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8((char) (0xF0 - 0x80)));
+    __m128i must_cont = _mm_and_si128(
+        _mm_or_si128(third, fourth), _mm_set1_epi8((char) 0x80)
+    );
+    return _mm_xor_si128(must_cont, special);
+}
+
+__attribute__((target("ssse3"))) static bool utf8_validate_ssse3(
+    const uint8_t *data, size_t len
+) {
+    __m128i error = _mm_setzero_si128();
+    __m128i prev = _mm_setzero_si128();
+    bool prev_incomplete = false;
+    size_t i = 0;
+
+    for (; (len - i) >= 16; i += 16) {
+        __m128i input = _mm_loadu_si128((const __m128i *) &data[i]);
+        if (_mm_movemask_epi8(input) == 0) {
+            if (prev_incomplete) {
+                return false;
+            }
+        } else {
+            error = _mm_or_si128(error, utf8_check_ssse3(input, prev));
+            prev_incomplete = utf8_block_incomplete(&data[i + 16]);
+        }
+        prev = input;
+    }
+
+    // Zero padding is ASCII, which ends any sequence still open
+    uint8_t tail[16] = { 0 };
+    memcpy(tail, &data[i], len - i);
+    __m128i input = _mm_loadu_si128((const __m128i *) tail);
+    error = _mm_or_si128(error, utf8_check_ssse3(input, prev));
+
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128()))
+        == 0xFFFF;
+}
+
+__attribute__((target("avx2"))) static __m256i utf8_check_avx2(
+    __m256i input, __m256i prev
+) {
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    // Bytes 16..31 of prev followed by bytes 0..15 of input
+    __m256i shifted = _mm256_permute2x128_si256(prev, input, 0x21);
+    __m256i prev1 = _mm256_alignr_epi8(input, shifted, 15);
+    __m256i byte_1_high = _mm256_shuffle_epi8(
+        _mm256_broadcastsi128_si256(
+            _mm_loadu_si128((const __m128i *) BYTE_1_HIGH)
+        ),
+        _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)
+    );
+    __m256i byte_1_low = _mm256_shuffle_epi8(
+        _mm256_broadcastsi128_si256(
+            _mm_loadu_si128((const __m128i *) BYTE_1_LOW)
+        ),
+        _mm256_and_si256(prev1, nibble)
+    );
+    __m256i byte_2_high = _mm256_shuffle_epi8(
+        _mm256_broadcastsi128_si256(
+            _mm_loadu_si128((const __m128i *) BYTE_2_HIGH)
+        ),
+        _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble)
+    );
+    __m256i special = _mm256_and_si256(
+        _mm256_and_si256(byte_1_high, byte_1_low), byte_2_high
+    );
+
+    __m256i prev2 = _mm256_alignr_epi8(input, shifted, 14);
+    __m256i prev3 = _mm256_alignr_epi8(input, shifted, 13);
+    __m256i third
+        = _mm256_subs_epu8(prev2, _mm256_set1_epi8((char) (0xE0 - 0x80)));
+    __m256i fourth
+        = _mm256_subs_epu8(prev3, _mm256_set1_epi8((char) (0xF0 - 0x80)));
+    __m256i must_cont = _mm256_and_si256(
+        _mm256_or_si256(third, fourth), _mm256_set1_epi8((char) 0x80)
+    );
+    return _mm256_xor_si256(must_cont, special);
+}
+
+__attribute__((target("avx2"))) static bool utf8_validate_avx2(
+    const uint8_t *data, size_t len
+) {
+    __m256i error = _mm256_setzero_si256();
+    __m256i prev = _mm256_setzero_si256();
+    bool prev_incomplete = false;
+    size_t i = 0;
+
+    for (; (len - i) >= 32; i += 32) {
+        __m256i input = _mm256_loadu_si256((const __m256i *) &data[i]);
+        if (_mm256_movemask_epi8(input) == 0) {
+            if (prev_incomplete) {
+                return false;
+            }
+        } else {
+            error = _mm256_or_si256(error, utf8_check_avx2(input, prev));
+            prev_incomplete = utf8_block_incomplete(&data[i + 32]);
+        }
+        prev = input;
+    }
+
+    // Zero padding is ASCII, which ends any sequence still open
+    uint8_t tail[32] = { 0 };
+    memcpy(tail, &data[i], len - i);
+    __m256i input = _mm256_loadu_si256((const __m256i *) tail);
+    error = _mm256_or_si256(error, utf8_check_avx2(input, prev));
+
+    return _mm256_testz_si256(error, error) != 0;
+}
+
+static Utf8ValidateFn *utf8_validate_impl = utf8_validate_scalar;
+
+__attribute__((constructor)) static void utf8_select_impl(void) {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        utf8_validate_impl = utf8_validate_avx2;
+    } else if (__builtin_cpu_supports("ssse3")) {
+        utf8_validate_impl = utf8_validate_ssse3;
+    }
+}
+
+#elif UTF8_NEON
+
+static uint8x16_t utf8_check_neon(uint8x16_t input, uint8x16_t prev) {
+    const uint8x16_t nibble = vdupq_n_u8(0x0F);
+    uint8x16_t prev1 = vextq_u8(prev, input, 15);
+    uint8x16_t byte_1_high
+        = vqtbl1q_u8(vld1q_u8(BYTE_1_HIGH), vshrq_n_u8(prev1, 4));
+    uint8x16_t byte_1_low
+        = vqtbl1q_u8(vld1q_u8(BYTE_1_LOW), vandq_u8(prev1, nibble));
+    uint8x16_t byte_2_high
+        = vqtbl1q_u8(vld1q_u8(BYTE_2_HIGH), vshrq_n_u8(input, 4));
+    uint8x16_t special
+        = vandq_u8(vandq_u8(byte_1_high, byte_1_low), byte_2_high);
+
+    uint8x16_t prev2 = vextq_u8(prev, input, 14);
+    uint8x16_t prev3 = vextq_u8(prev, input, 13);
+    uint8x16_t third = vqsubq_u8(prev2, vdupq_n_u8(0xE0 - 0x80));
+    uint8x16_t fourth = vqsubq_u8(prev3, vdupq_n_u8(0xF0 - 0x80));
+    uint8x16_t must_cont
+        = vandq_u8(vorrq_u8(third, fourth), vdupq_n_u8(0x80));
+    return veorq_u8(must_cont, special);
+}
+
+static bool utf8_validate_neon(const uint8_t *data, size_t len) {
+    uint8x16_t error = vdupq_n_u8(0);
+    uint8x16_t prev = vdupq_n_u8(0);
+    bool prev_incomplete = false;
+    size_t i = 0;
+
+    for (; (len - i) >= 16; i += 16) {
+        uint8x16_t input = vld1q_u8(&data[i]);
+        if (vmaxvq_u8(input) < 0x80) {
+            if (prev_incomplete) {
+                return false;
+            }
+        } else {
+            error = vorrq_u8(error, utf8_check_neon(input, prev));
+            prev_incomplete = utf8_block_incomplete(&data[i + 16]);
+        }
+        prev = input;
+    }
+
+    // Zero padding is ASCII, which ends any sequence still open
+    uint8_t tail[16] = { 0 };
+    memcpy(tail, &data[i], len - i);
+    error = vorrq_u8(error, utf8_check_neon(vld1q_u8(tail), prev));
+
+    return vmaxvq_u8(error) == 0;
+}
+
+static Utf8ValidateFn *const utf8_validate_impl = utf8_validate_neon;
+
+#else
+
+static Utf8ValidateFn *const utf8_validate_impl = utf8_validate_scalar;
+
+#endif
+
+bool gg_utf8_validate(GgBuffer buf) {
+    if (buf.len == 0) {
+        return true;
+    }
+    return utf8_validate_impl(buf.data, buf.len);
+}
+
+#ifdef GG_SDK_TESTING
+#include <gg/test.h>
+#include <unity.h>
+
+static const char *const UTF8_VALID[] = {
+    "",
+    "ascii only",
+    "\xC2\xA9 copyright",
+    "\xE2\x82\xAC euro",
+    "\xF0\x9F\x98\x80 emoji",
+    "\xED\x9F\xBF",
+    "\xEE\x80\x80",
+    "\xF4\x8F\xBF\xBF",
+    "\xE0\xA0\x80",
+    "\xF0\x90\x80\x80",
+};
+
+static const char *const UTF8_INVALID[] = {
+    "\x80",
+    "\xBF continuation",
+    "\xC0\x80",
+    "\xC1\xBF",
+    "\xC2",
+    "\xC2 ",
+    "\xE0\x80\x80",
+    "\xE0\x9F\xBF",
+    "\xED\xA0\x80",
+    "\xED\xBF\xBF",
+    "\xE2\x82",
+    "\xF0\x80\x80\x80",
+    "\xF0\x8F\xBF\xBF",
+    "\xF4\x90\x80\x80",
+    "\xF5\x80\x80\x80",
+    "\xFF",
+    "\xF0\x9F\x98",
+};
+
+static Utf8ValidateFn *const UTF8_TEST_IMPLS[] = {
+    utf8_validate_scalar,
+#if UTF8_NEON
+    utf8_validate_neon,
+#endif
+};
+
+static void utf8_test_all_impls(
+    const uint8_t *data, size_t len, bool expected, UNITY_UINT line_no
+) {
+    Utf8ValidateFn *impls[4];
+    size_t count = 0;
+    for (size_t i = 0; i < sizeof(UTF8_TEST_IMPLS) / sizeof(*UTF8_TEST_IMPLS);
+         i++) {
+        impls[count++] = UTF8_TEST_IMPLS[i];
+    }
+#if UTF8_X86
+    if (__builtin_cpu_supports("ssse3")) {
+        impls[count++] = utf8_validate_ssse3;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        impls[count++] = utf8_validate_avx2;
+    }
+#endif
+    for (size_t i = 0; i < count; i++) {
+        if (impls[i](data, len) != expected) {
+            UnityFail(
+                expected ? "Valid UTF-8 rejected." : "Invalid UTF-8 accepted.",
+                line_no
+            );
+        }
+    }
+}
+
+GG_TEST_DEFINE(utf8_validate_sequences) {
+    // Place each sequence at every offset around vector block boundaries
+    uint8_t buf[80];
+    for (size_t i = 0; i < sizeof(UTF8_VALID) / sizeof(*UTF8_VALID); i++) {
+        size_t len = strlen(UTF8_VALID[i]);
+        for (size_t offset = 0; offset + len <= sizeof(buf); offset++) {
+            memset(buf, 'a', sizeof(buf));
+            memcpy(&buf[offset], UTF8_VALID[i], len);
+            utf8_test_all_impls(buf, sizeof(buf), true, __LINE__);
+            utf8_test_all_impls(buf, offset + len, true, __LINE__);
+        }
+    }
+    for (size_t i = 0; i < sizeof(UTF8_INVALID) / sizeof(*UTF8_INVALID); i++) {
+        size_t len = strlen(UTF8_INVALID[i]);
+        for (size_t offset = 0; offset + len <= sizeof(buf); offset++) {
+            memset(buf, 'a', sizeof(buf));
+            memcpy(&buf[offset], UTF8_INVALID[i], len);
+            utf8_test_all_impls(buf, sizeof(buf), false, __LINE__);
+            utf8_test_all_impls(buf, offset + len, false, __LINE__);
+        }
+    }
+}
+
+GG_TEST_DEFINE(utf8_validate_random) {
+    // Vector implementations must agree with the scalar one
+    uint8_t buf[256];
+    uint32_t state = 12345;
+    for (size_t iter = 0; iter < 20000; iter++) {
+        for (size_t i = 0; i < sizeof(buf); i++) {
+            state = (state * 1103515245U) + 12345U;
+            uint8_t byte = (uint8_t) (state >> 16);
+            // Bias towards structured multi-byte input
+            buf[i] = ((state >> 8) & 3) == 0 ? (uint8_t) (byte | 0x80)
+                                              : (uint8_t) (byte & 0x7F);
+            if (((state >> 4) & 7) == 0) {
+                buf[i] = (uint8_t) (0x80 | (byte & 0x3F));
+            }
+        }
+        size_t len = (size_t) (state % sizeof(buf));
+        bool expected = utf8_validate_scalar(buf, len);
+        utf8_test_all_impls(buf, len, expected, __LINE__);
+    }
+
+    // Random valid code points
+    for (size_t iter = 0; iter < 2000; iter++) {
+        size_t len = 0;
+        while (len + 4 <= sizeof(buf)) {
+            state = (state * 1103515245U) + 12345U;
+            uint32_t cp = (state >> 8) % 0x110000;
+            if ((cp >= 0xD800) && (cp <= 0xDFFF)) {
+                continue;
+            }
+            if (cp < 0x80) {
+                buf[len++] = (uint8_t) cp;
+            } else if (cp < 0x800) {
+                buf[len++] = (uint8_t) (0xC0 | (cp >> 6));
+                buf[len++] = (uint8_t) (0x80 | (cp & 0x3F));
+            } else if (cp < 0x10000) {
+                buf[len++] = (uint8_t) (0xE0 | (cp >> 12));
+                buf[len++] = (uint8_t) (0x80 | ((cp >> 6) & 0x3F));
+                buf[len++] = (uint8_t) (0x80 | (cp & 0x3F));
+            } else {
+                buf[len++] = (uint8_t) (0xF0 | (cp >> 18));
+                buf[len++] = (uint8_t) (0x80 | ((cp >> 12) & 0x3F));
+                buf[len++] = (uint8_t) (0x80 | ((cp >> 6) & 0x3F));
+                buf[len++] = (uint8_t) (0x80 | (cp & 0x3F));
+            }
+        }
+        utf8_test_all_impls(buf, len, true, __LINE__);
+        // Truncating inside the last sequence must fail
+        if ((buf[len - 1] & 0x80) != 0) {
+            size_t cut = len - 1;
+            while ((buf[cut] & 0xC0) == 0x80) {
+                cut--;
+            }
+            for (size_t end = cut + 1; end < len; end++) {
+                utf8_test_all_impls(buf, end, false, __LINE__);
+            }
+        }
+    }
+}
+
+#endif
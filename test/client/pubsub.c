@@ -0,0 +1,156 @@
+#include <gg/buffer.h>
+#include <gg/ipc/client.h>
+#include <gg/ipc/mock.h>
+#include <gg/ipc/packet_sequences.h>
+#include <gg/log.h>
+#include <gg/map.h>
+#include <gg/object.h>
+#include <gg/process_wait.h>
+#include <gg/sdk.h>
+#include <gg/test.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+#include <unity.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define GG_MODULE "test_pubsub"
+
+// CBOR encoding of {"a": 1}
+static const GgBuffer CBOR_MAP_BASE64 = GG_STR("oWFhAQ==");
+// CBOR encoding of 1
+static const GgBuffer CBOR_INT_BASE64 = GG_STR("AQ==");
+
+GG_TEST_DEFINE(publish_to_topic_cbor_okay) {
+    pid_t pid = fork();
+    TEST_ASSERT_TRUE_MESSAGE(pid >= 0, "fork failed");
+
+    if (pid == 0) {
+        gg_sdk_init();
+        GG_TEST_ASSERT_OK(ggipc_connect());
+        GG_TEST_ASSERT_OK(ggipc_publish_to_topic_cbor(
+            GG_STR("my/topic"), GG_MAP(gg_kv(GG_STR("a"), gg_obj_i64(1)))
+        ));
+        TEST_PASS();
+    }
+
+    GG_TEST_ASSERT_OK(gg_test_accept_client(1));
+
+    GG_TEST_ASSERT_OK(gg_test_expect_packet_sequence(
+        gg_test_connect_accepted_sequence(gg_test_get_auth_token()), 5
+    ));
+
+    GG_TEST_ASSERT_OK(gg_test_expect_packet_sequence(
+        gg_test_pubsub_publish_binary_accepted_sequence(
+            1, GG_STR("my/topic"), CBOR_MAP_BASE64
+        ),
+        5
+    ));
+
+    GG_TEST_ASSERT_OK(gg_test_wait_for_client_disconnect(1));
+
+    GG_TEST_ASSERT_OK(gg_process_wait(pid));
+}
+
+typedef struct {
+    pthread_mutex_t mut;
+    pthread_cond_t cond;
+    size_t calls;
+} SubscribeCborContext;
+
+static SubscribeCborContext subscribe_cbor_context
+    = { .mut = PTHREAD_MUTEX_INITIALIZER,
+        .cond = PTHREAD_COND_INITIALIZER,
+        .calls = 0 };
+
+static void subscribe_to_topic_cbor_okay_response(
+    void *ctx, GgBuffer topic, GgMap payload, GgIpcSubscriptionHandle handle
+) {
+    (void) handle;
+    SubscribeCborContext *context = ctx;
+    TEST_ASSERT_EQUAL_PTR(&subscribe_cbor_context, context);
+    GG_TEST_ASSERT_BUF_EQUAL_STR(GG_STR("my/topic"), topic);
+
+    TEST_ASSERT_EQUAL_size_t(1, payload.len);
+    GgObject *value;
+    TEST_ASSERT_TRUE(gg_map_get(payload, GG_STR("a"), &value));
+    TEST_ASSERT_EQUAL(GG_TYPE_I64, gg_obj_type(*value));
+    TEST_ASSERT_EQUAL_INT64(1, gg_obj_into_i64(*value));
+
+    pthread_mutex_lock(&context->mut);
+    context->calls += 1;
+    pthread_cond_signal(&context->cond);
+    pthread_mutex_unlock(&context->mut);
+}
+
+GG_TEST_DEFINE(subscribe_to_topic_cbor_okay) {
+    // Non-map payload is dropped without closing the subscription, and the
+    // map is then received both CBOR encoded and as a JSON message.
+    static const size_t EXPECTED_CALLS = 2;
+
+    pid_t pid = fork();
+    TEST_ASSERT_TRUE_MESSAGE(pid >= 0, "fork failed");
+
+    if (pid == 0) {
+        gg_sdk_init();
+        GG_TEST_ASSERT_OK(ggipc_connect());
+        GG_TEST_ASSERT_OK(ggipc_subscribe_to_topic_cbor(
+            GG_STR("my/topic"),
+            subscribe_to_topic_cbor_okay_response,
+            &subscribe_cbor_context,
+            NULL
+        ));
+
+        struct timespec wait_until;
+        clock_gettime(CLOCK_REALTIME, &wait_until);
+        wait_until.tv_sec += 1;
+
+        int pthread_ret = 0;
+        pthread_mutex_lock(&subscribe_cbor_context.mut);
+        while ((subscribe_cbor_context.calls < EXPECTED_CALLS)
+               && (pthread_ret == 0)) {
+            pthread_ret = pthread_cond_timedwait(
+                &subscribe_cbor_context.cond,
+                &subscribe_cbor_context.mut,
+                &wait_until
+            );
+        }
+        size_t calls = subscribe_cbor_context.calls;
+        pthread_mutex_unlock(&subscribe_cbor_context.mut);
+
+        TEST_ASSERT_EQUAL_size_t_MESSAGE(
+            EXPECTED_CALLS,
+            calls,
+            "Subscription not called the expected number of times."
+        );
+        TEST_PASS();
+    }
+
+    GgObject messages[] = {
+        gg_obj_buf(CBOR_INT_BASE64),
+        gg_obj_buf(CBOR_MAP_BASE64),
+        gg_obj_map(GG_MAP(gg_kv(GG_STR("a"), gg_obj_i64(1)))),
+    };
+
+    GG_TEST_ASSERT_OK(gg_test_accept_client(1));
+
+    GG_TEST_ASSERT_OK(gg_test_expect_packet_sequence(
+        gg_test_connect_accepted_sequence(gg_test_get_auth_token()), 5
+    ));
+
+    GG_TEST_ASSERT_OK(gg_test_expect_packet_sequence(
+        gg_test_pubsub_subscribe_accepted_sequence(
+            1,
+            GG_STR("my/topic"),
+            (GgList) { .items = messages,
+                       .len = sizeof(messages) / sizeof(messages[0]) }
+        ),
+        30
+    ));
+
+    GG_TEST_ASSERT_OK(gg_test_wait_for_client_disconnect(5));
+
+    GG_TEST_ASSERT_OK(gg_process_wait(pid));
+}
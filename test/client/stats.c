@@ -0,0 +1,88 @@
+#include <gg/buffer.h>
+#include <gg/ipc/client.h>
+#include <gg/ipc/limits.h>
+#include <gg/ipc/mock.h>
+#include <gg/ipc/packet_sequences.h>
+#include <gg/ipc/stats.h>
+#include <gg/process_wait.h>
+#include <gg/sdk.h>
+#include <gg/test.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <unity.h>
+#include <stdint.h>
+
+GG_TEST_DEFINE(ipc_stats_publish) {
+    pid_t pid = fork();
+    TEST_ASSERT_TRUE_MESSAGE(pid >= 0, "fork failed");
+
+    if (pid == 0) {
+        gg_sdk_init();
+        GG_TEST_ASSERT_OK(ggipc_connect());
+        GG_TEST_ASSERT_OK(ggipc_publish_to_iot_core(
+            GG_STR("my/topic"), GG_STR("Hello world!"), 0
+        ));
+        GG_TEST_ASSERT_BAD(ggipc_publish_to_iot_core(
+            GG_STR("my/topic"), GG_STR("Hello world!"), 0
+        ));
+
+        GgIpcStats stats;
+        ggipc_get_stats(&stats);
+        TEST_ASSERT_EQUAL_UINT64(2, stats.calls);
+        TEST_ASSERT_EQUAL_UINT64(1, stats.errors);
+        TEST_ASSERT_EQUAL_UINT64(0, stats.timeouts);
+        // Connect and two requests each way
+        TEST_ASSERT_EQUAL_UINT64(3, stats.frames_sent);
+        TEST_ASSERT_EQUAL_UINT64(3, stats.frames_received);
+        TEST_ASSERT_TRUE(stats.bytes_sent > 3 * 16);
+        TEST_ASSERT_TRUE(stats.bytes_received > 3 * 16);
+        TEST_ASSERT_EQUAL_UINT64(0, stats.decode_failures);
+
+        TEST_ASSERT_EQUAL(1, stats.op_count);
+        GG_TEST_ASSERT_BUF_EQUAL_STR(
+            GG_STR("aws.greengrass#PublishToIoTCore"),
+            gg_buffer_from_null_term(stats.ops[0].operation)
+        );
+        TEST_ASSERT_EQUAL_UINT64(2, stats.ops[0].calls);
+        TEST_ASSERT_EQUAL_UINT64(1, stats.ops[0].errors);
+        uint64_t responses = 0;
+        for (size_t i = 0; i < GG_IPC_LATENCY_BUCKETS; i++) {
+            responses += stats.ops[0].latency_hist[i];
+        }
+        TEST_ASSERT_EQUAL_UINT64(2, responses);
+
+        // Received frames are stored without their 12 byte prelude
+        GgIpcMemoryUsage usage;
+        ggipc_get_memory_usage(&usage);
+        TEST_ASSERT_TRUE(usage.send_buf.peak > 16);
+        TEST_ASSERT_TRUE(usage.send_buf.peak < stats.bytes_sent);
+        TEST_ASSERT_TRUE(usage.recv_buf.peak > 4);
+        TEST_ASSERT_TRUE(usage.recv_buf.peak + 12 <= stats.bytes_received);
+        TEST_ASSERT_EQUAL(GG_IPC_MAX_MSG_LEN, usage.recv_buf.capacity);
+        TEST_PASS();
+    }
+
+    GG_TEST_ASSERT_OK(gg_test_accept_client(1));
+
+    GG_TEST_ASSERT_OK(gg_test_expect_packet_sequence(
+        gg_test_connect_accepted_sequence(gg_test_get_auth_token()), 5
+    ));
+
+    GG_TEST_ASSERT_OK(gg_test_expect_packet_sequence(
+        gg_test_mqtt_publish_accepted_sequence(
+            1, GG_STR("my/topic"), GG_STR("SGVsbG8gd29ybGQh"), GG_STR("0")
+        ),
+        5
+    ));
+
+    GG_TEST_ASSERT_OK(gg_test_expect_packet_sequence(
+        gg_test_mqtt_publish_error_sequence(
+            2, GG_STR("my/topic"), GG_STR("SGVsbG8gd29ybGQh"), GG_STR("0")
+        ),
+        5
+    ));
+
+    GG_TEST_ASSERT_OK(gg_test_wait_for_client_disconnect(1));
+
+    GG_TEST_ASSERT_OK(gg_process_wait(pid));
+}